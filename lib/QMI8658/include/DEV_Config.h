@@ -63,6 +63,8 @@
 
 #define DEV_SDA_PIN     (6)
 #define DEV_SCL_PIN     (7)
+#define DEV_INT1_PIN    (4)     // QMI8658 INT1
+#define DEV_INT2_PIN    (3)     // QMI8658 INT2
 
 #define BAT_ADC_PIN     (1)
 
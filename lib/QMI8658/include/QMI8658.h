@@ -29,9 +29,20 @@
 #define QMI8658_CONFIG_ACCGYRMAG_ENABLE (QMI8658_CONFIG_ACC_ENABLE | QMI8658_CONFIG_GYR_ENABLE | QMI8658_CONFIG_MAG_ENABLE)
 #define QMI8658_CONFIG_AEMAG_ENABLE (QMI8658_CONFIG_AE_ENABLE | QMI8658_CONFIG_MAG_ENABLE)
 
+#define QMI8658_CTRL1_INT1_ENABLE (0x08)
+#define QMI8658_CTRL1_INT2_ENABLE (0x10)
+
+#define QMI8658_STATUSINT_CMD_DONE (0x80)
 #define QMI8658_STATUS1_CMD_DONE (0x01)
 #define QMI8658_STATUS1_WAKEUP_EVENT (0x04)
 
+#define QMI8658_FIFO_CTRL_RD_MODE (0x80)
+#define QMI8658_FIFO_STATUS_FULL (0x80)
+#define QMI8658_FIFO_STATUS_WTM (0x40)
+#define QMI8658_FIFO_STATUS_OVERFLOW (0x20)
+#define QMI8658_FIFO_STATUS_NOT_EMPTY (0x10)
+#define QMI8658_FIFO_STATUS_CNT_MSB (0x03)
+
 enum QMI8658Register
 {
     /*! \brief FIS device identifier register. */
@@ -72,12 +83,16 @@ enum QMI8658Register
     QMI8658Register_Cal4_L,
     /*! \brief Calibration register 4 least significant byte. */
     QMI8658Register_Cal4_H,
+    /*! \brief FIFO watermark level, in samples. */
+    QMI8658Register_FifoWtmTh = 19,
     /*! \brief FIFO control register. */
-    QMI8658Register_FifoCtrl = 19,
-    /*! \brief FIFO data register. */
-    QMI8658Register_FifoData, // 20
-    /*! \brief FIFO status register. */
-    QMI8658Register_FifoStatus, // 21
+    QMI8658Register_FifoCtrl, // 20
+    /*! \brief FIFO sample count, in 2-byte words (LSBs). */
+    QMI8658Register_FifoSmplCnt, // 21
+    /*! \brief FIFO status register, sample count MSBs in bits 1:0. */
+    QMI8658Register_FifoStatus, // 22
+    /*! \brief FIFO data register, reads do not auto-increment. */
+    QMI8658Register_FifoData, // 23
     /*! \brief Output data overrun and availability. */
     QMI8658Register_StatusInt = 45,
     /*! \brief Output data overrun and availability. */
@@ -224,6 +239,8 @@ enum QMI8658_Ctrl9Command
     QMI8658_Ctrl9_Cmd_NOP = 0X00,
     QMI8658_Ctrl9_Cmd_GyroBias = 0X01,
     QMI8658_Ctrl9_Cmd_Rqst_Sdi_Mod = 0X03,
+    QMI8658_Ctrl9_Cmd_Rst_Fifo = 0x04,
+    QMI8658_Ctrl9_Cmd_Req_Fifo = 0x05,
     QMI8658_Ctrl9_Cmd_WoM_Setting = 0x08,
     QMI8658_Ctrl9_Cmd_AccelHostDeltaOffset = 0x09,
     QMI8658_Ctrl9_Cmd_GyroHostDeltaOffset = 0x0A,
@@ -315,6 +332,21 @@ enum QMI8658_GyrOdr
     QMI8658GyrOdr_31_25Hz = 0x08 /*!< \brief High resolution 31.25Hz output rate. */
 };
 
+enum QMI8658_FifoSize
+{
+    QMI8658FifoSize_16 = 0x00 << 2,  /*!< \brief 16 samples. */
+    QMI8658FifoSize_32 = 0x01 << 2,  /*!< \brief 32 samples. */
+    QMI8658FifoSize_64 = 0x02 << 2,  /*!< \brief 64 samples. */
+    QMI8658FifoSize_128 = 0x03 << 2  /*!< \brief 128 samples. */
+};
+
+enum QMI8658_FifoMode
+{
+    QMI8658FifoMode_Bypass = 0x00, /*!< \brief FIFO disabled. */
+    QMI8658FifoMode_Fifo = 0x01,   /*!< \brief Stop collecting when full. */
+    QMI8658FifoMode_Stream = 0x02  /*!< \brief Overwrite the oldest samples when full. */
+};
+
 enum QMI8658_AeOdr
 {
     QMI8658AeOdr_1Hz = 0x00,   /*!< \brief 1Hz output rate. */
@@ -437,6 +469,23 @@ struct FisImuRawSample
     // unsigned int durT;
 };
 
+/*!
+ * \brief One accelerometer + gyroscope sample read from the FIFO.
+ */
+struct QMI8658Sample
+{
+    /*! \brief Sample counter of the IMU, increments once per output sample. */
+    unsigned int timestamp;
+    /*! \brief Acceleration in mg. */
+    float acc[3];
+    /*! \brief Angular rate in dps. */
+    float gyro[3];
+    /*! \brief Acceleration as read, in LSB of the configured range. */
+    short acc_raw[3];
+    /*! \brief Angular rate as read, in LSB of the configured range. */
+    short gyro_raw[3];
+};
+
 struct QMI8658_offsetCalibration
 {
     enum QMI8658_AccUnit accUnit;
@@ -451,18 +500,19 @@ struct QMI8658_sensitivityCalibration
     float gyrSensitivity[3];
 };
 
+/* Wake on motion interrupt selection, CAL1_H bits [7:6] */
 enum QMI8658_Interrupt
 {
     /*! \brief FIS INT1 line. */
-    QMI8658_Int1 = (0 << 6),
+    QMI8658_Int1 = (1 << 7),
     /*! \brief FIS INT2 line. */
-    QMI8658_Int2 = (1 << 6)
+    QMI8658_Int2 = (0 << 7)
 };
 
 enum QMI8658_InterruptState
 {
-    QMI8658State_high = (1 << 7), /*!< Interrupt high. */
-    QMI8658State_low = (0 << 7)   /*!< Interrupt low. */
+    QMI8658State_high = (1 << 6), /*!< Interrupt high. */
+    QMI8658State_low = (0 << 6)   /*!< Interrupt low. */
 };
 
 enum QMI8658_WakeOnMotionThreshold
@@ -484,7 +534,11 @@ extern void QMI8658_read_ae(float quat[4], float velocity[3]);
 extern unsigned char QMI8658_readStatus0(void);
 extern unsigned char QMI8658_readStatus1(void);
 extern float QMI8658_readTemp(void);
-extern void QMI8658_enableWakeOnMotion(void);
+extern unsigned char QMI8658_doCtrl9Command(enum QMI8658_Ctrl9Command cmd);
+extern unsigned char QMI8658_config_fifo(unsigned char watermark, enum QMI8658_FifoSize size, enum QMI8658_FifoMode mode);
+extern int QMI8658_read_fifo(struct QMI8658Sample *samples, int max_samples, unsigned char *fifo_status);
+extern void QMI8658_reset_fifo(void);
+extern void QMI8658_enableWakeOnMotion(enum QMI8658_WakeOnMotionThreshold threshold, enum QMI8658_Interrupt interrupt);
 extern void QMI8658_disableWakeOnMotion(void);
 
 #endif
@@ -29,6 +29,13 @@ static unsigned short ae_q_lsb_div = (1 << 14);
 static unsigned short ae_v_lsb_div = (1 << 10);
 static unsigned int imu_timestamp = 0;
 static struct QMI8658Config QMI8658_config;
+static unsigned int fifo_timestamp = 0; // Sample counter of the next sample in the FIFO
+static unsigned char fifo_ctrl = 0;
+
+// One FIFO sample with accelerometer and gyroscope enabled: Ax..Az, Gx..Gz
+#define QMI8658_FIFO_SAMPLE_BYTES 12
+// Stay below the 128 byte buffer of the Wire library
+#define QMI8658_FIFO_READ_CHUNK (10 * QMI8658_FIFO_SAMPLE_BYTES)
 static unsigned char QMI8658_slave_addr = QMI8658_SLAVE_ADDR_L;
 
 unsigned char QMI8658_write_reg(unsigned char reg, unsigned char value)
@@ -460,39 +467,192 @@ void QMI8658_read_ae(float quat[4], float velocity[3])
 	velocity[2] = (float)(raw_v_xyz[2] * 1.0f) / ae_v_lsb_div;
 }
 
-void QMI8658_enableWakeOnMotion(void)
+/*!
+ * \brief Run a CTRL9 command: write it, wait for CmdDone, then acknowledge it.
+ * \returns 1 when the IMU completed the command, 0 on timeout.
+ */
+unsigned char QMI8658_doCtrl9Command(enum QMI8658_Ctrl9Command cmd)
+{
+	unsigned char status = 0;
+	int retry = 0;
+
+	QMI8658_write_reg(QMI8658Register_Ctrl9, (unsigned char)cmd);
+	QMI8658_read_reg(QMI8658Register_StatusInt, &status, 1);
+	while (!(status & QMI8658_STATUSINT_CMD_DONE) && retry++ < 10)
+	{
+		delay(1);
+		QMI8658_read_reg(QMI8658Register_StatusInt, &status, 1);
+	}
+	if (!(status & QMI8658_STATUSINT_CMD_DONE))
+	{
+		return 0;
+	}
+
+	// Acknowledge, the IMU clears CmdDone in response
+	QMI8658_write_reg(QMI8658Register_Ctrl9, QMI8658_Ctrl9_Cmd_NOP);
+	retry = 0;
+	do
+	{
+		QMI8658_read_reg(QMI8658Register_StatusInt, &status, 1);
+	} while ((status & QMI8658_STATUSINT_CMD_DONE) && retry++ < 10);
+
+	return 1;
+}
+
+static unsigned int QMI8658_read_timestamp(void)
+{
+	unsigned char buf[3];
+
+	QMI8658_read_reg(QMI8658Register_Timestamp_L, buf, 3);
+	return (unsigned int)(((unsigned int)buf[2] << 16) | ((unsigned int)buf[1] << 8) | buf[0]);
+}
+
+// Extend the 24-bit sample counter of the IMU with the upper bits of the last known timestamp
+static unsigned int QMI8658_extend_timestamp(unsigned int timestamp24, unsigned int last)
+{
+	unsigned int extended = (last & 0xFF000000) | timestamp24;
+	if (extended + 0x800000 < last)
+	{
+		extended += 0x1000000;
+	}
+	return extended;
+}
+
+/*!
+ * \brief Collect accelerometer and gyroscope samples in the FIFO.
+ * \param watermark FIFO_WTM flag level, in samples.
+ * \returns 1 when the FIFO was reset successfully.
+ * \remark Only the accelerometer + gyroscope layout (12 bytes per sample) is supported.
+ */
+unsigned char QMI8658_config_fifo(unsigned char watermark, enum QMI8658_FifoSize size, enum QMI8658_FifoMode mode)
+{
+	fifo_ctrl = (unsigned char)size | (unsigned char)mode;
+	QMI8658_write_reg(QMI8658Register_FifoWtmTh, watermark);
+	QMI8658_write_reg(QMI8658Register_FifoCtrl, fifo_ctrl);
+
+	unsigned char ok = QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_Rst_Fifo);
+	fifo_timestamp = QMI8658_extend_timestamp(QMI8658_read_timestamp(), fifo_timestamp) + 1;
+	return ok;
+}
+
+/*!
+ * \brief Drop the samples in the FIFO.
+ */
+void QMI8658_reset_fifo(void)
+{
+	QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_Rst_Fifo);
+	fifo_timestamp = QMI8658_extend_timestamp(QMI8658_read_timestamp(), fifo_timestamp) + 1;
+}
+
+/*!
+ * \brief Read the samples pending in the FIFO, oldest first.
+ * \param samples Output, acceleration in mg and angular rate in dps.
+ * \param max_samples Size of \a samples, anything beyond it stays in the FIFO.
+ * \param fifo_status Optional output, FIFO status before the read (QMI8658_FIFO_STATUS_*).
+ * \returns Number of samples read, -1 if the IMU didn't grant the FIFO read.
+ */
+int QMI8658_read_fifo(struct QMI8658Sample *samples, int max_samples, unsigned char *fifo_status)
 {
-	unsigned char womCmd[3];
-	enum QMI8658_Interrupt interrupt = QMI8658_Int1;
+	unsigned char status[2] = {0, 0};
+	unsigned char buf[QMI8658_FIFO_READ_CHUNK];
+	int count;
+	int i;
+
+	if (!QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_Req_Fifo))
+	{
+		return -1;
+	}
+
+	// Sample count in 2-byte words
+	QMI8658_read_reg(QMI8658Register_FifoSmplCnt, status, 2);
+	count = (((status[1] & QMI8658_FIFO_STATUS_CNT_MSB) << 8) | status[0]) * 2 / QMI8658_FIFO_SAMPLE_BYTES;
+	if (count > max_samples)
+	{
+		count = max_samples;
+	}
+	if (fifo_status)
+	{
+		*fifo_status = status[1];
+	}
+
+	// Samples were dropped, restart the counter from the newest sample
+	if (status[1] & QMI8658_FIFO_STATUS_OVERFLOW)
+	{
+		unsigned int newest = QMI8658_extend_timestamp(QMI8658_read_timestamp(), fifo_timestamp);
+		unsigned int pending = ((((status[1] & QMI8658_FIFO_STATUS_CNT_MSB) << 8) | status[0]) * 2) / QMI8658_FIFO_SAMPLE_BYTES;
+		fifo_timestamp = newest + 1 - pending;
+	}
+
+	for (i = 0; i < count;)
+	{
+		int chunk = count - i;
+		if (chunk > QMI8658_FIFO_READ_CHUNK / QMI8658_FIFO_SAMPLE_BYTES)
+		{
+			chunk = QMI8658_FIFO_READ_CHUNK / QMI8658_FIFO_SAMPLE_BYTES;
+		}
+		QMI8658_read_reg(QMI8658Register_FifoData, buf, chunk * QMI8658_FIFO_SAMPLE_BYTES);
+
+		for (int j = 0; j < chunk; j++, i++)
+		{
+			const unsigned char *p = &buf[j * QMI8658_FIFO_SAMPLE_BYTES];
+			struct QMI8658Sample *s = &samples[i];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				short raw_acc = (short)((unsigned short)(p[2 * axis + 1] << 8) | p[2 * axis]);
+				short raw_gyro = (short)((unsigned short)(p[2 * axis + 7] << 8) | p[2 * axis + 6]);
+				s->acc_raw[axis] = raw_acc;
+				s->gyro_raw[axis] = raw_gyro;
+				s->acc[axis] = (float)(raw_acc * 1000.0f) / acc_lsb_div;
+				s->gyro[axis] = (float)(raw_gyro * 1.0f) / gyro_lsb_div;
+			}
+			s->timestamp = fifo_timestamp++;
+		}
+	}
+
+	// Leave FIFO read mode
+	QMI8658_write_reg(QMI8658Register_FifoCtrl, fifo_ctrl & ~QMI8658_FIFO_CTRL_RD_MODE);
+	return count;
+}
+
+/*!
+ * \brief Put the IMU in low power wake on motion mode: only the accelerometer runs
+ * (21Hz) and the interrupt line toggles whenever an axis changes by more than the threshold.
+ * \remark The line starts low. QMI8658_readStatus1() clears the event flag.
+ */
+void QMI8658_enableWakeOnMotion(enum QMI8658_WakeOnMotionThreshold threshold, enum QMI8658_Interrupt interrupt)
+{
+	unsigned char ctrl1 = 0;
 	enum QMI8658_InterruptState initialState = QMI8658State_low;
-	enum QMI8658_WakeOnMotionThreshold threshold = QMI8658WomThreshold_low;
 	unsigned char blankingTime = 0x00;
 	const unsigned char blankingTimeMask = 0x3F;
 
 	QMI8658_enableSensors(QMI8658_CTRL7_DISABLE_ALL);
 	QMI8658_config_acc(QMI8658AccRange_2g, QMI8658AccOdr_LowPower_21Hz, QMI8658Lpf_Disable, QMI8658St_Disable);
 
-	womCmd[0] = QMI8658Register_Cal1_L; // WoM Threshold: absolute value in mg (with 1mg/LSB resolution)
-	womCmd[1] = threshold;
-	womCmd[2] = (unsigned char)interrupt | (unsigned char)initialState | (blankingTime & blankingTimeMask);
-	QMI8658_write_reg(QMI8658Register_Cal1_L, womCmd[1]);
-	QMI8658_write_reg(QMI8658Register_Cal1_H, womCmd[2]);
+	QMI8658_write_reg(QMI8658Register_Cal1_L, threshold); // WoM Threshold: absolute value in mg (with 1mg/LSB resolution)
+	QMI8658_write_reg(QMI8658Register_Cal1_H, (unsigned char)interrupt | (unsigned char)initialState | (blankingTime & blankingTimeMask));
+	QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_WoM_Setting);
+
+	QMI8658_read_reg(QMI8658Register_Ctrl1, &ctrl1, 1);
+	ctrl1 |= (interrupt == QMI8658_Int1) ? QMI8658_CTRL1_INT1_ENABLE : QMI8658_CTRL1_INT2_ENABLE;
+	QMI8658_write_reg(QMI8658Register_Ctrl1, ctrl1);
 
-	// QMI8658_doCtrl9Command(Ctrl9_ConfigureWakeOnMotion);
 	QMI8658_enableSensors(QMI8658_CTRL7_ACC_ENABLE);
-	// while(1)
-	//{
-	//	QMI8658_read_reg(QMI8658Register_Status1,&womCmd[0],1);
-	//	if(womCmd[0]&0x01)
-	//		break;
-	// }
 }
 
 void QMI8658_disableWakeOnMotion(void)
 {
+	unsigned char ctrl1 = 0;
+
 	QMI8658_enableSensors(QMI8658_CTRL7_DISABLE_ALL);
+	// A zero threshold turns wake on motion off
 	QMI8658_write_reg(QMI8658Register_Cal1_L, 0);
-	// QMI8658_doCtrl9Command(Ctrl9_ConfigureWakeOnMotion);
+	QMI8658_write_reg(QMI8658Register_Cal1_H, 0);
+	QMI8658_doCtrl9Command(QMI8658_Ctrl9_Cmd_WoM_Setting);
+
+	QMI8658_read_reg(QMI8658Register_Ctrl1, &ctrl1, 1);
+	ctrl1 &= ~(QMI8658_CTRL1_INT1_ENABLE | QMI8658_CTRL1_INT2_ENABLE);
+	QMI8658_write_reg(QMI8658Register_Ctrl1, ctrl1);
 }
 
 void QMI8658_enableSensors(unsigned char enableFlags)
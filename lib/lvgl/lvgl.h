@@ -36,6 +36,7 @@ extern "C" {
 #include "src/core/lv_group.h"
 #include "src/core/lv_indev.h"
 #include "src/core/lv_refr.h"
+#include "src/core/lv_refr_prof.h"
 #include "src/core/lv_disp.h"
 #include "src/core/lv_theme.h"
 
@@ -43,6 +44,8 @@ extern "C" {
 #include "src/font/lv_font_loader.h"
 #include "src/font/lv_font_fmt_txt.h"
 
+#include "src/draw/sw/lv_draw_sw.h"
+
 #include "src/widgets/lv_arc.h"
 #include "src/widgets/lv_btn.h"
 #include "src/widgets/lv_img.h"
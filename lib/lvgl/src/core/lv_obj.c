@@ -196,6 +196,16 @@ void lv_init(void)
 
 void lv_deinit(void)
 {
+    /*The built-in fonts would keep pointing to the glyph id lookup tables*/
+    lv_font_fmt_txt_cache_clear();
+    /*The layer contexts and the renderers' own pools would be kept in the freed heap*/
+    _lv_draw_layer_ctx_pool_clear();
+    lv_disp_t * disp = lv_disp_get_next(NULL);
+    while(disp) {
+        lv_disp_drv_t * drv = disp->driver;
+        if(drv->draw_ctx && drv->draw_ctx_deinit) drv->draw_ctx_deinit(drv, drv->draw_ctx);
+        disp = lv_disp_get_next(disp);
+    }
     _lv_gc_clear_roots();
 
     lv_disp_set_default(NULL);
@@ -468,6 +478,11 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
         lv_mem_free(obj->spec_attr);
         obj->spec_attr = NULL;
     }
+
+#if LV_OBJ_STYLE_CACHE
+    lv_mem_free(obj->style_cache);
+    obj->style_cache = NULL;
+#endif
 }
 
 static void lv_obj_draw(lv_event_t * e)
@@ -875,6 +890,10 @@ static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
     /*If there is no difference in styles there is nothing else to do*/
     if(cmp_res == _LV_STYLE_STATE_CMP_SAME) return;
 
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;    /*The children might inherit from the new state*/
+#endif
+
     _lv_obj_style_transition_dsc_t * ts = lv_mem_buf_get(sizeof(_lv_obj_style_transition_dsc_t) * STYLE_TRANSITION_MAX);
     lv_memset_00(ts, sizeof(_lv_obj_style_transition_dsc_t) * STYLE_TRANSITION_MAX);
     uint32_t tsi = 0;
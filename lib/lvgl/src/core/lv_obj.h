@@ -176,6 +176,9 @@ typedef struct _lv_obj_t {
     struct _lv_obj_t * parent;
     _lv_obj_spec_attr_t * spec_attr;
     _lv_obj_style_t * styles;
+#if LV_OBJ_STYLE_CACHE
+    struct _lv_obj_style_cache_t * style_cache;   /**< The most read style properties, resolved. Allocated on the first read*/
+#endif
 #if LV_USE_USER_DATA
     void * user_data;
 #endif
@@ -45,8 +45,32 @@ void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
-    lv_obj_set_x(obj, x);
-    lv_obj_set_y(obj, y);
+    lv_res_t res_x;
+    lv_style_value_t v_x;
+    lv_res_t res_y;
+    lv_style_value_t v_y;
+
+    res_x = lv_obj_get_local_style_prop(obj, LV_STYLE_X, &v_x, 0);
+    res_y = lv_obj_get_local_style_prop(obj, LV_STYLE_Y, &v_y, 0);
+
+    bool x_changed = (res_x == LV_RES_OK && v_x.num != x) || res_x == LV_RES_INV;
+    bool y_changed = (res_y == LV_RES_OK && v_y.num != y) || res_y == LV_RES_INV;
+
+    if(x_changed && y_changed) {
+        /*Set both and refresh once, so the object is invalidated and laid out once for the move*/
+        bool refr = lv_obj_is_style_refresh_enabled();
+        lv_obj_enable_style_refresh(false);
+        lv_obj_set_style_x(obj, x, 0);
+        lv_obj_set_style_y(obj, y, 0);
+        lv_obj_enable_style_refresh(refr);
+        lv_obj_refresh_style(obj, 0, LV_STYLE_X);
+    }
+    else if(x_changed) {
+        lv_obj_set_style_x(obj, x, 0);
+    }
+    else if(y_changed) {
+        lv_obj_set_style_y(obj, y, 0);
+    }
 }
 
 void lv_obj_set_x(lv_obj_t * obj, lv_coord_t x)
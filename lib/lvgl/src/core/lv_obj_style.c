@@ -15,6 +15,10 @@
  *********************/
 #define MY_CLASS &lv_obj_class
 
+#if LV_OBJ_STYLE_CACHE
+#define STYLE_CACHE_PROP_CNT    25
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +39,21 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_OBJ_STYLE_CACHE
+/*The cached properties of a part in a state, resolved in the `gen` generation of the styles*/
+typedef struct {
+    uint32_t gen;
+    uint32_t valid;         /*Bit `i`: `values[i]` is resolved*/
+    lv_part_t part;
+    lv_state_t state;
+    lv_style_value_t values[STYLE_CACHE_PROP_CNT];
+} style_cache_slot_t;
+
+struct _lv_obj_style_cache_t {
+    style_cache_slot_t slots[2];    /*The main part and the last other part read*/
+};
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -44,7 +63,11 @@ typedef enum {
  **********************/
 static lv_style_t * get_local_style(lv_obj_t * obj, lv_style_selector_t selector);
 static _lv_obj_style_t * get_trans_style(lv_obj_t * obj, uint32_t part);
+static lv_style_value_t get_prop_resolved(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop);
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+#if LV_OBJ_STYLE_CACHE
+static style_cache_slot_t * get_style_cache_slot(lv_obj_t * obj, lv_part_t part);
+#endif
 static void report_style_change_core(void * style, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
 static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, trans_t * tr_limit);
@@ -60,6 +83,37 @@ static void fade_in_anim_ready(lv_anim_t * a);
  **********************/
 static bool style_refr = true;
 
+#if LV_OBJ_STYLE_CACHE
+/*1 + index in the cache slots of the cached properties, 0: not cached. The most read ones while drawing*/
+static const uint8_t style_cache_ids[_LV_STYLE_NUM_BUILT_IN_PROPS] = {
+    [LV_STYLE_RADIUS] = 1,
+    [LV_STYLE_PAD_TOP] = 2,
+    [LV_STYLE_PAD_BOTTOM] = 3,
+    [LV_STYLE_PAD_LEFT] = 4,
+    [LV_STYLE_PAD_RIGHT] = 5,
+    [LV_STYLE_BASE_DIR] = 6,
+    [LV_STYLE_CLIP_CORNER] = 7,
+    [LV_STYLE_BG_COLOR] = 8,
+    [LV_STYLE_BG_OPA] = 9,
+    [LV_STYLE_BG_IMG_SRC] = 10,
+    [LV_STYLE_BORDER_WIDTH] = 11,
+    [LV_STYLE_BORDER_POST] = 12,
+    [LV_STYLE_OUTLINE_WIDTH] = 13,
+    [LV_STYLE_SHADOW_WIDTH] = 14,
+    [LV_STYLE_TEXT_COLOR] = 15,
+    [LV_STYLE_TEXT_OPA] = 16,
+    [LV_STYLE_TEXT_FONT] = 17,
+    [LV_STYLE_TEXT_LETTER_SPACE] = 18,
+    [LV_STYLE_TEXT_LINE_SPACE] = 19,
+    [LV_STYLE_OPA] = 20,
+    [LV_STYLE_COLOR_FILTER_DSC] = 21,
+    [LV_STYLE_TRANSFORM_WIDTH] = 22,
+    [LV_STYLE_TRANSFORM_HEIGHT] = 23,
+    [LV_STYLE_TRANSFORM_ZOOM] = 24,
+    [LV_STYLE_TRANSFORM_ANGLE] = STYLE_CACHE_PROP_CNT,
+};
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -168,6 +222,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;    /*Even if not refreshed now, e.g. the styles of the object were changed*/
+#endif
+
     if(!style_refr) return;
 
     lv_obj_invalidate(obj);
@@ -220,51 +278,29 @@ void lv_obj_enable_style_refresh(bool en)
     style_refr = en;
 }
 
-lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
+bool lv_obj_is_style_refresh_enabled(void)
 {
-    lv_style_value_t value_act;
-    bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
-    lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
-    while(obj) {
-        found = get_prop_core(obj, part, prop, &value_act);
-        if(found == LV_STYLE_RES_FOUND) break;
-        if(!inheritable) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(found != LV_STYLE_RES_INHERIT && part != LV_PART_MAIN) {
-            part = LV_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        obj = lv_obj_get_parent(obj);
-    }
-
-    if(found != LV_STYLE_RES_FOUND) {
-        if(part == LV_PART_MAIN && (prop == LV_STYLE_WIDTH || prop == LV_STYLE_HEIGHT)) {
-            const lv_obj_class_t * cls = obj->class_p;
-            while(cls) {
-                if(prop == LV_STYLE_WIDTH) {
-                    if(cls->width_def != 0) break;
-                }
-                else {
-                    if(cls->height_def != 0) break;
-                }
-                cls = cls->base_class;
-            }
+    return style_refr;
+}
 
-            if(cls) {
-                value_act.num = prop == LV_STYLE_WIDTH ? cls->width_def : cls->height_def;
-            }
-            else {
-                value_act.num = 0;
+lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
+{
+#if LV_OBJ_STYLE_CACHE
+    /*While `skip_trans` is set the values are not the real ones, don't cache them*/
+    uint32_t cache_id = prop < _LV_STYLE_NUM_BUILT_IN_PROPS ? style_cache_ids[prop] : 0;
+    if(cache_id && obj && !obj->skip_trans) {
+        style_cache_slot_t * slot = get_style_cache_slot((lv_obj_t *)obj, part);
+        if(slot) {
+            uint32_t bit = (uint32_t)1 << (cache_id - 1);
+            if((slot->valid & bit) == 0) {
+                slot->values[cache_id - 1] = get_prop_resolved(obj, part, prop);
+                slot->valid |= bit;
             }
-        }
-        else {
-            value_act = lv_style_prop_get_default(prop);
+            return slot->values[cache_id - 1];
         }
     }
-    return value_act;
+#endif
+    return get_prop_resolved(obj, part, prop);
 }
 
 void lv_obj_set_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop, lv_style_value_t value,
@@ -568,6 +604,80 @@ static _lv_obj_style_t * get_trans_style(lv_obj_t * obj,  lv_style_selector_t se
     return &obj->styles[0];
 }
 
+/**
+ * Get the value of a property the long way: search the styles of the object, the main part and the parents
+ * (if inheritable), and fall back to the default value.
+ */
+static lv_style_value_t get_prop_resolved(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
+{
+    lv_style_value_t value_act;
+    bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
+    lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
+    while(obj) {
+        found = get_prop_core(obj, part, prop, &value_act);
+        if(found == LV_STYLE_RES_FOUND) break;
+        if(!inheritable) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(found != LV_STYLE_RES_INHERIT && part != LV_PART_MAIN) {
+            part = LV_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        obj = lv_obj_get_parent(obj);
+    }
+
+    if(found != LV_STYLE_RES_FOUND) {
+        if(part == LV_PART_MAIN && (prop == LV_STYLE_WIDTH || prop == LV_STYLE_HEIGHT)) {
+            const lv_obj_class_t * cls = obj->class_p;
+            while(cls) {
+                if(prop == LV_STYLE_WIDTH) {
+                    if(cls->width_def != 0) break;
+                }
+                else {
+                    if(cls->height_def != 0) break;
+                }
+                cls = cls->base_class;
+            }
+
+            if(cls) {
+                value_act.num = prop == LV_STYLE_WIDTH ? cls->width_def : cls->height_def;
+            }
+            else {
+                value_act.num = 0;
+            }
+        }
+        else {
+            value_act = lv_style_prop_get_default(prop);
+        }
+    }
+    return value_act;
+}
+
+#if LV_OBJ_STYLE_CACHE
+/**
+ * Get the cache slot of a part of an object, emptied if the styles changed since it was filled.
+ * @return the slot or NULL if the cache couldn't be allocated
+ */
+static style_cache_slot_t * get_style_cache_slot(lv_obj_t * obj, lv_part_t part)
+{
+    if(obj->style_cache == NULL) {
+        obj->style_cache = lv_mem_alloc(sizeof(struct _lv_obj_style_cache_t));
+        if(obj->style_cache == NULL) return NULL;
+        lv_memset_00(obj->style_cache, sizeof(struct _lv_obj_style_cache_t));
+    }
+
+    style_cache_slot_t * slot = &obj->style_cache->slots[part == LV_PART_MAIN ? 0 : 1];
+    if(slot->gen != _lv_style_gen || slot->part != part || slot->state != obj->state) {
+        slot->gen = _lv_style_gen;
+        slot->part = part;
+        slot->state = obj->state;
+        slot->valid = 0;
+    }
+    return slot;
+}
+#endif
 
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v)
 {
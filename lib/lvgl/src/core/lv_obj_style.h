@@ -118,6 +118,12 @@ void lv_obj_refresh_style(struct _lv_obj_t * obj, lv_part_t part, lv_style_prop_
  */
 void lv_obj_enable_style_refresh(bool en);
 
+/**
+ * Tell whether automatic style refreshing is enabled
+ * @return          true: enabled; false: disabled with `lv_obj_enable_style_refresh(false)`
+ */
+bool lv_obj_is_style_refresh_enabled(void);
+
 /**
  * Get the value of a style property. The current state of the object will be considered.
  * Inherited properties will be inherited.
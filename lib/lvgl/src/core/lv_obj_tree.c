@@ -171,6 +171,9 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
     parent->spec_attr->children[lv_obj_get_child_cnt(parent) - 1] = obj;
 
     obj->parent = parent;
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;    /*Inherits from the new parent*/
+#endif
 
     /*Notify the original parent because one of its children is lost*/
     lv_obj_readjust_scroll(old_parent, LV_ANIM_OFF);
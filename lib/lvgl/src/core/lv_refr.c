@@ -8,6 +8,7 @@
  *********************/
 #include <stddef.h>
 #include "lv_refr.h"
+#include "lv_refr_prof.h"
 #include "lv_disp.h"
 #include "../hal/lv_hal_tick.h"
 #include "../hal/lv_hal_disp.h"
@@ -52,6 +53,8 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static void lv_refr_join_area(void);
+static uint32_t get_area_parts(const lv_disp_drv_t * drv, const lv_area_t * area);
+static uint32_t get_area_cost(const lv_disp_drv_t * drv, const lv_area_t * area);
 static void refr_invalid_areas(void);
 static void refr_area(const lv_area_t * area_p);
 static void refr_area_part(lv_draw_ctx_t * draw_ctx);
@@ -239,6 +242,9 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
         return;
     }
 
+    /*Drop the parts which can't be seen on non-rectangular displays*/
+    if(!lv_disp_drv_clip_to_row_spans(disp->driver, &com_area)) return;
+
     if(disp->driver->rounder_cb) disp->driver->rounder_cb(disp->driver, &com_area);
 
     /*Save only if this area is not in one of the saved areas*/
@@ -304,6 +310,10 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         disp_refr = lv_disp_get_default();
     }
 
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_begin();
+#endif
+
     /*Refresh the screen's layout if required*/
     lv_obj_update_layout(disp_refr->act_scr);
     if(disp_refr->prev_scr) lv_obj_update_layout(disp_refr->prev_scr);
@@ -315,11 +325,16 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     if(disp_refr->act_scr == NULL) {
         disp_refr->inv_p = 0;
         LV_LOG_WARN("there is no active screen");
+#if LV_USE_REFR_PROFILER
+        _lv_refr_prof_frame_end(false);
+#endif
         REFR_TRACE("finished");
         return;
     }
 
+    LV_REFR_PROF_BEGIN(LV_REFR_PROF_JOIN);
     lv_refr_join_area();
+    LV_REFR_PROF_END(LV_REFR_PROF_JOIN);
 
     refr_invalid_areas();
 
@@ -346,6 +361,10 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
     _lv_draw_mask_cleanup();
 #endif
 
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_end(px_num != 0);
+#endif
+
 #if LV_USE_PERF_MONITOR && LV_USE_LABEL
     lv_obj_t * perf_label = perf_monitor.perf_label;
     if(perf_label == NULL) {
@@ -459,42 +478,104 @@ uint32_t lv_refr_get_fps_avg(void)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Join the invalidated areas where refreshing their bounding box costs less than refreshing them one by one.
+ * The areas are sorted by their top edge and swept from the top, so an area is compared only with the ones
+ * above it that are still close enough to be joined with it.
  */
 static void lv_refr_join_area(void)
 {
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
+    const lv_disp_drv_t * drv = disp_refr->driver;
+    lv_area_t * areas = disp_refr->inv_areas;
+    uint8_t * joined = disp_refr->inv_area_joined;
+    uint32_t cnt = disp_refr->inv_p;
+    if(cnt < 2) return;
+
+    /*Sort by `y1`, there are at most `LV_INV_BUF_SIZE` areas*/
+    uint32_t i;
+    for(i = 1; i < cnt; i++) {
+        lv_area_t tmp = areas[i];
+        uint32_t j = i;
+        while(j > 0 && areas[j - 1].y1 > tmp.y1) {
+            areas[j] = areas[j - 1];
+            j--;
+        }
+        areas[j] = tmp;
+    }
 
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
+    /*The areas a later one can still be joined to*/
+    uint8_t active[LV_INV_BUF_SIZE];
+    uint32_t active_cnt = 0;
+    for(i = 0; i < cnt; i++) {
+        /*Drop the areas so far above that only the rows in between would cost more than they could save.
+         *The next areas start even lower.*/
+        uint32_t a = 0;
+        while(a < active_cnt) {
+            const lv_area_t * above = &areas[active[a]];
+            int32_t gap = areas[i].y1 - above->y2 - 1;
+            if(gap > 0 && (uint32_t)gap * lv_area_get_width(above) * drv->px_cost >=
+               drv->area_cost * get_area_parts(drv, above)) {
+                active[a] = active[--active_cnt];
             }
+            else a++;
+        }
 
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
-
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
-
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+        /*Join into the active area that saves the most, then the result with the others as long as it saves*/
+        uint32_t cur = i;
+        bool cur_active = false;
+        while(1) {
+            uint32_t cur_cost = get_area_cost(drv, &areas[cur]);
+            uint32_t best_a = active_cnt;
+            uint32_t best_saving = 0;
+            lv_area_t best_area;
+            for(a = 0; a < active_cnt; a++) {
+                if(active[a] == cur) continue;
+                lv_area_t joined_area;
+                _lv_area_join(&joined_area, &areas[active[a]], &areas[cur]);
+                uint32_t sep_cost = get_area_cost(drv, &areas[active[a]]) + cur_cost;
+                uint32_t joined_cost = get_area_cost(drv, &joined_area);
+                if(joined_cost < sep_cost && sep_cost - joined_cost > best_saving) {
+                    best_saving = sep_cost - joined_cost;
+                    best_a = a;
+                    best_area = joined_area;
+                }
             }
+            if(best_a == active_cnt) break;
+
+            /*Keep the upper one, it's already at its place in the refresh order*/
+            uint32_t into = active[best_a];
+            areas[into] = best_area;
+            joined[cur] = 1;
+            if(cur_active) {
+                for(a = 0; active[a] != cur; a++);
+                active[a] = active[--active_cnt];
+            }
+            cur = into;
+            cur_active = true;
         }
+        if(!cur_active) active[active_cnt++] = cur;
     }
 }
 
+/**
+ * Number of parts an area is refreshed and flushed in
+ */
+static uint32_t get_area_parts(const lv_disp_drv_t * drv, const lv_area_t * area)
+{
+    if(drv->full_refresh || drv->direct_mode) return 1;
+
+    uint32_t max_row = drv->draw_buf->size / lv_area_get_width(area);
+    if(max_row == 0) return 1;
+    return (lv_area_get_height(area) + max_row - 1) / max_row;
+}
+
+/**
+ * Cost of refreshing an area by the cost model of the display driver
+ */
+static uint32_t get_area_cost(const lv_disp_drv_t * drv, const lv_area_t * area)
+{
+    return drv->area_cost * get_area_parts(drv, area) + drv->px_cost * lv_area_get_size(area);
+}
+
 /**
  * Refresh the joined areas
  */
@@ -528,8 +609,11 @@ static void refr_invalid_areas(void)
         if(disp_refr->inv_area_joined[i] == 0) {
 
             if(i == last_i) disp_refr->driver->draw_buf->last_area = 1;
+            LV_REFR_PROF_COUNT(LV_REFR_PROF_CNT_AREA);
             disp_refr->driver->draw_buf->last_part = 0;
+            LV_REFR_PROF_BEGIN(LV_REFR_PROF_DRAW);
             refr_area(&disp_refr->inv_areas[i]);
+            LV_REFR_PROF_END(LV_REFR_PROF_DRAW);
 
             px_num += lv_area_get_size(&disp_refr->inv_areas[i]);
         }
@@ -622,9 +706,11 @@ static void refr_area_part(lv_draw_ctx_t * draw_ctx)
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
     if((draw_buf->buf1 && !draw_buf->buf2) ||
        (draw_buf->buf1 && draw_buf->buf2 && full_sized)) {
+        LV_REFR_PROF_BEGIN(LV_REFR_PROF_FLUSH_WAIT);
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        LV_REFR_PROF_END(LV_REFR_PROF_FLUSH_WAIT);
 
         /*If the screen is transparent initialize it when the flushing is ready*/
 #if LV_COLOR_SCREEN_TRANSP
@@ -907,9 +993,11 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
 
         if(layer_type == LV_LAYER_TYPE_SIMPLE) flags |= LV_DRAW_LAYER_FLAG_CAN_SUBDIVIDE;
 
+        LV_REFR_PROF_BEGIN(LV_REFR_PROF_LAYER);
         lv_draw_layer_ctx_t * layer_ctx = lv_draw_layer_create(draw_ctx, &layer_area_full, flags);
         if(layer_ctx == NULL) {
             LV_LOG_WARN("Couldn't create a new layer context");
+            LV_REFR_PROF_END(LV_REFR_PROF_LAYER);
             return;
         }
         lv_point_t pivot = {
@@ -946,7 +1034,9 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
                 layer_alpha_test(obj, draw_ctx, layer_ctx, flags);
             }
 
+            LV_REFR_PROF_BEGIN(LV_REFR_PROF_DRAW);
             lv_obj_redraw(draw_ctx, obj);
+            LV_REFR_PROF_END(LV_REFR_PROF_DRAW);
 
             draw_dsc.pivot.x = obj->coords.x1 + pivot.x - draw_ctx->buf_area->x1;
             draw_dsc.pivot.y = obj->coords.y1 + pivot.y - draw_ctx->buf_area->y1;
@@ -961,6 +1051,7 @@ void refr_obj(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
         }
 
         lv_draw_layer_destroy(draw_ctx, layer_ctx);
+        LV_REFR_PROF_END(LV_REFR_PROF_LAYER);
     }
 }
 
@@ -1169,9 +1260,11 @@ static void draw_buf_rotate(lv_area_t * area, lv_color_t * color_p)
             /*Flush the completed area to the display*/
             call_flush_cb(drv, area, rot_buf == NULL ? color_p : rot_buf);
             /*FIXME: Rotation forces legacy behavior where rendering and flushing are done serially*/
+            LV_REFR_PROF_BEGIN(LV_REFR_PROF_FLUSH_WAIT);
             while(draw_buf->flushing) {
                 if(drv->wait_cb) drv->wait_cb(drv);
             }
+            LV_REFR_PROF_END(LV_REFR_PROF_FLUSH_WAIT);
             color_p += area_w * height;
             row += height;
         }
@@ -1195,9 +1288,11 @@ static void draw_buf_flush(lv_disp_t * disp)
      * and driver is ready to receive the new buffer */
     bool full_sized = draw_buf->size == (uint32_t)disp_refr->driver->hor_res * disp_refr->driver->ver_res;
     if(draw_buf->buf1 && draw_buf->buf2 && !full_sized) {
+        LV_REFR_PROF_BEGIN(LV_REFR_PROF_FLUSH_WAIT);
         while(draw_buf->flushing) {
             if(disp_refr->driver->wait_cb) disp_refr->driver->wait_cb(disp_refr->driver);
         }
+        LV_REFR_PROF_END(LV_REFR_PROF_FLUSH_WAIT);
     }
 
     draw_buf->flushing = 1;
@@ -1238,7 +1333,9 @@ static void call_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_
         .y2 = area->y2 + drv->offset_y
     };
 
+    LV_REFR_PROF_BEGIN(LV_REFR_PROF_FLUSH);
     drv->flush_cb(drv, &offset_area, color_p);
+    LV_REFR_PROF_END(LV_REFR_PROF_FLUSH);
 }
 
 #if LV_USE_PERF_MONITOR
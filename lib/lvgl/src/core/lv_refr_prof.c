@@ -0,0 +1,249 @@
+/**
+ * @file lv_refr_prof.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_refr_prof.h"
+#if LV_USE_REFR_PROFILER
+
+#include "../hal/lv_hal_tick.h"
+#include "../misc/lv_log.h"
+#include "../misc/lv_mem.h"
+#include "../misc/lv_printf.h"
+#include LV_REFR_PROFILER_INCLUDE
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LINE_MAX_LEN    160
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static inline uint32_t time_us(void);
+static void charge_top(uint32_t now);
+static void add_sample(lv_refr_prof_stat_t * stat, uint32_t us);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_refr_prof_stat_t stats[_LV_REFR_PROF_PHASE_NUM];
+static const char * const phase_names[_LV_REFR_PROF_PHASE_NUM] = {
+    "join", "draw", "layer", "flush_wait", "flush", "transfer", "other", "frame"
+};
+static lv_refr_prof_count_stat_t count_stats[_LV_REFR_PROF_CNT_NUM];
+static const char * const counter_names[_LV_REFR_PROF_CNT_NUM] = {
+    "area", "layer_alloc"
+};
+
+/*The frame being measured*/
+static bool in_frame;
+static uint32_t frame_start;
+static uint32_t last_time;
+static uint32_t frame_us[LV_REFR_PROF_FRAME];
+static uint32_t entered;        /*Bit `n`: phase `n` ran in this frame*/
+static lv_refr_prof_phase_t stack[LV_REFR_PROF_STACK_DEPTH];
+static uint8_t depth;
+static uint8_t overflow;        /*Phases begun beyond the stack, charged to the top of the stack*/
+static uint32_t frame_counts[_LV_REFR_PROF_CNT_NUM];
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_refr_prof_frame_begin(void)
+{
+    lv_memset_00(frame_us, sizeof(frame_us));
+    lv_memset_00(frame_counts, sizeof(frame_counts));
+    stack[0] = LV_REFR_PROF_OTHER;
+    depth = 1;
+    overflow = 0;
+    entered = 1 << LV_REFR_PROF_OTHER;
+    frame_start = time_us();
+    last_time = frame_start;
+    in_frame = true;
+}
+
+void _lv_refr_prof_frame_end(bool refreshed)
+{
+    if(!in_frame) return;
+
+    uint32_t now = time_us();
+    charge_top(now);
+    in_frame = false;
+
+    if(!refreshed) return;
+
+    lv_refr_prof_phase_t i;
+    for(i = 0; i < LV_REFR_PROF_FRAME; i++) {
+        if(entered & (1 << i)) add_sample(&stats[i], frame_us[i]);
+    }
+    add_sample(&stats[LV_REFR_PROF_FRAME], now - frame_start);
+
+    lv_refr_prof_counter_t c;
+    for(c = 0; c < _LV_REFR_PROF_CNT_NUM; c++) {
+        lv_refr_prof_count_stat_t * s = &count_stats[c];
+        s->frames++;
+        s->sum += frame_counts[c];
+        if(frame_counts[c] > s->max) s->max = frame_counts[c];
+    }
+}
+
+void lv_refr_prof_begin(lv_refr_prof_phase_t phase)
+{
+    if(!in_frame || phase >= LV_REFR_PROF_FRAME) return;
+
+    if(depth >= LV_REFR_PROF_STACK_DEPTH) {
+        overflow++;
+        return;
+    }
+
+    charge_top(time_us());
+    stack[depth] = phase;
+    depth++;
+    entered |= 1 << phase;
+}
+
+void lv_refr_prof_end(lv_refr_prof_phase_t phase)
+{
+    if(!in_frame) return;
+
+    if(overflow) {
+        overflow--;
+        return;
+    }
+
+    /*Never pop the frame itself*/
+    if(depth <= 1) return;
+
+    if(stack[depth - 1] != phase) {
+        LV_LOG_WARN("ending %s but %s is running", lv_refr_prof_get_phase_name(phase),
+                    lv_refr_prof_get_phase_name(stack[depth - 1]));
+    }
+
+    charge_top(time_us());
+    depth--;
+}
+
+void lv_refr_prof_count(lv_refr_prof_counter_t counter)
+{
+    if(!in_frame || counter >= _LV_REFR_PROF_CNT_NUM) return;
+    frame_counts[counter]++;
+}
+
+const lv_refr_prof_stat_t * lv_refr_prof_get_stat(lv_refr_prof_phase_t phase)
+{
+    if(phase >= _LV_REFR_PROF_PHASE_NUM) return NULL;
+    return &stats[phase];
+}
+
+const char * lv_refr_prof_get_phase_name(lv_refr_prof_phase_t phase)
+{
+    if(phase >= _LV_REFR_PROF_PHASE_NUM) return "?";
+    return phase_names[phase];
+}
+
+const lv_refr_prof_count_stat_t * lv_refr_prof_get_count_stat(lv_refr_prof_counter_t counter)
+{
+    if(counter >= _LV_REFR_PROF_CNT_NUM) return NULL;
+    return &count_stats[counter];
+}
+
+const char * lv_refr_prof_get_counter_name(lv_refr_prof_counter_t counter)
+{
+    if(counter >= _LV_REFR_PROF_CNT_NUM) return "?";
+    return counter_names[counter];
+}
+
+void lv_refr_prof_reset(void)
+{
+    lv_memset_00(stats, sizeof(stats));
+    lv_memset_00(count_stats, sizeof(count_stats));
+}
+
+void lv_refr_prof_dump(lv_refr_prof_print_cb_t print_cb)
+{
+    if(print_cb == NULL) return;
+
+    char line[LINE_MAX_LEN];
+    uint32_t len;
+    uint32_t b;
+
+    len = lv_snprintf(line, sizeof(line), "phase,frames,mean_us,max_us");
+    for(b = 0; b < LV_REFR_PROF_BUCKET_CNT - 1 && len < sizeof(line); b++) {
+        len += lv_snprintf(line + len, sizeof(line) - len, ",<%"LV_PRIu32, (uint32_t)1 << (LV_REFR_PROF_BUCKET_MIN_SHIFT + b));
+    }
+    if(len < sizeof(line)) {
+        lv_snprintf(line + len, sizeof(line) - len, ",>=%"LV_PRIu32,
+                    (uint32_t)1 << (LV_REFR_PROF_BUCKET_MIN_SHIFT + LV_REFR_PROF_BUCKET_CNT - 2));
+    }
+    print_cb(line);
+
+    lv_refr_prof_phase_t i;
+    for(i = 0; i < _LV_REFR_PROF_PHASE_NUM; i++) {
+        const lv_refr_prof_stat_t * s = &stats[i];
+        uint32_t mean = s->cnt ? (uint32_t)(s->sum_us / s->cnt) : 0;
+        len = lv_snprintf(line, sizeof(line), "%s,%"LV_PRIu32",%"LV_PRIu32",%"LV_PRIu32, phase_names[i], s->cnt, mean,
+                          s->max_us);
+        for(b = 0; b < LV_REFR_PROF_BUCKET_CNT && len < sizeof(line); b++) {
+            len += lv_snprintf(line + len, sizeof(line) - len, ",%"LV_PRIu32, s->hist[b]);
+        }
+        print_cb(line);
+    }
+
+    print_cb("counter,frames,total,max_per_frame");
+    lv_refr_prof_counter_t c;
+    for(c = 0; c < _LV_REFR_PROF_CNT_NUM; c++) {
+        const lv_refr_prof_count_stat_t * s = &count_stats[c];
+        lv_snprintf(line, sizeof(line), "%s,%"LV_PRIu32",%"LV_PRIu32",%"LV_PRIu32, counter_names[c], s->frames,
+                    (uint32_t)s->sum, s->max);
+        print_cb(line);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline uint32_t time_us(void)
+{
+    return (uint32_t)(LV_REFR_PROFILER_TIME_EXPR);
+}
+
+/**
+ * Charge the time since the last event to the phase on the top of the stack
+ */
+static void charge_top(uint32_t now)
+{
+    frame_us[stack[depth - 1]] += now - last_time;
+    last_time = now;
+}
+
+static void add_sample(lv_refr_prof_stat_t * stat, uint32_t us)
+{
+    /*Bucket of the highest set bit above the first bucket's limit*/
+    uint32_t b = 0;
+    uint32_t v = us >> LV_REFR_PROF_BUCKET_MIN_SHIFT;
+    while(v && b < LV_REFR_PROF_BUCKET_CNT - 1) {
+        v >>= 1;
+        b++;
+    }
+
+    stat->hist[b]++;
+    stat->cnt++;
+    stat->sum_us += us;
+    if(us > stat->max_us) stat->max_us = us;
+}
+
+#endif /*LV_USE_REFR_PROFILER*/
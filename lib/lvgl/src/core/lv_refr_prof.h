@@ -0,0 +1,177 @@
+/**
+ * @file lv_refr_prof.h
+ * Frame profiler: splits the time of every refreshed frame into phases
+ * and collects them into fixed-bucket histograms.
+ */
+
+#ifndef LV_REFR_PROF_H
+#define LV_REFR_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#if LV_USE_REFR_PROFILER
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*Bucket `i` counts the frames with less than `2^(LV_REFR_PROF_BUCKET_MIN_SHIFT + i)` us in a phase,
+ *the last bucket everything above*/
+#define LV_REFR_PROF_BUCKET_CNT         12
+#define LV_REFR_PROF_BUCKET_MIN_SHIFT   6
+
+/*Deepest nesting of phases tracked (layers in layers add two levels each)*/
+#define LV_REFR_PROF_STACK_DEPTH        16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Phases of a frame. The times are exclusive: while a nested phase runs
+ * (e.g. the flush inside the drawing of an area) its parent is not charged,
+ * so the phases of a frame add up to the frame time.
+ */
+enum {
+    LV_REFR_PROF_JOIN,          /**< Joining the invalidated areas*/
+    LV_REFR_PROF_DRAW,          /**< Drawing the objects into the draw buffer*/
+    LV_REFR_PROF_LAYER,         /**< Creating, blending (transforming) and freeing layers*/
+    LV_REFR_PROF_FLUSH_WAIT,    /**< Waiting for the previous flush to release the buffer*/
+    LV_REFR_PROF_FLUSH,         /**< The flush callback, without the transfer*/
+    LV_REFR_PROF_TRANSFER,      /**< Sending the pixels to the display, marked by the flush callback*/
+    LV_REFR_PROF_OTHER,         /**< Everything else in the refresh timer: layout, clean up*/
+    LV_REFR_PROF_FRAME,         /**< The whole frame (statistics only, can't be begun)*/
+    _LV_REFR_PROF_PHASE_NUM
+};
+typedef uint8_t lv_refr_prof_phase_t;
+
+/**
+ * Events counted per frame
+ */
+enum {
+    LV_REFR_PROF_CNT_AREA,          /**< Areas refreshed, after joining the invalidated ones*/
+    LV_REFR_PROF_CNT_LAYER_ALLOC,   /**< Memory allocated for a layer: its context or buffer*/
+    _LV_REFR_PROF_CNT_NUM
+};
+typedef uint8_t lv_refr_prof_counter_t;
+
+typedef struct {
+    uint32_t hist[LV_REFR_PROF_BUCKET_CNT];
+    uint32_t cnt;       /**< Frames in which the phase ran*/
+    uint32_t max_us;
+    uint64_t sum_us;
+} lv_refr_prof_stat_t;
+
+typedef struct {
+    uint32_t frames;        /**< Refreshed frames*/
+    uint32_t max;           /**< Most events in a frame*/
+    uint64_t sum;
+} lv_refr_prof_count_stat_t;
+
+typedef void (*lv_refr_prof_print_cb_t)(const char * line);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start a new frame. Called by the refresh timer.
+ */
+void _lv_refr_prof_frame_begin(void);
+
+/**
+ * Close the frame started with `_lv_refr_prof_frame_begin()`
+ * @param refreshed true: add the frame to the histograms; false: nothing was drawn, drop it
+ */
+void _lv_refr_prof_frame_end(bool refreshed);
+
+/**
+ * Enter a phase of the current frame. Ignored outside of a frame.
+ * The display driver can mark its own phases too, e.g. `LV_REFR_PROF_TRANSFER` in `flush_cb`.
+ * @param phase the phase to enter
+ */
+void lv_refr_prof_begin(lv_refr_prof_phase_t phase);
+
+/**
+ * Leave the phase entered last
+ * @param phase the phase to leave, for consistency checks
+ */
+void lv_refr_prof_end(lv_refr_prof_phase_t phase);
+
+/**
+ * Count an event in the current frame. Ignored outside of a frame.
+ * @param counter the event
+ */
+void lv_refr_prof_count(lv_refr_prof_counter_t counter);
+
+/**
+ * Get the statistics of a phase
+ * @param phase a phase or `LV_REFR_PROF_FRAME`
+ * @return pointer to the statistics
+ */
+const lv_refr_prof_stat_t * lv_refr_prof_get_stat(lv_refr_prof_phase_t phase);
+
+/**
+ * Get the name of a phase as used by `lv_refr_prof_dump()`
+ * @param phase a phase or `LV_REFR_PROF_FRAME`
+ * @return the name, e.g. "draw"
+ */
+const char * lv_refr_prof_get_phase_name(lv_refr_prof_phase_t phase);
+
+/**
+ * Get the statistics of a counter
+ * @param counter a counter
+ * @return pointer to the statistics
+ */
+const lv_refr_prof_count_stat_t * lv_refr_prof_get_count_stat(lv_refr_prof_counter_t counter);
+
+/**
+ * Get the name of a counter as used by `lv_refr_prof_dump()`
+ * @param counter a counter
+ * @return the name, e.g. "layer_alloc"
+ */
+const char * lv_refr_prof_get_counter_name(lv_refr_prof_counter_t counter);
+
+/**
+ * Clear the statistics of all phases and counters
+ */
+void lv_refr_prof_reset(void);
+
+/**
+ * Print the statistics as CSV: a header line and one line per phase with
+ * the frame count, mean and max time in us and the histogram buckets,
+ * then a header line and one line per counter with the frame count, the total and the most in a frame.
+ * @param print_cb called with every line, without line ending
+ */
+void lv_refr_prof_dump(lv_refr_prof_print_cb_t print_cb);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#define LV_REFR_PROF_BEGIN(phase) lv_refr_prof_begin(phase)
+#define LV_REFR_PROF_END(phase) lv_refr_prof_end(phase)
+#define LV_REFR_PROF_COUNT(counter) lv_refr_prof_count(counter)
+
+#else
+
+#define LV_REFR_PROF_BEGIN(phase)
+#define LV_REFR_PROF_END(phase)
+#define LV_REFR_PROF_COUNT(counter)
+
+#endif /*LV_USE_REFR_PROFILER*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_REFR_PROF_H*/
@@ -9,6 +9,7 @@
 #include "lv_draw.h"
 #include "lv_draw_arc.h"
 #include "../core/lv_refr.h"
+#include "../core/lv_refr_prof.h"
 
 /*********************
  *      DEFINES
@@ -21,10 +22,17 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_draw_layer_ctx_t * layer_ctx_get(size_t size);
+static void layer_ctx_put(lv_draw_layer_ctx_t * layer_ctx, size_t size);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_LAYER_POOL_SIZE
+    /*Contexts kept for the next layers, as many as the layer buffers*/
+    static lv_draw_layer_ctx_t * ctx_pool[LV_LAYER_POOL_BUF_CNT];
+    static size_t ctx_pool_size[LV_LAYER_POOL_BUF_CNT];
+#endif
 
 /**********************
  *      MACROS
@@ -39,7 +47,7 @@ lv_draw_layer_ctx_t * lv_draw_layer_create(lv_draw_ctx_t * draw_ctx, const lv_ar
 {
     if(draw_ctx->layer_init == NULL) return NULL;
 
-    lv_draw_layer_ctx_t * layer_ctx = lv_mem_alloc(draw_ctx->layer_instance_size);
+    lv_draw_layer_ctx_t * layer_ctx = layer_ctx_get(draw_ctx->layer_instance_size);
     LV_ASSERT_MALLOC(layer_ctx);
     if(layer_ctx == NULL) {
         LV_LOG_WARN("Couldn't allocate a new layer context");
@@ -57,7 +65,7 @@ lv_draw_layer_ctx_t * lv_draw_layer_create(lv_draw_ctx_t * draw_ctx, const lv_ar
 
     lv_draw_layer_ctx_t * init_layer_ctx =  draw_ctx->layer_init(draw_ctx, layer_ctx, flags);
     if(NULL == init_layer_ctx) {
-        lv_mem_free(layer_ctx);
+        layer_ctx_put(layer_ctx, draw_ctx->layer_instance_size);
     }
     return init_layer_ctx;
 }
@@ -85,9 +93,54 @@ void lv_draw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer
     disp_refr->driver->screen_transp = layer_ctx->original.screen_transp;
 
     if(draw_ctx->layer_destroy) draw_ctx->layer_destroy(draw_ctx, layer_ctx);
-    lv_mem_free(layer_ctx);
+    layer_ctx_put(layer_ctx, draw_ctx->layer_instance_size);
+}
+
+void _lv_draw_layer_ctx_pool_clear(void)
+{
+#if LV_LAYER_POOL_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        lv_mem_free(ctx_pool[i]);
+        ctx_pool[i] = NULL;
+        ctx_pool_size[i] = 0;
+    }
+#endif
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+static lv_draw_layer_ctx_t * layer_ctx_get(size_t size)
+{
+#if LV_LAYER_POOL_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        if(ctx_pool[i] && ctx_pool_size[i] == size) {
+            lv_draw_layer_ctx_t * layer_ctx = ctx_pool[i];
+            ctx_pool[i] = NULL;
+            return layer_ctx;
+        }
+    }
+#endif
+    LV_REFR_PROF_COUNT(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    return lv_mem_alloc(size);
+}
+
+static void layer_ctx_put(lv_draw_layer_ctx_t * layer_ctx, size_t size)
+{
+#if LV_LAYER_POOL_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        if(ctx_pool[i] == NULL) {
+            ctx_pool[i] = layer_ctx;
+            ctx_pool_size[i] = size;
+            return;
+        }
+    }
+#else
+    LV_UNUSED(size);
+#endif
+    lv_mem_free(layer_ctx);
+}
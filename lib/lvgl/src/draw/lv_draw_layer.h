@@ -72,6 +72,11 @@ void lv_draw_layer_blend(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_layer
  */
 void lv_draw_layer_destroy(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_layer_ctx_t * layer_ctx);
 
+/**
+ * Free the layer contexts kept for the next layers. Called by `lv_deinit()`.
+ */
+void _lv_draw_layer_ctx_pool_clear(void);
+
 /**********************
  *      MACROS
  **********************/
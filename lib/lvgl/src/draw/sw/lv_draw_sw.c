@@ -28,6 +28,7 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
+static uint32_t ctx_cnt;
 
 /**********************
  *      MACROS
@@ -40,6 +41,7 @@
 void lv_draw_sw_init_ctx(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
 {
     LV_UNUSED(drv);
+    ctx_cnt++;
 
     lv_draw_sw_ctx_t * draw_sw_ctx = (lv_draw_sw_ctx_t *) draw_ctx;
     lv_memset_00(draw_sw_ctx, sizeof(lv_draw_sw_ctx_t));
@@ -70,6 +72,9 @@ void lv_draw_sw_deinit_ctx(lv_disp_drv_t * drv, lv_draw_ctx_t * draw_ctx)
 
     lv_draw_sw_ctx_t * draw_sw_ctx = (lv_draw_sw_ctx_t *) draw_ctx;
     lv_memset_00(draw_sw_ctx, sizeof(lv_draw_sw_ctx_t));
+
+    /*Keep the layer buffers until the last context is gone, canvases and snapshots make short-lived ones*/
+    if(ctx_cnt > 0 && --ctx_cnt == 0) lv_draw_sw_layer_pool_clear();
 }
 
 void lv_draw_sw_wait_for_finish(lv_draw_ctx_t * draw_ctx)
@@ -43,6 +43,18 @@ typedef struct {
     uint32_t has_alpha : 1;
 } lv_draw_sw_layer_ctx_t;
 
+/**
+ * Usage of the layer buffer pool, see `LV_LAYER_POOL_SIZE`
+ */
+typedef struct {
+    uint32_t size;          /**< Bytes the kept buffers take*/
+    uint32_t max_size;      /**< Most bytes they took at once, never above `LV_LAYER_POOL_SIZE`*/
+    uint32_t buf_cnt;       /**< Buffers kept*/
+    uint32_t reuse_cnt;     /**< Layers that got a kept buffer without allocating*/
+    uint32_t alloc_cnt;     /**< Buffers allocated: kept ones grown and ones of their own*/
+    uint32_t unpooled_cnt;  /**< Buffers of their own, the budget or the buffer count was exceeded*/
+} lv_draw_sw_layer_pool_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -89,6 +101,18 @@ void lv_draw_sw_layer_blend(struct _lv_draw_ctx_t * draw_ctx, struct _lv_draw_la
 
 void lv_draw_sw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * layer_ctx);
 
+/**
+ * Give information about the layer buffer pool
+ * @param mon_p pointer to a lv_draw_sw_layer_pool_monitor_t variable
+ */
+void lv_draw_sw_layer_pool_monitor(lv_draw_sw_layer_pool_monitor_t * mon_p);
+
+/**
+ * Free the kept layer buffers that are not in use, e.g. to give the memory to something else
+ * for a while. Called when the last software draw context is deinitialized.
+ */
+void lv_draw_sw_layer_pool_clear(void);
+
 /***********************
  * GLOBAL VARIABLES
  ***********************/
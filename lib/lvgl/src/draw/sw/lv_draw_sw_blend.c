@@ -23,6 +23,8 @@
  *  STATIC PROTOTYPES
  **********************/
 
+static inline bool row_spans_cover(const lv_disp_row_span_t * spans, const lv_area_t * area);
+
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide);
 
@@ -98,7 +100,38 @@ void lv_draw_sw_blend(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * d
 
     if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
 
-    ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    const lv_disp_row_span_t * spans = disp->driver->row_spans;
+
+    /*Row spans are in screen coordinates so apply them only when drawing directly to the display buffer*/
+    if(spans == NULL || draw_ctx->buf != disp->driver->draw_buf->buf_act ||
+       row_spans_cover(spans, &blend_area)) {
+        ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
+        return;
+    }
+
+    /*Blend band by band, restricting the clip area to the visible part of the rows.
+     *The blend implementations offset the source and the mask from the original areas, so only the clip area changes.*/
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    lv_area_t band;
+    band.y1 = blend_area.y1;
+    while(band.y1 <= blend_area.y2) {
+        band.x1 = LV_MAX(spans[band.y1].x1, blend_area.x1);
+        band.x2 = LV_MIN(spans[band.y1].x2, blend_area.x2);
+        band.y2 = band.y1;
+        while(band.y2 < blend_area.y2 &&
+              LV_MAX(spans[band.y2 + 1].x1, blend_area.x1) == band.x1 &&
+              LV_MIN(spans[band.y2 + 1].x2, blend_area.x2) == band.x2) {
+            band.y2++;
+        }
+
+        if(band.x1 <= band.x2) {
+            draw_ctx->clip_area = &band;
+            ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
+        }
+        band.y1 = band.y2 + 1;
+    }
+    draw_ctx->clip_area = clip_area_ori;
 }
 
 LV_ATTRIBUTE_FAST_MEM void lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx, const lv_draw_sw_blend_dsc_t * dsc)
@@ -204,6 +237,16 @@ LV_ATTRIBUTE_FAST_MEM void lv_draw_sw_blend_basic(lv_draw_ctx_t * draw_ctx, cons
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Tell whether an area is fully visible. The visible region is expected to be convex (e.g. a disc)
+ * so it's enough to check the first and last rows.
+ */
+static inline bool row_spans_cover(const lv_disp_row_span_t * spans, const lv_area_t * area)
+{
+    return spans[area->y1].x1 <= area->x1 && spans[area->y1].x2 >= area->x2 &&
+           spans[area->y2].x1 <= area->x1 && spans[area->y2].x2 >= area->x2;
+}
+
 static void fill_set_px(lv_color_t * dest_buf, const lv_area_t * blend_area, lv_coord_t dest_stride,
                         lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stide)
 {
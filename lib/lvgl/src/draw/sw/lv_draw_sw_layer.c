@@ -10,22 +10,40 @@
 #include "../../hal/lv_hal_disp.h"
 #include "../../misc/lv_area.h"
 #include "../../core/lv_refr.h"
+#include "../../core/lv_refr_prof.h"
 
 /*********************
  *      DEFINES
  *********************/
 
+/*A kept buffer grows with some headroom so a layer that changes its size a little every frame (e.g. rotating)
+ *doesn't grow it every time*/
+#define POOL_GROW_ALIGN     256
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_LAYER_POOL_SIZE
+typedef struct {
+    void * buf;
+    uint32_t size;
+    bool used;
+} pool_buf_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void * layer_buf_get(uint32_t size);
+static void layer_buf_put(void * buf);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_LAYER_POOL_SIZE
+    static pool_buf_t pool[LV_LAYER_POOL_BUF_CNT];
+#endif
+static lv_draw_sw_layer_pool_monitor_t pool_mon;
 
 /**********************
  *  GLOBAL VARIABLES
@@ -54,12 +72,12 @@ struct _lv_draw_layer_ctx_t * lv_draw_sw_layer_create(struct _lv_draw_ctx_t * dr
         layer_sw_ctx->buf_size_bytes = LV_LAYER_SIMPLE_BUF_SIZE;
         uint32_t full_size = lv_area_get_size(&layer_sw_ctx->base_draw.area_full) * px_size;
         if(layer_sw_ctx->buf_size_bytes > full_size) layer_sw_ctx->buf_size_bytes = full_size;
-        layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+        layer_sw_ctx->base_draw.buf = layer_buf_get(layer_sw_ctx->buf_size_bytes);
         if(layer_sw_ctx->base_draw.buf == NULL) {
             LV_LOG_WARN("Cannot allocate %"LV_PRIu32" bytes for layer buffer. Allocating %"LV_PRIu32" bytes instead. (Reduced performance)",
                         (uint32_t)layer_sw_ctx->buf_size_bytes, (uint32_t)LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE * px_size);
             layer_sw_ctx->buf_size_bytes = LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE;
-            layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+            layer_sw_ctx->base_draw.buf = layer_buf_get(layer_sw_ctx->buf_size_bytes);
             if(layer_sw_ctx->base_draw.buf == NULL) {
                 return NULL;
             }
@@ -73,7 +91,7 @@ struct _lv_draw_layer_ctx_t * lv_draw_sw_layer_create(struct _lv_draw_ctx_t * dr
     else {
         layer_sw_ctx->base_draw.area_act = layer_sw_ctx->base_draw.area_full;
         layer_sw_ctx->buf_size_bytes = lv_area_get_size(&layer_sw_ctx->base_draw.area_full) * px_size;
-        layer_sw_ctx->base_draw.buf = lv_mem_alloc(layer_sw_ctx->buf_size_bytes);
+        layer_sw_ctx->base_draw.buf = layer_buf_get(layer_sw_ctx->buf_size_bytes);
         lv_memset_00(layer_sw_ctx->base_draw.buf, layer_sw_ctx->buf_size_bytes);
         layer_sw_ctx->has_alpha = flags & LV_DRAW_LAYER_FLAG_HAS_ALPHA ? 1 : 0;
         if(layer_sw_ctx->base_draw.buf == NULL) {
@@ -141,10 +159,117 @@ void lv_draw_sw_layer_destroy(lv_draw_ctx_t * draw_ctx, lv_draw_layer_ctx_t * la
 {
     LV_UNUSED(draw_ctx);
 
-    lv_mem_free(layer_ctx->buf);
+    layer_buf_put(layer_ctx->buf);
+}
+
+void lv_draw_sw_layer_pool_monitor(lv_draw_sw_layer_pool_monitor_t * mon_p)
+{
+    *mon_p = pool_mon;
 }
 
+void lv_draw_sw_layer_pool_clear(void)
+{
+#if LV_LAYER_POOL_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        if(pool[i].buf == NULL || pool[i].used) continue;
+        lv_mem_free(pool[i].buf);
+        pool_mon.size -= pool[i].size;
+        pool_mon.buf_cnt--;
+        pool[i].buf = NULL;
+        pool[i].size = 0;
+    }
+#endif
+}
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Get a layer buffer: the smallest free one of the pool that's large enough, else the largest free one
+ * grown to `size` (the other free ones are dropped if the budget needs it), else a buffer of its own
+ * @param size the size in bytes
+ * @return the buffer or NULL if there's no memory
+ */
+static void * layer_buf_get(uint32_t size)
+{
+#if LV_LAYER_POOL_SIZE
+    int32_t fit = -1;
+    int32_t grow = -1;
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        if(pool[i].used) continue;
+        if(pool[i].buf && pool[i].size >= size) {
+            if(fit < 0 || pool[i].size < pool[fit].size) fit = i;
+        }
+        else if(grow < 0 || pool[i].size > pool[grow].size) {
+            grow = i;
+        }
+    }
+
+    if(fit >= 0) {
+        pool[fit].used = true;
+        pool_mon.reuse_cnt++;
+        return pool[fit].buf;
+    }
+
+    if(grow >= 0 && size <= LV_LAYER_POOL_SIZE) {
+        if(pool[grow].buf) {
+            lv_mem_free(pool[grow].buf);
+            pool_mon.size -= pool[grow].size;
+            pool_mon.buf_cnt--;
+            pool[grow].buf = NULL;
+            pool[grow].size = 0;
+        }
+        for(i = 0; i < LV_LAYER_POOL_BUF_CNT && pool_mon.size + size > LV_LAYER_POOL_SIZE; i++) {
+            if(pool[i].used || pool[i].buf == NULL) continue;
+            lv_mem_free(pool[i].buf);
+            pool_mon.size -= pool[i].size;
+            pool_mon.buf_cnt--;
+            pool[i].buf = NULL;
+            pool[i].size = 0;
+        }
+    }
+
+    /*Only the buffers in use are left if it still doesn't fit*/
+    if(grow >= 0 && pool_mon.size + size <= LV_LAYER_POOL_SIZE) {
+        uint32_t new_size = LV_MIN((size + size / 8 + POOL_GROW_ALIGN - 1) & ~(POOL_GROW_ALIGN - 1),
+                                   LV_LAYER_POOL_SIZE - pool_mon.size);
+        LV_REFR_PROF_COUNT(LV_REFR_PROF_CNT_LAYER_ALLOC);
+        pool_mon.alloc_cnt++;
+        pool[grow].buf = lv_mem_alloc_fast(new_size);
+        if(pool[grow].buf == NULL) return NULL;
+
+        pool[grow].size = new_size;
+        pool[grow].used = true;
+        pool_mon.buf_cnt++;
+        pool_mon.size += new_size;
+        pool_mon.max_size = LV_MAX(pool_mon.max_size, pool_mon.size);
+        return pool[grow].buf;
+    }
+#endif
+
+    LV_REFR_PROF_COUNT(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    pool_mon.alloc_cnt++;
+    pool_mon.unpooled_cnt++;
+    return lv_mem_alloc_fast(size);
+}
+
+/**
+ * Give back a buffer of `layer_buf_get()`
+ * @param buf the buffer
+ */
+static void layer_buf_put(void * buf)
+{
+#if LV_LAYER_POOL_SIZE
+    uint32_t i;
+    for(i = 0; i < LV_LAYER_POOL_BUF_CNT; i++) {
+        if(pool[i].buf == buf && pool[i].used) {
+            pool[i].used = false;
+            return;
+        }
+    }
+#endif
+    lv_mem_free(buf);
+}
@@ -244,6 +244,35 @@ LV_ATTRIBUTE_FAST_MEM static void draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     int32_t row_start = pos->y >= draw_ctx->clip_area->y1 ? 0 : draw_ctx->clip_area->y1 - pos->y;
     int32_t row_end   = pos->y + box_h <= draw_ctx->clip_area->y2 ? box_h : draw_ctx->clip_area->y2 - pos->y + 1;
 
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+
+    /*A byte per pixel which needs no change: the bitmap itself is the mask.
+     *The blending only reads it, the mask is rounded in place only without anti-aliasing.*/
+    if(bpp == 8 && opa >= LV_OPA_MAX && disp->driver->antialiasing) {
+        lv_area_t letter_area;
+        letter_area.x1 = pos->x;
+        letter_area.y1 = pos->y;
+        letter_area.x2 = pos->x + box_w - 1;
+        letter_area.y2 = pos->y + box_h - 1;
+#if LV_DRAW_COMPLEX
+        if(!lv_draw_mask_is_any(&letter_area))
+#endif
+        {
+            blend_dsc.blend_area = &letter_area;
+            blend_dsc.mask_area = &letter_area;
+            blend_dsc.mask_buf = (lv_opa_t *)map_p;
+            blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+            lv_draw_sw_blend(draw_ctx, &blend_dsc);
+            return;
+        }
+    }
+
     /*Move on the map too*/
     uint32_t bit_ofs = (row_start * width_bit) + (col_start * bpp);
     map_p += bit_ofs >> 3;
@@ -252,13 +281,7 @@ LV_ATTRIBUTE_FAST_MEM static void draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     uint32_t col_bit;
     col_bit = bit_ofs & 0x7; /*"& 0x7" equals to "% 8" just faster*/
 
-    lv_draw_sw_blend_dsc_t blend_dsc;
-    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
-    blend_dsc.color = dsc->color;
-    blend_dsc.opa = dsc->opa;
-    blend_dsc.blend_mode = dsc->blend_mode;
-
-    lv_coord_t hor_res = lv_disp_get_hor_res(_lv_refr_get_disp_refreshing());
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
     uint32_t mask_buf_size = box_w * box_h > hor_res ? hor_res : box_w * box_h;
     lv_opa_t * mask_buf = lv_mem_buf_get(mask_buf_size);
     blend_dsc.mask_buf = mask_buf;
@@ -286,30 +309,44 @@ LV_ATTRIBUTE_FAST_MEM static void draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
 #if LV_DRAW_COMPLEX
         int32_t mask_p_start = mask_p;
 #endif
-        bitmask = bitmask_init >> col_bit;
-        for(col = col_start; col < col_end; col++) {
-            /*Load the pixel's opacity into the mask*/
-            letter_px = (*map_p & bitmask) >> (col_bit_max - col_bit);
-            if(letter_px) {
-                mask_buf[mask_p] = bpp_opa_table_p[letter_px];
+        if(bpp == 8) {
+            /*A byte per pixel (e.g. from the glyph cache): copy the line or map it at once*/
+            int32_t col_cnt = col_end - col_start;
+            if(opa >= LV_OPA_MAX) {
+                for(col = 0; col < col_cnt; col++) mask_buf[mask_p + col] = map_p[col];
             }
             else {
-                mask_buf[mask_p] = 0;
+                for(col = 0; col < col_cnt; col++) mask_buf[mask_p + col] = bpp_opa_table_p[map_p[col]];
             }
+            map_p += col_cnt;
+            mask_p += col_cnt;
+        }
+        else {
+            bitmask = bitmask_init >> col_bit;
+            for(col = col_start; col < col_end; col++) {
+                /*Load the pixel's opacity into the mask*/
+                letter_px = (*map_p & bitmask) >> (col_bit_max - col_bit);
+                if(letter_px) {
+                    mask_buf[mask_p] = bpp_opa_table_p[letter_px];
+                }
+                else {
+                    mask_buf[mask_p] = 0;
+                }
 
-            /*Go to the next column*/
-            if(col_bit < col_bit_max) {
-                col_bit += bpp;
-                bitmask = bitmask >> bpp;
-            }
-            else {
-                col_bit = 0;
-                bitmask = bitmask_init;
-                map_p++;
-            }
+                /*Go to the next column*/
+                if(col_bit < col_bit_max) {
+                    col_bit += bpp;
+                    bitmask = bitmask >> bpp;
+                }
+                else {
+                    col_bit = 0;
+                    bitmask = bitmask_init;
+                    map_p++;
+                }
 
-            /*Next mask byte*/
-            mask_p++;
+                /*Next mask byte*/
+                mask_p++;
+            }
         }
 
 #if LV_DRAW_COMPLEX
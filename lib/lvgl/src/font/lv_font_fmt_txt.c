@@ -14,10 +14,20 @@
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
 #include "../misc/lv_mem.h"
+#include "../misc/lv_lru.h"
+#include "../misc/lv_math.h"
 
 /*********************
  *      DEFINES
  *********************/
+/*Expected size of a cached A8 glyph, sizes the hash table of the cache*/
+#define GLYPH_CACHE_AVG_SIZE    64
+
+/*Letters above Latin-1 put in the hash of a lookup table at most. Fonts with more of them search the cmaps*/
+#define GLYPH_LUT_HASH_MAX      256
+
+/*Glyph id in a lookup table telling the letter has to be searched in the cmaps*/
+#define GLYPH_LUT_SEARCH        0xFFFF
 
 /**********************
  *      TYPEDEFS
@@ -28,14 +38,55 @@ typedef enum {
     RLE_STATE_COUNTER,
 } rle_state_t;
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+typedef struct {
+    const lv_font_t * font;
+    uint32_t gid;
+} glyph_cache_key_t;
+#endif
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+/*Glyph ids of a font: Latin-1 is indexed directly, the rest is in an open addressing hash*/
+typedef struct _lv_font_fmt_txt_lut_t {
+    struct _lv_font_fmt_txt_lut_t * next;       /*Every table is in one list to free them together*/
+    lv_font_fmt_txt_glyph_cache_t * owner;      /*Points to this table*/
+    uint32_t * hash_letters;                    /*0: free slot*/
+    uint16_t * hash_gids;
+    uint32_t hash_mask;                         /*Number of slots - 1, 0: no hash*/
+    uint16_t latin1[256];
+} lv_font_fmt_txt_lut_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t search_glyph_id(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
+static const uint8_t * get_bitmap_native(const lv_font_t * font, uint32_t gid);
+static inline uint32_t kern_pair_left(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t i);
+static inline uint32_t kern_pair_right(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t i);
+static uint32_t kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kdsc, const uint32_t * order,
+                                      const uint32_t * group_start, uint32_t group_cnt, bool right,
+                                      uint8_t * class_mapping);
+static bool kern_groups_equal(const lv_font_fmt_txt_kern_pair_t * kdsc, const uint32_t * order,
+                              uint32_t start1, uint32_t start2, uint32_t cnt, bool right);
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    static bool is_cached_a8(const lv_font_t * font, const lv_font_fmt_txt_glyph_dsc_t * gdsc);
+    static const uint8_t * get_bitmap_a8(const lv_font_t * font, uint32_t gid);
+    static void expand_to_a8(const uint8_t * in, uint8_t * out, uint32_t px_cnt, uint8_t bpp);
+#endif
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+    static lv_font_fmt_txt_lut_t * lut_create(lv_font_fmt_txt_dsc_t * fdsc);
+    static uint32_t lut_get(const lv_font_fmt_txt_lut_t * lut, uint32_t letter);
+    static void lut_add(lv_font_fmt_txt_lut_t * lut, uint32_t letter, uint32_t gid);
+    static inline uint32_t lut_hash(uint32_t letter);
+#endif
 
 #if LV_USE_FONT_COMPRESSED
     static void decompress(const uint8_t * in, uint8_t * out, lv_coord_t w, lv_coord_t h, uint8_t bpp, bool prefilter);
@@ -58,9 +109,19 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static rle_state_t rle_state;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    static uint32_t glyph_cache_hit_cnt;
+    static uint32_t glyph_cache_miss_cnt;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    extern const uint8_t _lv_bpp1_opa_table[2];
+    extern const uint8_t _lv_bpp2_opa_table[4];
+    extern const uint8_t _lv_bpp4_opa_table[16];
+#endif
 
 /**********************
  *      MACROS
@@ -84,57 +145,13 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
     if(!gid) return NULL;
 
-    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
-
-    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
-        return &fdsc->glyph_bitmap[gdsc->bitmap_index];
-    }
-    /*Handle compressed bitmap*/
-    else {
-#if LV_USE_FONT_COMPRESSED
-        static size_t last_buf_size = 0;
-        if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
-
-        uint32_t gsize = gdsc->box_w * gdsc->box_h;
-        if(gsize == 0) return NULL;
-
-        uint32_t buf_size = gsize;
-        /*Compute memory size needed to hold decompressed glyph, rounding up*/
-        switch(fdsc->bpp) {
-            case 1:
-                buf_size = (gsize + 7) >> 3;
-                break;
-            case 2:
-                buf_size = (gsize + 3) >> 2;
-                break;
-            case 3:
-                buf_size = (gsize + 1) >> 1;
-                break;
-            case 4:
-                buf_size = (gsize + 1) >> 1;
-                break;
-        }
-
-        if(last_buf_size < buf_size) {
-            uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
-            LV_ASSERT_MALLOC(tmp);
-            if(tmp == NULL) return NULL;
-            LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
-            last_buf_size = buf_size;
-        }
-
-        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
-                   (uint8_t)fdsc->bpp, prefilter);
-        return LV_GC_ROOT(_lv_font_decompr_buf);
-#else /*!LV_USE_FONT_COMPRESSED*/
-        LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
-        return NULL;
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    if(is_cached_a8(font, &fdsc->glyph_dsc[gid])) return get_bitmap_a8(font, gid);
+#else
+    LV_UNUSED(fdsc);
 #endif
-    }
 
-    /*If not returned earlier then the letter is not found in this font*/
-    return NULL;
+    return get_bitmap_native(font, gid);
 }
 
 /**
@@ -184,6 +201,11 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     dsc_out->bpp   = (uint8_t)fdsc->bpp;
     dsc_out->is_placeholder = false;
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    /*The bitmap will come from the cache, already expanded to 1 byte per pixel*/
+    if(is_cached_a8(font, gdsc)) dsc_out->bpp = 8;
+#endif
+
     if(is_tab) dsc_out->box_w = dsc_out->box_w * 2;
 
     return true;
@@ -202,25 +224,254 @@ void _lv_font_clean_up_fmt_txt(void)
 #endif
 }
 
+/**
+ * Drop every glyph from the glyph bitmap cache and free the glyph id lookup tables.
+ * The tables are built again at the next lookup.
+ * Required when a font is freed, a new one could get the same address.
+ */
+void lv_font_fmt_txt_cache_clear(void)
+{
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    if(LV_GC_ROOT(_lv_font_glyph_cache)) lv_lru_clear(LV_GC_ROOT(_lv_font_glyph_cache));
+#endif
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+    lv_font_fmt_txt_lut_t * lut = LV_GC_ROOT(_lv_font_glyph_luts);
+    while(lut) {
+        lv_font_fmt_txt_lut_t * next = lut->next;
+        lut->owner->lut = NULL;
+        lv_mem_free(lut);
+        lut = next;
+    }
+    LV_GC_ROOT(_lv_font_glyph_luts) = NULL;
+#endif
+}
+
+/**
+ * Give information about the glyph bitmap cache.
+ * @param mon_p pointer to a `lv_font_fmt_txt_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_font_fmt_txt_cache_monitor(lv_font_fmt_txt_cache_monitor_t * mon_p)
+{
+    lv_memset_00(mon_p, sizeof(lv_font_fmt_txt_cache_monitor_t));
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    lv_lru_t * cache = LV_GC_ROOT(_lv_font_glyph_cache);
+    mon_p->total_size = LV_FONT_FMT_TXT_CACHE_SIZE;
+    if(cache) mon_p->used_size = cache->total_memory - cache->free_memory;
+    mon_p->hit_cnt = glyph_cache_hit_cnt;
+    mon_p->miss_cnt = glyph_cache_miss_cnt;
+    uint32_t lookup_cnt = glyph_cache_hit_cnt + glyph_cache_miss_cnt;
+    if(lookup_cnt) mon_p->hit_pct = (uint8_t)(((uint64_t)glyph_cache_hit_cnt * 100) / lookup_cnt);
+#endif
+}
+
+/**
+ * Convert kerning pairs to kerning classes, to look up the kerning of two glyphs without a search.
+ * Glyphs kerned the same way with every other glyph get the same class.
+ * @param kdsc the kerning pairs, ordered by the left glyph id first, then by the right one
+ * @param glyph_cnt number of glyphs in the font, the glyph ids are less than this
+ * @param max_size the largest size of the classes [bytes]: two class mappings with `glyph_cnt` bytes
+ *                 each and a byte for every pair of classes
+ * @return the kerning classes, their parts allocated with `lv_mem_alloc()`.
+ *         NULL if they would be larger than `max_size`, there are more than 255 classes or out of memory.
+ */
+lv_font_fmt_txt_kern_classes_t * lv_font_fmt_txt_kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kdsc,
+                                                                       uint32_t glyph_cnt, uint32_t max_size)
+{
+    if(kdsc->pair_cnt == 0 || kdsc->glyph_ids_size > 1) return NULL;
+    if(glyph_cnt * 2 > max_size) return NULL;
+
+    uint32_t pair_cnt = kdsc->pair_cnt;
+    uint32_t i;
+    for(i = 0; i < pair_cnt; i++) {
+        if(kern_pair_left(kdsc, i) >= glyph_cnt || kern_pair_right(kdsc, i) >= glyph_cnt) return NULL;
+    }
+
+    lv_font_fmt_txt_kern_classes_t * classes = lv_mem_alloc(sizeof(lv_font_fmt_txt_kern_classes_t));
+    uint8_t * left_class_mapping = lv_mem_alloc(glyph_cnt);
+    uint8_t * right_class_mapping = lv_mem_alloc(glyph_cnt);
+    uint32_t * order = lv_mem_alloc(pair_cnt * sizeof(uint32_t));
+    uint32_t * group_start = lv_mem_alloc((glyph_cnt + 1) * sizeof(uint32_t));
+    int8_t * class_pair_values = NULL;
+    bool ok = classes && left_class_mapping && right_class_mapping && order && group_start;
+
+    uint32_t left_class_cnt = 0;
+    uint32_t right_class_cnt = 0;
+    if(ok) {
+        lv_memset_00(left_class_mapping, glyph_cnt);
+        lv_memset_00(right_class_mapping, glyph_cnt);
+
+        /*The pairs of a left glyph follow each other, ordered by the right glyph*/
+        uint32_t group_cnt = 0;
+        for(i = 0; i < pair_cnt; i++) {
+            order[i] = i;
+            if(i == 0 || kern_pair_left(kdsc, i) != kern_pair_left(kdsc, i - 1)) group_start[group_cnt++] = i;
+        }
+        group_start[group_cnt] = pair_cnt;
+        left_class_cnt = kern_pairs_to_classes(kdsc, order, group_start, group_cnt, false, left_class_mapping);
+
+        /*Group the pairs by the right glyph too, a counting sort keeps them ordered by the left glyph*/
+        lv_memset_00(group_start, (glyph_cnt + 1) * sizeof(uint32_t));
+        for(i = 0; i < pair_cnt; i++) group_start[kern_pair_right(kdsc, i) + 1]++;
+        for(i = 0; i < glyph_cnt; i++) group_start[i + 1] += group_start[i];
+        for(i = 0; i < pair_cnt; i++) order[group_start[kern_pair_right(kdsc, i)]++] = i;
+
+        /*`group_start[g]` is the end of glyph `g`'s pairs now. Keep the non-empty groups.*/
+        group_cnt = 0;
+        uint32_t start = 0;
+        for(i = 0; i < glyph_cnt; i++) {
+            if(group_start[i] == start) continue;
+            uint32_t end = group_start[i];
+            group_start[group_cnt++] = start;
+            start = end;
+        }
+        group_start[group_cnt] = pair_cnt;
+        right_class_cnt = kern_pairs_to_classes(kdsc, order, group_start, group_cnt, true, right_class_mapping);
+
+        ok = left_class_cnt <= 255 && right_class_cnt <= 255 &&
+             glyph_cnt * 2 + left_class_cnt * right_class_cnt <= max_size;
+    }
+
+    if(ok) {
+        class_pair_values = lv_mem_alloc(left_class_cnt * right_class_cnt);
+        ok = class_pair_values != NULL;
+    }
+
+    if(ok) {
+        lv_memset_00(class_pair_values, left_class_cnt * right_class_cnt);
+        for(i = 0; i < pair_cnt; i++) {
+            uint32_t left_class = left_class_mapping[kern_pair_left(kdsc, i)];
+            uint32_t right_class = right_class_mapping[kern_pair_right(kdsc, i)];
+            class_pair_values[(left_class - 1) * right_class_cnt + (right_class - 1)] = kdsc->values[i];
+        }
+
+        classes->class_pair_values = class_pair_values;
+        classes->left_class_mapping = left_class_mapping;
+        classes->right_class_mapping = right_class_mapping;
+        classes->left_class_cnt = (uint8_t)left_class_cnt;
+        classes->right_class_cnt = (uint8_t)right_class_cnt;
+    }
+    else {
+        if(classes) lv_mem_free(classes);
+        if(left_class_mapping) lv_mem_free(left_class_mapping);
+        if(right_class_mapping) lv_mem_free(right_class_mapping);
+        classes = NULL;
+    }
+
+    if(order) lv_mem_free(order);
+    if(group_start) lv_mem_free(group_start);
+
+    return classes;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Get the bitmap of a glyph in the font's own bpp, decompressed if required.
+ * @param font pointer to font
+ * @param gid id of the glyph
+ * @return pointer to the bitmap or NULL if not found
+ */
+static const uint8_t * get_bitmap_native(const lv_font_t * font, uint32_t gid)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+
+    if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+        return &fdsc->glyph_bitmap[gdsc->bitmap_index];
+    }
+    /*Handle compressed bitmap*/
+    else {
+#if LV_USE_FONT_COMPRESSED
+        static size_t last_buf_size = 0;
+        if(LV_GC_ROOT(_lv_font_decompr_buf) == NULL) last_buf_size = 0;
+
+        uint32_t gsize = gdsc->box_w * gdsc->box_h;
+        if(gsize == 0) return NULL;
+
+        uint32_t buf_size = gsize;
+        /*Compute memory size needed to hold decompressed glyph, rounding up*/
+        switch(fdsc->bpp) {
+            case 1:
+                buf_size = (gsize + 7) >> 3;
+                break;
+            case 2:
+                buf_size = (gsize + 3) >> 2;
+                break;
+            case 3:
+                buf_size = (gsize + 1) >> 1;
+                break;
+            case 4:
+                buf_size = (gsize + 1) >> 1;
+                break;
+        }
+
+        if(last_buf_size < buf_size) {
+            uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
+            LV_ASSERT_MALLOC(tmp);
+            if(tmp == NULL) return NULL;
+            LV_GC_ROOT(_lv_font_decompr_buf) = tmp;
+            last_buf_size = buf_size;
+        }
+
+        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
+        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
+                   (uint8_t)fdsc->bpp, prefilter);
+        return LV_GC_ROOT(_lv_font_decompr_buf);
+#else /*!LV_USE_FONT_COMPRESSED*/
+        LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
+        return NULL;
+#endif
+    }
+
+    /*If not returned earlier then the letter is not found in this font*/
+    return NULL;
+}
+
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 {
     if(letter == '\0') return 0;
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->cache == NULL) return search_glyph_id(fdsc, letter);
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+    lv_font_fmt_txt_lut_t * lut = fdsc->cache->lut;
+    if(lut == NULL) lut = lut_create(fdsc);
+    if(lut) {
+        uint32_t glyph_id = lut_get(lut, letter);
+        if(glyph_id != GLYPH_LUT_SEARCH) return glyph_id;
+    }
+#endif
 
     /*Check the cache first*/
-    if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
+    if(letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
+
+    uint32_t glyph_id = search_glyph_id(fdsc, letter);
 
+    /*Update the cache*/
+    fdsc->cache->last_letter = letter;
+    fdsc->cache->last_glyph_id = glyph_id;
+    return glyph_id;
+}
+
+/**
+ * Find the glyph id of a letter in the cmaps of a font.
+ * @param fdsc descriptor of the font
+ * @param letter a UNICODE letter code
+ * @return the glyph id or 0 if the letter is not in the font
+ */
+static uint32_t search_glyph_id(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -251,22 +502,132 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             }
         }
 
-        /*Update the cache*/
-        if(fdsc->cache) {
-            fdsc->cache->last_letter = letter;
-            fdsc->cache->last_glyph_id = glyph_id;
-        }
         return glyph_id;
     }
 
-    if(fdsc->cache) {
-        fdsc->cache->last_letter = letter;
-        fdsc->cache->last_glyph_id = 0;
+    /*If not returned earlier then the letter is not found in this font*/
+    return 0;
+}
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+
+/**
+ * Build the glyph id lookup table of a font from its cmaps.
+ * The letters above Latin-1 get a hash only if there are at most `GLYPH_LUT_HASH_MAX` of them.
+ * @param fdsc descriptor of the font, `fdsc->cache` will point to the table
+ * @return the new table or NULL if out of memory
+ */
+static lv_font_fmt_txt_lut_t * lut_create(lv_font_fmt_txt_dsc_t * fdsc)
+{
+    /*Count the letters above Latin-1, overlapping cmaps are counted twice*/
+    uint32_t cnt = 0;
+    uint16_t i;
+    uint32_t j;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        if(cmap->unicode_list == NULL) {
+            uint32_t last = cmap->range_start + cmap->range_length;
+            if(last > 0x100) cnt += last - LV_MAX(cmap->range_start, 0x100);
+        }
+        else {
+            for(j = 0; j < cmap->list_length; j++) {
+                if(cmap->range_start + cmap->unicode_list[j] >= 0x100) cnt++;
+            }
+        }
+    }
+
+    /*At most half of the slots are used to keep the probe sequences short*/
+    uint32_t slot_cnt = 0;
+    if(cnt > 0 && cnt <= GLYPH_LUT_HASH_MAX) {
+        slot_cnt = 4;
+        while(slot_cnt < cnt * 2) slot_cnt <<= 1;
+    }
+
+    lv_font_fmt_txt_lut_t * lut = lv_mem_alloc(sizeof(lv_font_fmt_txt_lut_t) +
+                                               slot_cnt * (sizeof(uint32_t) + sizeof(uint16_t)));
+    if(lut == NULL) return NULL;
+
+    lut->hash_letters = (uint32_t *)(lut + 1);
+    lut->hash_gids = (uint16_t *)(lut->hash_letters + slot_cnt);
+    lut->hash_mask = slot_cnt ? slot_cnt - 1 : 0;
+    lv_memset_00(lut->hash_letters, slot_cnt * sizeof(uint32_t));
+
+    for(j = 0; j < 256; j++) {
+        uint32_t gid = search_glyph_id(fdsc, j);
+        lut->latin1[j] = gid < GLYPH_LUT_SEARCH ? gid : GLYPH_LUT_SEARCH;
+    }
+
+    if(slot_cnt) {
+        for(i = 0; i < fdsc->cmap_num; i++) {
+            const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+            uint32_t letter_cnt = cmap->unicode_list ? cmap->list_length : cmap->range_length;
+            for(j = 0; j < letter_cnt; j++) {
+                uint32_t letter = cmap->range_start + (cmap->unicode_list ? cmap->unicode_list[j] : j);
+                if(letter < 0x100) continue;
+                /*Searched again, an earlier cmap wins if they overlap*/
+                lut_add(lut, letter, search_glyph_id(fdsc, letter));
+            }
+        }
+    }
+
+    lut->owner = fdsc->cache;
+    lut->next = LV_GC_ROOT(_lv_font_glyph_luts);
+    LV_GC_ROOT(_lv_font_glyph_luts) = lut;
+    fdsc->cache->lut = lut;
+
+    return lut;
+}
+
+/**
+ * Look up the glyph id of a letter.
+ * @param lut pointer to a lookup table
+ * @param letter a UNICODE letter code
+ * @return the glyph id, 0 if the letter is not in the font,
+ *         `GLYPH_LUT_SEARCH` if the letter has to be searched in the cmaps
+ */
+static uint32_t lut_get(const lv_font_fmt_txt_lut_t * lut, uint32_t letter)
+{
+    if(letter < 0x100) return lut->latin1[letter];
+    if(lut->hash_mask == 0) return GLYPH_LUT_SEARCH;
+
+    /*Every letter of the font is in the hash, a free slot ends the search*/
+    uint32_t i = lut_hash(letter) & lut->hash_mask;
+    while(lut->hash_letters[i]) {
+        if(lut->hash_letters[i] == letter) return lut->hash_gids[i];
+        i = (i + 1) & lut->hash_mask;
     }
+
     return 0;
+}
+
+/**
+ * Add a letter above Latin-1 to the hash of a lookup table.
+ * @param lut pointer to a lookup table with a free slot
+ * @param letter a UNICODE letter code, above 0xFF
+ * @param gid the glyph id of the letter, not added if 0
+ */
+static void lut_add(lv_font_fmt_txt_lut_t * lut, uint32_t letter, uint32_t gid)
+{
+    if(gid == 0) return;
+
+    uint32_t i = lut_hash(letter) & lut->hash_mask;
+    while(lut->hash_letters[i]) {
+        if(lut->hash_letters[i] == letter) return;
+        i = (i + 1) & lut->hash_mask;
+    }
 
+    lut->hash_letters[i] = letter;
+    lut->hash_gids[i] = gid < GLYPH_LUT_SEARCH ? gid : GLYPH_LUT_SEARCH;
 }
 
+static inline uint32_t lut_hash(uint32_t letter)
+{
+    /*Fibonacci hashing, neighbouring letters get distant slots*/
+    return (letter * 2654435761u) >> 16;
+}
+
+#endif /*LV_FONT_FMT_TXT_GLYPH_LUT*/
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
@@ -323,6 +684,93 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     return value;
 }
 
+static inline uint32_t kern_pair_left(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t i)
+{
+    if(kdsc->glyph_ids_size == 0) return ((const uint8_t *)kdsc->glyph_ids)[i * 2];
+    else return ((const uint16_t *)kdsc->glyph_ids)[i * 2];
+}
+
+static inline uint32_t kern_pair_right(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t i)
+{
+    if(kdsc->glyph_ids_size == 0) return ((const uint8_t *)kdsc->glyph_ids)[i * 2 + 1];
+    else return ((const uint16_t *)kdsc->glyph_ids)[i * 2 + 1];
+}
+
+/**
+ * Give a class to the glyphs of groups of kerning pairs, the same class if their groups are the same.
+ * @param kdsc the kerning pairs
+ * @param order indices of the pairs, the pairs of a group follow each other
+ * @param group_start the first index in `order` of each group, `group_start[group_cnt]` is the end of the last one
+ * @param group_cnt number of groups
+ * @param right true: the pairs are grouped by the right glyph; false: by the left glyph
+ * @param class_mapping store the class of the glyphs here, from 1
+ * @return the number of classes, more than 255 means the classes don't fit into `class_mapping`
+ */
+static uint32_t kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kdsc, const uint32_t * order,
+                                      const uint32_t * group_start, uint32_t group_cnt, bool right,
+                                      uint8_t * class_mapping)
+{
+    /*The first group of each class*/
+    uint32_t * class_first_group = lv_mem_buf_get(255 * sizeof(uint32_t));
+    if(class_first_group == NULL) return 256;
+
+    uint32_t class_cnt = 0;
+    uint32_t g;
+    for(g = 0; g < group_cnt; g++) {
+        uint32_t start = group_start[g];
+        uint32_t cnt = group_start[g + 1] - start;
+        uint32_t c;
+        for(c = 0; c < class_cnt; c++) {
+            uint32_t first = class_first_group[c];
+            if(group_start[first + 1] - group_start[first] != cnt) continue;
+            if(kern_groups_equal(kdsc, order, group_start[first], start, cnt, right)) break;
+        }
+
+        if(c == class_cnt) {
+            if(class_cnt == 255) {
+                class_cnt = 256;
+                break;
+            }
+            class_first_group[class_cnt++] = g;
+        }
+
+        uint32_t pair = order[start];
+        class_mapping[right ? kern_pair_right(kdsc, pair) : kern_pair_left(kdsc, pair)] = (uint8_t)(c + 1);
+    }
+
+    lv_mem_buf_release(class_first_group);
+    return class_cnt;
+}
+
+/**
+ * Tell whether two groups of kerning pairs kern with the same glyphs by the same values.
+ * @param kdsc the kerning pairs
+ * @param order indices of the pairs
+ * @param start1 index of the first group in `order`
+ * @param start2 index of the second group in `order`
+ * @param cnt number of pairs in both groups
+ * @param right true: the pairs are grouped by the right glyph, compare the left ones; false: the opposite
+ * @return true: the two groups are the same
+ */
+static bool kern_groups_equal(const lv_font_fmt_txt_kern_pair_t * kdsc, const uint32_t * order,
+                              uint32_t start1, uint32_t start2, uint32_t cnt, bool right)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        uint32_t p1 = order[start1 + i];
+        uint32_t p2 = order[start2 + i];
+        if(kdsc->values[p1] != kdsc->values[p2]) return false;
+        if(right) {
+            if(kern_pair_left(kdsc, p1) != kern_pair_left(kdsc, p2)) return false;
+        }
+        else {
+            if(kern_pair_right(kdsc, p1) != kern_pair_right(kdsc, p2)) return false;
+        }
+    }
+
+    return true;
+}
+
 static int32_t kern_pair_8_compare(const void * ref, const void * element)
 {
     const uint8_t * ref8_p = ref;
@@ -344,6 +792,120 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
     else return (int32_t) ref16_p[1] - element16_p[1];
 }
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+/**
+ * Tell whether the bitmap of a glyph is served from the cache.
+ * The glyph descriptor and the bitmap have to agree on it, so both ask here.
+ * @param font pointer to font
+ * @param gdsc descriptor of the glyph
+ * @return true: the glyph is drawn from an A8 bitmap in the cache
+ */
+static bool is_cached_a8(const lv_font_t * font, const lv_font_fmt_txt_glyph_dsc_t * gdsc)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+
+    /*Sub-pixel glyphs are drawn from their own format*/
+    if(font->subpx != LV_FONT_SUBPX_NONE) return false;
+
+    /*Plain 8 bpp bitmaps are A8 already*/
+    if(fdsc->bpp == 8 && fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) return false;
+#if LV_USE_FONT_COMPRESSED == 0
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) return false;
+#endif
+
+    uint32_t px_cnt = (uint32_t)gdsc->box_w * gdsc->box_h;
+    return px_cnt > 0 && px_cnt <= LV_FONT_FMT_TXT_CACHE_SIZE;
+}
+
+/**
+ * Get the bitmap of a glyph with 1 byte per pixel from the cache.
+ * On a miss the glyph is decompressed and expanded once and added to the cache,
+ * evicting the least recently used glyphs if the cache is full.
+ * @param font pointer to font
+ * @param gid id of the glyph
+ * @return pointer to the A8 bitmap or NULL on error
+ */
+static const uint8_t * get_bitmap_a8(const lv_font_t * font, uint32_t gid)
+{
+    if(LV_GC_ROOT(_lv_font_glyph_cache) == NULL) {
+        LV_GC_ROOT(_lv_font_glyph_cache) = lv_lru_create(LV_FONT_FMT_TXT_CACHE_SIZE,
+                                                         LV_MIN(GLYPH_CACHE_AVG_SIZE, LV_FONT_FMT_TXT_CACHE_SIZE), NULL, NULL);
+        if(LV_GC_ROOT(_lv_font_glyph_cache) == NULL) return NULL;
+    }
+    lv_lru_t * cache = LV_GC_ROOT(_lv_font_glyph_cache);
+
+    /*Zero the padding too, the key is compared byte by byte*/
+    glyph_cache_key_t key;
+    lv_memset_00(&key, sizeof(key));
+    key.font = font;
+    key.gid = gid;
+
+    uint8_t * a8 = NULL;
+    lv_lru_get(cache, &key, sizeof(key), (void **)&a8);
+    if(a8) {
+        glyph_cache_hit_cnt++;
+        return a8;
+    }
+    glyph_cache_miss_cnt++;
+
+    const uint8_t * native = get_bitmap_native(font, gid);
+    if(native == NULL) return NULL;
+
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    uint32_t px_cnt = (uint32_t)gdsc->box_w * gdsc->box_h;
+    a8 = lv_mem_alloc_fast(px_cnt);
+    LV_ASSERT_MALLOC(a8);
+    if(a8 == NULL) return NULL;
+
+    expand_to_a8(native, a8, px_cnt, (uint8_t)fdsc->bpp);
+
+    if(lv_lru_set(cache, &key, sizeof(key), a8, px_cnt) != LV_LRU_OK) {
+        lv_mem_free(a8);
+        return NULL;
+    }
+
+    return a8;
+}
+
+/**
+ * Expand a bitmap to 1 byte per pixel with the opacity the letter drawing would map the pixels to.
+ * @param in the bitmap in the font's bpp, without padding between the lines
+ * @param out buffer of `px_cnt` bytes to store the result
+ * @param px_cnt number of pixels in the glyph (width * height)
+ * @param bpp bit per pixel of `in` (bpp = 3 is stored as bpp = 4)
+ */
+static void expand_to_a8(const uint8_t * in, uint8_t * out, uint32_t px_cnt, uint8_t bpp)
+{
+    const uint8_t * opa_table;
+    switch(bpp) {
+        case 1:
+            opa_table = _lv_bpp1_opa_table;
+            break;
+        case 2:
+            opa_table = _lv_bpp2_opa_table;
+            break;
+        case 3:
+        case 4:
+            opa_table = _lv_bpp4_opa_table;
+            bpp = 4;
+            break;
+        default:
+            lv_memcpy(out, in, px_cnt);
+            return;
+    }
+
+    uint8_t mask = (1 << bpp) - 1;
+    uint32_t bit_pos = 0;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) {
+        uint8_t px = (in[bit_pos >> 3] >> (8 - bpp - (bit_pos & 0x7))) & mask;
+        out[i] = opa_table[px];
+        bit_pos += bpp;
+    }
+}
+#endif /*LV_FONT_FMT_TXT_CACHE_SIZE*/
+
 #if LV_USE_FONT_COMPRESSED
 /**
  * The compress a glyph's bitmap
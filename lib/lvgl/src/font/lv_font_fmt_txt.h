@@ -151,9 +151,15 @@ typedef enum {
     LV_FONT_FMT_TXT_COMPRESSED_NO_PREFILTER = 1,
 } lv_font_fmt_txt_bitmap_format_t;
 
+struct _lv_font_fmt_txt_lut_t;
+
 typedef struct {
     uint32_t last_letter;
     uint32_t last_glyph_id;
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+    /*Glyph ids of the letters, built at the first lookup. Used only by the library.*/
+    struct _lv_font_fmt_txt_lut_t * lut;
+#endif
 } lv_font_fmt_txt_glyph_cache_t;
 
 /*Describe store additional data for fonts*/
@@ -197,6 +203,14 @@ typedef struct {
     lv_font_fmt_txt_glyph_cache_t * cache;
 } lv_font_fmt_txt_dsc_t;
 
+typedef struct {
+    uint32_t total_size;    /**< Size of the glyph bitmap cache, `LV_FONT_FMT_TXT_CACHE_SIZE`*/
+    uint32_t used_size;     /**< Bytes of the cached A8 bitmaps*/
+    uint32_t hit_cnt;       /**< Bitmaps served from the cache*/
+    uint32_t miss_cnt;      /**< Bitmaps decompressed and expanded into the cache*/
+    uint8_t hit_pct;        /**< hit_cnt / (hit_cnt + miss_cnt) in percentage*/
+} lv_font_fmt_txt_cache_monitor_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -225,6 +239,31 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
  */
 void _lv_font_clean_up_fmt_txt(void);
 
+/**
+ * Drop every glyph from the glyph bitmap cache and free the glyph id lookup tables.
+ * Required when a font is freed, a new one could get the same address.
+ */
+void lv_font_fmt_txt_cache_clear(void);
+
+/**
+ * Give information about the glyph bitmap cache.
+ * @param mon_p pointer to a `lv_font_fmt_txt_cache_monitor_t` variable, the result will be stored here
+ */
+void lv_font_fmt_txt_cache_monitor(lv_font_fmt_txt_cache_monitor_t * mon_p);
+
+/**
+ * Convert kerning pairs to kerning classes, to look up the kerning of two glyphs without a search.
+ * Glyphs kerned the same way with every other glyph get the same class.
+ * @param kdsc the kerning pairs, ordered by the left glyph id first, then by the right one
+ * @param glyph_cnt number of glyphs in the font, the glyph ids are less than this
+ * @param max_size the largest size of the classes [bytes]: two class mappings with `glyph_cnt` bytes
+ *                 each and a byte for every pair of classes
+ * @return the kerning classes, their parts allocated with `lv_mem_alloc()`.
+ *         NULL if they would be larger than `max_size`, there are more than 255 classes or out of memory.
+ */
+lv_font_fmt_txt_kern_classes_t * lv_font_fmt_txt_kern_pairs_to_classes(const lv_font_fmt_txt_kern_pair_t * kdsc,
+                                                                       uint32_t glyph_cnt, uint32_t max_size);
+
 /**********************
  *      MACROS
  **********************/
@@ -66,6 +66,9 @@ typedef struct cmap_table_bin {
 static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp);
 static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font);
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start);
+#if LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+    static void convert_kern_pairs(lv_font_fmt_txt_dsc_t * font_dsc, uint32_t glyph_cnt);
+#endif
 
 static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
 static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
@@ -117,6 +120,9 @@ lv_font_t * lv_font_load(const char * font_name)
 void lv_font_free(lv_font_t * font)
 {
     if(NULL != font) {
+        /*The cached glyphs of this font would be found for the next font at this address*/
+        lv_font_fmt_txt_cache_clear();
+
         lv_font_fmt_txt_dsc_t * dsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
         if(NULL != dsc) {
@@ -172,6 +178,9 @@ void lv_font_free(lv_font_t * font)
             if(NULL != dsc->glyph_dsc) {
                 lv_mem_free((void *)dsc->glyph_dsc);
             }
+            if(NULL != dsc->cache) {
+                lv_mem_free(dsc->cache);
+            }
             lv_mem_free(dsc);
         }
         lv_mem_free(font);
@@ -489,6 +498,13 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     font->dsc = font_dsc;
 
+    /*Like the built-in fonts, to remember the last letter and keep the glyph id lookup table*/
+    font_dsc->cache = lv_mem_alloc(sizeof(lv_font_fmt_txt_glyph_cache_t));
+    if(font_dsc->cache == NULL) {
+        return false;
+    }
+    memset(font_dsc->cache, 0, sizeof(lv_font_fmt_txt_glyph_cache_t));
+
     /*header*/
     int32_t header_length = read_label(fp, 0, "head");
     if(header_length < 0) {
@@ -580,9 +596,43 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
     uint32_t kern_start = glyph_start + glyph_length;
 
     int32_t kern_length = load_kern(fp, font_dsc, font_header.glyph_id_format, kern_start);
+    if(kern_length < 0) {
+        return false;
+    }
+
+#if LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+    if(font_dsc->kern_classes == 0) {
+        convert_kern_pairs(font_dsc, loca_count);
+    }
+#endif
+
+    return true;
+}
+
+#if LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+/**
+ * Replace the kerning pairs of a font with kerning classes if they fit into `LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE`.
+ * Otherwise the pairs are kept.
+ * @param font_dsc descriptor of the font with kerning pairs
+ * @param glyph_cnt number of glyphs in the font
+ */
+static void convert_kern_pairs(lv_font_fmt_txt_dsc_t * font_dsc, uint32_t glyph_cnt)
+{
+    lv_font_fmt_txt_kern_pair_t * kern_pair = (lv_font_fmt_txt_kern_pair_t *)font_dsc->kern_dsc;
+    if(NULL == kern_pair) return;
+
+    lv_font_fmt_txt_kern_classes_t * kern_classes =
+        lv_font_fmt_txt_kern_pairs_to_classes(kern_pair, glyph_cnt, LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE);
+    if(NULL == kern_classes) return;
+
+    lv_mem_free((void *)kern_pair->glyph_ids);
+    lv_mem_free((void *)kern_pair->values);
+    lv_mem_free(kern_pair);
 
-    return kern_length >= 0;
+    font_dsc->kern_dsc = kern_classes;
+    font_dsc->kern_classes = 1;
 }
+#endif
 
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start)
 {
@@ -95,6 +95,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->screen_transp    = 0;
     driver->dpi              = LV_DPI_DEF;
     driver->color_chroma_key = LV_COLOR_CHROMA_KEY;
+    driver->px_cost          = 1;
 
 #if LV_USE_GPU_RA6M3_G2D
     driver->draw_ctx_init = lv_draw_ra6m3_2d_ctx_init;
@@ -126,7 +127,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->draw_ctx_size = sizeof(lv_draw_arm2d_ctx_t);
 #else
     driver->draw_ctx_init = lv_draw_sw_init_ctx;
-    driver->draw_ctx_deinit = lv_draw_sw_init_ctx;
+    driver->draw_ctx_deinit = lv_draw_sw_deinit_ctx;
     driver->draw_ctx_size = sizeof(lv_draw_sw_ctx_t);
 #endif
 
@@ -602,6 +603,56 @@ void lv_disp_drv_use_generic_set_px_cb(lv_disp_drv_t * disp_drv, lv_img_cf_t cf)
     }
 }
 
+void lv_disp_row_spans_init_circle(lv_disp_row_span_t * spans, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    /*Work with doubled coordinates so that the pixel centers are integers*/
+    int32_t d = LV_MIN(hor_res, ver_res);
+    lv_coord_t y;
+    for(y = 0; y < ver_res; y++) {
+        int32_t dy = 2 * y + 1 - ver_res;
+        if(dy * dy > d * d) {
+            spans[y].x1 = 0;
+            spans[y].x2 = -1;
+            continue;
+        }
+
+        lv_sqrt_res_t half;
+        lv_sqrt((uint32_t)(d * d - dy * dy), &half, 0x8000);
+        spans[y].x1 = LV_MAX((hor_res - 1 - half.i + 1) / 2, 0);
+        spans[y].x2 = LV_MIN((hor_res - 1 + half.i) / 2, hor_res - 1);
+    }
+}
+
+bool lv_disp_drv_clip_to_row_spans(const lv_disp_drv_t * disp_drv, lv_area_t * area)
+{
+    const lv_disp_row_span_t * spans = disp_drv->row_spans;
+    if(spans == NULL) return true;
+
+    lv_coord_t x1 = LV_COORD_MAX;
+    lv_coord_t x2 = LV_COORD_MIN;
+    lv_coord_t y1 = LV_COORD_MAX;
+    lv_coord_t y2 = LV_COORD_MIN;
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_coord_t sx1 = LV_MAX(spans[y].x1, area->x1);
+        lv_coord_t sx2 = LV_MIN(spans[y].x2, area->x2);
+        if(sx1 > sx2) continue;
+
+        if(sx1 < x1) x1 = sx1;
+        if(sx2 > x2) x2 = sx2;
+        if(y1 == LV_COORD_MAX) y1 = y;
+        y2 = y;
+    }
+
+    if(y1 == LV_COORD_MAX) return false;
+
+    area->x1 = x1;
+    area->x2 = x2;
+    area->y1 = y1;
+    area->y2 = y2;
+    return true;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -62,6 +62,14 @@ typedef struct _lv_disp_draw_buf_t {
     volatile uint32_t last_part         : 1; /*1: the last part of the current area is being rendered*/
 } lv_disp_draw_buf_t;
 
+/**
+ * Visible pixels of one display row: `x1..x2` inclusive. `x1 > x2` means nothing is visible in the row.
+ */
+typedef struct {
+    lv_coord_t x1;
+    lv_coord_t x2;
+} lv_disp_row_span_t;
+
 typedef enum {
     LV_DISP_ROT_NONE = 0,
     LV_DISP_ROT_90,
@@ -136,6 +144,20 @@ typedef struct _lv_disp_drv_t {
     /** OPTIONAL: called when start rendering */
     void (*render_start_cb)(struct _lv_disp_drv_t * disp_drv);
 
+    /** OPTIONAL: Visible span of every row (`ver_res` entries) on non-rectangular panels, e.g. round displays.
+     * Invalidated areas are clipped to the spans and pixels outside of them are not rendered.
+     * `flush_cb` still receives rectangles but only the pixels inside the spans are valid.
+     * NULL: the whole rectangle is visible*/
+    const lv_disp_row_span_t * row_spans;
+
+    /** Cost model of refreshing an area, used to decide which invalidated areas to join:
+     * `area_cost` for every part of an area flushed separately (e.g. setting the address window, finding
+     * the objects to draw) plus `px_cost` for every pixel (drawing and sending it), in any unit, e.g. ns.
+     * Two areas are joined if their bounding box costs less than the two of them.
+     * The cost of the whole screen has to fit into 32 bits. Default 0 and 1: join if it has fewer pixels*/
+    uint32_t area_cost;
+    uint32_t px_cost;
+
     /** On CHROMA_KEYED images this color will be transparent.
      * `LV_COLOR_CHROMA_KEY` by default. (lv_conf.h)*/
     lv_color_t color_chroma_key;
@@ -360,6 +382,23 @@ lv_disp_draw_buf_t * lv_disp_get_draw_buf(lv_disp_t * disp);
 
 void lv_disp_drv_use_generic_set_px_cb(lv_disp_drv_t * disp_drv, lv_img_cf_t cf);
 
+/**
+ * Fill a row span table with the disc inscribed in a `hor_res` x `ver_res` display.
+ * Assign the table to `disp_drv->row_spans` to skip the invisible corners of round displays.
+ * @param spans pointer to an array of `ver_res` elements
+ * @param hor_res horizontal resolution of the display
+ * @param ver_res vertical resolution of the display
+ */
+void lv_disp_row_spans_init_circle(lv_disp_row_span_t * spans, lv_coord_t hor_res, lv_coord_t ver_res);
+
+/**
+ * Clip an area to the bounding box of the visible row spans it covers.
+ * @param disp_drv pointer to a display driver
+ * @param area pointer to an area in screen coordinates. It's modified in place
+ * @return false: no visible pixels in the area; true: `area` contains visible pixels
+ */
+bool lv_disp_drv_clip_to_row_spans(const lv_disp_drv_t * disp_drv, lv_area_t * area);
+
 /**********************
  *      MACROS
  **********************/
@@ -46,17 +46,36 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 1
+#define LV_MEM_CUSTOM 0
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
-    #define LV_MEM_SIZE (48U * 1024U)          /*[bytes]*/
+    #define LV_MEM_SIZE (96U * 1024U)          /*[bytes] the UI peaks at about 30 kB*/
 
     /*Set an address for the memory pool instead of allocating it as a normal array. Can be in external SRAM too.*/
     #define LV_MEM_ADR 0     /*0: unused*/
     /*Instead of an address give a memory allocator that will be called to get a memory pool for LVGL. E.g. my_malloc*/
     #if LV_MEM_ADR == 0
-        #undef LV_MEM_POOL_INCLUDE
-        #undef LV_MEM_POOL_ALLOC
+        /*Objects, styles and text in PSRAM, next to the audio buffer but in a pool of their own*/
+        #define LV_MEM_POOL_INCLUDE <esp_heap_caps.h>
+        #define LV_MEM_POOL_ALLOC(size) heap_caps_malloc_prefer(size, 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_8BIT)
+    #endif
+
+    /*Serve the allocations up to 256 bytes from pages split into blocks of a few size classes
+     *instead of the TLSF heap: O(1), and small short-lived blocks don't fragment the heap.
+     *The pages are taken from the pool at `lv_mem_init()`, the classes share them.*/
+    #define LV_MEM_CLASSES 1
+    #if LV_MEM_CLASSES
+        #define LV_MEM_CLASS_AREA_SIZE (16U * 1024U)   /*[bytes] all the pages, the UI uses about 9 kB*/
+        #define LV_MEM_CLASS_PAGE_SIZE 1024            /*[bytes] one page, a multiple of 256*/
+    #endif
+
+    /*Size of a second pool for `lv_mem_alloc_fast()` (layer and draw buffers), e.g. in internal RAM
+     *while the main pool is in external RAM. 0: `lv_mem_alloc_fast()` allocates from the main pool*/
+    #define LV_MEM_FAST_SIZE (56U * 1024U)   /*[bytes] the layer pool (32 kB), the glyph cache (8 kB) and the scratch draw buffers*/
+    /*Give a memory allocator that will be called to get the fast pool, else it's a normal array*/
+    #if LV_MEM_FAST_SIZE
+        #define LV_MEM_FAST_POOL_INCLUDE <esp_heap_caps.h>
+        #define LV_MEM_FAST_POOL_ALLOC(size) heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA)
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
@@ -139,6 +158,13 @@
 #define LV_LAYER_SIMPLE_BUF_SIZE          (24 * 1024)
 #define LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE (3 * 1024)
 
+/*Keep the layer buffers after use and give them to the next layers instead of allocating them on every redraw.
+ * - LV_LAYER_POOL_SIZE: [bytes] most memory the kept buffers can take, 0: no pool
+ * - LV_LAYER_POOL_BUF_CNT: most buffers kept, layers in layers need one each
+ *A kept buffer grows to the largest layer it served, larger layers than the budget allows get a buffer of their own.*/
+#define LV_LAYER_POOL_SIZE                (32 * 1024)
+#define LV_LAYER_POOL_BUF_CNT             2
+
 /*Default image cache size. Image caching keeps the images opened.
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
@@ -294,6 +320,18 @@
 /*1: Draw random colored rectangles over the redrawn areas*/
 #define LV_USE_REFR_DEBUG 0
 
+/*1: Split the time of every frame into phases (join, draw, layer, flush, transfer...) and collect histograms
+ *See lv_refr_prof.h, dumped with the `prof` serial command*/
+#define LV_USE_REFR_PROFILER 1
+#if LV_USE_REFR_PROFILER
+    #define LV_REFR_PROFILER_INCLUDE "Arduino.h"    /*Header for the time function*/
+    #define LV_REFR_PROFILER_TIME_EXPR (micros())   /*Expression evaluating to current time in us*/
+#endif
+
+/*1: Keep the most read style properties (paddings, radius, background, text, transformation...) of the objects
+ *resolved instead of searching the styles of the object and of its parents on every read. ~230 bytes per object*/
+#define LV_OBJ_STYLE_CACHE 1
+
 /*Change the built in (v)snprintf functions*/
 #define LV_SPRINTF_CUSTOM 0
 #if LV_SPRINTF_CUSTOM
@@ -411,6 +449,22 @@
 /*Enables/disables support for compressed fonts.*/
 #define LV_USE_FONT_COMPRESSED 0
 
+/*Size of the cache of glyph bitmaps expanded to 1 byte per pixel [bytes] (0: disable).
+ *The bitmaps are decompressed and expanded once, the letters are drawn without converting the bpp.
+ *Least recently used glyphs are dropped when the cache is full.
+ *The ASCII glyphs of montserrat_14 take about 7 kB.*/
+#define LV_FONT_FMT_TXT_CACHE_SIZE (8 * 1024)
+
+/*Look up the glyph ids of the letters in a table built for each font at its first use
+ *instead of searching the cmaps. Latin-1 takes 512 bytes per font,
+ *the other letters 12-24 bytes each if the font has at most 256 of them.*/
+#define LV_FONT_FMT_TXT_GLYPH_LUT 1
+
+/*Convert the kerning pairs of the fonts loaded by `lv_font_load()` to kerning classes
+ *if the classes take at most this many bytes (0: keep the pairs).
+ *The pairs are searched for every two letters, the classes are indexed directly.*/
+#define LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE (4 * 1024)
+
 /*Enable subpixel rendering*/
 #define LV_USE_FONT_SUBPX 0
 #if LV_USE_FONT_SUBPX
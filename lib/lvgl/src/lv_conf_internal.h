@@ -157,6 +157,60 @@
         #endif
     #endif
 
+    /*Serve the allocations up to 256 bytes from pages split into blocks of a few size classes
+     *instead of the TLSF heap: O(1), and small short-lived blocks don't fragment the heap.
+     *The pages are taken from the pool at `lv_mem_init()`, the classes share them.*/
+    #ifndef LV_MEM_CLASSES
+        #ifdef CONFIG_LV_MEM_CLASSES
+            #define LV_MEM_CLASSES CONFIG_LV_MEM_CLASSES
+        #else
+            #define LV_MEM_CLASSES 0
+        #endif
+    #endif
+    #if LV_MEM_CLASSES
+        #ifndef LV_MEM_CLASS_AREA_SIZE
+            #ifdef CONFIG_LV_MEM_CLASS_AREA_SIZE
+                #define LV_MEM_CLASS_AREA_SIZE CONFIG_LV_MEM_CLASS_AREA_SIZE
+            #else
+                #define LV_MEM_CLASS_AREA_SIZE (16U * 1024U)   /*[bytes] all the pages*/
+            #endif
+        #endif
+        #ifndef LV_MEM_CLASS_PAGE_SIZE
+            #ifdef CONFIG_LV_MEM_CLASS_PAGE_SIZE
+                #define LV_MEM_CLASS_PAGE_SIZE CONFIG_LV_MEM_CLASS_PAGE_SIZE
+            #else
+                #define LV_MEM_CLASS_PAGE_SIZE 1024            /*[bytes] one page, a multiple of 256*/
+            #endif
+        #endif
+    #endif
+
+    /*Size of a second pool for `lv_mem_alloc_fast()` (layer and draw buffers), e.g. in internal RAM
+     *while the main pool is in external RAM. 0: `lv_mem_alloc_fast()` allocates from the main pool*/
+    #ifndef LV_MEM_FAST_SIZE
+        #ifdef CONFIG_LV_MEM_FAST_SIZE
+            #define LV_MEM_FAST_SIZE CONFIG_LV_MEM_FAST_SIZE
+        #else
+            #define LV_MEM_FAST_SIZE 0
+        #endif
+    #endif
+    /*Give a memory allocator that will be called to get the fast pool, else it's a normal array*/
+    #if LV_MEM_FAST_SIZE
+        #ifndef LV_MEM_FAST_POOL_INCLUDE
+            #ifdef CONFIG_LV_MEM_FAST_POOL_INCLUDE
+                #define LV_MEM_FAST_POOL_INCLUDE CONFIG_LV_MEM_FAST_POOL_INCLUDE
+            #else
+                #undef LV_MEM_FAST_POOL_INCLUDE
+            #endif
+        #endif
+        #ifndef LV_MEM_FAST_POOL_ALLOC
+            #ifdef CONFIG_LV_MEM_FAST_POOL_ALLOC
+                #define LV_MEM_FAST_POOL_ALLOC CONFIG_LV_MEM_FAST_POOL_ALLOC
+            #else
+                #undef LV_MEM_FAST_POOL_ALLOC
+            #endif
+        #endif
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #ifndef LV_MEM_CUSTOM_INCLUDE
         #ifdef CONFIG_LV_MEM_CUSTOM_INCLUDE
@@ -343,6 +397,25 @@
     #endif
 #endif
 
+/*Keep the layer buffers after use and give them to the next layers instead of allocating them on every redraw.
+ * - LV_LAYER_POOL_SIZE: [bytes] most memory the kept buffers can take, 0: no pool
+ * - LV_LAYER_POOL_BUF_CNT: most buffers kept, layers in layers need one each
+ *A kept buffer grows to the largest layer it served, larger layers than the budget allows get a buffer of their own.*/
+#ifndef LV_LAYER_POOL_SIZE
+    #ifdef CONFIG_LV_LAYER_POOL_SIZE
+        #define LV_LAYER_POOL_SIZE CONFIG_LV_LAYER_POOL_SIZE
+    #else
+        #define LV_LAYER_POOL_SIZE                0
+    #endif
+#endif
+#ifndef LV_LAYER_POOL_BUF_CNT
+    #ifdef CONFIG_LV_LAYER_POOL_BUF_CNT
+        #define LV_LAYER_POOL_BUF_CNT CONFIG_LV_LAYER_POOL_BUF_CNT
+    #else
+        #define LV_LAYER_POOL_BUF_CNT             2
+    #endif
+#endif
+
 /*Default image cache size. Image caching keeps the images opened.
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
@@ -796,6 +869,42 @@
     #endif
 #endif
 
+/*1: Split the time of every frame into phases (join, draw, layer, flush, transfer...) and collect histograms
+ *See lv_refr_prof.h*/
+#ifndef LV_USE_REFR_PROFILER
+    #ifdef CONFIG_LV_USE_REFR_PROFILER
+        #define LV_USE_REFR_PROFILER CONFIG_LV_USE_REFR_PROFILER
+    #else
+        #define LV_USE_REFR_PROFILER 0
+    #endif
+#endif
+#if LV_USE_REFR_PROFILER
+    #ifndef LV_REFR_PROFILER_INCLUDE
+        #ifdef CONFIG_LV_REFR_PROFILER_INCLUDE
+            #define LV_REFR_PROFILER_INCLUDE CONFIG_LV_REFR_PROFILER_INCLUDE
+        #else
+            #define LV_REFR_PROFILER_INCLUDE <stdint.h>             /*Header for the time function*/
+        #endif
+    #endif
+    #ifndef LV_REFR_PROFILER_TIME_EXPR
+        #ifdef CONFIG_LV_REFR_PROFILER_TIME_EXPR
+            #define LV_REFR_PROFILER_TIME_EXPR CONFIG_LV_REFR_PROFILER_TIME_EXPR
+        #else
+            #define LV_REFR_PROFILER_TIME_EXPR (lv_tick_get() * 1000) /*Expression evaluating to current time in us*/
+        #endif
+    #endif
+#endif
+
+/*1: Keep the most read style properties (paddings, radius, background, text, transformation...) of the objects
+ *resolved instead of searching the styles of the object and of its parents on every read. ~230 bytes per object*/
+#ifndef LV_OBJ_STYLE_CACHE
+    #ifdef CONFIG_LV_OBJ_STYLE_CACHE
+        #define LV_OBJ_STYLE_CACHE CONFIG_LV_OBJ_STYLE_CACHE
+    #else
+        #define LV_OBJ_STYLE_CACHE 0
+    #endif
+#endif
+
 /*Change the built in (v)snprintf functions*/
 #ifndef LV_SPRINTF_CUSTOM
     #ifdef CONFIG_LV_SPRINTF_CUSTOM
@@ -1229,6 +1338,39 @@
     #endif
 #endif
 
+/*Size of the cache of glyph bitmaps expanded to 1 byte per pixel [bytes] (0: disable).
+ *The bitmaps are decompressed and expanded once, the letters are drawn without converting the bpp.
+ *Least recently used glyphs are dropped when the cache is full.*/
+#ifndef LV_FONT_FMT_TXT_CACHE_SIZE
+    #ifdef CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+        #define LV_FONT_FMT_TXT_CACHE_SIZE CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+    #else
+        #define LV_FONT_FMT_TXT_CACHE_SIZE 0
+    #endif
+#endif
+
+/*Look up the glyph ids of the letters in a table built for each font at its first use
+ *instead of searching the cmaps. Latin-1 takes 512 bytes per font,
+ *the other letters 12-24 bytes each if the font has at most 256 of them.*/
+#ifndef LV_FONT_FMT_TXT_GLYPH_LUT
+    #ifdef CONFIG_LV_FONT_FMT_TXT_GLYPH_LUT
+        #define LV_FONT_FMT_TXT_GLYPH_LUT CONFIG_LV_FONT_FMT_TXT_GLYPH_LUT
+    #else
+        #define LV_FONT_FMT_TXT_GLYPH_LUT 0
+    #endif
+#endif
+
+/*Convert the kerning pairs of the fonts loaded by `lv_font_load()` to kerning classes
+ *if the classes take at most this many bytes (0: keep the pairs).
+ *The pairs are searched for every two letters, the classes are indexed directly.*/
+#ifndef LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+    #ifdef CONFIG_LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+        #define LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE CONFIG_LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE
+    #else
+        #define LV_FONT_FMT_TXT_KERN_CLASSES_MAX_SIZE 0
+    #endif
+#endif
+
 /*Enable subpixel rendering*/
 #ifndef LV_USE_FONT_SUBPX
     #ifdef CONFIG_LV_USE_FONT_SUBPX
@@ -20,6 +20,8 @@
  *********************/
 #define LV_ANIM_RESOLUTION 1024
 #define LV_ANIM_RES_SHIFT 10
+#define LV_ANIM_LUT_SIZE 256  /*Entries of the easing tables, one per 4 of the LV_BEZIER_VAL_MAX range*/
+#define LV_ANIM_LUT_SHIFT 2
 
 /**********************
  *      TYPEDEFS
@@ -29,8 +31,14 @@
  *  STATIC PROTOTYPES
  **********************/
 static void anim_timer(lv_timer_t * param);
+static inline void anim_step(lv_anim_t * a, uint32_t elaps);
+static void anim_flush_batch(uint32_t first, uint32_t end);
 static void anim_mark_list_change(void);
 static void anim_ready_handler(lv_anim_t * a);
+static bool anim_insert(lv_anim_t * a);
+static void anim_remove(lv_anim_t * a);
+static int32_t anim_path_lut(const lv_anim_t * a, const uint16_t * lut);
+static int32_t lut_get(const uint16_t * lut, uint32_t t);
 
 /**********************
  *  STATIC VARIABLES
@@ -39,6 +47,110 @@ static uint32_t last_timer_run;
 static bool anim_list_changed;
 static bool anim_run_round;
 static lv_timer_t * _lv_anim_tmr;
+static uint32_t anim_cnt;
+static uint32_t anim_cap;
+
+/*The cubic bezier curves of the built-in paths at t = 0, 4, 8 ... 1024, evaluated exactly and rounded.
+ *`lv_bezier3()` truncates its terms and would make the curves wobble back by a step here and there.*/
+static const uint16_t ease_in_lut[LV_ANIM_LUT_SIZE + 1] = {
+    0, 1, 1, 2, 2, 3, 4, 4, 5, 5, 6, 7, 7, 8, 8, 9,
+    10, 10, 11, 11, 12, 13, 13, 14, 15, 15, 16, 17, 18, 18, 19, 20,
+    20, 21, 22, 23, 24, 24, 25, 26, 27, 28, 28, 29, 30, 31, 32, 33,
+    34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 48, 49, 50,
+    51, 52, 54, 55, 56, 58, 59, 60, 62, 63, 64, 66, 67, 69, 70, 72,
+    74, 75, 77, 78, 80, 82, 84, 85, 87, 89, 91, 93, 94, 96, 98, 100,
+    102, 104, 106, 109, 111, 113, 115, 117, 120, 122, 124, 127, 129, 131, 134, 136,
+    139, 141, 144, 147, 149, 152, 155, 158, 160, 163, 166, 169, 172, 175, 178, 181,
+    184, 187, 191, 194, 197, 200, 204, 207, 211, 214, 218, 221, 225, 229, 232, 236,
+    240, 244, 248, 252, 256, 260, 264, 268, 272, 276, 280, 285, 289, 294, 298, 303,
+    307, 312, 316, 321, 326, 331, 336, 340, 345, 350, 356, 361, 366, 371, 376, 382,
+    387, 393, 398, 404, 409, 415, 421, 426, 432, 438, 444, 450, 456, 462, 469, 475,
+    481, 488, 494, 501, 507, 514, 520, 527, 534, 541, 548, 555, 562, 569, 576, 583,
+    591, 598, 605, 613, 621, 628, 636, 644, 652, 659, 667, 675, 684, 692, 700, 708,
+    717, 725, 734, 742, 751, 760, 769, 777, 786, 795, 805, 814, 823, 832, 842, 851,
+    861, 870, 880, 890, 900, 910, 920, 930, 940, 950, 960, 971, 981, 992, 1003, 1013,
+    1024
+};
+
+static const uint16_t ease_out_lut[LV_ANIM_LUT_SIZE + 1] = {
+    0, 11, 21, 31, 42, 52, 62, 72, 82, 92, 102, 111, 121, 131, 140, 150,
+    159, 168, 178, 187, 196, 205, 214, 223, 231, 240, 249, 257, 266, 274, 283, 291,
+    299, 308, 316, 324, 332, 340, 347, 355, 363, 371, 378, 386, 393, 401, 408, 415,
+    422, 430, 437, 444, 451, 457, 464, 471, 478, 484, 491, 498, 504, 510, 517, 523,
+    529, 535, 542, 548, 554, 560, 565, 571, 577, 583, 589, 594, 600, 605, 611, 616,
+    621, 627, 632, 637, 642, 647, 652, 657, 662, 667, 672, 677, 682, 686, 691, 695,
+    700, 704, 709, 713, 718, 722, 726, 730, 735, 739, 743, 747, 751, 755, 759, 763,
+    766, 770, 774, 778, 781, 785, 788, 792, 795, 799, 802, 806, 809, 812, 815, 819,
+    822, 825, 828, 831, 834, 837, 840, 843, 846, 849, 851, 854, 857, 860, 862, 865,
+    867, 870, 873, 875, 878, 880, 882, 885, 887, 889, 892, 894, 896, 898, 901, 903,
+    905, 907, 909, 911, 913, 915, 917, 919, 921, 923, 924, 926, 928, 930, 932, 933,
+    935, 937, 938, 940, 942, 943, 945, 946, 948, 949, 951, 952, 954, 955, 957, 958,
+    959, 961, 962, 963, 965, 966, 967, 968, 970, 971, 972, 973, 975, 976, 977, 978,
+    979, 980, 981, 982, 984, 985, 986, 987, 988, 989, 990, 991, 992, 993, 994, 995,
+    996, 997, 998, 999, 999, 1000, 1001, 1002, 1003, 1004, 1005, 1006, 1007, 1008, 1008, 1009,
+    1010, 1011, 1012, 1013, 1014, 1015, 1015, 1016, 1017, 1018, 1019, 1020, 1021, 1021, 1022, 1023,
+    1024
+};
+
+static const uint16_t ease_in_out_lut[LV_ANIM_LUT_SIZE + 1] = {
+    0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 10, 11, 12, 14, 16, 17,
+    19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 40, 42, 45, 47, 50, 53,
+    55, 58, 61, 64, 67, 70, 73, 76, 79, 83, 86, 89, 93, 96, 100, 103,
+    107, 111, 114, 118, 122, 126, 130, 134, 138, 142, 146, 150, 154, 158, 162, 167,
+    171, 175, 180, 184, 189, 193, 198, 202, 207, 212, 216, 221, 226, 231, 235, 240,
+    245, 250, 255, 260, 265, 270, 275, 280, 285, 290, 296, 301, 306, 311, 316, 322,
+    327, 332, 338, 343, 348, 354, 359, 365, 370, 375, 381, 386, 392, 397, 403, 408,
+    414, 420, 425, 431, 436, 442, 447, 453, 459, 464, 470, 476, 481, 487, 492, 498,
+    504, 509, 515, 521, 526, 532, 538, 543, 549, 555, 560, 566, 571, 577, 583, 588,
+    594, 599, 605, 610, 616, 622, 627, 633, 638, 644, 649, 654, 660, 665, 671, 676,
+    682, 687, 692, 698, 703, 708, 713, 719, 724, 729, 734, 739, 744, 750, 755, 760,
+    765, 770, 775, 780, 784, 789, 794, 799, 804, 808, 813, 818, 822, 827, 832, 836,
+    841, 845, 850, 854, 858, 863, 867, 871, 875, 879, 883, 887, 891, 895, 899, 903,
+    907, 911, 915, 918, 922, 925, 929, 932, 936, 939, 943, 946, 949, 952, 955, 958,
+    961, 964, 967, 970, 973, 975, 978, 981, 983, 986, 988, 990, 993, 995, 997, 999,
+    1001, 1003, 1005, 1007, 1009, 1010, 1012, 1013, 1015, 1016, 1018, 1019, 1020, 1021, 1022, 1023,
+    1024
+};
+
+static const uint16_t overshoot_lut[LV_ANIM_LUT_SIZE + 1] = {
+    0, 12, 23, 35, 46, 58, 69, 80, 92, 103, 114, 125, 136, 147, 158, 169,
+    179, 190, 201, 211, 222, 232, 242, 253, 263, 273, 283, 293, 303, 313, 323, 333,
+    342, 352, 362, 371, 381, 390, 399, 409, 418, 427, 436, 445, 454, 463, 472, 481,
+    489, 498, 507, 515, 524, 532, 541, 549, 557, 565, 573, 581, 589, 597, 605, 613,
+    621, 628, 636, 644, 651, 658, 666, 673, 680, 688, 695, 702, 709, 716, 723, 729,
+    736, 743, 750, 756, 763, 769, 776, 782, 788, 794, 801, 807, 813, 819, 825, 830,
+    836, 842, 848, 853, 859, 864, 870, 875, 880, 886, 891, 896, 901, 906, 911, 916,
+    921, 926, 930, 935, 940, 944, 949, 953, 958, 962, 966, 970, 975, 979, 983, 987,
+    991, 994, 998, 1002, 1006, 1009, 1013, 1016, 1020, 1023, 1026, 1030, 1033, 1036, 1039, 1042,
+    1045, 1048, 1051, 1054, 1056, 1059, 1062, 1064, 1067, 1069, 1072, 1074, 1076, 1079, 1081, 1083,
+    1085, 1087, 1089, 1091, 1093, 1094, 1096, 1098, 1099, 1101, 1102, 1104, 1105, 1107, 1108, 1109,
+    1110, 1111, 1112, 1113, 1114, 1115, 1116, 1117, 1117, 1118, 1119, 1119, 1120, 1120, 1120, 1121,
+    1121, 1121, 1121, 1122, 1122, 1122, 1121, 1121, 1121, 1121, 1121, 1120, 1120, 1119, 1119, 1118,
+    1118, 1117, 1116, 1115, 1115, 1114, 1113, 1112, 1111, 1110, 1108, 1107, 1106, 1105, 1103, 1102,
+    1100, 1099, 1097, 1095, 1094, 1092, 1090, 1088, 1086, 1084, 1082, 1080, 1078, 1076, 1074, 1071,
+    1069, 1067, 1064, 1062, 1059, 1056, 1054, 1051, 1048, 1045, 1042, 1040, 1037, 1033, 1030, 1027,
+    1024
+};
+
+static const uint16_t bounce_lut[LV_ANIM_LUT_SIZE + 1] = {
+    1024, 1021, 1019, 1016, 1013, 1011, 1008, 1005, 1003, 1000, 997, 995, 992, 989, 987, 984,
+    981, 978, 976, 973, 970, 967, 964, 962, 959, 956, 953, 950, 948, 945, 942, 939,
+    936, 933, 930, 928, 925, 922, 919, 916, 913, 910, 907, 904, 901, 898, 895, 892,
+    889, 886, 883, 880, 877, 874, 871, 868, 865, 862, 859, 855, 852, 849, 846, 843,
+    840, 837, 833, 830, 827, 824, 821, 817, 814, 811, 808, 804, 801, 798, 795, 791,
+    788, 785, 781, 778, 775, 771, 768, 764, 761, 758, 754, 751, 747, 744, 740, 737,
+    733, 730, 726, 723, 719, 716, 712, 709, 705, 701, 698, 694, 691, 687, 683, 680,
+    676, 672, 669, 665, 661, 657, 654, 650, 646, 642, 639, 635, 631, 627, 623, 619,
+    616, 612, 608, 604, 600, 596, 592, 588, 584, 580, 576, 572, 568, 564, 560, 556,
+    552, 548, 544, 539, 535, 531, 527, 523, 519, 514, 510, 506, 502, 498, 493, 489,
+    485, 480, 476, 472, 467, 463, 459, 454, 450, 445, 441, 436, 432, 427, 423, 418,
+    414, 409, 405, 400, 396, 391, 386, 382, 377, 373, 368, 363, 358, 354, 349, 344,
+    339, 335, 330, 325, 320, 315, 310, 306, 301, 296, 291, 286, 281, 276, 271, 266,
+    261, 256, 251, 246, 241, 236, 230, 225, 220, 215, 210, 205, 199, 194, 189, 184,
+    178, 173, 168, 162, 157, 152, 146, 141, 135, 130, 125, 119, 114, 108, 103, 97,
+    91, 86, 80, 75, 69, 63, 58, 52, 46, 41, 35, 29, 23, 17, 12, 6,
+    0
+};
 
 /**********************
  *      MACROS
@@ -56,7 +168,9 @@ static lv_timer_t * _lv_anim_tmr;
 
 void _lv_anim_core_init(void)
 {
-    _lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
+    LV_GC_ROOT(_lv_anim_arr) = NULL;
+    anim_cnt = 0;
+    anim_cap = 0;
     _lv_anim_tmr = lv_timer_create(anim_timer, LV_DISP_DEF_REFR_PERIOD, NULL);
     anim_mark_list_change(); /*Turn off the animation timer*/
     anim_list_changed = false;
@@ -81,12 +195,11 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
     if(a->exec_cb != NULL) lv_anim_del(a->var, a->exec_cb); /*exec_cb == NULL would delete all animations of var*/
 
     /*If the list is empty the anim timer was suspended and it's last run measure is invalid*/
-    if(_lv_ll_is_empty(&LV_GC_ROOT(_lv_anim_ll))) {
+    if(anim_cnt == 0) {
         last_timer_run = lv_tick_get();
     }
 
-    /*Add the new animation to the animation linked list*/
-    lv_anim_t * new_anim = _lv_ll_ins_head(&LV_GC_ROOT(_lv_anim_ll));
+    lv_anim_t * new_anim = lv_mem_alloc(sizeof(lv_anim_t));
     LV_ASSERT_MALLOC(new_anim);
     if(new_anim == NULL) return NULL;
 
@@ -94,6 +207,14 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
     lv_memcpy(new_anim, a, sizeof(lv_anim_t));
     if(a->var == a) new_anim->var = new_anim;
     new_anim->run_round = anim_run_round;
+    new_anim->batch_pending = 0;
+    new_anim->ready_pending = 0;
+
+    /*Add the new animation to the active ones*/
+    if(!anim_insert(new_anim)) {
+        lv_mem_free(new_anim);
+        return NULL;
+    }
 
     /*Set the start value*/
     if(new_anim->early_apply) {
@@ -104,6 +225,7 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
         }
 
         if(new_anim->exec_cb && new_anim->var) new_anim->exec_cb(new_anim->var, new_anim->start_value);
+        if(new_anim->batch_cb && new_anim->var) new_anim->batch_cb(new_anim->var);
     }
 
     /*Creating an animation changed the linked list.
@@ -137,24 +259,25 @@ uint32_t lv_anim_get_playtime(lv_anim_t * a)
 
 bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    lv_anim_t * a_next;
     bool del = false;
-    a        = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-    while(a != NULL) {
-        /*'a' might be deleted, so get the next object while 'a' is valid*/
-        a_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
-
+    uint32_t i = 0;
+    while(i < anim_cnt) {
+        lv_anim_t * a = LV_GC_ROOT(_lv_anim_arr)[i];
         if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
-            _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+            anim_remove(a);
+            anim_list_changed = false;
             if(a->deleted_cb != NULL) a->deleted_cb(a);
+            bool restart = anim_list_changed;
             lv_mem_free(a);
             anim_mark_list_change(); /*Read by `anim_timer`. It need to know if a delete occurred in
-                                       the linked list*/
+                                       the list*/
             del = true;
+            /*The next one moved to `i`, unless `deleted_cb` changed the list too, then start over*/
+            if(restart) i = 0;
+        }
+        else {
+            i++;
         }
-
-        a = a_next;
     }
 
     return del;
@@ -162,14 +285,19 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 
 void lv_anim_del_all(void)
 {
-    _lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
+    while(anim_cnt > 0) {
+        lv_anim_t * a = LV_GC_ROOT(_lv_anim_arr)[anim_cnt - 1];
+        anim_cnt--;
+        lv_mem_free(a);
+    }
     anim_mark_list_change();
 }
 
 lv_anim_t * lv_anim_get(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) {
+    uint32_t i;
+    for(i = 0; i < anim_cnt; i++) {
+        lv_anim_t * a = LV_GC_ROOT(_lv_anim_arr)[i];
         if(a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
             return a;
         }
@@ -185,11 +313,7 @@ struct _lv_timer_t * lv_anim_get_timer(void)
 
 uint16_t lv_anim_count_running(void)
 {
-    uint16_t cnt = 0;
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) cnt++;
-
-    return cnt;
+    return (uint16_t)anim_cnt;
 }
 
 uint32_t lv_anim_speed_to_time(uint32_t speed, int32_t start, int32_t end)
@@ -226,58 +350,22 @@ int32_t lv_anim_path_linear(const lv_anim_t * a)
 
 int32_t lv_anim_path_ease_in(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
-    int32_t step = lv_bezier3(t, 0, 50, 100, LV_BEZIER_VAL_MAX);
-
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_lut(a, ease_in_lut);
 }
 
 int32_t lv_anim_path_ease_out(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
-    int32_t step = lv_bezier3(t, 0, 900, 950, LV_BEZIER_VAL_MAX);
-
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_lut(a, ease_out_lut);
 }
 
 int32_t lv_anim_path_ease_in_out(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
-    int32_t step = lv_bezier3(t, 0, 50, 952, LV_BEZIER_VAL_MAX);
-
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_lut(a, ease_in_out_lut);
 }
 
 int32_t lv_anim_path_overshoot(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
-    int32_t step = lv_bezier3(t, 0, 1000, 1300, LV_BEZIER_VAL_MAX);
-
-    int32_t new_value;
-    new_value = step * (a->end_value - a->start_value);
-    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
-    new_value += a->start_value;
-
-    return new_value;
+    return anim_path_lut(a, overshoot_lut);
 }
 
 int32_t lv_anim_path_bounce(const lv_anim_t * a)
@@ -321,7 +409,7 @@ int32_t lv_anim_path_bounce(const lv_anim_t * a)
 
     if(t > LV_BEZIER_VAL_MAX) t = LV_BEZIER_VAL_MAX;
     if(t < 0) t = 0;
-    int32_t step = lv_bezier3(t, LV_BEZIER_VAL_MAX, 800, 500, 0);
+    int32_t step = lut_get(bounce_lut, t);
 
     int32_t new_value;
     new_value = step * diff;
@@ -356,60 +444,116 @@ static void anim_timer(lv_timer_t * param)
     /*Flip the run round*/
     anim_run_round = anim_run_round ? false : true;
 
-    lv_anim_t * a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-
-    while(a != NULL) {
+    /*The animations of a variable are next to each other, they are stepped together,
+     *then their batch callbacks are called, then the finished ones are handled*/
+    uint32_t i = 0;
+    while(i < anim_cnt) {
         /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
+         * happened in `anim_ready_handler` which could make this list reading corrupt
          * because the list is changed meanwhile
          */
         anim_list_changed = false;
 
-        if(a->run_round != anim_run_round) {
-            a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
-
-            /*The animation will run now for the first time. Call `start_cb`*/
-            int32_t new_act_time = a->act_time + elaps;
-            if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
-                if(a->early_apply == 0 && a->get_value_cb) {
-                    int32_t v_ofs = a->get_value_cb(a);
-                    a->start_value += v_ofs;
-                    a->end_value += v_ofs;
-                }
-                if(a->start_cb) a->start_cb(a);
-                a->start_cb_called = 1;
-            }
-            a->act_time += elaps;
-            if(a->act_time >= 0) {
-                if(a->act_time > a->time) a->act_time = a->time;
-
-                int32_t new_value;
-                new_value = a->path_cb(a);
-
-                if(new_value != a->current_value) {
-                    a->current_value = new_value;
-                    /*Apply the calculated value*/
-                    if(a->exec_cb) a->exec_cb(a->var, new_value);
-                }
-
-                /*If the time is elapsed the animation is ready*/
-                if(a->act_time >= a->time) {
-                    anim_ready_handler(a);
-                }
+        lv_anim_t ** arr = LV_GC_ROOT(_lv_anim_arr);
+        void * var = arr[i]->var;
+        uint32_t end = i + 1;
+        while(end < anim_cnt && arr[end]->var == var) end++;
+
+        /*Most variables have one animation without `batch_cb`, the other passes are skipped for them*/
+        bool batch = false;
+        bool ready = false;
+        uint32_t k;
+        for(k = i; k < end && !anim_list_changed; k++) {
+            lv_anim_t * a = arr[k];
+            anim_step(a, elaps);
+            batch |= a->batch_pending;
+            ready |= a->ready_pending;
+        }
+        if(anim_list_changed) {
+            i = 0;
+            continue;
+        }
+        if(batch) anim_flush_batch(i, end);
+        for(k = i; ready && k < end && !anim_list_changed; k++) {
+            lv_anim_t * a = LV_GC_ROOT(_lv_anim_arr)[k];
+            if(a->ready_pending) {
+                a->ready_pending = 0;
+                anim_ready_handler(a);
             }
         }
 
-        /*If the linked list changed due to anim. delete then it's not safe to continue
-         *the reading of the list from here -> start from the head*/
-        if(anim_list_changed)
-            a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-        else
-            a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+        /*If the list changed due to anim. delete then it's not safe to continue
+         *the reading of the list from here -> start from the head.
+         *The flags of the animations tell what is left to do.*/
+        i = anim_list_changed ? 0 : end;
     }
 
     last_timer_run = lv_tick_get();
 }
 
+/**
+ * Advance an animation by the elapsed time and apply its new value, once per round
+ * @param a pointer to an animation descriptor
+ * @param elaps time since the last round
+ */
+static inline void anim_step(lv_anim_t * a, uint32_t elaps)
+{
+    if(a->run_round == anim_run_round) return;
+    a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
+
+    /*The animation will run now for the first time. Call `start_cb`*/
+    int32_t new_act_time = a->act_time + elaps;
+    if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
+        if(a->early_apply == 0 && a->get_value_cb) {
+            int32_t v_ofs = a->get_value_cb(a);
+            a->start_value += v_ofs;
+            a->end_value += v_ofs;
+        }
+        if(a->start_cb) a->start_cb(a);
+        a->start_cb_called = 1;
+    }
+    a->act_time += elaps;
+    if(a->act_time >= 0) {
+        if(a->act_time > a->time) a->act_time = a->time;
+
+        int32_t new_value;
+        new_value = a->path_cb(a);
+
+        if(new_value != a->current_value) {
+            a->current_value = new_value;
+            /*Apply the calculated value*/
+            if(a->exec_cb) a->exec_cb(a->var, new_value);
+            if(a->batch_cb) a->batch_pending = 1;
+        }
+
+        /*If the time is elapsed the animation is ready*/
+        if(a->act_time >= a->time) a->ready_pending = 1;
+    }
+}
+
+/**
+ * Call the batch callbacks of the animations of a variable whose value changed in this round,
+ * each callback once
+ * @param first index of the first animation of the variable
+ * @param end index after the last one
+ */
+static void anim_flush_batch(uint32_t first, uint32_t end)
+{
+    uint32_t i;
+    for(i = first; i < end && !anim_list_changed; i++) {
+        lv_anim_t * a = LV_GC_ROOT(_lv_anim_arr)[i];
+        if(!a->batch_pending) continue;
+
+        lv_anim_batch_cb_t batch_cb = a->batch_cb;
+        uint32_t k;
+        for(k = i; k < end; k++) {
+            lv_anim_t * b = LV_GC_ROOT(_lv_anim_arr)[k];
+            if(b->batch_cb == batch_cb) b->batch_pending = 0;
+        }
+        batch_cb(a->var);
+    }
+}
+
 /**
  * Called when an animation is ready to do the necessary thinks
  * e.g. repeat, play back, delete etc.
@@ -429,7 +573,7 @@ static void anim_ready_handler(lv_anim_t * a)
 
         /*Delete the animation from the list.
          * This way the `ready_cb` will see the animations like it's animation is ready deleted*/
-        _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+        anim_remove(a);
         /*Flag that the list has changed*/
         anim_mark_list_change();
 
@@ -463,8 +607,93 @@ static void anim_ready_handler(lv_anim_t * a)
 static void anim_mark_list_change(void)
 {
     anim_list_changed = true;
-    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL)
+    if(anim_cnt == 0)
         lv_timer_pause(_lv_anim_tmr);
     else
         lv_timer_resume(_lv_anim_tmr);
 }
+
+/**
+ * Add an animation to the active ones, right after the other animations of its variable
+ * @param a pointer to an animation descriptor
+ * @return false: out of memory
+ */
+static bool anim_insert(lv_anim_t * a)
+{
+    if(anim_cnt == anim_cap) {
+        uint32_t new_cap = anim_cap ? anim_cap * 2 : 8;
+        lv_anim_t ** new_arr = lv_mem_realloc(LV_GC_ROOT(_lv_anim_arr), new_cap * sizeof(lv_anim_t *));
+        LV_ASSERT_MALLOC(new_arr);
+        if(new_arr == NULL) return false;
+        LV_GC_ROOT(_lv_anim_arr) = new_arr;
+        anim_cap = new_cap;
+    }
+
+    lv_anim_t ** arr = LV_GC_ROOT(_lv_anim_arr);
+    uint32_t pos = anim_cnt;
+    uint32_t i;
+    for(i = anim_cnt; i > 0; i--) {
+        if(arr[i - 1]->var == a->var) {
+            pos = i;
+            break;
+        }
+    }
+    for(i = anim_cnt; i > pos; i--) arr[i] = arr[i - 1];
+    arr[pos] = a;
+    anim_cnt++;
+    return true;
+}
+
+/**
+ * Remove an animation from the active ones, the others keep their order
+ * @param a pointer to an animation descriptor
+ */
+static void anim_remove(lv_anim_t * a)
+{
+    lv_anim_t ** arr = LV_GC_ROOT(_lv_anim_arr);
+    uint32_t i;
+    for(i = 0; i < anim_cnt; i++) {
+        if(arr[i] == a) {
+            anim_cnt--;
+            for(; i < anim_cnt; i++) arr[i] = arr[i + 1];
+            return;
+        }
+    }
+}
+
+/**
+ * Evaluate a built-in path from its table
+ * @param a pointer to an animation descriptor
+ * @param lut the path's table
+ * @return the current value
+ */
+static int32_t anim_path_lut(const lv_anim_t * a, const uint16_t * lut)
+{
+    /*Calculate the current step*/
+    uint32_t t = lv_map(a->act_time, 0, a->time, 0, LV_BEZIER_VAL_MAX);
+    int32_t step = lut_get(lut, t);
+
+    int32_t new_value;
+    new_value = step * (a->end_value - a->start_value);
+    new_value = new_value >> LV_BEZIER_VAL_SHIFT;
+    new_value += a->start_value;
+
+    return new_value;
+}
+
+/**
+ * Interpolate between the two entries of a path's table around `t`
+ * @param lut the path's table
+ * @param t the time in [0..LV_BEZIER_VAL_MAX] range
+ * @return the path's value at `t`
+ */
+static int32_t lut_get(const uint16_t * lut, uint32_t t)
+{
+    uint32_t i = t >> LV_ANIM_LUT_SHIFT;
+    if(i >= LV_ANIM_LUT_SIZE) return lut[LV_ANIM_LUT_SIZE];
+
+    int32_t v0 = lut[i];
+    int32_t v1 = lut[i + 1];
+    int32_t frac = t & ((1 << LV_ANIM_LUT_SHIFT) - 1);
+    return v0 + (((v1 - v0) * frac) >> LV_ANIM_LUT_SHIFT);
+}
@@ -69,6 +69,10 @@ typedef int32_t (*lv_anim_get_value_cb_t)(struct _lv_anim_t *);
 /** Callback used when the animation is deleted*/
 typedef void (*lv_anim_deleted_cb_t)(struct _lv_anim_t *);
 
+/** Called once per animation round with the variable after the `exec_cb`s of its
+ * animations changed it, e.g. to apply several staged values together*/
+typedef void (*lv_anim_batch_cb_t)(void *);
+
 /** Describes an animation*/
 typedef struct _lv_anim_t {
     void * var;                          /**<Variable to animate*/
@@ -77,6 +81,7 @@ typedef struct _lv_anim_t {
     lv_anim_ready_cb_t ready_cb;         /**< Call it when the animation is ready*/
     lv_anim_deleted_cb_t deleted_cb;     /**< Call it when the animation is deleted*/
     lv_anim_get_value_cb_t get_value_cb; /**< Get the current value in relative mode*/
+    lv_anim_batch_cb_t batch_cb;         /**< Call it once per round after the `exec_cb`s of `var`*/
 #if LV_USE_USER_DATA
     void * user_data; /**< Custom user data*/
 #endif
@@ -96,6 +101,8 @@ typedef struct _lv_anim_t {
     uint8_t playback_now : 1; /**< Play back is in progress*/
     uint8_t run_round : 1;    /**< Indicates the animation has run in this round*/
     uint8_t start_cb_called : 1;    /**< Indicates that the `start_cb` was already called*/
+    uint8_t batch_pending : 1;      /**< The value changed in this round, `batch_cb` is due*/
+    uint8_t ready_pending : 1;      /**< The time elapsed in this round, to repeat or delete*/
 } lv_anim_t;
 
 /**********************
@@ -229,6 +236,18 @@ static inline void lv_anim_set_ready_cb(lv_anim_t * a, lv_anim_ready_cb_t ready_
     a->ready_cb = ready_cb;
 }
 
+/**
+ * Set a function to call once per round after the animations of the same variable applied their values.
+ * The animations sharing a `batch_cb` get one call together, e.g. an `x` and a `y` animation of an object
+ * can stage their values in `exec_cb` and move the object once in `batch_cb`.
+ * @param a         pointer to an initialized `lv_anim_t` variable
+ * @param batch_cb  a function to call with `var`
+ */
+static inline void lv_anim_set_batch_cb(lv_anim_t * a, lv_anim_batch_cb_t batch_cb)
+{
+    a->batch_cb = batch_cb;
+}
+
 /**
  * Set a function call when the animation is deleted.
  * @param a         pointer to an initialized `lv_anim_t` variable
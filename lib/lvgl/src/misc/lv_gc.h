@@ -32,6 +32,18 @@ extern "C" {
 #    define LV_IMG_CACHE_DEF            0
 #endif
 
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+#    define LV_FONT_GLYPH_CACHE_DEF     1
+#else
+#    define LV_FONT_GLYPH_CACHE_DEF     0
+#endif
+
+#if LV_FONT_FMT_TXT_GLYPH_LUT
+#    define LV_FONT_GLYPH_LUT_DEF       1
+#else
+#    define LV_FONT_GLYPH_LUT_DEF       0
+#endif
+
 #define LV_DISPATCH(f, t, n)            f(t, n)
 #define LV_DISPATCH_COND(f, t, n, m, v) LV_CONCAT3(LV_DISPATCH, m, v)(f, t, n)
 
@@ -42,10 +54,11 @@ extern "C" {
 
 #define LV_ITERATE_ROOTS(f)                                                                            \
     LV_DISPATCH(f, lv_ll_t, _lv_timer_ll) /*Linked list to store the lv_timers*/                       \
+    LV_DISPATCH(f, lv_timer_t **, _lv_timer_heap) /*Min-heap of the running lv_timers on their next run*/ \
     LV_DISPATCH(f, lv_ll_t, _lv_disp_ll)  /*Linked list of display device*/                            \
     LV_DISPATCH(f, lv_ll_t, _lv_indev_ll) /*Linked list of input device*/                              \
     LV_DISPATCH(f, lv_ll_t, _lv_fsdrv_ll)                                                              \
-    LV_DISPATCH(f, lv_ll_t, _lv_anim_ll)                                                               \
+    LV_DISPATCH(f, struct _lv_anim_t **, _lv_anim_arr) /*The running animations, grouped by variable*/ \
     LV_DISPATCH(f, lv_ll_t, _lv_group_ll)                                                              \
     LV_DISPATCH(f, lv_ll_t, _lv_img_decoder_ll)                                                        \
     LV_DISPATCH(f, lv_ll_t, _lv_obj_style_trans_ll)                                                    \
@@ -59,6 +72,8 @@ extern "C" {
     LV_DISPATCH(f, void * , _lv_theme_default_styles)                                                  \
     LV_DISPATCH(f, void * , _lv_theme_basic_styles)                                                  \
     LV_DISPATCH_COND(f, uint8_t *, _lv_font_decompr_buf, LV_USE_FONT_COMPRESSED, 1)                    \
+    LV_DISPATCH_COND(f, struct lv_lru_t *, _lv_font_glyph_cache, LV_FONT_GLYPH_CACHE_DEF, 1)            \
+    LV_DISPATCH_COND(f, struct _lv_font_fmt_txt_lut_t *, _lv_font_glyph_luts, LV_FONT_GLYPH_LUT_DEF, 1) \
     LV_DISPATCH(f, uint8_t * , _lv_grad_cache_mem)                                                     \
     LV_DISPATCH(f, uint8_t * , _lv_style_custom_prop_flag_lookup_table)
 
@@ -104,7 +104,19 @@ void lv_lru_del(lv_lru_t * cache)
 {
     LV_ASSERT_NULL(cache);
 
-    // free each of the cached items, and the hash table
+    // free the cached items, and the hash table
+    lv_lru_clear(cache);
+    lv_mem_free(cache->items);
+
+    // free the cache
+    lv_mem_free(cache);
+}
+
+void lv_lru_clear(lv_lru_t * cache)
+{
+    LV_ASSERT_NULL(cache);
+
+    // free each of the cached items, the hash table is kept
     lv_lru_item_t * item = NULL, *next = NULL;
     uint32_t i = 0;
     if(cache->items) {
@@ -118,21 +130,18 @@ void lv_lru_del(lv_lru_t * cache)
                 lv_mem_free(item);
                 item = next;
             }
+            cache->items[i] = NULL;
         }
-        lv_mem_free(cache->items);
     }
 
-    if(cache->free_items) {
-        item = cache->free_items;
-        while(item) {
-            next = (lv_lru_item_t *) item->next;
-            lv_mem_free(item);
-            item = next;
-        }
+    // and the items kept for reuse
+    item = cache->free_items;
+    while(item) {
+        next = (lv_lru_item_t *) item->next;
+        lv_mem_free(item);
+        item = next;
     }
-
-    // free the cache
-    lv_mem_free(cache);
+    cache->free_items = NULL;
 }
 
 
@@ -21,6 +21,22 @@
     #include LV_MEM_POOL_INCLUDE
 #endif
 
+#ifdef LV_MEM_FAST_POOL_INCLUDE
+    #include LV_MEM_FAST_POOL_INCLUDE
+#endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_CLASSES
+    #define MEM_CLASSES     1
+#else
+    #define MEM_CLASSES     0
+#endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_FAST_SIZE
+    #define MEM_FAST        1
+#else
+    #define MEM_FAST        0
+#endif
+
 /*********************
  *      DEFINES
  *********************/
@@ -39,15 +55,48 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+#if MEM_CLASSES
+    #define CLASS_NUM           8
+    #define CLASS_MAX_SIZE      256
+    #define CLASS_PAGE_NUM      (LV_MEM_CLASS_AREA_SIZE / LV_MEM_CLASS_PAGE_SIZE)
+    #define PAGE_NONE           0xFFFF
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if MEM_CLASSES
+/*A page of the class area, split into the blocks of one class while it's in use*/
+typedef struct {
+    void * free_head;   /*Free blocks of the page, linked through their first word*/
+    uint16_t used;      /*Blocks given out*/
+    uint16_t prev;      /*In the free pages or in the list of the class's pages with free blocks*/
+    uint16_t next;
+    uint8_t class_id;
+} mem_page_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
+    static void pool_monitor(lv_tlsf_t pool_tlsf, uint32_t total_size, uint32_t max, uint32_t reserved_free,
+                             lv_mem_monitor_t * mon_p);
+#endif
+#if MEM_CLASSES
+    static void class_init(void);
+    static void * class_alloc(size_t size);
+    static size_t class_free(void * data);
+    static void * class_realloc(void * data, size_t new_size);
+    static inline bool in_class_area(const void * p);
+    static uint16_t page_take(uint8_t class_id);
+    static void page_list_add(uint16_t * head, uint16_t page);
+    static void page_list_remove(uint16_t * head, uint16_t page);
+#endif
+#if MEM_FAST
+    static void * fast_realloc(void * data, size_t new_size);
+    static inline bool in_fast_pool(const void * p);
 #endif
 
 /**********************
@@ -59,6 +108,24 @@
     static uint32_t max_used;
 #endif
 
+#if MEM_CLASSES
+    static const uint16_t class_size[CLASS_NUM] = {16, 32, 48, 64, 96, 128, 192, 256};
+    /*Class of the sizes by `(size + 15) / 16`*/
+    static const uint8_t class_of_size[CLASS_MAX_SIZE / 16 + 1] = {0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7};
+    static uint8_t * class_area;
+    static mem_page_t pages[CLASS_PAGE_NUM];
+    static uint16_t free_pages;
+    static uint16_t partial_pages[CLASS_NUM];  /*Pages of the class with free blocks*/
+    static lv_mem_class_monitor_t class_mon[CLASS_NUM];
+#endif
+
+#if MEM_FAST
+    static lv_tlsf_t tlsf_fast;
+    static uint8_t * fast_mem;
+    static uint32_t fast_cur_used;
+    static uint32_t fast_max_used;
+#endif
+
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
 
 /**********************
@@ -98,6 +165,25 @@ void lv_mem_init(void)
 #else
     tlsf = lv_tlsf_create_with_pool((void *)LV_MEM_ADR, LV_MEM_SIZE);
 #endif
+    cur_used = 0;
+    max_used = 0;
+#endif
+
+#if MEM_CLASSES
+    class_init();
+#endif
+
+#if MEM_FAST
+#ifdef LV_MEM_FAST_POOL_ALLOC
+    fast_mem = (uint8_t *)LV_MEM_FAST_POOL_ALLOC(LV_MEM_FAST_SIZE);
+#else
+    static LV_ATTRIBUTE_LARGE_RAM_ARRAY MEM_UNIT fast_mem_int[LV_MEM_FAST_SIZE / sizeof(MEM_UNIT)];
+    fast_mem = (uint8_t *)fast_mem_int;
+#endif
+    LV_ASSERT_MALLOC(fast_mem);
+    if(fast_mem) tlsf_fast = lv_tlsf_create_with_pool(fast_mem, LV_MEM_FAST_SIZE);
+    fast_cur_used = 0;
+    fast_max_used = 0;
 #endif
 
 #if LV_MEM_ADD_JUNK
@@ -113,6 +199,9 @@ void lv_mem_deinit(void)
 {
 #if LV_MEM_CUSTOM == 0
     lv_tlsf_destroy(tlsf);
+#if MEM_FAST
+    if(fast_mem) lv_tlsf_destroy(tlsf_fast);
+#endif
     lv_mem_init();
 #endif
 }
@@ -130,7 +219,10 @@ void * lv_mem_alloc(size_t size)
         return &zero_mem;
     }
 
-#if LV_MEM_CUSTOM == 0
+#if MEM_CLASSES
+    void * alloc = class_alloc(size);
+    if(alloc == NULL) alloc = lv_tlsf_malloc(tlsf, size);
+#elif LV_MEM_CUSTOM == 0
     void * alloc = lv_tlsf_malloc(tlsf, size);
 #else
     void * alloc = LV_MEM_CUSTOM_ALLOC(size);
@@ -162,6 +254,28 @@ void * lv_mem_alloc(size_t size)
     return alloc;
 }
 
+void * lv_mem_alloc_fast(size_t size)
+{
+#if MEM_FAST
+    if(size == 0 || fast_mem == NULL) return lv_mem_alloc(size);
+
+    void * alloc = lv_tlsf_malloc(tlsf_fast, size);
+    if(alloc == NULL) {
+        LV_LOG_INFO("fast pool full, allocating %lu bytes from the main pool", (unsigned long)size);
+        return lv_mem_alloc(size);
+    }
+#if LV_MEM_ADD_JUNK
+    lv_memset(alloc, 0xaa, size);
+#endif
+    fast_cur_used += size;
+    fast_max_used = LV_MAX(fast_cur_used, fast_max_used);
+    MEM_TRACE("allocated %lu bytes at %p in the fast pool", (unsigned long)size, alloc);
+    return alloc;
+#else
+    return lv_mem_alloc(size);
+#endif
+}
+
 /**
  * Free an allocated data
  * @param data pointer to an allocated memory
@@ -173,10 +287,30 @@ void lv_mem_free(void * data)
     if(data == NULL) return;
 
 #if LV_MEM_CUSTOM == 0
+#if MEM_FAST
+    if(in_fast_pool(data)) {
 #  if LV_MEM_ADD_JUNK
-    lv_memset(data, 0xbb, lv_tlsf_block_size(data));
+        lv_memset(data, 0xbb, lv_tlsf_block_size(data));
 #  endif
-    size_t size = lv_tlsf_free(tlsf, data);
+        size_t fast_size = lv_tlsf_free(tlsf_fast, data);
+        if(fast_cur_used > fast_size) fast_cur_used -= fast_size;
+        else fast_cur_used = 0;
+        return;
+    }
+#endif
+    size_t size;
+#if MEM_CLASSES
+    if(in_class_area(data)) {
+        size = class_free(data);
+    }
+    else
+#endif
+    {
+#  if LV_MEM_ADD_JUNK
+        lv_memset(data, 0xbb, lv_tlsf_block_size(data));
+#  endif
+        size = lv_tlsf_free(tlsf, data);
+    }
     if(cur_used > size) cur_used -= size;
     else cur_used = 0;
 #else
@@ -203,7 +337,15 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
     if(data_p == &zero_mem) return lv_mem_alloc(new_size);
 
 #if LV_MEM_CUSTOM == 0
-    void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+    void * new_p;
+    if(data_p == NULL) new_p = lv_mem_alloc(new_size);
+#if MEM_CLASSES
+    else if(in_class_area(data_p)) new_p = class_realloc(data_p, new_size);
+#endif
+#if MEM_FAST
+    else if(in_fast_pool(data_p)) new_p = fast_realloc(data_p, new_size);
+#endif
+    else new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
 #else
     void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
 #endif
@@ -233,6 +375,29 @@ lv_res_t lv_mem_test(void)
         LV_LOG_WARN("pool failed");
         return LV_RES_INV;
     }
+#endif
+#if MEM_FAST
+    if(fast_mem && (lv_tlsf_check(tlsf_fast) || lv_tlsf_check_pool(lv_tlsf_get_pool(tlsf_fast)))) {
+        LV_LOG_WARN("fast pool failed");
+        return LV_RES_INV;
+    }
+#endif
+#if MEM_CLASSES
+    uint32_t c;
+    for(c = 0; c < CLASS_NUM; c++) {
+        uint32_t used = 0;
+        uint32_t page_cnt = 0;
+        uint32_t p;
+        for(p = 0; p < CLASS_PAGE_NUM; p++) {
+            if(pages[p].class_id != c) continue;
+            used += pages[p].used;
+            page_cnt++;
+        }
+        if(used != class_mon[c].used_cnt || page_cnt != class_mon[c].page_cnt) {
+            LV_LOG_WARN("size class %d failed", (int)class_size[c]);
+            return LV_RES_INV;
+        }
+    }
 #endif
     MEM_TRACE("passed");
     return LV_RES_OK;
@@ -249,22 +414,44 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
     lv_memset(mon_p, 0, sizeof(lv_mem_monitor_t));
 #if LV_MEM_CUSTOM == 0
     MEM_TRACE("begin");
-
-    lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf), lv_mem_walker, mon_p);
-
-    mon_p->total_size = LV_MEM_SIZE;
-    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
-    if(mon_p->free_size > 0) {
-        mon_p->frag_pct = mon_p->free_biggest_size * 100U / mon_p->free_size;
-        mon_p->frag_pct = 100 - mon_p->frag_pct;
-    }
-    else {
-        mon_p->frag_pct = 0; /*no fragmentation if all the RAM is used*/
+    uint32_t class_free_size = 0;
+#if MEM_CLASSES
+    /*The class area is one block for the heap, its unused blocks are free memory too*/
+    if(class_area) {
+        class_free_size = LV_MEM_CLASS_AREA_SIZE;
+        uint32_t c;
+        for(c = 0; c < CLASS_NUM; c++) class_free_size -= class_mon[c].used_cnt * class_size[c];
     }
+#endif
+    pool_monitor(tlsf, LV_MEM_SIZE, max_used, class_free_size, mon_p);
+    MEM_TRACE("finished");
+#endif
+}
 
-    mon_p->max_used = max_used;
+void lv_mem_fast_monitor(lv_mem_monitor_t * mon_p)
+{
+    lv_memset(mon_p, 0, sizeof(lv_mem_monitor_t));
+#if MEM_FAST
+    if(fast_mem) pool_monitor(tlsf_fast, LV_MEM_FAST_SIZE, fast_max_used, 0, mon_p);
+#endif
+}
 
-    MEM_TRACE("finished");
+uint32_t lv_mem_class_count(void)
+{
+#if MEM_CLASSES
+    return CLASS_NUM;
+#else
+    return 0;
+#endif
+}
+
+void lv_mem_class_monitor(uint32_t class_id, lv_mem_class_monitor_t * mon_p)
+{
+    lv_memset(mon_p, 0, sizeof(lv_mem_class_monitor_t));
+#if MEM_CLASSES
+    if(class_id < CLASS_NUM) *mon_p = class_mon[class_id];
+#else
+    LV_UNUSED(class_id);
 #endif
 }
 
@@ -308,7 +495,9 @@ void * lv_mem_buf_get(uint32_t size)
     for(uint8_t i = 0; i < LV_MEM_BUF_MAX_NUM; i++) {
         if(LV_GC_ROOT(lv_mem_buf[i]).used == 0) {
             /*if this fails you probably need to increase your LV_MEM_SIZE/heap size*/
-            void * buf = lv_mem_realloc(LV_GC_ROOT(lv_mem_buf[i]).p, size);
+            void * buf;
+            if(LV_GC_ROOT(lv_mem_buf[i]).p) buf = lv_mem_realloc(LV_GC_ROOT(lv_mem_buf[i]).p, size);
+            else buf = lv_mem_alloc_fast(size);     /*The renderer works in them*/
             LV_ASSERT_MSG(buf != NULL, "Out of memory, can't allocate a new buffer (increase your LV_MEM_SIZE/heap size)");
             if(buf == NULL) return NULL;
 
@@ -563,4 +752,215 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
             mon_p->free_biggest_size = size;
     }
 }
+
+static void pool_monitor(lv_tlsf_t pool_tlsf, uint32_t total_size, uint32_t max, uint32_t reserved_free,
+                         lv_mem_monitor_t * mon_p)
+{
+    lv_tlsf_walk_pool(lv_tlsf_get_pool(pool_tlsf), lv_mem_walker, mon_p);
+    mon_p->free_size += reserved_free;
+
+    mon_p->total_size = total_size;
+    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
+    if(mon_p->free_size > 0) {
+        mon_p->frag_pct = mon_p->free_biggest_size * 100U / mon_p->free_size;
+        mon_p->frag_pct = 100 - mon_p->frag_pct;
+    }
+    else {
+        mon_p->frag_pct = 0; /*no fragmentation if all the RAM is used*/
+    }
+
+    mon_p->max_used = max;
+}
+#endif
+
+#if MEM_CLASSES
+/**
+ * Take the class area from the pool and put all its pages on the free list
+ */
+static void class_init(void)
+{
+    class_area = lv_tlsf_malloc(tlsf, LV_MEM_CLASS_AREA_SIZE);
+    LV_ASSERT_MALLOC(class_area);
+
+    free_pages = PAGE_NONE;
+    uint32_t i;
+    for(i = 0; i < CLASS_NUM; i++) {
+        partial_pages[i] = PAGE_NONE;
+        lv_memset_00(&class_mon[i], sizeof(lv_mem_class_monitor_t));
+        class_mon[i].block_size = class_size[i];
+    }
+    for(i = CLASS_PAGE_NUM; i > 0; i--) {
+        pages[i - 1].class_id = CLASS_NUM;
+        if(class_area) page_list_add(&free_pages, i - 1);
+    }
+}
+
+/**
+ * Allocate a block of the smallest class `size` fits in
+ * @param size the requested size
+ * @return the block or NULL if `size` is too large for the classes or no page is free
+ */
+static void * class_alloc(size_t size)
+{
+    if(size > CLASS_MAX_SIZE) return NULL;
+
+    uint8_t c = class_of_size[(size + 15) >> 4];
+    lv_mem_class_monitor_t * mon = &class_mon[c];
+    uint16_t p = partial_pages[c];
+    if(p == PAGE_NONE) {
+        p = page_take(c);
+        if(p == PAGE_NONE) {
+            mon->fallback_cnt++;
+            return NULL;
+        }
+    }
+
+    mem_page_t * page = &pages[p];
+    void * block = page->free_head;
+    page->free_head = *(void **)block;
+    page->used++;
+    if(page->free_head == NULL) page_list_remove(&partial_pages[c], p);
+
+    mon->alloc_cnt++;
+    mon->used_cnt++;
+    if(mon->used_cnt > mon->max_used_cnt) mon->max_used_cnt = mon->used_cnt;
+
+#if LV_MEM_ADD_JUNK
+    lv_memset(block, 0xaa, class_size[c]);
+#endif
+    return block;
+}
+
+/**
+ * Give back a block to its page, the page to the free ones when it's empty
+ * @param data pointer to a block in the class area
+ * @return the size of the block
+ */
+static size_t class_free(void * data)
+{
+    uint16_t p = (uint16_t)(((uint8_t *)data - class_area) / LV_MEM_CLASS_PAGE_SIZE);
+    mem_page_t * page = &pages[p];
+    uint8_t c = page->class_id;
+    size_t block_size = class_size[c];
+
+#if LV_MEM_ADD_JUNK
+    lv_memset(data, 0xbb, block_size);
+#endif
+
+    /*Was full, it has a free block again*/
+    if(page->free_head == NULL) page_list_add(&partial_pages[c], p);
+    *(void **)data = page->free_head;
+    page->free_head = data;
+    page->used--;
+    class_mon[c].used_cnt--;
+
+    /*Keep the last page of the class, there would be a page to set up on the next allocation*/
+    if(page->used == 0 && (partial_pages[c] != p || page->next != PAGE_NONE)) {
+        page_list_remove(&partial_pages[c], p);
+        page->class_id = CLASS_NUM;
+        page_list_add(&free_pages, p);
+        class_mon[c].page_cnt--;
+    }
+
+    return block_size;
+}
+
+/**
+ * Resize a block of a class. It stays if the new size is of the same class, else it moves.
+ * @param data pointer to a block in the class area
+ * @param new_size the new size
+ * @return pointer to the block, NULL if no memory (`data` is kept then)
+ */
+static void * class_realloc(void * data, size_t new_size)
+{
+    uint16_t p = (uint16_t)(((uint8_t *)data - class_area) / LV_MEM_CLASS_PAGE_SIZE);
+    uint8_t c = pages[p].class_id;
+    if(new_size <= CLASS_MAX_SIZE && class_of_size[(new_size + 15) >> 4] == c) return data;
+
+    void * new_p = lv_mem_alloc(new_size);
+    if(new_p == NULL) return NULL;
+    lv_memcpy(new_p, data, LV_MIN(new_size, class_size[c]));
+    lv_mem_free(data);
+    return new_p;
+}
+
+static inline bool in_class_area(const void * p)
+{
+    return class_area && (const uint8_t *)p >= class_area &&
+           (const uint8_t *)p < class_area + CLASS_PAGE_NUM * LV_MEM_CLASS_PAGE_SIZE;
+}
+
+/**
+ * Split a free page into blocks of a class
+ * @param class_id the class
+ * @return the page, already on the class's list, PAGE_NONE if there was no free page
+ */
+static uint16_t page_take(uint8_t class_id)
+{
+    uint16_t p = free_pages;
+    if(p == PAGE_NONE) return PAGE_NONE;
+    page_list_remove(&free_pages, p);
+
+    mem_page_t * page = &pages[p];
+    uint8_t * first = class_area + (uint32_t)p * LV_MEM_CLASS_PAGE_SIZE;
+    uint32_t block_size = class_size[class_id];
+    uint32_t block_cnt = LV_MEM_CLASS_PAGE_SIZE / block_size;
+    uint32_t i;
+    for(i = 0; i < block_cnt - 1; i++) {
+        *(void **)(first + i * block_size) = first + (i + 1) * block_size;
+    }
+    *(void **)(first + i * block_size) = NULL;
+
+    page->free_head = first;
+    page->used = 0;
+    page->class_id = class_id;
+    page_list_add(&partial_pages[class_id], p);
+    class_mon[class_id].page_cnt++;
+    return p;
+}
+
+static void page_list_add(uint16_t * head, uint16_t page)
+{
+    pages[page].prev = PAGE_NONE;
+    pages[page].next = *head;
+    if(*head != PAGE_NONE) pages[*head].prev = page;
+    *head = page;
+}
+
+static void page_list_remove(uint16_t * head, uint16_t page)
+{
+    if(pages[page].prev != PAGE_NONE) pages[pages[page].prev].next = pages[page].next;
+    else *head = pages[page].next;
+    if(pages[page].next != PAGE_NONE) pages[pages[page].next].prev = pages[page].prev;
+}
+#endif
+
+#if MEM_FAST
+/**
+ * Resize a block of the fast pool, it moves to the main pool if the fast one is full
+ * @param data pointer to a block in the fast pool
+ * @param new_size the new size
+ * @return pointer to the block, NULL if no memory (`data` is kept then)
+ */
+static void * fast_realloc(void * data, size_t new_size)
+{
+    size_t old_size = lv_tlsf_block_size(data);
+    void * new_p = lv_tlsf_realloc(tlsf_fast, data, new_size);
+    if(new_p) {
+        fast_cur_used = fast_cur_used + lv_tlsf_block_size(new_p) - LV_MIN(old_size, fast_cur_used);
+        fast_max_used = LV_MAX(fast_cur_used, fast_max_used);
+        return new_p;
+    }
+
+    new_p = lv_mem_alloc(new_size);
+    if(new_p == NULL) return NULL;
+    lv_memcpy(new_p, data, LV_MIN(old_size, new_size));
+    lv_mem_free(data);
+    return new_p;
+}
+
+static inline bool in_fast_pool(const void * p)
+{
+    return fast_mem && (const uint8_t *)p >= fast_mem && (const uint8_t *)p < fast_mem + LV_MEM_FAST_SIZE;
+}
 #endif
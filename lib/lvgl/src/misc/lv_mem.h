@@ -43,6 +43,18 @@ typedef struct {
     uint8_t frag_pct; /**< Amount of fragmentation*/
 } lv_mem_monitor_t;
 
+/**
+ * Usage of a size class, see `LV_MEM_CLASSES`
+ */
+typedef struct {
+    uint16_t block_size;   /**< Size of the blocks of the class*/
+    uint16_t page_cnt;     /**< Pages the class holds*/
+    uint32_t used_cnt;     /**< Blocks in use*/
+    uint32_t max_used_cnt; /**< Most blocks in use at once*/
+    uint32_t alloc_cnt;    /**< Allocations served from the class*/
+    uint32_t fallback_cnt; /**< Allocations of the class's sizes that went to the heap, no page was free*/
+} lv_mem_class_monitor_t;
+
 typedef struct {
     void * p;
     uint16_t size;
@@ -73,6 +85,14 @@ void lv_mem_deinit(void);
  */
 void * lv_mem_alloc(size_t size);
 
+/**
+ * Allocate memory for a buffer the renderer works in (e.g. a layer), from the fast pool if
+ * `LV_MEM_FAST_SIZE` is set. Falls back to `lv_mem_alloc()` if it's full. Free it with `lv_mem_free()`.
+ * @param size size of the memory to allocate in bytes
+ * @return pointer to the allocated memory
+ */
+void * lv_mem_alloc_fast(size_t size);
+
 /**
  * Free an allocated data
  * @param data pointer to an allocated memory
@@ -101,6 +121,25 @@ lv_res_t lv_mem_test(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+/**
+ * Give information about the fast pool of `lv_mem_alloc_fast()`
+ * @param mon_p pointer to a lv_mem_monitor_t variable, all 0 if there is no fast pool
+ */
+void lv_mem_fast_monitor(lv_mem_monitor_t * mon_p);
+
+/**
+ * Get the number of size classes
+ * @return the number of classes, 0 if `LV_MEM_CLASSES` is disabled
+ */
+uint32_t lv_mem_class_count(void);
+
+/**
+ * Give information about a size class
+ * @param class_id index of the class, smaller blocks first [0..lv_mem_class_count() - 1]
+ * @param mon_p pointer to a lv_mem_class_monitor_t variable
+ */
+void lv_mem_class_monitor(uint32_t class_id, lv_mem_class_monitor_t * mon_p);
+
 
 /**
  * Get a temporal buffer with the given size.
@@ -132,6 +132,10 @@ const uint8_t _lv_style_builtin_prop_flag_lookup_table[_LV_STYLE_NUM_BUILT_IN_PR
 
 uint32_t _lv_style_custom_prop_flag_lookup_table_size = 0;
 
+#if LV_OBJ_STYLE_CACHE
+uint32_t _lv_style_gen;
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -170,6 +174,10 @@ void lv_style_reset(lv_style_t * style)
         return;
     }
 
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;
+#endif
+
     if(style->prop_cnt > 1) lv_mem_free(style->v_p.values_and_props);
     lv_memset_00(style, sizeof(lv_style_t));
 #if LV_USE_ASSERT_STYLE
@@ -227,6 +235,10 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_prop_t prop)
         return false;
     }
 
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;
+#endif
+
     if(style->prop_cnt == 0)  return false;
 
     if(style->prop_cnt == 1) {
@@ -420,6 +432,10 @@ static void lv_style_set_prop_internal(lv_style_t * style, lv_style_prop_t prop_
         return;
     }
 
+#if LV_OBJ_STYLE_CACHE
+    _lv_style_gen++;
+#endif
+
     lv_style_prop_t prop_id = LV_STYLE_PROP_ID_MASK(prop_and_meta);
 
     if(style->prop_cnt > 1) {
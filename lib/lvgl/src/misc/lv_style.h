@@ -338,6 +338,13 @@ typedef struct {
  * GLOBAL PROTOTYPES
  **********************/
 
+#if LV_OBJ_STYLE_CACHE
+/**
+ * Stepped on every change of a style and of the styles of an object.
+ * Style properties resolved in an earlier generation have to be resolved again.
+ */
+extern uint32_t _lv_style_gen;
+#endif
 
 /**
  * Initialize a style
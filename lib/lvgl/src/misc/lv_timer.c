@@ -17,6 +17,7 @@
  *********************/
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PERIOD 500
+#define NOT_QUEUED UINT32_MAX /*`heap_index` of a paused timer*/
 
 /**********************
  *      TYPEDEFS
@@ -25,16 +26,23 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_timer_exec(lv_timer_t * timer);
+static void lv_timer_exec(lv_timer_t * timer);
 static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static bool heap_earlier(const lv_timer_t * a, const lv_timer_t * b);
+static bool heap_insert(lv_timer_t * timer);
+static void heap_remove(lv_timer_t * timer);
+static void heap_update(lv_timer_t * timer);
+static void heap_sift_up(uint32_t i);
+static void heap_sift_down(uint32_t i);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
-static bool timer_deleted;
-static bool timer_created;
+static uint32_t heap_size;
+static uint32_t heap_cap;
+static uint32_t handler_cnt; /*lv_timer_handler() calls, see `lv_timer_t::run_id`*/
 
 /**********************
  *      MACROS
@@ -55,6 +63,9 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    LV_GC_ROOT(_lv_timer_heap) = NULL;
+    heap_size = 0;
+    heap_cap = 0;
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,41 +106,18 @@ LV_ATTRIBUTE_TIMER_HANDLER uint32_t lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
-
-    uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
-
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
+    /*Run the due timers, earliest deadline first. The heap is kept up to date by every
+     *change, so timers created or deleted by the callbacks need no special care.
+     *A timer runs once per call: one that is due again right away (period 0) stops the loop.*/
+    handler_cnt++;
+    while(heap_size > 0) {
+        lv_timer_t * timer = LV_GC_ROOT(_lv_timer_heap)[0];
+        if(timer->run_id == handler_cnt || lv_timer_time_remaining(timer) > 0) break;
+        lv_timer_exec(timer);
     }
 
+    uint32_t time_till_next = lv_timer_get_time_until_next();
+
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
     if(idle_period_time >= IDLE_MEAS_PERIOD) {
@@ -178,8 +166,14 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
+    new_timer->heap_index = NOT_QUEUED;
+    new_timer->run_id = handler_cnt - 1;
 
-    timer_created = true;
+    if(!heap_insert(new_timer)) {
+        _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), new_timer);
+        lv_mem_free(new_timer);
+        return NULL;
+    }
 
     return new_timer;
 }
@@ -201,7 +195,9 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
 void lv_timer_del(lv_timer_t * timer)
 {
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
-    timer_deleted = true;
+    heap_remove(timer);
+    /*Tell lv_timer_exec() the timer is gone if it deleted itself*/
+    if(LV_GC_ROOT(_lv_timer_act) == timer) LV_GC_ROOT(_lv_timer_act) = NULL;
 
     lv_mem_free(timer);
 }
@@ -213,10 +209,12 @@ void lv_timer_del(lv_timer_t * timer)
 void lv_timer_pause(lv_timer_t * timer)
 {
     timer->paused = true;
+    heap_remove(timer);
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
+    if(timer->paused && !heap_insert(timer)) return;
     timer->paused = false;
 }
 
@@ -228,6 +226,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    heap_update(timer);
 }
 
 /**
@@ -237,6 +236,7 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 void lv_timer_ready(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get() - timer->period - 1;
+    heap_update(timer);
 }
 
 /**
@@ -247,6 +247,8 @@ void lv_timer_ready(lv_timer_t * timer)
 void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 {
     timer->repeat_count = repeat_count;
+    /*Deleted by the next lv_timer_handler(), without calling it*/
+    if(repeat_count == 0) lv_timer_ready(timer);
 }
 
 /**
@@ -257,6 +259,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    heap_update(timer);
 }
 
 /**
@@ -268,6 +271,16 @@ void lv_timer_enable(bool en)
     lv_timer_run = en;
 }
 
+/**
+ * Get the time until the next timer has to run
+ * @return the time in ms, 0 if a timer is due, `LV_NO_TIMER_READY` if all timers are paused
+ */
+uint32_t lv_timer_get_time_until_next(void)
+{
+    if(heap_size == 0) return LV_NO_TIMER_READY;
+    return lv_timer_time_remaining(LV_GC_ROOT(_lv_timer_heap)[0]);
+}
+
 /**
  * Get idle percentage
  * @return the lv_timer idle in percentage
@@ -293,37 +306,31 @@ lv_timer_t * lv_timer_get_next(lv_timer_t * timer)
  **********************/
 
 /**
- * Execute timer if its remaining time is zero
- * @param timer pointer to lv_timer
- * @return true: execute, false: not executed
+ * Execute a due timer, and delete it if its repeat count is over
+ * @param timer pointer to lv_timer, the first one in the heap
  */
-static bool lv_timer_exec(lv_timer_t * timer)
+static void lv_timer_exec(lv_timer_t * timer)
 {
-    if(timer->paused) return false;
-
-    bool exec = false;
-    if(lv_timer_time_remaining(timer) == 0) {
-        /* Decrement the repeat count before executing the timer_cb.
-         * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
-         * but at least the repeat count is zero and the timer can be deleted in the next round*/
-        int32_t original_repeat_count = timer->repeat_count;
-        if(timer->repeat_count > 0) timer->repeat_count--;
-        timer->last_run = lv_tick_get();
-        TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
-        if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
-        TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
-        LV_ASSERT_MEM_INTEGRITY();
-        exec = true;
-    }
+    /*Decrement the repeat count before executing the timer_cb, the timer is deleted below after its last run*/
+    int32_t original_repeat_count = timer->repeat_count;
+    if(timer->repeat_count > 0) timer->repeat_count--;
+    timer->last_run = lv_tick_get();
+    timer->run_id = handler_cnt;
+    heap_update(timer); /*Its next deadline, before the callback changes the heap*/
+
+    LV_GC_ROOT(_lv_timer_act) = timer;
+    TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
+    if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
+    TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
+    LV_ASSERT_MEM_INTEGRITY();
 
-    if(timer_deleted == false) { /*The timer might be deleted by itself as well*/
+    if(LV_GC_ROOT(_lv_timer_act) == timer) { /*The timer might be deleted by itself as well*/
+        LV_GC_ROOT(_lv_timer_act) = NULL;
         if(timer->repeat_count == 0) { /*The repeat count is over, delete the timer*/
             TIMER_TRACE("deleting timer with %p callback because the repeat count is over", *((void **)&timer->timer_cb));
             lv_timer_del(timer);
         }
     }
-
-    return exec;
 }
 
 /**
@@ -339,3 +346,104 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
         return 0;
     return timer->period - elp;
 }
+
+/**
+ * Compare the next run of two timers. Overflow safe while they are less than 2^31 ms apart.
+ * On the same tick the one that didn't run in this lv_timer_handler() call yet comes first.
+ * @return true: `a` has to run before `b`
+ */
+static bool heap_earlier(const lv_timer_t * a, const lv_timer_t * b)
+{
+    int32_t diff = (int32_t)((a->last_run + a->period) - (b->last_run + b->period));
+    if(diff != 0) return diff < 0;
+    return a->run_id != handler_cnt && b->run_id == handler_cnt;
+}
+
+/**
+ * Add a timer to the heap of running timers, grow the heap if needed
+ * @param timer pointer to lv_timer, not in the heap yet
+ * @return false: out of memory
+ */
+static bool heap_insert(lv_timer_t * timer)
+{
+    if(timer->heap_index != NOT_QUEUED) return true;
+
+    if(heap_size == heap_cap) {
+        uint32_t new_cap = heap_cap ? heap_cap * 2 : 16;
+        lv_timer_t ** new_heap = lv_mem_realloc(LV_GC_ROOT(_lv_timer_heap), new_cap * sizeof(lv_timer_t *));
+        LV_ASSERT_MALLOC(new_heap);
+        if(new_heap == NULL) return false;
+        LV_GC_ROOT(_lv_timer_heap) = new_heap;
+        heap_cap = new_cap;
+    }
+
+    timer->heap_index = heap_size;
+    LV_GC_ROOT(_lv_timer_heap)[heap_size] = timer;
+    heap_size++;
+    heap_sift_up(timer->heap_index);
+    return true;
+}
+
+/**
+ * Remove a timer from the heap of running timers
+ * @param timer pointer to lv_timer, nothing happens if it's not in the heap
+ */
+static void heap_remove(lv_timer_t * timer)
+{
+    uint32_t i = timer->heap_index;
+    if(i == NOT_QUEUED) return;
+
+    timer->heap_index = NOT_QUEUED;
+    heap_size--;
+    if(i == heap_size) return;
+
+    /*The last one takes its place, and moves up or down from there*/
+    lv_timer_t * last = LV_GC_ROOT(_lv_timer_heap)[heap_size];
+    LV_GC_ROOT(_lv_timer_heap)[i] = last;
+    last->heap_index = i;
+    heap_sift_up(i);
+    heap_sift_down(last->heap_index);
+}
+
+/**
+ * Move a timer to its place after its next run changed
+ * @param timer pointer to lv_timer, nothing happens if it's not in the heap
+ */
+static void heap_update(lv_timer_t * timer)
+{
+    if(timer->heap_index == NOT_QUEUED) return;
+    heap_sift_up(timer->heap_index);
+    heap_sift_down(timer->heap_index);
+}
+
+static void heap_sift_up(uint32_t i)
+{
+    lv_timer_t ** heap = LV_GC_ROOT(_lv_timer_heap);
+    lv_timer_t * timer = heap[i];
+    while(i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if(!heap_earlier(timer, heap[parent])) break;
+        heap[i] = heap[parent];
+        heap[i]->heap_index = i;
+        i = parent;
+    }
+    heap[i] = timer;
+    timer->heap_index = i;
+}
+
+static void heap_sift_down(uint32_t i)
+{
+    lv_timer_t ** heap = LV_GC_ROOT(_lv_timer_heap);
+    lv_timer_t * timer = heap[i];
+    while(true) {
+        uint32_t child = 2 * i + 1;
+        if(child >= heap_size) break;
+        if(child + 1 < heap_size && heap_earlier(heap[child + 1], heap[child])) child++;
+        if(!heap_earlier(heap[child], timer)) break;
+        heap[i] = heap[child];
+        heap[i]->heap_index = i;
+        i = child;
+    }
+    heap[i] = timer;
+    timer->heap_index = i;
+}
@@ -47,6 +47,8 @@ typedef struct _lv_timer_t {
     lv_timer_cb_t timer_cb; /**< Timer function*/
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
+    uint32_t heap_index; /**< Position in the heap of running timers, `UINT32_MAX` while paused*/
+    uint32_t run_id; /**< The lv_timer_handler() call it last ran in*/
     uint32_t paused : 1;
 } lv_timer_t;
 
@@ -159,6 +161,13 @@ void lv_timer_reset(lv_timer_t * timer);
  */
 void lv_timer_enable(bool en);
 
+/**
+ * Get the time until the next timer has to run. Unlike the return value of `lv_timer_handler()`,
+ * it stays right when timers are created, resumed or made ready after the handler returned.
+ * @return the time in ms, 0 if a timer is due, `LV_NO_TIMER_READY` if all timers are paused
+ */
+uint32_t lv_timer_get_time_until_next(void);
+
 /**
  * Get idle percentage
  * @return the lv_timer idle in percentage
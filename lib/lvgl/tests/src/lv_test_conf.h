@@ -30,6 +30,10 @@ void lv_test_assert_fail(void);
 uint32_t custom_tick_get(void);
 #define LV_TICK_CUSTOM_SYS_TIME_EXPR custom_tick_get()
 
+/*Manual clock of the frame profiler, see lv_test_prof_time_set()*/
+uint32_t lv_test_prof_time_get(void);
+#define LV_REFR_PROFILER_TIME_EXPR lv_test_prof_time_get()
+
 typedef void * lv_user_data_t;
 
 /**********************
@@ -1,6 +1,10 @@
 #ifndef LV_TEST_HELPERS_H
 #define LV_TEST_HELPERS_H
 
+#include <stdarg.h>
+#include <time.h>
+#include "unity/unity.h"
+
 #ifdef LVGL_CI_USING_SYS_HEAP
 /* Skip checking heap as we don't have the info available */
 #define LV_HEAP_CHECK(x) do {} while(0)
@@ -17,6 +21,27 @@ static inline uint32_t lv_test_get_free_mem(void)
 }
 #endif /* LVGL_CI_USING_SYS_HEAP */
 
+/* Time per run in ns of `cnt` runs of a benchmark started at `begin = clock()`.
+ * Less than a clock tick counts as one tick, so the result is never 0 */
+static inline double lv_test_bench_ns(clock_t begin, uint32_t cnt)
+{
+    clock_t elapsed = clock() - begin;
+    if(elapsed < 1) elapsed = 1;
+    return (double)elapsed * 1000000000.0 / CLOCKS_PER_SEC / cnt;
+}
+
+/* Print the result of a benchmark with the test's name, formatted as `lv_snprintf()` */
+static inline void lv_test_bench_report(const char * fmt, ...) LV_FORMAT_ATTRIBUTE(1, 2);
+static inline void lv_test_bench_report(const char * fmt, ...)
+{
+    char msg[160];
+    va_list va;
+    va_start(va, fmt);
+    lv_vsnprintf(msg, sizeof(msg), fmt, va);
+    va_end(va);
+    TEST_MESSAGE(msg);
+}
+
 
 #endif /*LV_TEST_HELPERS_H*/
 
@@ -92,6 +92,23 @@ uint32_t custom_tick_get(void)
     return time_ms;
 }
 
+static uint32_t prof_time_us;
+
+uint32_t lv_test_prof_time_get(void)
+{
+    return prof_time_us;
+}
+
+void lv_test_prof_time_set(uint32_t us)
+{
+    prof_time_us = us;
+}
+
+void lv_test_prof_time_advance(uint32_t us)
+{
+    prof_time_us += us;
+}
+
 void lv_test_assert_fail(void)
 {
     TEST_FAIL();
@@ -11,6 +11,8 @@ extern "C" {
 
 void lv_test_init(void);
 void lv_test_deinit(void);
+void lv_test_prof_time_set(uint32_t us);
+void lv_test_prof_time_advance(uint32_t us);
 
 #ifdef __cplusplus
 } /*extern "C"*/
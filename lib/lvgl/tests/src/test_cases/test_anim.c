@@ -0,0 +1,351 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#define BENCH_ROUNDS    10000
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t applied_x;
+    int32_t applied_y;
+    uint32_t batch_cnt;
+} point_t;
+
+static uint32_t ready_cnt;
+static uint32_t style_changed_cnt;
+static point_t * ready_check;
+static lv_anim_t * del_in_ready;
+static int32_t restarted;
+
+static void set_x_cb(void * var, int32_t v)
+{
+    ((point_t *)var)->x = v;
+}
+
+static void set_y_cb(void * var, int32_t v)
+{
+    ((point_t *)var)->y = v;
+}
+
+static void apply_cb(void * var)
+{
+    point_t * p = var;
+    p->applied_x = p->x;
+    p->applied_y = p->y;
+    p->batch_cnt++;
+}
+
+static void set_int_cb(void * var, int32_t v)
+{
+    *(int32_t *)var = v;
+}
+
+static void ready_cb(lv_anim_t * a)
+{
+    LV_UNUSED(a);
+    ready_cnt++;
+    /*The last values are applied before the animation ends*/
+    if(ready_check) {
+        TEST_ASSERT_EQUAL_INT32(ready_check->x, ready_check->applied_x);
+        TEST_ASSERT_EQUAL_INT32(ready_check->y, ready_check->applied_y);
+    }
+}
+
+static void del_other_cb(lv_anim_t * a)
+{
+    ready_cb(a);
+    if(del_in_ready) lv_anim_del(del_in_ready->var, NULL);
+    del_in_ready = NULL;
+
+    lv_anim_t b;
+    lv_anim_init(&b);
+    lv_anim_set_var(&b, &restarted);
+    lv_anim_set_exec_cb(&b, set_int_cb);
+    lv_anim_set_values(&b, 0, 1024);
+    lv_anim_set_time(&b, 64);
+    lv_anim_set_ready_cb(&b, ready_cb);
+    lv_anim_start(&b);
+}
+
+static void del_other_on_delete_cb(lv_anim_t * a)
+{
+    LV_UNUSED(a);
+    lv_anim_t * other = del_in_ready;
+    del_in_ready = NULL;
+    if(other) lv_anim_del(other->var, NULL);
+}
+
+static void style_changed_event_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    style_changed_cnt++;
+}
+
+void setUp(void)
+{
+    ready_cnt = 0;
+    style_changed_cnt = 0;
+    ready_check = NULL;
+    del_in_ready = NULL;
+    restarted = 0;
+}
+
+void tearDown(void)
+{
+    lv_anim_del_all();
+    lv_obj_clean(lv_scr_act());
+}
+
+static void step(uint32_t ms)
+{
+    lv_tick_inc(ms);
+    lv_anim_refr_now();
+}
+
+static lv_anim_t * start(void * var, lv_anim_exec_xcb_t exec_cb, int32_t from, int32_t to, uint32_t time,
+                         lv_anim_path_cb_t path_cb)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, var);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_values(&a, from, to);
+    lv_anim_set_time(&a, time);
+    lv_anim_set_path_cb(&a, path_cb);
+    return lv_anim_start(&a);
+}
+
+static const struct {
+    lv_anim_path_cb_t path_cb;
+    uint32_t u1;
+    uint32_t u2;
+} paths[] = {
+    {lv_anim_path_ease_in, 50, 100},
+    {lv_anim_path_ease_out, 900, 950},
+    {lv_anim_path_ease_in_out, 50, 952},
+    {lv_anim_path_overshoot, 1000, 1300},
+};
+
+/*The curve from 0 to LV_BEZIER_VAL_MAX without `lv_bezier3()`'s truncation*/
+static double bezier3(int32_t t, uint32_t u1, uint32_t u2)
+{
+    double x = (double)t / LV_BEZIER_VAL_MAX;
+    double r = 1 - x;
+    return 3 * r * r * x * u1 + 3 * r * x * x * u2 + x * x * x * LV_BEZIER_VAL_MAX;
+}
+
+void test_anim_paths_follow_the_bezier_curves(void)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_values(&a, 0, LV_BEZIER_VAL_MAX);
+    lv_anim_set_time(&a, LV_BEZIER_VAL_MAX);
+
+    uint32_t p;
+    for(p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        int32_t t;
+        for(t = 0; t <= LV_BEZIER_VAL_MAX; t++) {
+            a.act_time = t;
+            /*The tables are rounded at every 4th step and interpolated in between*/
+            TEST_ASSERT_INT32_WITHIN(1, (int32_t)(bezier3(t, paths[p].u1, paths[p].u2) + 0.5), paths[p].path_cb(&a));
+        }
+        a.act_time = 0;
+        TEST_ASSERT_EQUAL_INT32(0, paths[p].path_cb(&a));
+        a.act_time = LV_BEZIER_VAL_MAX;
+        TEST_ASSERT_EQUAL_INT32(LV_BEZIER_VAL_MAX, paths[p].path_cb(&a));
+    }
+
+    /*Scaled to the range of the animation*/
+    lv_anim_set_values(&a, 100, -300);
+    lv_anim_set_time(&a, 800);
+    a.act_time = 400;
+    int32_t expected = 100 + (int32_t)(bezier3(512, 900, 950) * -400 / LV_BEZIER_VAL_MAX);
+    TEST_ASSERT_INT32_WITHIN(2, expected, lv_anim_path_ease_out(&a));
+}
+
+void test_anim_paths_never_step_back(void)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_values(&a, 0, LV_BEZIER_VAL_MAX);
+    lv_anim_set_time(&a, LV_BEZIER_VAL_MAX);
+
+    uint32_t p;
+    for(p = 0; p < sizeof(paths) / sizeof(paths[0]); p++) {
+        /*The overshoot goes back once, after its peak*/
+        bool past_peak = false;
+        int32_t prev = 0;
+        int32_t t;
+        for(t = 0; t <= LV_BEZIER_VAL_MAX; t++) {
+            a.act_time = t;
+            int32_t v = paths[p].path_cb(&a);
+            if(v < prev) {
+                TEST_ASSERT_TRUE(paths[p].path_cb == lv_anim_path_overshoot);
+                past_peak = true;
+            }
+            else if(past_peak) {
+                TEST_ASSERT_EQUAL_INT32(prev, v);
+            }
+            prev = v;
+        }
+    }
+}
+
+void test_anim_batch_cb_once_per_round(void)
+{
+    static point_t p1;
+    static point_t p2;
+    lv_memset_00(&p1, sizeof(p1));
+    lv_memset_00(&p2, sizeof(p2));
+
+    /*`p1`'s animations are started apart, they are still handled together*/
+    lv_anim_t * ax = start(&p1, set_x_cb, 0, 100, 100, lv_anim_path_linear);
+    lv_anim_set_batch_cb(ax, apply_cb);
+    lv_anim_t * a2 = start(&p2, set_x_cb, 0, 50, 50, lv_anim_path_linear);
+    lv_anim_set_batch_cb(a2, apply_cb);
+    lv_anim_t * ay = start(&p1, set_y_cb, 0, 200, 100, lv_anim_path_ease_out);
+    lv_anim_set_batch_cb(ay, apply_cb);
+    lv_anim_set_ready_cb(ay, ready_cb);
+    ready_check = &p1;
+
+    uint32_t i;
+    for(i = 1; i <= 10; i++) {
+        step(10);
+        TEST_ASSERT_EQUAL_UINT32(i, p1.batch_cnt);
+        TEST_ASSERT_EQUAL_INT32(p1.x, p1.applied_x);
+        TEST_ASSERT_EQUAL_INT32(p1.y, p1.applied_y);
+    }
+    TEST_ASSERT_EQUAL_INT32(100, p1.applied_x);
+    TEST_ASSERT_EQUAL_INT32(200, p1.applied_y);
+    TEST_ASSERT_EQUAL_UINT32(1, ready_cnt);
+    TEST_ASSERT_EQUAL_UINT32(5, p2.batch_cnt);
+    TEST_ASSERT_EQUAL_INT32(50, p2.applied_x);
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+
+    /*Not called when no value changed*/
+    lv_anim_t * still = start(&p2, set_x_cb, 50, 50, 100, lv_anim_path_linear);
+    lv_anim_set_batch_cb(still, apply_cb);
+    step(10);
+    TEST_ASSERT_EQUAL_UINT32(5, p2.batch_cnt);
+}
+
+void test_anim_callbacks_change_the_animations(void)
+{
+    static int32_t a_val;
+    static int32_t b_val;
+    static int32_t c_val;
+
+    lv_anim_t * a = start(&a_val, set_int_cb, 0, 1024, 16, lv_anim_path_linear);
+    lv_anim_t * b = start(&b_val, set_int_cb, 0, 1024, 64, lv_anim_path_linear);
+    start(&c_val, set_int_cb, 0, 1024, 64, lv_anim_path_linear);
+    lv_anim_set_ready_cb(a, del_other_cb);
+    del_in_ready = b;
+    TEST_ASSERT_EQUAL_UINT16(3, lv_anim_count_running());
+
+    /*`a` ends, deletes `b` and starts a new one*/
+    step(16);
+    TEST_ASSERT_EQUAL_UINT32(1, ready_cnt);
+    TEST_ASSERT_NULL(lv_anim_get(&b_val, NULL));
+    TEST_ASSERT_EQUAL_INT32(0, b_val);
+    TEST_ASSERT_EQUAL_INT32(256, c_val);
+    TEST_ASSERT_EQUAL_INT32(0, restarted);
+    TEST_ASSERT_EQUAL_UINT16(2, lv_anim_count_running());
+
+    /*Everything else was stepped once*/
+    step(16);
+    TEST_ASSERT_EQUAL_INT32(512, c_val);
+    TEST_ASSERT_EQUAL_INT32(256, restarted);
+
+    step(64);
+    TEST_ASSERT_EQUAL_INT32(1024, c_val);
+    TEST_ASSERT_EQUAL_INT32(1024, restarted);
+    TEST_ASSERT_EQUAL_UINT32(2, ready_cnt);
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+}
+
+void test_anim_del_removes_every_match(void)
+{
+    static point_t p[4];
+    lv_memset_00(p, sizeof(p));
+    uint32_t i;
+    for(i = 0; i < 4; i++) {
+        start(&p[i], set_x_cb, 0, 100, 100, lv_anim_path_linear);
+        start(&p[i], set_y_cb, 0, 100, 100, lv_anim_path_linear);
+    }
+
+    /*Every x, the ys stay*/
+    TEST_ASSERT_TRUE(lv_anim_del(NULL, set_x_cb));
+    TEST_ASSERT_EQUAL_UINT16(4, lv_anim_count_running());
+    for(i = 0; i < 4; i++) TEST_ASSERT_NOT_NULL(lv_anim_get(&p[i], set_y_cb));
+
+    /*A `deleted_cb` deleting one before, the next match moves back past the loop*/
+    lv_anim_del_all();
+    del_in_ready = start(&p[0], set_x_cb, 0, 100, 100, lv_anim_path_linear);
+    lv_anim_t * a = start(&p[0], set_y_cb, 0, 100, 100, lv_anim_path_linear);
+    lv_anim_set_deleted_cb(a, del_other_on_delete_cb);
+    start(&p[1], set_y_cb, 0, 100, 100, lv_anim_path_linear);
+    TEST_ASSERT_TRUE(lv_anim_del(NULL, set_y_cb));
+    TEST_ASSERT_EQUAL_UINT16(0, lv_anim_count_running());
+}
+
+void test_anim_set_pos_refreshes_once(void)
+{
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_add_event_cb(obj, style_changed_event_cb, LV_EVENT_STYLE_CHANGED, NULL);
+
+    lv_obj_set_pos(obj, 10, 20);
+    TEST_ASSERT_EQUAL_UINT32(1, style_changed_cnt);
+    lv_obj_set_pos(obj, 10, 30);
+    TEST_ASSERT_EQUAL_UINT32(2, style_changed_cnt);
+    lv_obj_set_pos(obj, 10, 30);
+    TEST_ASSERT_EQUAL_UINT32(2, style_changed_cnt);
+
+    lv_obj_update_layout(obj);
+    TEST_ASSERT_EQUAL_INT32(10, lv_obj_get_x(obj));
+    TEST_ASSERT_EQUAL_INT32(30, lv_obj_get_y(obj));
+
+    /*Refreshing stays disabled if it was*/
+    lv_obj_enable_style_refresh(false);
+    lv_obj_set_pos(obj, 40, 50);
+    TEST_ASSERT_FALSE(lv_obj_is_style_refresh_enabled());
+    lv_obj_enable_style_refresh(true);
+    TEST_ASSERT_EQUAL_UINT32(2, style_changed_cnt);
+}
+
+static void bench(uint32_t cnt)
+{
+    static int32_t vals[100];
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vals[i]);
+        lv_anim_set_exec_cb(&a, set_int_cb);
+        lv_anim_set_values(&a, 0, 240);
+        lv_anim_set_time(&a, 500 + i);
+        lv_anim_set_playback_time(&a, 500 + i);
+        lv_anim_set_repeat_count(&a, LV_ANIM_REPEAT_INFINITE);
+        lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
+        TEST_ASSERT_NOT_NULL(lv_anim_start(&a));
+    }
+
+    clock_t begin = clock();
+    for(i = 0; i < BENCH_ROUNDS; i++) step(1);
+    double ns = lv_test_bench_ns(begin, BENCH_ROUNDS);
+
+    TEST_ASSERT_EQUAL_UINT16(cnt, lv_anim_count_running());
+    lv_test_bench_report("%d animations: %d ns per round", (int)cnt, (int)ns);
+    lv_anim_del_all();
+}
+
+void test_anim_bench(void)
+{
+    bench(1);
+    bench(10);
+    bench(100);
+}
+
+#endif
@@ -0,0 +1,101 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+extern lv_color_t test_fb[];
+
+static lv_disp_row_span_t spans[480];
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    lv_disp_get_default()->driver->row_spans = NULL;
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_row_spans_circle(void)
+{
+    lv_disp_row_span_t s[240];
+    lv_disp_row_spans_init_circle(s, 240, 240);
+
+    /*Widest in the middle, narrow on the top and bottom*/
+    TEST_ASSERT_EQUAL(0, s[119].x1);
+    TEST_ASSERT_EQUAL(239, s[119].x2);
+    TEST_ASSERT_GREATER_THAN(100, s[0].x1);
+    TEST_ASSERT_LESS_THAN(140, s[0].x2);
+
+    /*Symmetric in both directions*/
+    uint32_t y;
+    for(y = 0; y < 240; y++) {
+        TEST_ASSERT_EQUAL(239 - s[y].x2, s[y].x1);
+        TEST_ASSERT_EQUAL(s[239 - y].x1, s[y].x1);
+    }
+}
+
+void test_row_spans_clip(void)
+{
+    lv_disp_drv_t drv;
+    lv_disp_drv_init(&drv);
+    lv_disp_row_span_t s[240];
+    lv_disp_row_spans_init_circle(s, 240, 240);
+
+    /*Rectangular display: nothing changes*/
+    lv_area_t a = {0, 0, 239, 239};
+    TEST_ASSERT_TRUE(lv_disp_drv_clip_to_row_spans(&drv, &a));
+    TEST_ASSERT_EQUAL(0, a.x1);
+    TEST_ASSERT_EQUAL(239, a.y2);
+
+    drv.row_spans = s;
+
+    /*A corner is fully off-glass*/
+    lv_area_t corner = {0, 0, 20, 20};
+    TEST_ASSERT_FALSE(lv_disp_drv_clip_to_row_spans(&drv, &corner));
+
+    /*The top band is narrowed to the visible part*/
+    lv_area_t top = {0, 0, 239, 9};
+    TEST_ASSERT_TRUE(lv_disp_drv_clip_to_row_spans(&drv, &top));
+    TEST_ASSERT_EQUAL(s[9].x1, top.x1);
+    TEST_ASSERT_EQUAL(s[9].x2, top.x2);
+    TEST_ASSERT_EQUAL(0, top.y1);
+    TEST_ASSERT_EQUAL(9, top.y2);
+
+    /*The unseen rows are removed from the left edge*/
+    lv_area_t left = {0, 0, 9, 239};
+    TEST_ASSERT_TRUE(lv_disp_drv_clip_to_row_spans(&drv, &left));
+    TEST_ASSERT_GREATER_THAN(0, left.y1);
+    TEST_ASSERT_LESS_THAN(239, left.y2);
+}
+
+void test_row_spans_skip_render(void)
+{
+    /*Fill the draw buffer with a color that neither the screen nor the buffer starts with*/
+    lv_color_t sentinel = lv_color_hex(0x0000ff);
+    lv_obj_set_style_bg_color(lv_scr_act(), sentinel, 0);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_COLOR(sentinel, test_fb[0]);
+
+    lv_disp_row_spans_init_circle(spans, 800, 480);
+    lv_disp_get_default()->driver->row_spans = spans;
+
+    lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0xff0000), 0);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+
+    /*Only the bounding box of the disc is flushed: x = 160..639*/
+    uint32_t stride = 480;
+
+    /*The middle is rendered*/
+    TEST_ASSERT_EQUAL_COLOR(lv_color_hex(0xff0000), test_fb[240 * stride + 240]);
+
+    /*The off-glass corners still have the previous content*/
+    TEST_ASSERT_EQUAL_COLOR(sentinel, test_fb[0]);
+    TEST_ASSERT_EQUAL_COLOR(sentinel, test_fb[479 * stride + 479]);
+}
+
+#endif
@@ -0,0 +1,142 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+static lv_obj_t * faded;
+static lv_obj_t * zoomed;
+
+void setUp(void)
+{
+    /*Layers without alpha, the screen of the tests has no transparency*/
+    faded = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(faded, 10, 10);
+    lv_obj_set_size(faded, 200, 100);
+    lv_obj_set_style_radius(faded, 0, 0);
+    lv_obj_set_style_opa(faded, LV_OPA_50, 0);
+
+    zoomed = lv_obj_create(lv_scr_act());
+    lv_obj_set_pos(zoomed, 300, 10);
+    lv_obj_set_size(zoomed, 80, 80);
+    lv_obj_set_style_radius(zoomed, 0, 0);
+    lv_obj_set_style_transform_zoom(zoomed, 200, 0);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_draw_sw_layer_pool_clear();
+}
+
+#if LV_LAYER_POOL_SIZE && LV_USE_REFR_PROFILER
+static lv_draw_sw_layer_pool_monitor_t pool_mon(void)
+{
+    lv_draw_sw_layer_pool_monitor_t mon;
+    lv_draw_sw_layer_pool_monitor(&mon);
+    return mon;
+}
+
+/*A frame with the zoom changing, so the transformed layer changes its size*/
+static void frame(uint32_t i)
+{
+    lv_obj_set_style_transform_zoom(zoomed, 128 + (i * 37) % 128, 0);
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+}
+#endif
+
+void test_draw_layer_pool_no_allocations_in_steady_state(void)
+{
+#if LV_LAYER_POOL_SIZE && LV_USE_REFR_PROFILER
+    uint32_t i;
+    for(i = 0; i < 20; i++) frame(i);
+    /*The layers are drawn one after the other, one buffer serves both*/
+    TEST_ASSERT_EQUAL_UINT32(1, pool_mon().buf_cnt);
+
+    lv_refr_prof_reset();
+    lv_draw_sw_layer_pool_monitor_t before = pool_mon();
+    for(i = 20; i < 70; i++) frame(i);
+    lv_draw_sw_layer_pool_monitor_t after = pool_mon();
+
+    const lv_refr_prof_count_stat_t * allocs = lv_refr_prof_get_count_stat(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    TEST_ASSERT_EQUAL_UINT32(50, allocs->frames);
+    TEST_ASSERT_EQUAL_UINT32(0, allocs->sum);
+    TEST_ASSERT_EQUAL_UINT32(before.alloc_cnt, after.alloc_cnt);
+    TEST_ASSERT_EQUAL_UINT32(before.reuse_cnt + 100, after.reuse_cnt);
+#endif
+}
+
+void test_draw_layer_pool_clear_frees_everything(void)
+{
+#if LV_LAYER_POOL_SIZE && LV_USE_REFR_PROFILER
+    frame(0);
+    _lv_draw_layer_ctx_pool_clear();
+    lv_draw_sw_layer_pool_clear();
+    TEST_ASSERT_EQUAL_UINT32(0, pool_mon().buf_cnt);
+
+    /*A context and a buffer again, shared by the two layers*/
+    lv_refr_prof_reset();
+    frame(1);
+    TEST_ASSERT_EQUAL_UINT32(2, lv_refr_prof_get_count_stat(LV_REFR_PROF_CNT_LAYER_ALLOC)->sum);
+#endif
+}
+
+void test_draw_layer_pool_cleared_with_the_last_context(void)
+{
+#if LV_LAYER_POOL_SIZE && LV_USE_REFR_PROFILER
+    frame(0);
+    TEST_ASSERT_EQUAL_UINT32(1, pool_mon().buf_cnt);
+
+    /*A short-lived context, like a canvas makes: the display still draws layers*/
+    lv_draw_sw_ctx_t tmp_ctx;
+    lv_draw_sw_init_ctx(NULL, &tmp_ctx.base_draw);
+    lv_draw_sw_deinit_ctx(NULL, &tmp_ctx.base_draw);
+    TEST_ASSERT_EQUAL_UINT32(1, pool_mon().buf_cnt);
+
+    /*The display's own one, as `lv_deinit()` does it*/
+    lv_disp_drv_t * drv = lv_disp_get_default()->driver;
+    drv->draw_ctx_deinit(drv, drv->draw_ctx);
+    TEST_ASSERT_EQUAL_UINT32(0, pool_mon().buf_cnt);
+    drv->draw_ctx_init(drv, drv->draw_ctx);
+#endif
+}
+
+void test_draw_layer_pool_stays_in_budget(void)
+{
+#if LV_LAYER_POOL_SIZE && LV_USE_REFR_PROFILER
+    /*A transformed layer larger than the budget gets a buffer of its own every frame*/
+    lv_obj_set_size(zoomed, 300, 300);
+    lv_draw_sw_layer_pool_monitor_t before = pool_mon();
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        frame(i);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_LAYER_POOL_SIZE, pool_mon().size);
+    }
+    lv_draw_sw_layer_pool_monitor_t after = pool_mon();
+    TEST_ASSERT_EQUAL_UINT32(before.unpooled_cnt + 10, after.unpooled_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_LAYER_POOL_SIZE, after.max_size);
+
+    /*The smaller one is still served from the pool*/
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(before.reuse_cnt + 9, after.reuse_cnt);
+
+    /*Many layers at once: the budget holds*/
+    lv_obj_set_size(zoomed, 80, 80);
+    lv_obj_t * objs[6];
+    for(i = 0; i < 6; i++) {
+        objs[i] = lv_obj_create(lv_scr_act());
+        lv_obj_set_pos(objs[i], 10 + i * 120, 200);
+        lv_obj_set_size(objs[i], 110, 110);
+        lv_obj_set_style_radius(objs[i], 0, 0);
+        lv_obj_set_style_opa(objs[i], LV_OPA_70, 0);
+    }
+    for(i = 0; i < 10; i++) frame(i);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_LAYER_POOL_BUF_CNT, pool_mon().buf_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_LAYER_POOL_SIZE, pool_mon().max_size);
+
+    lv_draw_sw_layer_pool_clear();
+    TEST_ASSERT_EQUAL_UINT32(0, pool_mon().size);
+    TEST_ASSERT_EQUAL_UINT32(0, pool_mon().buf_cnt);
+#endif
+}
+
+#endif
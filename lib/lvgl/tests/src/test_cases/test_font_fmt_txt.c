@@ -0,0 +1,524 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+#include <string.h>
+
+#define BENCH_FRAMES    200
+#define BENCH_LAYOUTS   2000
+#define BENCH_CORPUS_KB 256
+
+static const char * text =
+    "The quick brown fox jumps over the lazy dog while the five boxing wizards jump quickly. "
+    "Ask again later, reply hazy, try again. Signs point to yes, outlook good, it is certain. "
+    "Don't count on it, my sources say no, very doubtful. Concentrate and ask again! "
+    "Without a doubt: 0123456789.";
+
+/*English prose for the kerning benchmark, measured over and over: the start of the first chapter of
+ *Alice's Adventures in Wonderland (Lewis Carroll, 1865)*/
+static const char * corpus[] = {
+    "Alice was beginning to get very tired of sitting by her sister on the bank, and of having nothing to do: "
+    "once or twice she had peeped into the book her sister was reading, but it had no pictures or "
+    "conversations in it, 'and what is the use of a book,' thought Alice 'without pictures or conversations?'",
+    "So she was considering in her own mind (as well as she could, for the hot day made her feel very sleepy "
+    "and stupid), whether the pleasure of making a daisy-chain would be worth the trouble of getting up and "
+    "picking the daisies, when suddenly a White Rabbit with pink eyes ran close by her.",
+    "There was nothing so very remarkable in that; nor did Alice think it so very much out of the way to hear "
+    "the Rabbit say to itself, 'Oh dear! Oh dear! I shall be late!' (when she thought it over afterwards, it "
+    "occurred to her that she ought to have wondered at this, but at the time it all seemed quite natural); "
+    "but when the Rabbit actually took a watch out of its waistcoat-pocket, and looked at it, and then "
+    "hurried on, Alice started to her feet, for it flashed across her mind that she had never before seen a "
+    "rabbit with either a waistcoat-pocket, or a watch to take out of it, and burning with curiosity, she ran "
+    "across the field after it, and fortunately was just in time to see it pop down a large rabbit-hole under "
+    "the hedge.",
+    "In another moment down went Alice after it, never once considering how in the world she was to get out "
+    "again.",
+    "The rabbit-hole went straight on like a tunnel for some way, and then dipped suddenly down, so suddenly "
+    "that Alice had not a moment to think about stopping herself before she found herself falling down a very "
+    "deep well.",
+    "Either the well was very deep, or she fell very slowly, for she had plenty of time as she went down to "
+    "look about her and to wonder what was going to happen next. First, she tried to look down and make out "
+    "what she was coming to, but it was too dark to see anything; then she looked at the sides of the well, "
+    "and noticed that they were filled with cupboards and book-shelves; here and there she saw maps and "
+    "pictures hung upon pegs. She took down a jar from one of the shelves as she passed; it was labelled "
+    "'ORANGE MARMALADE', but to her great disappointment it was empty: she did not like to drop the jar for "
+    "fear of killing somebody, so managed to put it into one of the cupboards as she fell past it.",
+    "'Well!' thought Alice to herself, 'after such a fall as this, I shall think nothing of tumbling down "
+    "stairs! How brave they'll all think me at home! Why, I wouldn't say anything about it, even if I fell "
+    "off the top of the house!' (Which was very likely true.)",
+    "Down, down, down. Would the fall never come to an end! 'I wonder how many miles I've fallen by this "
+    "time?' she said aloud. 'I must be getting somewhere near the centre of the earth. Let me see: that would "
+    "be four thousand miles down, I think--' (for, you see, Alice had learnt several things of this sort in "
+    "her lessons in the schoolroom, and though this was not a very good opportunity for showing off her "
+    "knowledge, as there was no one to listen to her, still it was good practice to say it over) '--yes, "
+    "that's about the right distance--but then I wonder what Latitude or Longitude I've got to?' (Alice had "
+    "no idea what Latitude was, or Longitude either, but thought they were nice grand words to say.)",
+    "Presently she began again. 'I wonder if I shall fall right through the earth! How funny it'll seem to "
+    "come out among the people that walk with their heads downward! The Antipathies, I think--' (she was "
+    "rather glad there was no one listening, this time, as it didn't sound at all the right word) '--but I "
+    "shall have to ask them what the name of the country is, you know. Please, Ma'am, is this New Zealand or "
+    "Australia?' (and she tried to curtsey as she spoke--fancy curtseying as you're falling through the air! "
+    "Do you think you could manage it?) 'And what an ignorant little girl she'll think me for asking! No, "
+    "it'll never do to ask: perhaps I shall see it written up somewhere.'",
+    "Down, down, down. There was nothing else to do, so Alice soon began talking again. 'Dinah'll miss me "
+    "very much to-night, I should think!' (Dinah was the cat.) 'I hope they'll remember her saucer of milk at "
+    "tea-time. Dinah my dear! I wish you were down here with me! There are no mice in the air, I'm afraid, "
+    "but you might catch a bat, and that's very like a mouse, you know. But do cats eat bats, I wonder?' And "
+    "here Alice began to get rather sleepy, and went on saying to herself, in a dreamy sort of way, 'Do cats "
+    "eat bats? Do cats eat bats?' and sometimes, 'Do bats eat cats?' for, you see, as she couldn't answer "
+    "either question, it didn't much matter which way she put it. She felt that she was dozing off, and had "
+    "just begun to dream that she was walking hand in hand with Dinah, and saying to her very earnestly, "
+    "'Now, Dinah, tell me the truth: did you ever eat a bat?' when suddenly, thump! thump! down she came upon "
+    "a heap of sticks and dry leaves, and the fall was over.",
+    "Alice was not a bit hurt, and she jumped up on to her feet in a moment: she looked up, but it was all "
+    "dark overhead; before her was another long passage, and the White Rabbit was still in sight, hurrying "
+    "down it. There was not a moment to be lost: away went Alice like the wind, and was just in time to hear "
+    "it say, as it turned a corner, 'Oh my ears and whiskers, how late it's getting!' She was close behind it "
+    "when she turned the corner, but the Rabbit was no longer to be seen: she found herself in a long, low "
+    "hall, which was lit up by a row of lamps hanging from the roof.",
+};
+
+void setUp(void)
+{
+    lv_font_fmt_txt_cache_clear();
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+static lv_font_fmt_txt_cache_monitor_t cache_mon(void)
+{
+    lv_font_fmt_txt_cache_monitor_t mon;
+    lv_font_fmt_txt_cache_monitor(&mon);
+    return mon;
+}
+
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+/*The ASCII letters are in the first cmap of the built-in fonts*/
+static const uint8_t * native_bitmap(const lv_font_t * font, uint32_t letter, const lv_font_fmt_txt_glyph_dsc_t ** gdsc)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[0];
+    TEST_ASSERT_EQUAL(LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY, cmap->type);
+    TEST_ASSERT_EQUAL_UINT32(0x20, cmap->range_start);
+
+    *gdsc = &fdsc->glyph_dsc[cmap->glyph_id_start + letter - cmap->range_start];
+    return &fdsc->glyph_bitmap[(*gdsc)->bitmap_index];
+}
+
+/*Every pixel of the glyph has the opacity the letter drawing would have mapped it to*/
+static void check_ascii_a8(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t bpp = fdsc->bpp == 3 ? 4 : fdsc->bpp;
+    uint32_t max = (1 << bpp) - 1;
+
+    uint32_t letter;
+    for(letter = '!'; letter <= '~'; letter++) {
+        lv_font_glyph_dsc_t g;
+        TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(font, &g, letter, 0));
+        TEST_ASSERT_EQUAL_UINT8(8, g.bpp);
+        const uint8_t * a8 = lv_font_get_glyph_bitmap(font, letter);
+        TEST_ASSERT_NOT_NULL(a8);
+
+        const lv_font_fmt_txt_glyph_dsc_t * gdsc;
+        const uint8_t * native = native_bitmap(font, letter, &gdsc);
+        uint32_t px_cnt = gdsc->box_w * gdsc->box_h;
+        uint32_t i;
+        for(i = 0; i < px_cnt; i++) {
+            if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
+                uint32_t bit = i * bpp;
+                uint32_t px = (native[bit >> 3] >> (8 - bpp - (bit & 0x7))) & max;
+                TEST_ASSERT_EQUAL_UINT8(px * 255 / max, a8[i]);
+            }
+            else {
+                /*Decompressed: still one of the shades of the font's bpp*/
+                TEST_ASSERT_EQUAL_UINT8(0, a8[i] % (255 / max));
+            }
+        }
+    }
+}
+#endif
+
+void test_font_fmt_txt_cache_expands_to_a8(void)
+{
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    check_ascii_a8(&lv_font_montserrat_14);
+    check_ascii_a8(&lv_font_unscii_8);
+    check_ascii_a8(&lv_font_montserrat_28_compressed);
+
+    /*Sub-pixel fonts keep their own format*/
+    lv_font_glyph_dsc_t g;
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc(&lv_font_montserrat_12_subpx, &g, 'A', 0));
+    TEST_ASSERT_EQUAL_UINT8(4, g.bpp);
+#endif
+}
+
+void test_font_fmt_txt_cache_hit_rate(void)
+{
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    lv_font_fmt_txt_cache_monitor_t start = cache_mon();
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 760);
+    lv_label_set_text(label, text);
+    lv_refr_now(NULL);
+
+    /*Each letter was expanded once*/
+    lv_font_fmt_txt_cache_monitor_t first = cache_mon();
+    uint32_t miss_cnt = first.miss_cnt - start.miss_cnt;
+    uint32_t hit_cnt = first.hit_cnt - start.hit_cnt;
+    TEST_ASSERT_GREATER_THAN_UINT32(20, miss_cnt);
+    TEST_ASSERT_LESS_THAN_UINT32(80, miss_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(miss_cnt, hit_cnt);
+
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_obj_invalidate(label);
+        lv_refr_now(NULL);
+    }
+    lv_font_fmt_txt_cache_monitor_t mon = cache_mon();
+    TEST_ASSERT_EQUAL_UINT32(first.miss_cnt, mon.miss_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT32(hit_cnt * 10, mon.hit_cnt - first.hit_cnt);
+#endif
+}
+
+void test_font_fmt_txt_cache_stays_in_budget(void)
+{
+#if LV_FONT_FMT_TXT_CACHE_SIZE
+    /*The ASCII glyphs of the 48 px font don't fit, the oldest ones are dropped*/
+    uint32_t letter;
+    for(letter = '!'; letter <= '~'; letter++) {
+        TEST_ASSERT_NOT_NULL(lv_font_get_glyph_bitmap(&lv_font_montserrat_48, letter));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_FONT_FMT_TXT_CACHE_SIZE, cache_mon().used_size);
+    }
+
+    /*Expanded again correctly after they were dropped*/
+    lv_font_fmt_txt_cache_monitor_t before = cache_mon();
+    check_ascii_a8(&lv_font_montserrat_48);
+    TEST_ASSERT_GREATER_THAN_UINT32(before.miss_cnt, cache_mon().miss_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_FONT_FMT_TXT_CACHE_SIZE, cache_mon().used_size);
+
+    lv_font_fmt_txt_cache_clear();
+    TEST_ASSERT_EQUAL_UINT32(0, cache_mon().used_size);
+#endif
+}
+
+/*Glyph id of a letter walking the cmaps one by one*/
+static uint32_t ref_glyph_id(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
+    uint16_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        if(letter < cmap->range_start || letter >= cmap->range_start + cmap->range_length) continue;
+
+        uint32_t rcp = letter - cmap->range_start;
+        if(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) return cmap->glyph_id_start + rcp;
+        if(cmap->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+            return cmap->glyph_id_start + ((const uint8_t *)cmap->glyph_id_ofs_list)[rcp];
+        }
+
+        uint32_t j;
+        for(j = 0; j < cmap->list_length; j++) {
+            if(cmap->unicode_list[j] != rcp) continue;
+            if(cmap->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) return cmap->glyph_id_start + j;
+            return cmap->glyph_id_start + ((const uint16_t *)cmap->glyph_id_ofs_list)[j];
+        }
+        return 0;
+    }
+    return 0;
+}
+
+/*Every letter has the glyph of the cmaps, the ones of the lookup table and the ones searched*/
+static void check_glyph_ids(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t found_cnt = 0;
+    uint32_t letter;
+    for(letter = 1; letter < 0x20000; letter++) {
+        if(letter == '\t') continue;
+
+        uint32_t gid = ref_glyph_id(fdsc, letter);
+        lv_font_glyph_dsc_t g;
+        bool found = lv_font_get_glyph_dsc_fmt_txt(font, &g, letter, 0);
+        const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+        if(found != (gid != 0) ||
+           (found && (g.adv_w != (gdsc->adv_w + 8) >> 4 || g.box_w != gdsc->box_w || g.box_h != gdsc->box_h ||
+                      g.ofs_x != gdsc->ofs_x || g.ofs_y != gdsc->ofs_y))) {
+            char msg[64];
+            lv_snprintf(msg, sizeof(msg), "wrong glyph for U+%04X", (unsigned int)letter);
+            TEST_FAIL_MESSAGE(msg);
+        }
+        if(found) found_cnt++;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(90, found_cnt);
+}
+
+void test_font_fmt_txt_glyph_ids_match_the_cmaps(void)
+{
+    check_glyph_ids(&lv_font_montserrat_14);
+    check_glyph_ids(&lv_font_unscii_8);
+#if LV_FONT_MONTSERRAT_16 && LV_FONT_MONTSERRAT_48 && LV_FONT_MONTSERRAT_12_SUBPX && LV_FONT_MONTSERRAT_28_COMPRESSED
+    check_glyph_ids(&lv_font_montserrat_16);
+    check_glyph_ids(&lv_font_montserrat_48);
+    check_glyph_ids(&lv_font_montserrat_12_subpx);
+    check_glyph_ids(&lv_font_montserrat_28_compressed);
+#endif
+
+    /*The tables are built again*/
+    lv_font_fmt_txt_cache_clear();
+    check_glyph_ids(&lv_font_montserrat_14);
+
+    /*A font loaded at run time*/
+    lv_font_t * font = lv_font_load("A:src/test_fonts/font_1.fnt");
+    TEST_ASSERT_NOT_NULL(font);
+    check_glyph_ids(font);
+    lv_font_free(font);
+
+    /*Right after the last letter of a range, not the first glyph of the next one*/
+    lv_font_glyph_dsc_t g;
+    TEST_ASSERT_FALSE(lv_font_get_glyph_dsc_fmt_txt(&lv_font_montserrat_14, &g, 0x7F, 0));
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc_fmt_txt(&lv_font_montserrat_14, &g, 0x7E, 0));
+    TEST_ASSERT_TRUE(lv_font_get_glyph_dsc_fmt_txt(&lv_font_montserrat_14, &g, 0xF00C, 0)); /*LV_SYMBOL_OK*/
+}
+
+static void layout_bench(const lv_font_t * font)
+{
+    lv_point_t size;
+    clock_t begin = clock();
+    uint32_t i;
+    for(i = 0; i < BENCH_LAYOUTS; i++) {
+        lv_txt_get_size(&size, text, font, 0, 0, 760, LV_TEXT_FLAG_NONE);
+    }
+    double ns = lv_test_bench_ns(begin, BENCH_LAYOUTS);
+
+    TEST_ASSERT_GREATER_THAN(0, size.y);
+    lv_test_bench_report("%d letters, %d px font: %d us per layout", (int)strlen(text),
+                         (int)lv_font_get_line_height(font), (int)(ns / 1000));
+}
+
+void test_font_fmt_txt_layout_bench(void)
+{
+    layout_bench(&lv_font_montserrat_14);
+#if LV_FONT_MONTSERRAT_28_COMPRESSED
+    layout_bench(&lv_font_montserrat_28_compressed);
+#endif
+}
+
+/*Kerning pairs and kerning classes made of montserrat_14's own kerning classes*/
+static lv_font_fmt_txt_kern_pair_t kern_pairs;
+static uint16_t kern_pair_ids[95 * 95 * 2];
+static int8_t kern_pair_values[95 * 95];
+
+static int8_t class_kern(const lv_font_fmt_txt_kern_classes_t * kdsc, uint32_t left, uint32_t right)
+{
+    uint8_t left_class = kdsc->left_class_mapping[left];
+    uint8_t right_class = kdsc->right_class_mapping[right];
+    if(left_class == 0 || right_class == 0) return 0;
+    return kdsc->class_pair_values[(left_class - 1) * kdsc->right_class_cnt + (right_class - 1)];
+}
+
+/*The pairs of the ASCII glyphs with kerning, `ofs` is added to the glyph ids*/
+static const lv_font_fmt_txt_kern_pair_t * make_kern_pairs(uint32_t ofs)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = lv_font_montserrat_14.dsc;
+    TEST_ASSERT_EQUAL(1, fdsc->kern_classes);
+    uint32_t cnt = 0;
+    uint32_t left;
+    uint32_t right;
+    for(left = 1; left <= 95; left++) {
+        for(right = 1; right <= 95; right++) {
+            int8_t value = class_kern(fdsc->kern_dsc, left, right);
+            if(value == 0) continue;
+            kern_pair_ids[cnt * 2] = left + ofs;
+            kern_pair_ids[cnt * 2 + 1] = right + ofs;
+            kern_pair_values[cnt] = value;
+            cnt++;
+        }
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(100, cnt);
+
+    /*8 bit ids if they fit*/
+    if(ofs + 95 < 256) {
+        uint8_t * ids8 = (uint8_t *)kern_pair_ids;
+        uint32_t i;
+        for(i = 0; i < cnt * 2; i++) ids8[i] = (uint8_t)kern_pair_ids[i];
+    }
+
+    kern_pairs.glyph_ids = kern_pair_ids;
+    kern_pairs.values = kern_pair_values;
+    kern_pairs.pair_cnt = cnt;
+    kern_pairs.glyph_ids_size = ofs + 95 < 256 ? 0 : 1;
+    return &kern_pairs;
+}
+
+static int8_t pair_kern(const lv_font_fmt_txt_kern_pair_t * kdsc, uint32_t left, uint32_t right)
+{
+    const uint8_t * ids8 = kdsc->glyph_ids;
+    const uint16_t * ids16 = kdsc->glyph_ids;
+    uint32_t i;
+    for(i = 0; i < kdsc->pair_cnt; i++) {
+        uint32_t l = kdsc->glyph_ids_size ? ids16[i * 2] : ids8[i * 2];
+        uint32_t r = kdsc->glyph_ids_size ? ids16[i * 2 + 1] : ids8[i * 2 + 1];
+        if(l == left && r == right) return kdsc->values[i];
+    }
+    return 0;
+}
+
+static void free_kern_classes(lv_font_fmt_txt_kern_classes_t * kdsc)
+{
+    lv_mem_free((void *)kdsc->class_pair_values);
+    lv_mem_free((void *)kdsc->left_class_mapping);
+    lv_mem_free((void *)kdsc->right_class_mapping);
+    lv_mem_free(kdsc);
+}
+
+static void check_kern_classes(uint32_t ofs, uint32_t glyph_cnt)
+{
+    const lv_font_fmt_txt_kern_pair_t * pairs = make_kern_pairs(ofs);
+    lv_font_fmt_txt_kern_classes_t * classes = lv_font_fmt_txt_kern_pairs_to_classes(pairs, glyph_cnt, 16 * 1024);
+    TEST_ASSERT_NOT_NULL(classes);
+
+    /*No class for the glyphs without kerning*/
+    uint32_t left;
+    uint32_t right;
+    for(left = 0; left < glyph_cnt; left++) {
+        if(left > ofs && left <= ofs + 95) continue;
+        TEST_ASSERT_EQUAL_UINT8(0, classes->left_class_mapping[left]);
+        TEST_ASSERT_EQUAL_UINT8(0, classes->right_class_mapping[left]);
+    }
+
+    for(left = ofs + 1; left <= ofs + 95; left++) {
+        for(right = ofs + 1; right <= ofs + 95; right++) {
+            if(class_kern(classes, left, right) != pair_kern(pairs, left, right)) {
+                char msg[64];
+                lv_snprintf(msg, sizeof(msg), "wrong kerning of glyphs %d and %d", (int)left, (int)right);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+
+    /*Not more classes than the font was made with*/
+    const lv_font_fmt_txt_kern_classes_t * orig = ((const lv_font_fmt_txt_dsc_t *)lv_font_montserrat_14.dsc)->kern_dsc;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT8(orig->left_class_cnt, classes->left_class_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT8(orig->right_class_cnt, classes->right_class_cnt);
+
+    /*Only if the classes fit*/
+    uint32_t size = glyph_cnt * 2 + classes->left_class_cnt * classes->right_class_cnt;
+    free_kern_classes(classes);
+    TEST_ASSERT_NULL(lv_font_fmt_txt_kern_pairs_to_classes(pairs, glyph_cnt, size - 1));
+    classes = lv_font_fmt_txt_kern_pairs_to_classes(pairs, glyph_cnt, size);
+    TEST_ASSERT_NOT_NULL(classes);
+    free_kern_classes(classes);
+
+    /*Glyph ids out of the font*/
+    TEST_ASSERT_NULL(lv_font_fmt_txt_kern_pairs_to_classes(pairs, ofs + 95, 16 * 1024));
+}
+
+void test_font_fmt_txt_kern_pairs_to_classes(void)
+{
+    size_t mem_before = lv_test_get_free_mem();
+    check_kern_classes(0, 96);
+    check_kern_classes(300, 400);
+    TEST_ASSERT_EQUAL(mem_before, lv_test_get_free_mem());
+}
+
+static uint32_t kern_bench(const lv_font_t * font)
+{
+    uint32_t corpus_cnt = sizeof(corpus) / sizeof(corpus[0]);
+    uint32_t len = 0;
+    lv_point_t size;
+    clock_t begin = clock();
+    uint32_t i = 0;
+    while(len < BENCH_CORPUS_KB * 1024) {
+        const char * txt = corpus[i % corpus_cnt];
+        lv_txt_get_size(&size, txt, font, 0, 0, 230, LV_TEXT_FLAG_NONE);
+        len += strlen(txt);
+        i++;
+    }
+    return (uint32_t)(lv_test_bench_ns(begin, 1) / 1000);
+}
+
+void test_font_fmt_txt_kern_bench(void)
+{
+    /*montserrat_14 with its ASCII kerning as pairs and as classes made of them*/
+    static lv_font_fmt_txt_dsc_t pair_dsc;
+    static lv_font_fmt_txt_dsc_t class_dsc;
+    static lv_font_t pair_font;
+    static lv_font_t class_font;
+    pair_dsc = *(const lv_font_fmt_txt_dsc_t *)lv_font_montserrat_14.dsc;
+    pair_dsc.cache = NULL;
+    pair_dsc.kern_dsc = make_kern_pairs(0);
+    pair_dsc.kern_classes = 0;
+    class_dsc = pair_dsc;
+    class_dsc.kern_dsc = lv_font_fmt_txt_kern_pairs_to_classes(&kern_pairs, 96, 16 * 1024);
+    class_dsc.kern_classes = 1;
+    TEST_ASSERT_NOT_NULL(class_dsc.kern_dsc);
+    pair_font = lv_font_montserrat_14;
+    pair_font.dsc = &pair_dsc;
+    class_font = lv_font_montserrat_14;
+    class_font.dsc = &class_dsc;
+
+    /*Same layout*/
+    uint32_t i;
+    for(i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+        lv_point_t size1;
+        lv_point_t size2;
+        lv_point_t size3;
+        lv_txt_get_size(&size1, corpus[i], &pair_font, 0, 0, 230, LV_TEXT_FLAG_NONE);
+        lv_txt_get_size(&size2, corpus[i], &class_font, 0, 0, 230, LV_TEXT_FLAG_NONE);
+        lv_txt_get_size(&size3, corpus[i], &lv_font_montserrat_14, 0, 0, 230, LV_TEXT_FLAG_NONE);
+        TEST_ASSERT_EQUAL_INT32(size1.x, size2.x);
+        TEST_ASSERT_EQUAL_INT32(size1.y, size2.y);
+        TEST_ASSERT_EQUAL_INT32(size3.x, size2.x);
+        TEST_ASSERT_EQUAL_INT32(size3.y, size2.y);
+    }
+
+    uint32_t pair_us = kern_bench(&pair_font);
+    uint32_t class_us = kern_bench(&class_font);
+    lv_test_bench_report("%d kB of English text, %d kerning pairs: %d us, as %dx%d classes: %d us",
+                         BENCH_CORPUS_KB, (int)kern_pairs.pair_cnt, (int)pair_us,
+                         ((lv_font_fmt_txt_kern_classes_t *)class_dsc.kern_dsc)->left_class_cnt,
+                         ((lv_font_fmt_txt_kern_classes_t *)class_dsc.kern_dsc)->right_class_cnt, (int)class_us);
+
+    free_kern_classes((lv_font_fmt_txt_kern_classes_t *)class_dsc.kern_dsc);
+}
+
+static void bench(const lv_font_t * font)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, 760);
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_label_set_text(label, text);
+    lv_refr_now(NULL);
+
+    lv_font_fmt_txt_cache_monitor_t before = cache_mon();
+    clock_t begin = clock();
+    uint32_t i;
+    for(i = 0; i < BENCH_FRAMES; i++) {
+        lv_obj_invalidate(label);
+        lv_refr_now(NULL);
+    }
+    double ns = lv_test_bench_ns(begin, BENCH_FRAMES);
+    lv_font_fmt_txt_cache_monitor_t after = cache_mon();
+
+    uint32_t hit_cnt = after.hit_cnt - before.hit_cnt;
+    uint32_t miss_cnt = after.miss_cnt - before.miss_cnt;
+    uint32_t lookup_cnt = hit_cnt + miss_cnt;
+    lv_test_bench_report("%d letters, %d px font: %d us per frame, %d%% glyph cache hits",
+                         (int)strlen(text), (int)lv_font_get_line_height(font), (int)(ns / 1000),
+                         lookup_cnt ? (int)(hit_cnt * 100 / lookup_cnt) : 0);
+    lv_obj_del(label);
+}
+
+void test_font_fmt_txt_bench(void)
+{
+    bench(&lv_font_montserrat_14);
+#if LV_FONT_MONTSERRAT_28_COMPRESSED
+    bench(&lv_font_montserrat_28_compressed);
+#endif
+}
+
+#endif
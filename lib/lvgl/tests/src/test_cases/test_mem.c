@@ -2,6 +2,10 @@
 #include "../lvgl.h"
 
 #include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#define CHURN_SLOTS     256
+#define CHURN_OPS       200000
 
 void setUp(void)
 {
@@ -23,4 +27,159 @@ void test_mem_buf_realloc(void)
 #endif
 }
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_CLASSES
+static lv_mem_class_monitor_t class_mon(uint32_t class_id)
+{
+    lv_mem_class_monitor_t mon;
+    lv_mem_class_monitor(class_id, &mon);
+    return mon;
+}
+#endif
+
+void test_mem_size_classes(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_CLASSES
+    TEST_ASSERT_EQUAL_UINT32(8, lv_mem_class_count());
+    TEST_ASSERT_EQUAL_UINT16(16, class_mon(0).block_size);
+    TEST_ASSERT_EQUAL_UINT16(256, class_mon(7).block_size);
+
+    /*40 bytes are served from the 48 byte class*/
+    lv_mem_class_monitor_t before = class_mon(2);
+    void * blocks[64];
+    uint32_t i;
+    for(i = 0; i < 64; i++) {
+        blocks[i] = lv_mem_alloc(40);
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        lv_memset(blocks[i], i, 40);
+    }
+    lv_mem_class_monitor_t mon = class_mon(2);
+    TEST_ASSERT_EQUAL_UINT32(before.used_cnt + 64, mon.used_cnt);
+    TEST_ASSERT_EQUAL_UINT32(before.alloc_cnt + 64, mon.alloc_cnt);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(before.used_cnt + 64, mon.max_used_cnt);
+    TEST_ASSERT_GREATER_THAN_UINT16(before.page_cnt, mon.page_cnt);
+    for(i = 1; i < 64; i++) TEST_ASSERT_TRUE(blocks[i] != blocks[i - 1]);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    /*A freed block is given out again*/
+    void * freed = blocks[10];
+    lv_mem_free(freed);
+    blocks[10] = lv_mem_alloc(33);
+    TEST_ASSERT_EQUAL_PTR(freed, blocks[10]);
+
+    for(i = 0; i < 64; i++) lv_mem_free(blocks[i]);
+    mon = class_mon(2);
+    TEST_ASSERT_EQUAL_UINT32(before.used_cnt, mon.used_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT16(LV_MAX(before.page_cnt, 1), mon.page_cnt);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+
+    /*Larger sizes go to the heap*/
+    lv_mem_class_monitor_t big_before = class_mon(7);
+    void * big = lv_mem_alloc(257);
+    TEST_ASSERT_NOT_NULL(big);
+    TEST_ASSERT_EQUAL_UINT32(big_before.alloc_cnt, class_mon(7).alloc_cnt);
+    lv_mem_free(big);
+#endif
+}
+
+void test_mem_class_realloc(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_CLASSES
+    uint8_t * p = lv_mem_alloc(20);
+    uint32_t i;
+    for(i = 0; i < 20; i++) p[i] = i;
+
+    /*The same class: it stays*/
+    TEST_ASSERT_EQUAL_PTR(p, lv_mem_realloc(p, 32));
+
+    /*Another class and the heap: it moves with its content*/
+    p = lv_mem_realloc(p, 100);
+    TEST_ASSERT_NOT_NULL(p);
+    for(i = 0; i < 20; i++) TEST_ASSERT_EQUAL_UINT8(i, p[i]);
+    p = lv_mem_realloc(p, 1000);
+    TEST_ASSERT_NOT_NULL(p);
+    for(i = 0; i < 20; i++) TEST_ASSERT_EQUAL_UINT8(i, p[i]);
+    for(i = 20; i < 1000; i++) p[i] = i;
+
+    /*And back*/
+    p = lv_mem_realloc(p, 16);
+    TEST_ASSERT_NOT_NULL(p);
+    for(i = 0; i < 16; i++) TEST_ASSERT_EQUAL_UINT8(i, p[i]);
+
+    /*No memory: the block is kept*/
+    TEST_ASSERT_NULL(lv_mem_realloc(p, LV_MEM_SIZE + 16384));
+    for(i = 0; i < 16; i++) TEST_ASSERT_EQUAL_UINT8(i, p[i]);
+    lv_mem_free(p);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+void test_mem_fast_pool(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_FAST_SIZE
+    lv_mem_monitor_t before;
+    lv_mem_fast_monitor(&before);
+    TEST_ASSERT_EQUAL_UINT32(LV_MEM_FAST_SIZE, before.total_size);
+
+    uint8_t * buf = lv_mem_alloc_fast(4096);
+    TEST_ASSERT_NOT_NULL(buf);
+    lv_memset(buf, 0x5a, 4096);
+    lv_mem_monitor_t mon;
+    lv_mem_fast_monitor(&mon);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(before.free_size - 4096, mon.free_size);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4096, mon.max_used);
+
+    /*Grows in place or moves, keeping the content*/
+    buf = lv_mem_realloc(buf, 8192);
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_EQUAL_UINT8(0x5a, buf[4095]);
+
+    /*Full: from the main pool*/
+    void * too_big = lv_mem_alloc_fast(LV_MEM_FAST_SIZE);
+    TEST_ASSERT_NOT_NULL(too_big);
+    lv_mem_fast_monitor(&mon);
+    TEST_ASSERT_LESS_THAN_UINT32(before.free_size, mon.free_size + 1);
+
+    lv_mem_free(too_big);
+    lv_mem_free(buf);
+    lv_mem_fast_monitor(&mon);
+    TEST_ASSERT_EQUAL_UINT32(before.free_size, mon.free_size);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+/*Many blocks of mixed sizes, most small as the objects' and styles' are, freed and allocated at random*/
+void test_mem_churn(void)
+{
+    static void * slots[CHURN_SLOTS];
+    lv_memset_00(slots, sizeof(slots));
+    uint32_t seed = 12345;
+    uint32_t i;
+
+    clock_t begin = clock();
+    for(i = 0; i < CHURN_OPS; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t r = seed >> 8;
+        uint32_t slot = r % CHURN_SLOTS;
+        if(slots[slot]) {
+            lv_mem_free(slots[slot]);
+            slots[slot] = NULL;
+        }
+        else {
+            uint32_t size = (r >> 8) % 8 ? 8 + (r >> 12) % 120 : 256 + (r >> 12) % 2048;
+            slots[slot] = lv_mem_alloc(size);
+            TEST_ASSERT_NOT_NULL(slots[slot]);
+        }
+    }
+    double ns = lv_test_bench_ns(begin, CHURN_OPS);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    lv_test_bench_report("%d ns per allocation or free, fragmentation %d%%", (int)ns, mon.frag_pct);
+
+    for(i = 0; i < CHURN_SLOTS; i++) lv_mem_free(slots[i]);
+#if LV_MEM_CUSTOM == 0
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
 #endif
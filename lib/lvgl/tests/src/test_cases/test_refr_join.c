@@ -0,0 +1,229 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#define BENCH_FRAMES    200
+
+static lv_disp_drv_t * drv;
+static void (*orig_flush_cb)(struct _lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+
+static lv_area_t flushed[LV_INV_BUF_SIZE];
+static uint32_t flushed_cnt;
+static uint32_t flushed_px;
+
+static void capture_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(color_p);
+    if(flushed_cnt < LV_INV_BUF_SIZE) flushed[flushed_cnt] = *area;
+    flushed_cnt++;
+    flushed_px += lv_area_get_size(area);
+    lv_disp_flush_ready(disp_drv);
+}
+
+static void capture_reset(void)
+{
+    flushed_cnt = 0;
+    flushed_px = 0;
+}
+
+void setUp(void)
+{
+    drv = lv_disp_get_default()->driver;
+    orig_flush_cb = drv->flush_cb;
+    drv->flush_cb = capture_flush_cb;
+    lv_refr_now(NULL);
+    capture_reset();
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+    lv_refr_now(NULL);
+    drv->flush_cb = orig_flush_cb;
+    drv->area_cost = 0;
+    drv->px_cost = 1;
+}
+
+static uint32_t model_cost(const lv_area_t * area)
+{
+    return drv->area_cost + drv->px_cost * lv_area_get_size(area);
+}
+
+/*Refresh the areas and check that every pixel of them was flushed*/
+static void refresh(const lv_area_t * areas, uint32_t cnt)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) _lv_inv_area(NULL, &areas[i]);
+    capture_reset();
+    lv_refr_now(NULL);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(LV_INV_BUF_SIZE, flushed_cnt);
+
+    for(i = 0; i < cnt; i++) {
+        lv_coord_t x;
+        lv_coord_t y;
+        for(y = areas[i].y1; y <= areas[i].y2; y++) {
+            for(x = areas[i].x1; x <= areas[i].x2; x++) {
+                lv_point_t p = {x, y};
+                uint32_t f;
+                for(f = 0; f < flushed_cnt; f++) {
+                    if(_lv_area_is_point_on(&flushed[f], &p, 0)) break;
+                }
+                TEST_ASSERT_TRUE(f < flushed_cnt);
+            }
+        }
+    }
+}
+
+void test_refr_join_by_pixels_by_default(void)
+{
+    /*Overlapping a lot: the bounding box is smaller than the two, the dots are apart*/
+    const lv_area_t areas[] = {
+        {300, 300, 303, 303},
+        {10, 10, 59, 59},
+        {320, 300, 323, 303},
+        {20, 20, 69, 69},
+    };
+    refresh(areas, 4);
+    TEST_ASSERT_EQUAL_UINT32(3, flushed_cnt);
+    TEST_ASSERT_EQUAL_UINT32(60 * 60 + 2 * 4 * 4, flushed_px);
+
+    /*Overlapping a little: joining would refresh more pixels*/
+    const lv_area_t crossing[] = {
+        {10, 10, 59, 59},
+        {40, 40, 89, 89},
+    };
+    refresh(crossing, 2);
+    TEST_ASSERT_EQUAL_UINT32(2, flushed_cnt);
+}
+
+void test_refr_join_by_the_cost_model(void)
+{
+    const lv_area_t areas[] = {
+        {300, 300, 303, 303},
+        {10, 10, 59, 59},
+        {320, 300, 323, 303},
+        {20, 20, 69, 69},
+        {340, 302, 343, 305},
+    };
+
+    /*A flush costs about as much as 1000 pixels: the dots are refreshed together, the far ones not*/
+    drv->area_cost = 1000;
+    refresh(areas, 5);
+    TEST_ASSERT_EQUAL_UINT32(2, flushed_cnt);
+    TEST_ASSERT_EQUAL_UINT32(60 * 60 + 44 * 6, flushed_px);
+
+    /*The cost of a flush dominates: one area*/
+    drv->area_cost = 1000000;
+    refresh(areas, 5);
+    TEST_ASSERT_EQUAL_UINT32(1, flushed_cnt);
+    TEST_ASSERT_EQUAL_UINT32(334 * 296, flushed_px);
+}
+
+void test_refr_join_never_costs_more(void)
+{
+    static const uint32_t area_costs[] = {0, 100, 5000, 100000};
+    uint32_t seed = 1;
+    uint32_t m;
+    for(m = 0; m < sizeof(area_costs) / sizeof(area_costs[0]); m++) {
+        drv->area_cost = area_costs[m];
+        uint32_t round;
+        for(round = 0; round < 20; round++) {
+            lv_area_t areas[LV_INV_BUF_SIZE - 2];
+            uint32_t cnt = 1 + round % (LV_INV_BUF_SIZE - 2);
+            uint32_t sep_cost = 0;
+            uint32_t i;
+            for(i = 0; i < cnt; i++) {
+                seed = seed * 1103515245 + 12345;
+                lv_coord_t x = (seed >> 8) % 760;
+                lv_coord_t y = (seed >> 18) % 440;
+                seed = seed * 1103515245 + 12345;
+                lv_area_set(&areas[i], x, y, x + (seed >> 8) % 40, y + (seed >> 18) % 40);
+                sep_cost += model_cost(&areas[i]);
+            }
+            refresh(areas, cnt);
+
+            uint32_t joined_cost = 0;
+            for(i = 0; i < flushed_cnt; i++) joined_cost += model_cost(&flushed[i]);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(sep_cost, joined_cost);
+        }
+    }
+}
+
+/*"Speak Now . . ." with the dots blinking one after the other, and the triangle jumping around.
+ *Not rotated here, the screen of the tests has no transparency for the layer.*/
+static void bench(const char * name)
+{
+    lv_obj_t * label = lv_label_create(lv_scr_act());
+    lv_label_set_text_static(label, "Speak Now");
+    lv_obj_set_pos(label, 300, 380);
+    lv_obj_t * dots[3];
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        dots[i] = lv_obj_create(lv_scr_act());
+        lv_obj_remove_style_all(dots[i]);
+        lv_obj_set_style_bg_opa(dots[i], LV_OPA_COVER, 0);
+        lv_obj_set_pos(dots[i], 400 + i * 12, 392);
+        lv_obj_set_size(dots[i], 4, 4);
+    }
+    lv_obj_t * tri = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(tri, 60, 60);
+    lv_obj_set_style_radius(tri, 0, 0);
+    lv_refr_now(NULL);
+
+    uint32_t areas = 0;
+    uint32_t px = 0;
+    clock_t begin = clock();
+    for(i = 0; i < BENCH_FRAMES; i++) {
+        lv_obj_add_flag(dots[i % 3], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_clear_flag(dots[(i + 1) % 3], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_pos(tri, 100 + (i * 70) % 500, 60 + (i * 30) % 200);
+        capture_reset();
+        lv_refr_now(NULL);
+        areas += flushed_cnt;
+        px += flushed_px;
+    }
+    double ns = lv_test_bench_ns(begin, BENCH_FRAMES);
+
+    lv_test_bench_report("%s: %d.%02d areas, %d px, %d us per frame", name,
+                         (int)(areas / BENCH_FRAMES), (int)(areas * 100 / BENCH_FRAMES % 100), (int)(px / BENCH_FRAMES),
+                         (int)(ns / 1000));
+    lv_obj_clean(lv_scr_act());
+    lv_refr_now(NULL);
+}
+
+/*Time of refreshing `cnt` areas of `size` x `size` pixels*/
+static double time_areas(lv_coord_t size, uint32_t cnt)
+{
+    clock_t begin = clock();
+    uint32_t i;
+    for(i = 0; i < BENCH_FRAMES; i++) {
+        uint32_t a;
+        for(a = 0; a < cnt; a++) {
+            lv_area_t area;
+            lv_area_set(&area, a * 64, 0, a * 64 + size - 1, size - 1);
+            _lv_inv_area(NULL, &area);
+        }
+        lv_refr_now(NULL);
+    }
+    return lv_test_bench_ns(begin, BENCH_FRAMES);
+}
+
+void test_refr_join_bench(void)
+{
+    /*The costs of the host in ns: the time of a small area, and the time of the pixels of a large one*/
+    double tiny = (time_areas(1, 10) - time_areas(1, 1)) / 9;
+    double large = time_areas(64, 10) / 10;
+    uint32_t px_cost = (uint32_t)LV_MAX(1, (large - tiny) / (64 * 64));
+    uint32_t area_cost = (uint32_t)LV_MAX(0, tiny - px_cost);
+
+    lv_test_bench_report("host: %d ns per area, %d ns per pixel", (int)area_cost, (int)px_cost);
+
+    bench("pixels only");
+    drv->area_cost = area_cost;
+    drv->px_cost = px_cost;
+    bench("host costs");
+}
+
+#endif
@@ -0,0 +1,208 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_init.h"
+
+#if LV_USE_REFR_PROFILER
+
+static char last_line[160];
+static uint32_t line_cnt;
+
+static void capture_line(const char * line)
+{
+    lv_snprintf(last_line, sizeof(last_line), "%s", line);
+    line_cnt++;
+}
+
+static void transfer_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    LV_UNUSED(area);
+    LV_UNUSED(color_p);
+
+    lv_test_prof_time_advance(20);
+    LV_REFR_PROF_BEGIN(LV_REFR_PROF_TRANSFER);
+    lv_test_prof_time_advance(300);
+    LV_REFR_PROF_END(LV_REFR_PROF_TRANSFER);
+
+    lv_disp_flush_ready(disp_drv);
+}
+#endif
+
+void setUp(void)
+{
+#if LV_USE_REFR_PROFILER
+    lv_test_prof_time_set(1000);
+    lv_refr_prof_reset();
+#endif
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_refr_prof_phases_are_exclusive(void)
+{
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_begin();
+    lv_test_prof_time_advance(10);
+    lv_refr_prof_begin(LV_REFR_PROF_DRAW);
+    lv_test_prof_time_advance(100);
+    lv_refr_prof_begin(LV_REFR_PROF_FLUSH);
+    lv_test_prof_time_advance(30);
+    lv_refr_prof_begin(LV_REFR_PROF_TRANSFER);
+    lv_test_prof_time_advance(500);
+    lv_refr_prof_end(LV_REFR_PROF_TRANSFER);
+    lv_test_prof_time_advance(5);
+    lv_refr_prof_end(LV_REFR_PROF_FLUSH);
+    lv_test_prof_time_advance(20);
+    lv_refr_prof_end(LV_REFR_PROF_DRAW);
+    lv_test_prof_time_advance(7);
+    _lv_refr_prof_frame_end(true);
+
+    TEST_ASSERT_EQUAL_UINT32(120, lv_refr_prof_get_stat(LV_REFR_PROF_DRAW)->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(35, lv_refr_prof_get_stat(LV_REFR_PROF_FLUSH)->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(500, lv_refr_prof_get_stat(LV_REFR_PROF_TRANSFER)->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(17, lv_refr_prof_get_stat(LV_REFR_PROF_OTHER)->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(672, lv_refr_prof_get_stat(LV_REFR_PROF_FRAME)->sum_us);
+
+    /*Phases that didn't run are not counted*/
+    TEST_ASSERT_EQUAL_UINT32(0, lv_refr_prof_get_stat(LV_REFR_PROF_JOIN)->cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_refr_prof_get_stat(LV_REFR_PROF_DRAW)->cnt);
+#endif
+}
+
+void test_refr_prof_histogram_buckets(void)
+{
+#if LV_USE_REFR_PROFILER
+    const uint32_t samples[] = {0, 63, 64, 500, 65535, 65536, 10000000};
+    uint32_t i;
+    for(i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        _lv_refr_prof_frame_begin();
+        lv_test_prof_time_advance(samples[i]);
+        _lv_refr_prof_frame_end(true);
+    }
+
+    const lv_refr_prof_stat_t * s = lv_refr_prof_get_stat(LV_REFR_PROF_FRAME);
+    TEST_ASSERT_EQUAL_UINT32(7, s->cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, s->hist[0]);   /*< 64*/
+    TEST_ASSERT_EQUAL_UINT32(1, s->hist[1]);   /*< 128*/
+    TEST_ASSERT_EQUAL_UINT32(1, s->hist[3]);   /*< 512*/
+    TEST_ASSERT_EQUAL_UINT32(1, s->hist[LV_REFR_PROF_BUCKET_CNT - 2]);
+    TEST_ASSERT_EQUAL_UINT32(2, s->hist[LV_REFR_PROF_BUCKET_CNT - 1]);
+    TEST_ASSERT_EQUAL_UINT32(10000000, s->max_us);
+#endif
+}
+
+void test_refr_prof_drops_empty_frames(void)
+{
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_begin();
+    lv_test_prof_time_advance(100);
+    _lv_refr_prof_frame_end(false);
+
+    /*Outside of a frame*/
+    lv_refr_prof_begin(LV_REFR_PROF_TRANSFER);
+    lv_test_prof_time_advance(100);
+    lv_refr_prof_end(LV_REFR_PROF_TRANSFER);
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_refr_prof_get_stat(LV_REFR_PROF_FRAME)->cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_refr_prof_get_stat(LV_REFR_PROF_TRANSFER)->cnt);
+#endif
+}
+
+void test_refr_prof_refresh(void)
+{
+#if LV_USE_REFR_PROFILER
+    lv_disp_drv_t * drv = lv_disp_get_default()->driver;
+    void (*flush_cb)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *) = drv->flush_cb;
+    drv->flush_cb = transfer_flush_cb;
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(obj, 100, 100);
+    lv_refr_now(NULL);
+
+    drv->flush_cb = flush_cb;
+
+    TEST_ASSERT_EQUAL_UINT32(1, lv_refr_prof_get_stat(LV_REFR_PROF_FRAME)->cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_refr_prof_get_stat(LV_REFR_PROF_JOIN)->cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_refr_prof_get_stat(LV_REFR_PROF_DRAW)->cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_refr_prof_get_stat(LV_REFR_PROF_LAYER)->cnt);
+
+    /*The time the driver marks as transfer is taken out of the flush*/
+    const lv_refr_prof_stat_t * transfer = lv_refr_prof_get_stat(LV_REFR_PROF_TRANSFER);
+    const lv_refr_prof_stat_t * flush = lv_refr_prof_get_stat(LV_REFR_PROF_FLUSH);
+    TEST_ASSERT_EQUAL_UINT32(0, transfer->sum_us % 300);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, transfer->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(transfer->sum_us / 15, flush->sum_us);
+    TEST_ASSERT_EQUAL_UINT32(flush->sum_us + transfer->sum_us, lv_refr_prof_get_stat(LV_REFR_PROF_FRAME)->sum_us);
+#endif
+}
+
+void test_refr_prof_layer(void)
+{
+#if LV_USE_REFR_PROFILER
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(obj, 100, 100);
+    lv_obj_set_style_transform_angle(obj, 300, 0);
+    lv_refr_now(NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(1, lv_refr_prof_get_stat(LV_REFR_PROF_LAYER)->cnt);
+#endif
+}
+
+void test_refr_prof_dump(void)
+{
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_begin();
+    lv_refr_prof_begin(LV_REFR_PROF_TRANSFER);
+    lv_test_prof_time_advance(500);
+    lv_refr_prof_end(LV_REFR_PROF_TRANSFER);
+    _lv_refr_prof_frame_end(true);
+
+    line_cnt = 0;
+    lv_refr_prof_dump(capture_line);
+
+    /*Header and a line per phase, then a header and a line per counter*/
+    TEST_ASSERT_EQUAL_UINT32(_LV_REFR_PROF_PHASE_NUM + 1 + _LV_REFR_PROF_CNT_NUM + 1, line_cnt);
+    TEST_ASSERT_EQUAL_STRING("layer_alloc,1,0,0", last_line);
+#endif
+}
+
+void test_refr_prof_counters(void)
+{
+#if LV_USE_REFR_PROFILER
+    _lv_refr_prof_frame_begin();
+    lv_refr_prof_count(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    lv_refr_prof_count(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    _lv_refr_prof_frame_end(true);
+
+    _lv_refr_prof_frame_begin();
+    lv_refr_prof_count(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    _lv_refr_prof_frame_end(true);
+
+    /*Dropped with the frame and outside of a frame*/
+    _lv_refr_prof_frame_begin();
+    lv_refr_prof_count(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    _lv_refr_prof_frame_end(false);
+    lv_refr_prof_count(LV_REFR_PROF_CNT_LAYER_ALLOC);
+
+    const lv_refr_prof_count_stat_t * s = lv_refr_prof_get_count_stat(LV_REFR_PROF_CNT_LAYER_ALLOC);
+    TEST_ASSERT_EQUAL_UINT32(2, s->frames);
+    TEST_ASSERT_EQUAL_UINT32(3, s->sum);
+    TEST_ASSERT_EQUAL_UINT32(2, s->max);
+
+    /*A transformed layer: its context and buffer*/
+    lv_refr_prof_reset();
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(obj, 100, 100);
+    lv_obj_set_style_radius(obj, 0, 0);
+    lv_obj_set_style_transform_zoom(obj, 200, 0);
+    lv_draw_sw_layer_pool_clear();
+    lv_refr_now(NULL);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1, s->sum);
+#endif
+}
+
+#endif
@@ -2,8 +2,21 @@
 #include "../lvgl.h"
 
 #include "unity/unity.h"
+#include "lv_test_helpers.h"
 #include <unistd.h>
 
+#define BENCH_READS     1000000
+#define BENCH_FRAMES    100
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
 static void obj_set_height_helper(void * obj, int32_t height)
 {
     lv_obj_set_height((lv_obj_t *)obj, (lv_coord_t)height);
@@ -106,4 +119,131 @@ void test_inherit_meta_with_lower_precedence_style(void)
     TEST_ASSERT_EQUAL_HEX(lv_color_hex(0xff0000).full, lv_obj_get_style_text_color(grandchild, LV_PART_MAIN).full);
 }
 
+void test_style_cache_follows_the_changes(void)
+{
+    lv_obj_t * parent = lv_obj_create(lv_scr_act());
+    lv_obj_t * child = lv_obj_create(parent);
+    lv_obj_remove_style_all(child);
+    lv_obj_t * label = lv_label_create(child);
+
+    /*Inherited through `child`*/
+    lv_obj_set_style_text_color(parent, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0xff0000).full, lv_obj_get_style_text_color(label, 0).full);
+    lv_obj_set_style_text_color(parent, lv_color_hex(0x0000ff), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x0000ff).full, lv_obj_get_style_text_color(label, 0).full);
+
+    /*A shared style changed without reporting it*/
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_radius(&style, 3);
+    lv_obj_add_style(child, &style, 0);
+    TEST_ASSERT_EQUAL_INT(3, lv_obj_get_style_radius(child, 0));
+    lv_style_set_radius(&style, 4);
+    TEST_ASSERT_EQUAL_INT(4, lv_obj_get_style_radius(child, 0));
+    lv_style_remove_prop(&style, LV_STYLE_RADIUS);
+    TEST_ASSERT_EQUAL_INT(lv_style_prop_get_default(LV_STYLE_RADIUS).num, lv_obj_get_style_radius(child, 0));
+    lv_style_set_radius(&style, 5);
+    lv_obj_remove_style(child, &style, 0);
+    TEST_ASSERT_EQUAL_INT(lv_style_prop_get_default(LV_STYLE_RADIUS).num, lv_obj_get_style_radius(child, 0));
+
+    /*States of the object and of its parent*/
+    static lv_style_t pressed;
+    lv_style_init(&pressed);
+    lv_style_set_radius(&pressed, 7);
+    lv_style_set_text_color(&pressed, lv_color_hex(0x00ff00));
+    lv_obj_add_style(child, &pressed, LV_STATE_PRESSED);
+    lv_obj_set_style_radius(child, 2, 0);
+    TEST_ASSERT_EQUAL_INT(2, lv_obj_get_style_radius(child, 0));
+    lv_obj_add_state(child, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL_INT(7, lv_obj_get_style_radius(child, 0));
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x00ff00).full, lv_obj_get_style_text_color(label, 0).full);
+    lv_obj_clear_state(child, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL_INT(2, lv_obj_get_style_radius(child, 0));
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x0000ff).full, lv_obj_get_style_text_color(label, 0).full);
+
+    /*Other parts, more than the cache keeps at once*/
+    lv_obj_set_style_radius(child, 11, LV_PART_SCROLLBAR);
+    lv_obj_set_style_radius(child, 12, LV_PART_INDICATOR);
+    uint32_t i;
+    for(i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_INT(11, lv_obj_get_style_radius(child, LV_PART_SCROLLBAR));
+        TEST_ASSERT_EQUAL_INT(12, lv_obj_get_style_radius(child, LV_PART_INDICATOR));
+        TEST_ASSERT_EQUAL_INT(2, lv_obj_get_style_radius(child, LV_PART_MAIN));
+    }
+
+    /*A new parent*/
+    lv_obj_t * parent2 = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_text_color(parent2, lv_color_hex(0x123456), 0);
+    lv_obj_set_parent(child, parent2);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x123456).full, lv_obj_get_style_text_color(label, 0).full);
+
+    /*Changed while the refreshing is disabled*/
+    lv_obj_enable_style_refresh(false);
+    lv_obj_set_style_pad_left(label, 9, 0);
+    lv_obj_enable_style_refresh(true);
+    TEST_ASSERT_EQUAL_INT(9, lv_obj_get_style_pad_left(label, 0));
+}
+
+void test_style_cache_follows_transitions(void)
+{
+    static const lv_style_prop_t props[] = {LV_STYLE_BG_OPA, 0};
+    static lv_style_transition_dsc_t tr;
+    lv_style_transition_dsc_init(&tr, props, lv_anim_path_linear, 100, 0, NULL);
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_bg_opa(&style, LV_OPA_COVER);
+    lv_style_set_transition(&style, &tr);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, 0);
+    lv_obj_add_style(obj, &style, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL_UINT8(LV_OPA_TRANSP, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL_UINT8(LV_OPA_TRANSP, lv_obj_get_style_bg_opa(obj, 0));
+    lv_tick_inc(50);
+    lv_anim_refr_now();
+    TEST_ASSERT_UINT8_WITHIN(2, LV_OPA_50, lv_obj_get_style_bg_opa(obj, 0));
+    lv_tick_inc(50);
+    lv_anim_refr_now();
+    TEST_ASSERT_EQUAL_UINT8(LV_OPA_COVER, lv_obj_get_style_bg_opa(obj, 0));
+}
+
+void test_style_cache_bench(void)
+{
+    lv_obj_t * labels[7];
+    uint32_t i;
+    for(i = 0; i < 6; i++) {
+        lv_obj_t * btn = lv_btn_create(lv_scr_act());
+        lv_obj_set_pos(btn, 10 + (i % 2) * 110, 10 + (i / 2) * 70);
+        labels[i] = lv_label_create(btn);
+        lv_label_set_text(labels[i], "Button");
+    }
+    labels[6] = lv_label_create(lv_scr_act());
+    lv_label_set_text(labels[6], "Speak now . . .");
+    lv_obj_align(labels[6], LV_ALIGN_BOTTOM_MID, 0, -10);
+    lv_refr_now(NULL);
+
+    /*Inherited, local, from the theme and default values*/
+    clock_t begin = clock();
+    uint32_t sum = 0;
+    for(i = 0; i < BENCH_READS; i++) {
+        lv_obj_t * label = labels[i % 7];
+        sum += lv_obj_get_style_text_color(label, 0).full + lv_obj_get_style_pad_left(label, 0) +
+               lv_obj_get_style_radius(label, 0) + lv_obj_get_style_bg_opa(label, 0) +
+               (lv_obj_get_style_text_font(label, 0) != NULL);
+    }
+    double ns = lv_test_bench_ns(begin, BENCH_READS * 5);
+    TEST_ASSERT_NOT_EQUAL(0, sum);
+    lv_test_bench_report("Style property reads: %d k per second", (int)(1000000.0 / ns));
+
+    begin = clock();
+    for(i = 0; i < BENCH_FRAMES; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+    ns = lv_test_bench_ns(begin, BENCH_FRAMES);
+    lv_test_bench_report("Whole screen redraw: %d us", (int)(ns / 1000));
+}
+
 #endif
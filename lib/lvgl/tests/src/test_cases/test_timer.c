@@ -0,0 +1,236 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#define BENCH_TIMERS    500
+#define BENCH_CALLS     10000
+
+/*The timers of the display and the input devices, paused during the tests*/
+static lv_timer_t * lib_timers[16];
+static uint32_t lib_timer_cnt;
+
+static char order[16];
+static uint32_t order_len;
+static uint32_t run_cnt;
+static lv_timer_t * victim;
+
+static void record_cb(lv_timer_t * timer)
+{
+    if(order_len < sizeof(order) - 1) {
+        order[order_len++] = (char)(lv_uintptr_t)timer->user_data;
+        order[order_len] = '\0';
+    }
+    run_cnt++;
+}
+
+static void del_victim_cb(lv_timer_t * timer)
+{
+    record_cb(timer);
+    if(victim) lv_timer_del(victim);
+    victim = NULL;
+}
+
+static void del_self_cb(lv_timer_t * timer)
+{
+    record_cb(timer);
+    lv_timer_del(timer);
+}
+
+static void create_cb(lv_timer_t * timer)
+{
+    record_cb(timer);
+    lv_timer_set_repeat_count(lv_timer_create(record_cb, 0, (void *)'n'), 1);
+}
+
+static void count_cb(lv_timer_t * timer)
+{
+    (*(uint32_t *)timer->user_data)++;
+}
+
+void setUp(void)
+{
+    lib_timer_cnt = 0;
+    lv_timer_t * timer = lv_timer_get_next(NULL);
+    while(timer) {
+        if(!timer->paused && lib_timer_cnt < sizeof(lib_timers) / sizeof(lib_timers[0])) {
+            lv_timer_pause(timer);
+            lib_timers[lib_timer_cnt++] = timer;
+        }
+        timer = lv_timer_get_next(timer);
+    }
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+
+    order_len = 0;
+    order[0] = '\0';
+    run_cnt = 0;
+    victim = NULL;
+}
+
+void tearDown(void)
+{
+    uint32_t i;
+    for(i = 0; i < lib_timer_cnt; i++) lv_timer_resume(lib_timers[i]);
+}
+
+static lv_timer_t * create(char name, uint32_t period)
+{
+    return lv_timer_create(record_cb, period, (void *)(lv_uintptr_t)name);
+}
+
+void test_timer_runs_in_deadline_order(void)
+{
+    lv_timer_t * c = create('c', 30);
+    lv_timer_t * a = create('a', 10);
+    lv_timer_t * b = create('b', 20);
+
+    lv_tick_inc(9);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_STRING("", order);
+
+    lv_tick_inc(21);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_get_time_until_next());
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_STRING("abc", order);
+
+    lv_timer_del(a);
+    lv_timer_del(b);
+    lv_timer_del(c);
+}
+
+void test_timer_time_until_next(void)
+{
+    lv_timer_t * a = create('a', 50);
+    lv_timer_t * b = create('b', 120);
+    TEST_ASSERT_EQUAL_UINT32(50, lv_timer_get_time_until_next());
+
+    lv_tick_inc(20);
+    TEST_ASSERT_EQUAL_UINT32(30, lv_timer_get_time_until_next());
+    TEST_ASSERT_EQUAL_UINT32(30, lv_timer_handler());
+
+    lv_timer_pause(a);
+    TEST_ASSERT_EQUAL_UINT32(100, lv_timer_get_time_until_next());
+    lv_timer_resume(a);
+    TEST_ASSERT_EQUAL_UINT32(30, lv_timer_get_time_until_next());
+
+    lv_timer_set_period(a, 200);
+    TEST_ASSERT_EQUAL_UINT32(100, lv_timer_get_time_until_next());
+    lv_timer_reset(b);
+    TEST_ASSERT_EQUAL_UINT32(120, lv_timer_get_time_until_next());
+    lv_timer_ready(a);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_get_time_until_next());
+
+    /*After a run, the next period*/
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_STRING("a", order);
+    TEST_ASSERT_EQUAL_UINT32(120, lv_timer_get_time_until_next());
+
+    lv_timer_del(b);
+    TEST_ASSERT_EQUAL_UINT32(200, lv_timer_get_time_until_next());
+    lv_timer_del(a);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+void test_timer_repeat_count(void)
+{
+    lv_timer_t * once = create('o', 5);
+    lv_timer_set_repeat_count(once, 1);
+    lv_timer_t * twice = create('t', 10);
+    lv_timer_set_repeat_count(twice, 2);
+    lv_timer_t * stopped = create('s', 10);
+    lv_timer_set_repeat_count(stopped, 0);
+
+    /*Deleted on the next call without running*/
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_get_time_until_next());
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(0, run_cnt);
+
+    uint32_t i;
+    for(i = 0; i < 5; i++) {
+        lv_tick_inc(10);
+        lv_timer_handler();
+    }
+    TEST_ASSERT_EQUAL_STRING("ott", order);
+    lv_timer_t * timer = lv_timer_get_next(NULL);
+    while(timer) {
+        TEST_ASSERT_TRUE(timer->timer_cb != record_cb);
+        timer = lv_timer_get_next(timer);
+    }
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+void test_timer_callbacks_change_the_timers(void)
+{
+    /*`d` deletes `v`, which was due in the same call*/
+    lv_timer_t * d = lv_timer_create(del_victim_cb, 9, (void *)'d');
+    victim = lv_timer_create(record_cb, 10, (void *)'v');
+    lv_timer_t * s = lv_timer_create(del_self_cb, 5, (void *)'s');
+    LV_UNUSED(s);
+    lv_timer_t * c = lv_timer_create(create_cb, 20, (void *)'c');
+    lv_timer_set_repeat_count(c, 1);
+
+    lv_tick_inc(10);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_STRING("sd", order);
+
+    /*`c` creates `n` with period 0, which runs in the same call*/
+    lv_tick_inc(10);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_STRING("sddcn", order);
+
+    TEST_ASSERT_EQUAL_UINT32(9, lv_timer_get_time_until_next());
+    lv_timer_del(d);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+void test_timer_period_0_runs_once_per_call(void)
+{
+    lv_timer_t * a = create('a', 0);
+    lv_timer_t * b = create('b', 0);
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_timer_handler());
+    TEST_ASSERT_EQUAL_UINT32(2, run_cnt);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL_UINT32(4, run_cnt);
+
+    lv_timer_del(a);
+    lv_timer_del(b);
+}
+
+void test_timer_many(void)
+{
+    static lv_timer_t * timers[BENCH_TIMERS];
+    uint32_t slow_cnt = 0;
+    uint32_t fast_cnt = 0;
+    uint32_t i;
+
+    /*Hundreds of slow timers with spread out deadlines, one that runs every millisecond*/
+    for(i = 0; i < BENCH_TIMERS; i++) {
+        timers[i] = lv_timer_create(count_cb, 1000 + i, &slow_cnt);
+        TEST_ASSERT_NOT_NULL(timers[i]);
+    }
+    lv_timer_t * fast = lv_timer_create(count_cb, 1, &fast_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, lv_timer_get_time_until_next());
+
+    clock_t begin = clock();
+    for(i = 0; i < BENCH_CALLS; i++) {
+        lv_tick_inc(1);
+        lv_timer_handler();
+    }
+    double ns = lv_test_bench_ns(begin, BENCH_CALLS);
+
+    /*Slow timer `i` ran at 1000 + i, 2000 + 2 * i, ...*/
+    uint32_t expected_slow = 0;
+    for(i = 0; i < BENCH_TIMERS; i++) expected_slow += BENCH_CALLS / (1000 + i);
+    TEST_ASSERT_EQUAL_UINT32(BENCH_CALLS, fast_cnt);
+    TEST_ASSERT_EQUAL_UINT32(expected_slow, slow_cnt);
+
+    lv_test_bench_report("lv_timer_handler() with %d timers: %d ns per call", BENCH_TIMERS + 1, (int)ns);
+
+    for(i = 0; i < BENCH_TIMERS; i++) lv_timer_del(timers[i]);
+    lv_timer_del(fast);
+    TEST_ASSERT_EQUAL_UINT32(LV_NO_TIMER_READY, lv_timer_get_time_until_next());
+}
+
+#endif
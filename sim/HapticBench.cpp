@@ -0,0 +1,182 @@
+#include "HapticBench.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include "SimHost.h"
+#include "../src/VibrationManager.h"
+
+namespace
+{
+  const uint32_t CASE_MS = 1000; // Every case is over well before this
+
+  struct Edge
+  {
+    uint32_t ms;
+    uint32_t duty;
+  };
+
+  // What the bench does to the motors during a case
+  struct Action
+  {
+    uint32_t atMs;
+    const HapticPattern *pattern; // nullptr: stop()
+  };
+
+  struct Case
+  {
+    const char *name;
+    uint32_t latencyUs;
+    std::vector<Action> actions;
+    std::vector<Edge> expected; // Duty changes the steps ask for
+  };
+
+  struct Result
+  {
+    std::vector<Edge> edges;
+    size_t expectedEdges;
+    uint32_t maxLateMs;
+    bool ok;
+  };
+
+  const HapticStep RAMP_STEPS[] = {{80, 30}, {160, 30}, {255, 30}, {0, 40}, {255, 20}};
+  const HapticPattern RAMP = {RAMP_STEPS, 5};
+
+  // 40 steps of 10 ms, the ends of late steps would add up without the fixed schedule
+  HapticStep trainSteps[40];
+  const HapticPattern TRAIN = {trainSteps, 40};
+
+  // The expected duty changes of a pattern started at startMs
+  void expect(std::vector<Edge> &edges, const HapticPattern &p, uint32_t startMs)
+  {
+    uint32_t t = startMs;
+    for (uint8_t i = 0; i < p.count; i++)
+    {
+      edges.push_back({t, p.steps[i].intensity});
+      t += p.steps[i].ms;
+    }
+    edges.push_back({t, 0});
+  }
+
+  Result runCase(VibrationManager &motors, const Case &c)
+  {
+    SimHost::config().timerLatencyUs = c.latencyUs;
+    Result r;
+    r.maxLateMs = 0;
+    r.ok = true;
+
+    uint32_t last = 0;
+    size_t next = 0;
+    for (uint32_t ms = 0; ms < CASE_MS; ms++)
+    {
+      for (; next < c.actions.size() && c.actions[next].atMs == ms; next++)
+      {
+        if (c.actions[next].pattern)
+          motors.play(*c.actions[next].pattern);
+        else
+          motors.stop();
+      }
+      uint32_t duty = ledcRead(0);
+      if (ledcRead(1) != duty)
+        r.ok = false;
+      if (duty != last)
+        r.edges.push_back({ms, duty});
+      last = duty;
+      delay(1);
+    }
+    if (motors.isVibrating())
+      r.ok = false;
+    motors.stop();
+
+    // Steps with the same duty as the one before don't show, drop them from the plan
+    std::vector<Edge> expected;
+    uint32_t duty = 0;
+    for (size_t i = 0; i < c.expected.size(); i++)
+    {
+      if (c.expected[i].duty != duty)
+        expected.push_back(c.expected[i]);
+      duty = c.expected[i].duty;
+    }
+
+    r.expectedEdges = expected.size();
+
+    // Never early, late by the latency rounded up to the 1 ms sampling at most
+    uint32_t allowedMs = (c.latencyUs + 999) / 1000;
+    if (r.edges.size() != expected.size())
+      r.ok = false;
+    for (size_t i = 0; i < r.edges.size() && i < expected.size(); i++)
+    {
+      if (r.edges[i].duty != expected[i].duty || r.edges[i].ms < expected[i].ms)
+      {
+        r.ok = false;
+        continue;
+      }
+      uint32_t late = r.edges[i].ms - expected[i].ms;
+      r.maxLateMs = late > r.maxLateMs ? late : r.maxLateMs;
+      if (late > allowedMs)
+        r.ok = false;
+    }
+    return r;
+  }
+}
+
+int HapticBench::run()
+{
+  for (int i = 0; i < 40; i++)
+  {
+    trainSteps[i].intensity = i % 2 ? 0 : 255;
+    trainSteps[i].ms = 10;
+  }
+
+  std::vector<Case> cases;
+  const struct
+  {
+    const char *name;
+    const HapticPattern *pattern;
+  } presets[] = {{"short", &VibrationManager::SHORT_BUZZ},
+                 {"medium", &VibrationManager::MEDIUM_BUZZ},
+                 {"long", &VibrationManager::LONG_BUZZ},
+                 {"double", &VibrationManager::DOUBLE_BUZZ},
+                 {"ramp", &RAMP}};
+  for (size_t i = 0; i < sizeof(presets) / sizeof(presets[0]); i++)
+  {
+    Case c = {presets[i].name, 0, {{10, presets[i].pattern}}, {}};
+    expect(c.expected, *presets[i].pattern, 10);
+    cases.push_back(c);
+  }
+
+  Case late = {"double_late", 700, {{10, &VibrationManager::DOUBLE_BUZZ}}, {}};
+  expect(late.expected, VibrationManager::DOUBLE_BUZZ, 10);
+  cases.push_back(late);
+
+  Case train = {"train_late", 900, {{10, &TRAIN}}, {}};
+  expect(train.expected, TRAIN, 10);
+  cases.push_back(train);
+
+  // A new pattern replaces the one playing, from its first step
+  Case replace = {"replace", 0, {{10, &VibrationManager::LONG_BUZZ}, {130, &RAMP}}, {}};
+  replace.expected.push_back({10, 255});
+  expect(replace.expected, RAMP, 130);
+  cases.push_back(replace);
+
+  Case stop = {"stop", 0, {{10, &VibrationManager::DOUBLE_BUZZ}, {150, nullptr}}, {}};
+  stop.expected.push_back({10, 255});
+  stop.expected.push_back({110, 0});
+  cases.push_back(stop);
+
+  VibrationManager motors(45, 46);
+  motors.begin();
+
+  printf("  %-12s %10s %6s %8s %8s\n", "case", "latency_us", "edges", "expected", "late_ms");
+  bool clean = true;
+  for (size_t i = 0; i < cases.size(); i++)
+  {
+    Result r = runCase(motors, cases[i]);
+    printf("  %-12s %10lu %6lu %8lu %8lu%s\n", cases[i].name, (unsigned long)cases[i].latencyUs,
+           (unsigned long)r.edges.size(), (unsigned long)r.expectedEdges, (unsigned long)r.maxLateMs,
+           r.ok ? "" : "  FAILED");
+    clean = clean && r.ok;
+  }
+  SimHost::config().timerLatencyUs = 0;
+  printf("HAPTICBENCH %s\n", clean ? "ok" : "failed");
+  return clean ? 0 : 1;
+}
@@ -0,0 +1,12 @@
+// HapticBench.h - plays haptic patterns through VibrationManager on the simulator's
+// esp_timer and checks when the motor duty changes, with and without callback latency
+#ifndef HAPTIC_BENCH_H
+#define HAPTIC_BENCH_H
+
+namespace HapticBench
+{
+  // Returns 0, or 1 when a step started early, late by more than the latency, or was lost
+  int run();
+}
+
+#endif // HAPTIC_BENCH_H
@@ -0,0 +1,149 @@
+#include "RingStress.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../src/SampleRing.h"
+#include <QMI8658.h>
+
+namespace
+{
+  const uint32_t RING_SIZE = 128; // As MotionSampler's
+
+  // Every field derived from the sequence number, so a torn copy shows
+  void fill(QMI8658Sample &s, uint32_t seq)
+  {
+    s.timestamp = seq;
+    for (int i = 0; i < 3; i++)
+    {
+      s.acc_raw[i] = (short)(seq * 3 + i);
+      s.gyro_raw[i] = (short)(seq * 7 + i);
+      s.acc[i] = (float)(seq & 0xFFFF) + i;
+      s.gyro[i] = -(float)(seq & 0xFFFF) - i;
+    }
+  }
+
+  bool intact(const QMI8658Sample &s)
+  {
+    QMI8658Sample expected;
+    fill(expected, s.timestamp);
+    for (int i = 0; i < 3; i++)
+    {
+      if (s.acc_raw[i] != expected.acc_raw[i] || s.gyro_raw[i] != expected.gyro_raw[i] ||
+          s.acc[i] != expected.acc[i] || s.gyro[i] != expected.gyro[i])
+        return false;
+    }
+    return true;
+  }
+
+  void spin(uint32_t iterations)
+  {
+    volatile uint32_t sink = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+      sink += i;
+  }
+
+  struct Case
+  {
+    const char *name;
+    uint32_t items;
+    uint32_t producerSpin; // Busy work between pushes
+    uint32_t consumerSpin; // ... and between pops
+    uint32_t batch;        // Pop up to this many at once
+    bool lossless;         // The producer waits for room instead of dropping
+  };
+
+  struct Result
+  {
+    uint32_t received;
+    uint32_t overruns;
+    uint32_t errors;
+    uint32_t maxFill;
+    double ms;
+  };
+
+  Result runCase(const Case &c)
+  {
+    SampleRing<QMI8658Sample, RING_SIZE> *ring = new SampleRing<QMI8658Sample, RING_SIZE>();
+    std::atomic<bool> done(false);
+    Result r = {0, 0, 0, 0, 0};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::thread producer([&]
+                         {
+      QMI8658Sample s;
+      for (uint32_t seq = 0; seq < c.items; seq++)
+      {
+        fill(s, seq);
+        while (!ring->push(s) && c.lossless)
+          std::this_thread::yield();
+        spin(c.producerSpin);
+      }
+      done.store(true); });
+
+    std::thread consumer([&]
+                         {
+      std::vector<QMI8658Sample> out(c.batch);
+      bool first = true;
+      uint32_t last = 0;
+      for (;;)
+      {
+        bool finished = done.load();
+        uint32_t n = ring->pop(&out[0], c.batch);
+        for (uint32_t i = 0; i < n; i++)
+        {
+          // Overruns drop the newest elements, so sequence numbers may skip but never repeat or go back
+          bool inOrder = first ? (!c.lossless || out[i].timestamp == 0)
+                               : (c.lossless ? out[i].timestamp == last + 1 : out[i].timestamp > last);
+          if (!intact(out[i]) || !inOrder)
+            r.errors++;
+          first = false;
+          last = out[i].timestamp;
+          r.received++;
+        }
+        if (n == 0 && finished)
+          break;
+        if (n == 0)
+          std::this_thread::yield();
+        spin(c.consumerSpin);
+      } });
+
+    producer.join();
+    consumer.join();
+    r.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // Failed pushes the lossless producer retried count as overruns too
+    r.overruns = c.lossless ? 0 : ring->getOverruns();
+    r.maxFill = ring->getMaxFill();
+    if (r.received + r.overruns != c.items)
+      r.errors++;
+    delete ring;
+    return r;
+  }
+}
+
+int RingStress::run()
+{
+  const Case cases[] = {
+      {"lossless", 2000000, 0, 0, 1, true},
+      {"lossless_batched", 2000000, 0, 0, 32, true},
+      {"slow_producer", 200000, 500, 0, 8, true},
+      {"slow_consumer", 200000, 0, 2000, 8, false},
+      {"dropping", 2000000, 0, 0, 32, false},
+  };
+
+  printf("  %-16s %9s %9s %9s %8s %6s %9s\n", "case", "items", "received", "overruns", "max_fill", "errors",
+         "ns/item");
+  bool clean = true;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    Result r = runCase(cases[i]);
+    printf("  %-16s %9lu %9lu %9lu %8lu %6lu %9.1f\n", cases[i].name, (unsigned long)cases[i].items,
+           (unsigned long)r.received, (unsigned long)r.overruns, (unsigned long)r.maxFill, (unsigned long)r.errors,
+           r.ms * 1e6 / cases[i].items);
+    clean = clean && r.errors == 0;
+  }
+  printf("RINGSTRESS %s\n", clean ? "ok" : "failed");
+  return clean ? 0 : 1;
+}
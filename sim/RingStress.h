@@ -0,0 +1,12 @@
+// RingStress.h - hammers SampleRing with real host threads, one producer and one consumer
+// per ring, and checks that every element arrives once, in order and intact
+#ifndef RING_STRESS_H
+#define RING_STRESS_H
+
+namespace RingStress
+{
+  // Returns 0, or 1 when an element was lost, duplicated, reordered or torn
+  int run();
+}
+
+#endif // RING_STRESS_H
@@ -0,0 +1,205 @@
+#include "SchedBench.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <esp_timer.h>
+#include "SimHost.h"
+#include "../src/Scheduler.h"
+
+namespace
+{
+  const uint32_t BENCH_MS = 1000;
+  const uint32_t TICK_US = 1000;      // A wake is at most a tick past the deadline
+  const uint32_t FAST_MS = 7;
+  const uint32_t SLOW_MS = 50;
+  const uint32_t ONCE_MS = 23;
+  const uint32_t REARM_MS = 13;       // The rearm job's own delay, instead of a period
+  const uint32_t HEAVY_MS = 100;
+  const uint32_t HEAVY_RUN_US = 12000; // Longer than the fast job's period
+  const uint32_t BURST_RUNS = 5;      // The continuous job, then it pauses itself
+  const uint64_t TRIGGER_US = 333333; // The timer callback that triggers the event job
+
+  Scheduler scheduler;
+  int burstJob = Scheduler::NO_JOB;
+  int rearmJob = Scheduler::NO_JOB;
+  int eventJob = Scheduler::NO_JOB;
+  unsigned long startUs = 0;
+
+  struct Runs
+  {
+    const char *name;
+    std::vector<unsigned long> at; // micros() from the start of the bench
+  };
+
+  Runs fast = {"fast", {}};
+  Runs slow = {"slow", {}};
+  Runs once = {"once", {}};
+  Runs rearm = {"rearm", {}};
+  Runs heavy = {"heavy", {}};
+  Runs burst = {"burst", {}};
+  Runs event = {"event", {}};
+  unsigned long triggeredAt = 0;
+
+  void record(Runs &runs) { runs.at.push_back(micros() - startUs); }
+
+  void runFast() { record(fast); }
+  void runSlow() { record(slow); }
+  void runOnce() { record(once); }
+  void runEvent() { record(event); }
+
+  void runRearm()
+  {
+    record(rearm);
+    scheduler.runAfter(rearmJob, REARM_MS);
+  }
+
+  void runHeavy()
+  {
+    record(heavy);
+    delayMicroseconds(HEAVY_RUN_US);
+  }
+
+  void runBurst()
+  {
+    record(burst);
+    if (burst.at.size() >= BURST_RUNS)
+      scheduler.pause(burstJob);
+  }
+
+  void onTrigger(void *)
+  {
+    triggeredAt = micros() - startUs;
+    scheduler.trigger(eventJob);
+  }
+
+  struct Check
+  {
+    size_t runs;
+    size_t expectedRuns;
+    unsigned long maxLateUs;
+    bool ok;
+  };
+
+  // Against the deadlines; a run may be late by the tick, plus the heavy job's run time when lateBy is set
+  Check check(const Runs &runs, const std::vector<unsigned long> &deadlines, unsigned long lateBy)
+  {
+    Check c = {runs.at.size(), deadlines.size(), 0, runs.at.size() == deadlines.size()};
+    for (size_t i = 0; i < runs.at.size() && i < deadlines.size(); i++)
+    {
+      if (runs.at[i] < deadlines[i])
+      {
+        c.ok = false;
+        continue;
+      }
+      unsigned long late = runs.at[i] - deadlines[i];
+      c.maxLateUs = late > c.maxLateUs ? late : c.maxLateUs;
+      if (late > TICK_US + lateBy)
+        c.ok = false;
+    }
+    return c;
+  }
+
+  std::vector<unsigned long> every(uint32_t periodMs)
+  {
+    std::vector<unsigned long> deadlines;
+    for (uint32_t ms = 0; ms < BENCH_MS; ms += periodMs)
+      deadlines.push_back(ms * 1000UL);
+    return deadlines;
+  }
+
+  // A periodic job held up by the heavy one: each run at the latest grid deadline before it,
+  // a deadline run twice is a burst. Up to `skips` deadlines may go by while it waits.
+  Check checkGrid(const Runs &runs, uint32_t periodMs, size_t skips)
+  {
+    std::vector<unsigned long> grid = every(periodMs);
+    std::vector<unsigned long> deadlines;
+    for (size_t i = 0; i < runs.at.size(); i++)
+    {
+      unsigned long deadline = runs.at[i] / (periodMs * 1000UL) * periodMs * 1000UL;
+      if (!deadlines.empty() && deadline == deadlines.back())
+        printf("  %s ran twice for its deadline at %lu us\n", runs.name, deadline);
+      deadlines.push_back(deadline);
+    }
+    Check c = check(runs, deadlines, HEAVY_RUN_US);
+    c.expectedRuns = grid.size();
+    for (size_t i = 1; i < deadlines.size(); i++)
+      c.ok = c.ok && deadlines[i] != deadlines[i - 1];
+    c.ok = c.ok && runs.at.size() <= grid.size() && runs.at.size() + skips >= grid.size();
+    return c;
+  }
+
+  bool print(const Runs &runs, const Check &c)
+  {
+    printf("  %-8s %6lu %8lu %10lu%s\n", runs.name, (unsigned long)c.runs, (unsigned long)c.expectedRuns,
+           c.maxLateUs, c.ok ? "" : "  FAILED");
+    return c.ok;
+  }
+}
+
+int SchedBench::run()
+{
+  // Deadlines in whole milliseconds from here, like the loop right after setup()
+  delay(1);
+  startUs = micros();
+  scheduler.begin();
+  scheduler.every("fast", FAST_MS, runFast);
+  scheduler.every("slow", SLOW_MS, runSlow);
+  scheduler.after("once", ONCE_MS, runOnce);
+  rearmJob = scheduler.after("rearm", REARM_MS, runRearm);
+  burstJob = scheduler.every("burst", 0, runBurst);
+  eventJob = scheduler.after("event", 0, runEvent);
+  scheduler.pause(eventJob);
+
+  esp_timer_handle_t timer;
+  esp_timer_create_args_t args = {};
+  args.callback = onTrigger;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "trigger";
+  esp_timer_create(&args, &timer);
+  esp_timer_start_once(timer, TRIGGER_US);
+  scheduler.every("heavy", HEAVY_MS, runHeavy);
+
+  unsigned long slept = 0;
+  while (micros() - startUs < BENCH_MS * 1000UL)
+  {
+    slept += scheduler.run();
+  }
+  esp_timer_stop(timer);
+
+  printf("  %-8s %6s %8s %10s\n", "job", "runs", "expected", "late_max_us");
+  bool clean = true;
+
+  // The heavy job holds up whatever is due while it runs, the fast job skips a period or two
+  size_t heavyRuns = BENCH_MS / HEAVY_MS;
+  clean = print(fast, checkGrid(fast, FAST_MS, heavyRuns * (HEAVY_RUN_US / (FAST_MS * 1000) + 1))) && clean;
+  clean = print(slow, checkGrid(slow, SLOW_MS, 0)) && clean;
+  clean = print(heavy, check(heavy, every(HEAVY_MS), 0)) && clean;
+  clean = print(once, check(once, std::vector<unsigned long>(1, ONCE_MS * 1000UL), 0)) && clean;
+
+  // Each run from the end of the one before
+  std::vector<unsigned long> rearmDeadlines;
+  unsigned long next = REARM_MS * 1000UL;
+  for (size_t i = 0; next < BENCH_MS * 1000UL; i++)
+  {
+    rearmDeadlines.push_back(next);
+    next = (i < rearm.at.size() ? rearm.at[i] : next) + REARM_MS * 1000UL;
+  }
+  clean = print(rearm, check(rearm, rearmDeadlines, HEAVY_RUN_US)) && clean;
+
+  // On the first passes, nothing sleeps in between
+  Check b = check(burst, std::vector<unsigned long>(BURST_RUNS, 0), HEAVY_RUN_US);
+  clean = print(burst, b) && clean;
+
+  // Wakes the sleep early, between two runs of the heavy job
+  clean = print(event, check(event, std::vector<unsigned long>(1, triggeredAt), 0)) && clean;
+
+  // All but the run time of the jobs went to sleep
+  unsigned long busy = heavy.at.size() * HEAVY_RUN_US;
+  unsigned long idle = BENCH_MS * 1000UL - busy;
+  printf("  slept %lu us of %lu idle\n", slept, idle);
+  if (slept + TICK_US < idle || slept > idle)
+    clean = false;
+
+  printf("SCHEDBENCH %s\n", clean ? "ok" : "failed");
+  return clean ? 0 : 1;
+}
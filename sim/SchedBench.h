@@ -0,0 +1,13 @@
+// SchedBench.h - runs a set of jobs through the Scheduler on the simulator's virtual
+// clock and checks when each one ran: periodic and one-shot deadlines, a job that
+// overruns, continuous jobs and a trigger from a timer callback
+#ifndef SCHED_BENCH_H
+#define SCHED_BENCH_H
+
+namespace SchedBench
+{
+  // Returns 0, or 1 when a job ran early, later than a tick after its deadline, too often or not at all
+  int run();
+}
+
+#endif // SCHED_BENCH_H
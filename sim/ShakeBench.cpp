@@ -0,0 +1,302 @@
+#include "ShakeBench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "../src/ShakeDetector.h"
+#include "../src/MotionSampler.h"
+
+namespace
+{
+  const uint32_t ODR_HZ = MotionSampler::ODR_HZ;
+  const float SAMPLE_MS = 1000.0f / ODR_HZ;
+  const float GRACE_MS = 500.0f; // A detection this long after a shake still belongs to it
+
+  struct Trace
+  {
+    std::string name;
+    std::vector<float> acc; // mg, 3 per sample at ODR_HZ
+    std::vector<bool> shaking;
+
+    size_t size() const { return shaking.size(); }
+    void push(float x, float y, float z, bool label)
+    {
+      acc.push_back(x);
+      acc.push_back(y);
+      acc.push_back(z);
+      shaking.push_back(label);
+    }
+  };
+
+  // Deterministic sensor noise
+  uint32_t noiseState = 12345;
+  float noise(float amplitude)
+  {
+    noiseState = noiseState * 1103515245u + 12345u;
+    return amplitude * (((noiseState >> 16) & 0x7FFF) / 16384.0f - 1.0f);
+  }
+
+  void still(Trace &t, float ms)
+  {
+    for (float s = 0; s < ms; s += SAMPLE_MS)
+      t.push(noise(15), noise(15), 1000.0f + noise(15), false);
+  }
+
+  // A shake along (dx, dy, dz)
+  void shake(Trace &t, float ms, float peakMg, float hz, float dx, float dy, float dz)
+  {
+    for (float s = 0; s < ms; s += SAMPLE_MS)
+    {
+      float a = peakMg * sinf(2.0f * (float)M_PI * hz * s / 1000.0f);
+      t.push(dx * a + noise(30), dy * a + noise(30), 1000.0f + dz * a + noise(30), true);
+    }
+  }
+
+  // A knock: a short half-sine and a smaller, damped rebound
+  void bump(Trace &t, float peakMg, float widthMs, float dx, float dy, float dz)
+  {
+    for (float s = 0; s < 4 * widthMs; s += SAMPLE_MS)
+    {
+      float a = s < widthMs ? peakMg * sinf((float)M_PI * s / widthMs)
+                            : -0.3f * peakMg * expf(-(s - widthMs) / widthMs) * sinf((float)M_PI * (s - widthMs) / widthMs);
+      t.push(dx * a + noise(15), dy * a + noise(15), 1000.0f + dz * a + noise(15), false);
+    }
+  }
+
+  std::vector<Trace> builtinTraces()
+  {
+    std::vector<Trace> traces(7);
+    traces[0].name = "hard_shake";
+    traces[1].name = "gentle_shake";
+    traces[2].name = "vertical_shake";
+    traces[3].name = "bumps";
+    traces[4].name = "table_taps";
+    traces[5].name = "walking";
+    traces[6].name = "pick_up_set_down";
+
+    for (int i = 0; i < 3; i++)
+    {
+      still(traces[0], 3000);
+      shake(traces[0], 800, 7000, 8.0f, 1, 0.3f, 0);
+      still(traces[1], 3000);
+      shake(traces[1], 1500, 1800, 4.0f, 0.7f, 0.7f, 0);
+      still(traces[2], 3000);
+      shake(traces[2], 1000, 3000, 5.0f, 0, 0, 1);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+      still(traces[3], 2000);
+      bump(traces[3], 8000, 20, i % 2 ? 1.0f : 0.0f, 0, i % 2 ? 0.0f : 1.0f);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+      still(traces[4], 700);
+      bump(traces[4], 3000, 5, 0, 0, 1);
+    }
+    for (float s = 0; s < 30000; s += SAMPLE_MS)
+    {
+      float step = 2.0f * (float)M_PI * s / 1000.0f;
+      traces[5].push(200.0f * sinf(step) + noise(40), noise(40), 1000.0f + 400.0f * sinf(2.0f * step) + noise(40), false);
+    }
+    for (int i = 0; i < 5; i++)
+    {
+      still(traces[6], 2000);
+      for (float s = 0; s < 600; s += SAMPLE_MS)
+      {
+        float lift = 600.0f * sinf((float)M_PI * s / 600.0f);
+        traces[6].push(0.3f * lift + noise(20), noise(20), 1000.0f + lift + noise(20), false);
+      }
+      still(traces[6], 1500);
+      bump(traces[6], 4000, 15, 0, 0, 1);
+    }
+    for (size_t i = 0; i < traces.size(); i++)
+      still(traces[i], 2000);
+    return traces;
+  }
+
+  // Sample-and-hold resampling of a recorded trace to ODR_HZ
+  bool loadTrace(const char *path, Trace &trace)
+  {
+    FILE *f = fopen(path, "r");
+    if (!f)
+      return false;
+    std::vector<float> t, acc;
+    std::vector<bool> labels;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+      float row[8] = {0};
+      int label = 0;
+      if (sscanf(line, "%f,%f,%f,%f,%f,%f,%f,%d", &row[0], &row[1], &row[2], &row[3], &row[4], &row[5], &row[6],
+                 &label) >= 4)
+      {
+        t.push_back(row[0]);
+        acc.push_back(row[1]);
+        acc.push_back(row[2]);
+        acc.push_back(row[3]);
+        labels.push_back(label != 0);
+      }
+    }
+    fclose(f);
+    if (t.empty())
+      return false;
+
+    trace.name = path;
+    size_t row = 0;
+    for (float s = t.front(); s <= t.back(); s += SAMPLE_MS)
+    {
+      while (row + 1 < t.size() && t[row + 1] <= s)
+        row++;
+      trace.push(acc[3 * row], acc[3 * row + 1], acc[3 * row + 2], labels[row]);
+    }
+    return true;
+  }
+
+  int16_t toRaw(float mg)
+  {
+    long raw = lroundf(mg * MotionSampler::ACC_LSB_PER_G / 1000.0f);
+    return (int16_t)(raw > INT16_MAX ? INT16_MAX : (raw < INT16_MIN ? INT16_MIN : raw));
+  }
+
+  // The check the app had before: one polled sample every 16 ms over 5 g
+  struct ThresholdDetector
+  {
+    uint32_t lastShake;
+    bool hasShake;
+    ThresholdDetector() : lastShake(0), hasShake(false) {}
+
+    bool addSample(const int16_t acc[3], uint32_t timestamp)
+    {
+      const uint32_t pollEvery = 2; // 16 ms at 125 Hz
+      const int32_t threshold = 5 * MotionSampler::ACC_LSB_PER_G;
+      const uint32_t refractory = ShakeDetector::REFRACTORY_MS * ODR_HZ / 1000;
+      if (timestamp % pollEvery)
+        return false;
+      uint32_t mag2 = 0;
+      for (int i = 0; i < 3; i++)
+        mag2 += (uint32_t)((int32_t)acc[i] * acc[i]);
+      if (mag2 <= (uint32_t)threshold * threshold || (hasShake && timestamp - lastShake < refractory))
+        return false;
+      hasShake = true;
+      lastShake = timestamp;
+      return true;
+    }
+  };
+
+  struct Result
+  {
+    int shakes;
+    int found;
+    float latencySumMs;
+    float latencyMaxMs;
+    int falsePositives;
+    float quietMs;
+    Result() : shakes(0), found(0), latencySumMs(0), latencyMaxMs(0), falsePositives(0), quietMs(0) {}
+  };
+
+  template <typename Detector>
+  Result evaluate(const Trace &trace, Detector &detector)
+  {
+    Result r;
+    // Labeled segments as [start, end) in samples
+    std::vector<std::pair<size_t, size_t> > segments;
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      if (trace.shaking[i] && (i == 0 || !trace.shaking[i - 1]))
+        segments.push_back(std::make_pair(i, trace.size()));
+      if (!trace.shaking[i] && i > 0 && trace.shaking[i - 1])
+        segments.back().second = i;
+      if (!trace.shaking[i])
+        r.quietMs += SAMPLE_MS;
+    }
+    r.shakes = (int)segments.size();
+    std::vector<bool> found(segments.size(), false);
+    size_t grace = (size_t)(GRACE_MS / SAMPLE_MS);
+
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      int16_t raw[3] = {toRaw(trace.acc[3 * i]), toRaw(trace.acc[3 * i + 1]), toRaw(trace.acc[3 * i + 2])};
+      if (!detector.addSample(raw, (uint32_t)i))
+        continue;
+
+      bool matched = false;
+      for (size_t s = 0; s < segments.size() && !matched; s++)
+      {
+        if (i < segments[s].first || i >= segments[s].second + grace)
+          continue;
+        matched = true;
+        if (!found[s])
+        {
+          found[s] = true;
+          float latency = (i - segments[s].first) * SAMPLE_MS;
+          r.found++;
+          r.latencySumMs += latency;
+          r.latencyMaxMs = latency > r.latencyMaxMs ? latency : r.latencyMaxMs;
+        }
+      }
+      if (!matched)
+        r.falsePositives++;
+    }
+    return r;
+  }
+
+  void printRow(const char *trace, const char *detector, const Result &r)
+  {
+    printf("  %-20s %-10s %6d %6d %8.0f %8.0f %6d %10.1f\n", trace, detector, r.shakes, r.found,
+           r.found ? r.latencySumMs / r.found : 0.0f, r.latencyMaxMs, r.falsePositives,
+           r.quietMs > 0 ? r.falsePositives * 3600000.0f / r.quietMs : 0.0f);
+  }
+
+  void add(Result &total, const Result &r)
+  {
+    total.shakes += r.shakes;
+    total.found += r.found;
+    total.latencySumMs += r.latencySumMs;
+    total.latencyMaxMs = r.latencyMaxMs > total.latencyMaxMs ? r.latencyMaxMs : total.latencyMaxMs;
+    total.falsePositives += r.falsePositives;
+    total.quietMs += r.quietMs;
+  }
+}
+
+int ShakeBench::run(const char *csvPath)
+{
+  std::vector<Trace> traces;
+  if (csvPath)
+  {
+    Trace trace;
+    if (!loadTrace(csvPath, trace))
+    {
+      fprintf(stderr, "Cannot read IMU trace %s\n", csvPath);
+      return 2;
+    }
+    traces.push_back(trace);
+  }
+  else
+  {
+    traces = builtinTraces();
+  }
+
+  printf("  %-20s %-10s %6s %6s %8s %8s %6s %10s\n", "trace", "detector", "shakes", "found", "mean_ms", "max_ms",
+         "false", "fp_per_h");
+  Result windowedTotal, thresholdTotal;
+  for (size_t i = 0; i < traces.size(); i++)
+  {
+    ShakeDetector windowed(MotionSampler::ACC_LSB_PER_G, ODR_HZ);
+    ThresholdDetector threshold;
+    Result w = evaluate(traces[i], windowed);
+    Result t = evaluate(traces[i], threshold);
+    printRow(traces[i].name.c_str(), "windowed", w);
+    printRow("", "threshold", t);
+    add(windowedTotal, w);
+    add(thresholdTotal, t);
+  }
+  printRow("total", "windowed", windowedTotal);
+  printRow("", "threshold", thresholdTotal);
+
+  printf("SHAKEBENCH found=%d/%d mean_latency_ms=%.0f false=%d\n", windowedTotal.found, windowedTotal.shakes,
+         windowedTotal.found ? windowedTotal.latencySumMs / windowedTotal.found : 0.0f, windowedTotal.falsePositives);
+
+  bool clean = windowedTotal.found == windowedTotal.shakes && windowedTotal.falsePositives == 0;
+  return (csvPath || clean) ? 0 : 1;
+}
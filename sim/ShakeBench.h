@@ -0,0 +1,14 @@
+// ShakeBench.h - replays labeled IMU traces through the shake detector and reports
+// detection latency and false positives, next to the old single-sample threshold
+#ifndef SHAKE_BENCH_H
+#define SHAKE_BENCH_H
+
+namespace ShakeBench
+{
+  // csvPath: trace with rows "t_ms,ax,ay,az,gx,gy,gz,shaking" (mg, dps, 0/1),
+  // nullptr runs the built-in set of shakes, bumps, taps and walking.
+  // Returns 0, or 1 when the built-in set has a missed shake or a false positive.
+  int run(const char *csvPath);
+}
+
+#endif // SHAKE_BENCH_H
@@ -0,0 +1,127 @@
+#include "SimAlloc.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#include <atomic>
+
+static std::atomic<uint64_t> allocCount(0);
+static std::atomic<uint64_t> freeCount(0);
+static std::atomic<uint64_t> reallocCount(0);
+static std::atomic<uint64_t> allocBytes(0);
+
+#if defined(__GLIBC__)
+// Interpose the C allocator so LVGL (LV_MEM_CUSTOM), the app and operator new are all counted
+extern "C"
+{
+  void *__libc_malloc(size_t size);
+  void *__libc_calloc(size_t n, size_t size);
+  void *__libc_realloc(void *ptr, size_t size);
+  void __libc_free(void *ptr);
+
+  void *malloc(size_t size) noexcept
+  {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void *calloc(size_t n, size_t size) noexcept
+  {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(n * size, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+  }
+
+  void *realloc(void *ptr, size_t size) noexcept
+  {
+    if (ptr)
+      reallocCount.fetch_add(1, std::memory_order_relaxed);
+    else
+      allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+  }
+
+  void free(void *ptr) noexcept
+  {
+    if (ptr)
+    {
+      freeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    __libc_free(ptr);
+  }
+}
+
+bool SimAlloc::available()
+{
+  return true;
+}
+#else
+bool SimAlloc::available()
+{
+  return false;
+}
+#endif
+
+SimAlloc::Counters SimAlloc::snapshot()
+{
+  Counters c;
+  c.allocs = allocCount.load(std::memory_order_relaxed);
+  c.frees = freeCount.load(std::memory_order_relaxed);
+  c.reallocs = reallocCount.load(std::memory_order_relaxed);
+  c.bytes = allocBytes.load(std::memory_order_relaxed);
+  return c;
+}
+
+// ---------------------------------------------------------------------------
+// ESP-IDF heap API, every capability maps to the host heap
+// ---------------------------------------------------------------------------
+
+void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+  (void)caps;
+  return malloc(size);
+}
+
+void *heap_caps_malloc_prefer(size_t size, size_t num, ...)
+{
+  (void)num;
+  return malloc(size);
+}
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+  (void)caps;
+  return calloc(n, size);
+}
+
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps)
+{
+  (void)caps;
+  return realloc(ptr, size);
+}
+
+void heap_caps_free(void *ptr)
+{
+  free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+  return (caps & MALLOC_CAP_SPIRAM) ? ESP.getFreePsram() : ESP.getFreeHeap();
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+  return heap_caps_get_free_size(caps);
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+  return ESP.getFreeHeap();
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+  return ESP.getFreeHeap();
+}
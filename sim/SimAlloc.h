@@ -0,0 +1,22 @@
+// SimAlloc.h - heap operation counters of the simulator (glibc hosts)
+#ifndef SIM_ALLOC_H
+#define SIM_ALLOC_H
+
+#include <stdint.h>
+
+namespace SimAlloc
+{
+  struct Counters
+  {
+    uint64_t allocs;  // malloc/calloc/realloc(NULL) calls
+    uint64_t frees;   // free calls on non-NULL pointers
+    uint64_t reallocs; // realloc of an existing block
+    uint64_t bytes;   // bytes requested
+  };
+
+  // Whether the counters are live on this host
+  bool available();
+  Counters snapshot();
+}
+
+#endif // SIM_ALLOC_H
@@ -0,0 +1,185 @@
+#include "SimAudio.h"
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <vector>
+#include "SimHost.h"
+#include "../src/Recorder.h"
+
+static std::vector<int16_t> clip;
+static size_t playPos = 0;
+static bool armed = false;
+static uint32_t sampleClockFrac = 0; // Sub-microsecond remainder of the ADC sample clock
+
+static const uint32_t ADC_FULL_SCALE_MV = 3300;
+
+static uint32_t readLE(const uint8_t *p, int bytes)
+{
+  uint32_t v = 0;
+  for (int i = bytes - 1; i >= 0; i--)
+  {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+bool SimAudio::loadWav(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    return false;
+  }
+  std::vector<uint8_t> file;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+  {
+    file.insert(file.end(), chunk, chunk + n);
+  }
+  fclose(f);
+
+  if (file.size() < 12 || memcmp(&file[0], "RIFF", 4) != 0 || memcmp(&file[8], "WAVE", 4) != 0)
+  {
+    return false;
+  }
+
+  uint16_t format = 0, channels = 0, bits = 0;
+  uint32_t rate = 0;
+  const uint8_t *data = nullptr;
+  uint32_t dataSize = 0;
+  size_t pos = 12;
+  while (pos + 8 <= file.size())
+  {
+    uint32_t size = readLE(&file[pos + 4], 4);
+    const uint8_t *body = &file[pos + 8];
+    if (pos + 8 + size > file.size())
+    {
+      size = (uint32_t)(file.size() - pos - 8);
+    }
+    if (memcmp(&file[pos], "fmt ", 4) == 0 && size >= 16)
+    {
+      format = (uint16_t)readLE(body, 2);
+      channels = (uint16_t)readLE(body + 2, 2);
+      rate = readLE(body + 4, 4);
+      bits = (uint16_t)readLE(body + 14, 2);
+    }
+    else if (memcmp(&file[pos], "data", 4) == 0)
+    {
+      data = body;
+      dataSize = size;
+    }
+    pos += 8 + size + (size & 1);
+  }
+  if (format != 1 || bits != 16 || channels == 0 || rate == 0 || !data)
+  {
+    return false;
+  }
+
+  size_t frames = dataSize / (2 * channels);
+  size_t outFrames = (size_t)((uint64_t)frames * SAMPLE_RATE / rate);
+  clip.resize(outFrames);
+  for (size_t i = 0; i < outFrames; i++)
+  {
+    size_t src = (size_t)((uint64_t)i * rate / SAMPLE_RATE);
+    clip[i] = (int16_t)readLE(data + src * 2 * channels, 2);
+  }
+  playPos = 0;
+  return true;
+}
+
+void SimAudio::setSyntheticVoice(uint32_t duration_ms)
+{
+  size_t count = (size_t)duration_ms * SAMPLE_RATE / 1000;
+  clip.resize(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    float t = (float)i / SAMPLE_RATE;
+    float syllables = 0.5f + 0.5f * sinf(2.0f * (float)M_PI * 4.0f * t);
+    clip[i] = (int16_t)(9000.0f * syllables * sinf(2.0f * (float)M_PI * 220.0f * t));
+  }
+  playPos = 0;
+}
+
+void SimAudio::arm()
+{
+  armed = true;
+  playPos = 0;
+}
+
+bool SimAudio::isArmed()
+{
+  return armed;
+}
+
+bool SimAudio::isFinished()
+{
+  return armed && playPos >= clip.size();
+}
+
+size_t SimAudio::samplesPlayed()
+{
+  return playPos;
+}
+
+// ---------------------------------------------------------------------------
+// ADC1 driver
+// ---------------------------------------------------------------------------
+
+esp_err_t adc1_config_width(adc_bits_width_t width_bit)
+{
+  (void)width_bit;
+  return ESP_OK;
+}
+
+esp_err_t adc1_config_channel_atten(adc1_channel_t channel, adc_atten_t atten)
+{
+  (void)channel;
+  (void)atten;
+  return ESP_OK;
+}
+
+esp_err_t adc1_pad_get_io_num(adc1_channel_t channel, gpio_num_t *gpio_num)
+{
+  if (channel >= ADC1_CHANNEL_MAX || !gpio_num)
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *gpio_num = (gpio_num_t)(channel + 1); // ADC1_CHANNEL_n is GPIO n+1 on the S3
+  return ESP_OK;
+}
+
+// Each read takes one sample period of the simulator clock, like the real sampling loop
+int adc1_get_raw(adc1_channel_t channel)
+{
+  sampleClockFrac += 1000000;
+  SimHost::advanceUs(sampleClockFrac / SAMPLE_RATE);
+  sampleClockFrac %= SAMPLE_RATE;
+
+  int16_t sample = 0;
+  if (channel == ADC_MIC_CHANNEL && armed && playPos < clip.size())
+  {
+    sample = clip[playPos++];
+  }
+
+  // Inverse of VoiceActivatedRecorder::readADCSample(): 64 LSB per mV around the MAX9814 bias
+  int32_t mv = DC_OFFSET + sample / 64;
+  int32_t raw = (int32_t)(((int64_t)mv * 4095 + ADC_FULL_SCALE_MV / 2) / ADC_FULL_SCALE_MV);
+  return constrain(raw, 0, 4095);
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width,
+                                             uint32_t default_vref, esp_adc_cal_characteristics_t *chars)
+{
+  chars->adc_num = adc_num;
+  chars->atten = atten;
+  chars->bit_width = bit_width;
+  chars->vref = default_vref;
+  return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t adc_reading, const esp_adc_cal_characteristics_t *chars)
+{
+  (void)chars;
+  return adc_reading * ADC_FULL_SCALE_MV / 4095;
+}
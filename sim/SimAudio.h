@@ -0,0 +1,23 @@
+// SimAudio.h - microphone of the simulator, plays a WAV file (or a synthetic voice) into ADC1
+#ifndef SIM_AUDIO_H
+#define SIM_AUDIO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace SimAudio
+{
+  // 16-bit PCM WAV, any rate, first channel only; resampled to the recorder's SAMPLE_RATE
+  bool loadWav(const char *path);
+
+  // A spoken-like burst: amplitude-modulated tone followed by silence
+  void setSyntheticVoice(uint32_t duration_ms);
+
+  // Start playing from the next ADC read, until then the microphone is silent
+  void arm();
+  bool isArmed();
+  bool isFinished();
+  size_t samplesPlayed();
+}
+
+#endif // SIM_AUDIO_H
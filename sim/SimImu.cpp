@@ -0,0 +1,549 @@
+#include "SimImu.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <QMI8658.h>
+#include <DEV_Config.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include <WiFi.h>
+#include "SimHost.h"
+#include <deque>
+
+TwoWire Wire;
+
+static std::vector<SimImu::Sample> trace;
+static uint32_t replayStart = 0;
+static uint8_t regs[128];
+
+// FIFO: 12 byte acc + gyro samples, filled at the ODR while not in bypass mode
+static std::deque<uint8_t> fifo;
+static uint32_t fifoFilledUs = 0;
+static bool fifoOverflow = false;
+
+// Wake on motion: the accelerometer runs at 21 Hz and the INT line toggles on every event
+static const uint32_t WOM_PERIOD_US = 1000000 / 21;
+static bool womArmed = false;
+static uint8_t womPin = 0;
+static uint8_t womLevel = LOW;
+static float womLastAcc[3];
+static uint32_t womSampledUs = 0;
+
+static void updateWakeOnMotion();
+
+// ---------------------------------------------------------------------------
+// Trace
+// ---------------------------------------------------------------------------
+
+static SimImu::Sample stillSample(uint32_t t_ms)
+{
+  SimImu::Sample s = {t_ms, {0.0f, 0.0f, 1000.0f}, {0.0f, 0.0f, 0.0f}};
+  return s;
+}
+
+bool SimImu::loadCsv(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  if (!f)
+  {
+    return false;
+  }
+  std::vector<Sample> rows;
+  char line[256];
+  while (fgets(line, sizeof(line), f))
+  {
+    Sample s;
+    unsigned long t;
+    if (sscanf(line, "%lu,%f,%f,%f,%f,%f,%f", &t, &s.acc[0], &s.acc[1], &s.acc[2],
+               &s.gyro[0], &s.gyro[1], &s.gyro[2]) == 7)
+    {
+      s.t_ms = (uint32_t)t;
+      rows.push_back(s);
+    }
+  }
+  fclose(f);
+  if (rows.empty())
+  {
+    return false;
+  }
+  setTrace(rows);
+  return true;
+}
+
+void SimImu::setTrace(const std::vector<Sample> &t)
+{
+  trace = t;
+}
+
+bool SimImu::hasTrace()
+{
+  return !trace.empty();
+}
+
+void SimImu::startReplay(uint32_t now_ms)
+{
+  replayStart = now_ms;
+}
+
+SimImu::Sample SimImu::sampleAt(uint32_t now_ms)
+{
+  if (trace.empty() || (int32_t)(now_ms - replayStart) < 0)
+  {
+    return stillSample(now_ms);
+  }
+  uint32_t t = now_ms - replayStart;
+  if (t > trace.back().t_ms)
+  {
+    return stillSample(now_ms);
+  }
+
+  // Last row at or before t
+  size_t lo = 0, hi = trace.size();
+  while (hi - lo > 1)
+  {
+    size_t mid = (lo + hi) / 2;
+    if (trace[mid].t_ms <= t)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return trace[lo];
+}
+
+void SimImu::appendStill(std::vector<Sample> &out, uint32_t from_ms, uint32_t duration_ms, float wobble_dps)
+{
+  // Slow hand tremor so the tilt-driven triangle keeps moving
+  for (uint32_t t = 0; t < duration_ms; t += 10)
+  {
+    Sample s = stillSample(from_ms + t);
+    float phase = (from_ms + t) * 0.001f;
+    s.gyro[0] = wobble_dps * sinf(phase * 2.1f);
+    s.gyro[1] = wobble_dps * cosf(phase * 1.3f);
+    out.push_back(s);
+  }
+}
+
+void SimImu::appendShake(std::vector<Sample> &out, uint32_t from_ms, uint32_t duration_ms, float peak_mg)
+{
+  // ~8 Hz back and forth along X
+  for (uint32_t t = 0; t < duration_ms; t += 10)
+  {
+    Sample s = stillSample(from_ms + t);
+    float swing = sinf(t * 0.05f);
+    s.acc[0] = peak_mg * swing;
+    s.acc[1] = 0.3f * peak_mg * swing;
+    s.gyro[2] = 400.0f * swing;
+    out.push_back(s);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Register file
+// ---------------------------------------------------------------------------
+
+static void putShort(uint8_t reg, float value)
+{
+  long raw = lroundf(value);
+  if (raw > INT16_MAX)
+    raw = INT16_MAX;
+  if (raw < INT16_MIN)
+    raw = INT16_MIN;
+  regs[reg] = (uint8_t)(raw & 0xFF);
+  regs[reg + 1] = (uint8_t)((raw >> 8) & 0xFF);
+}
+
+// Output data rate from the accelerometer ODR code in CTRL2 (normal mode codes only)
+static uint32_t odrHz()
+{
+  uint8_t odr = regs[QMI8658Register_Ctrl2] & 0x0F;
+  return odr <= 8 ? 8000u >> odr : 8000u >> 8;
+}
+
+// Refresh the output registers from the trace, scaled by the ranges in CTRL2/CTRL3
+static void latchOutputs()
+{
+  uint32_t now = millis();
+  SimImu::Sample s = SimImu::sampleAt(now);
+
+  float accLsbPerMg = (float)(1 << (14 - ((regs[QMI8658Register_Ctrl2] >> 4) & 0x03))) / 1000.0f;
+  float gyroLsbPerDps = (float)(1024 >> ((regs[QMI8658Register_Ctrl3] >> 4) & 0x07));
+
+  // Sample counter at the ODR, 24 bits
+  uint32_t ts = (uint32_t)((uint64_t)micros() * odrHz() / 1000000u) & 0xFFFFFF;
+  regs[QMI8658Register_Timestamp_L] = ts & 0xFF;
+  regs[QMI8658Register_Timestamp_M] = (ts >> 8) & 0xFF;
+  regs[QMI8658Register_Timestamp_H] = (ts >> 16) & 0xFF;
+  putShort(QMI8658Register_Tempearture_L, 25.0f * 256.0f);
+
+  for (int i = 0; i < 3; i++)
+  {
+    putShort(QMI8658Register_Ax_L + 2 * i, s.acc[i] * accLsbPerMg);
+    putShort(QMI8658Register_Gx_L + 2 * i, s.gyro[i] * gyroLsbPerDps);
+  }
+  regs[QMI8658Register_Status0] = 0x03; // Accel and gyro data available
+  updateWakeOnMotion();
+}
+
+static size_t fifoCapacity()
+{
+  return (size_t)(16 << ((regs[QMI8658Register_FifoCtrl] >> 2) & 0x03)) * 12;
+}
+
+// Append the samples taken since the last fill
+static void fillFifo()
+{
+  uint32_t nowUs = micros();
+  uint32_t periodUs = 1000000u / odrHz();
+  uint8_t mode = regs[QMI8658Register_FifoCtrl] & 0x03;
+  if (mode == QMI8658FifoMode_Bypass || (regs[QMI8658Register_FifoCtrl] & QMI8658_FIFO_CTRL_RD_MODE))
+  {
+    fifoFilledUs = nowUs;
+    return;
+  }
+
+  float accLsbPerMg = (float)(1 << (14 - ((regs[QMI8658Register_Ctrl2] >> 4) & 0x03))) / 1000.0f;
+  float gyroLsbPerDps = (float)(1024 >> ((regs[QMI8658Register_Ctrl3] >> 4) & 0x07));
+  while (nowUs - fifoFilledUs >= periodUs)
+  {
+    fifoFilledUs += periodUs;
+    if (fifo.size() + 12 > fifoCapacity())
+    {
+      if (mode == QMI8658FifoMode_Fifo)
+      {
+        continue; // Full, new samples are dropped
+      }
+      fifo.erase(fifo.begin(), fifo.begin() + 12);
+      fifoOverflow = true;
+    }
+    SimImu::Sample s = SimImu::sampleAt(fifoFilledUs / 1000);
+    for (int i = 0; i < 6; i++)
+    {
+      float v = i < 3 ? s.acc[i] * accLsbPerMg : s.gyro[i - 3] * gyroLsbPerDps;
+      long raw = lroundf(v);
+      raw = raw > INT16_MAX ? INT16_MAX : (raw < INT16_MIN ? INT16_MIN : raw);
+      fifo.push_back((uint8_t)(raw & 0xFF));
+      fifo.push_back((uint8_t)((raw >> 8) & 0xFF));
+    }
+  }
+}
+
+static void latchFifoStatus()
+{
+  size_t words = fifo.size() / 2;
+  uint8_t status = (uint8_t)((words >> 8) & QMI8658_FIFO_STATUS_CNT_MSB);
+  if (!fifo.empty())
+    status |= QMI8658_FIFO_STATUS_NOT_EMPTY;
+  if (fifo.size() >= (size_t)regs[QMI8658Register_FifoWtmTh] * 12)
+    status |= QMI8658_FIFO_STATUS_WTM;
+  if (fifo.size() + 12 > fifoCapacity())
+    status |= QMI8658_FIFO_STATUS_FULL;
+  if (fifoOverflow)
+    status |= QMI8658_FIFO_STATUS_OVERFLOW;
+  regs[QMI8658Register_FifoSmplCnt] = (uint8_t)(words & 0xFF);
+  regs[QMI8658Register_FifoStatus] = status;
+}
+
+static void armWakeOnMotion()
+{
+  womArmed = regs[QMI8658Register_Cal1_L] != 0;
+  if (!womArmed)
+    return;
+
+  uint8_t select = regs[QMI8658Register_Cal1_H];
+  womPin = (select & QMI8658_Int1) ? DEV_INT1_PIN : DEV_INT2_PIN;
+  womLevel = (select & QMI8658State_high) ? HIGH : LOW;
+  digitalWrite(womPin, womLevel);
+
+  SimImu::Sample s = SimImu::sampleAt(millis());
+  memcpy(womLastAcc, s.acc, sizeof(womLastAcc));
+  womSampledUs = micros();
+}
+
+// Compare the low power samples taken since the last call against the threshold
+static void updateWakeOnMotion()
+{
+  if (!womArmed || !(regs[QMI8658Register_Ctrl7] & QMI8658_CTRL7_ACC_ENABLE))
+    return;
+
+  uint32_t nowUs = micros();
+  float threshold = regs[QMI8658Register_Cal1_L];
+  while (nowUs - womSampledUs >= WOM_PERIOD_US)
+  {
+    womSampledUs += WOM_PERIOD_US;
+    SimImu::Sample s = SimImu::sampleAt(womSampledUs / 1000);
+    bool moved = false;
+    for (int i = 0; i < 3; i++)
+    {
+      moved = moved || fabsf(s.acc[i] - womLastAcc[i]) > threshold;
+      womLastAcc[i] = s.acc[i];
+    }
+    if (moved)
+    {
+      womLevel = womLevel == HIGH ? LOW : HIGH;
+      digitalWrite(womPin, womLevel);
+      regs[QMI8658Register_Status1] |= QMI8658_STATUS1_WAKEUP_EVENT;
+    }
+  }
+}
+
+static void runCtrl9(uint8_t cmd)
+{
+  if (cmd == QMI8658_Ctrl9_Cmd_NOP)
+  {
+    regs[QMI8658Register_StatusInt] &= ~QMI8658_STATUSINT_CMD_DONE;
+    return;
+  }
+  if (cmd == QMI8658_Ctrl9_Cmd_Rst_Fifo)
+  {
+    fifo.clear();
+    fifoOverflow = false;
+    fifoFilledUs = micros();
+  }
+  else if (cmd == QMI8658_Ctrl9_Cmd_Req_Fifo)
+  {
+    fillFifo();
+    regs[QMI8658Register_FifoCtrl] |= QMI8658_FIFO_CTRL_RD_MODE;
+    latchFifoStatus();
+    fifoOverflow = false;
+  }
+  else if (cmd == QMI8658_Ctrl9_Cmd_WoM_Setting)
+  {
+    armWakeOnMotion();
+  }
+  regs[QMI8658Register_StatusInt] |= QMI8658_STATUSINT_CMD_DONE;
+  regs[QMI8658Register_Status1] |= QMI8658_STATUS1_CMD_DONE;
+}
+
+static void writeReg(uint8_t reg, uint8_t value)
+{
+  if (reg == QMI8658Register_FifoCtrl)
+  {
+    // Samples taken while the FIFO was being read are still collected
+    fillFifo();
+  }
+  if (reg < sizeof(regs) && reg > QMI8658Register_Revision)
+  {
+    regs[reg] = value;
+  }
+  if (reg == QMI8658Register_Ctrl9)
+  {
+    runCtrl9(value);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// TwoWire
+// ---------------------------------------------------------------------------
+
+// SA0 selects 0x6A or 0x6B, answer on both
+static bool isImu(uint8_t address)
+{
+  return address == 0x6A || address == 0x6B;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _address = address;
+  _txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+  if (_txLen >= sizeof(_tx))
+  {
+    return 0;
+  }
+  _tx[_txLen++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t len)
+{
+  size_t n = 0;
+  while (n < len && write(data[n]))
+  {
+    n++;
+  }
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+  if (!isImu(_address))
+  {
+    return _txLen ? 2 : 0; // NACK on address
+  }
+  // First byte selects the register, the rest are written to consecutive registers
+  if (_txLen > 0)
+  {
+    for (size_t i = 1; i < _txLen; i++)
+    {
+      writeReg(_tx[0] + i - 1, _tx[i]);
+    }
+    _reg = _tx[0]; // Register pointer for a following read
+  }
+  _txLen = 0;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, size_t len)
+{
+  _rxLen = 0;
+  if (!isImu(address))
+  {
+    _rxPos = 0;
+    return 0;
+  }
+  latchOutputs();
+  uint8_t reg = _reg;
+  for (size_t i = 0; i < len && i < sizeof(_rx); i++, reg++)
+  {
+    if (_reg == QMI8658Register_FifoData)
+    {
+      // No auto-increment, every byte is popped from the FIFO
+      reg = QMI8658Register_FifoData;
+      if (fifo.empty())
+      {
+        _rx[i] = 0;
+        continue;
+      }
+      _rx[i] = fifo.front();
+      fifo.pop_front();
+      continue;
+    }
+    _rx[i] = reg < sizeof(regs) ? regs[reg] : 0;
+  }
+  _rxLen = len < sizeof(_rx) ? len : sizeof(_rx);
+  _rxPos = 0;
+  if (_reg <= QMI8658Register_Status1 && _reg + _rxLen > QMI8658Register_Status1)
+  {
+    regs[QMI8658Register_Status1] &= ~QMI8658_STATUS1_WAKEUP_EVENT; // Cleared on read
+  }
+  return (uint8_t)_rxLen;
+}
+
+int TwoWire::available()
+{
+  return (int)(_rxLen - _rxPos);
+}
+
+int TwoWire::read()
+{
+  return _rxPos < _rxLen ? _rx[_rxPos++] : -1;
+}
+
+// Identity registers of a QMI8658C
+struct ImuIdentity
+{
+  ImuIdentity()
+  {
+    regs[QMI8658Register_WhoAmI] = 0x05;
+    regs[QMI8658Register_Revision] = 0x7C;
+  }
+};
+static ImuIdentity imuIdentity;
+
+// ---------------------------------------------------------------------------
+// Light and deep sleep, the IMU interrupt line is the GPIO or ext0 wake source
+// ---------------------------------------------------------------------------
+
+static int wakePin = -1;
+static int wakeLevel = HIGH;
+static bool gpioWakeup = false;
+static int ext0Pin = -1;
+static int ext0Level = HIGH;
+static uint64_t timerWakeupUs = 0;
+static esp_sleep_wakeup_cause_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+void SimImu::setWakeCause(int cause)
+{
+  wakeCause = (esp_sleep_wakeup_cause_t)cause;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+  if (intr_type != GPIO_INTR_LOW_LEVEL && intr_type != GPIO_INTR_HIGH_LEVEL)
+    return ESP_ERR_INVALID_ARG;
+  wakePin = gpio_num;
+  wakeLevel = intr_type == GPIO_INTR_HIGH_LEVEL ? HIGH : LOW;
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num)
+{
+  if (gpio_num == wakePin)
+    wakePin = -1;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void)
+{
+  gpioWakeup = true;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+  timerWakeupUs = time_in_us;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level)
+{
+  ext0Pin = gpio_num;
+  ext0Level = level ? HIGH : LOW;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source)
+{
+  if (source == ESP_SLEEP_WAKEUP_GPIO)
+    gpioWakeup = false;
+  else if (source == ESP_SLEEP_WAKEUP_EXT0)
+    ext0Pin = -1;
+  else if (source == ESP_SLEEP_WAKEUP_TIMER)
+    timerWakeupUs = 0;
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+  return wakeCause;
+}
+
+// Advances the clock until an enabled source fires
+static esp_sleep_wakeup_cause_t sleepUntilWakeup()
+{
+  // Give up after an hour without a wake source, so a scenario can't hang
+  const uint64_t maxSleepUs = 3600ULL * 1000000;
+  uint64_t start = SimHost::nowUs();
+  while (SimHost::nowUs() - start < maxSleepUs)
+  {
+    delayMicroseconds(1000);
+    updateWakeOnMotion();
+    if (gpioWakeup && wakePin >= 0 && digitalRead(wakePin) == wakeLevel)
+      return ESP_SLEEP_WAKEUP_GPIO;
+    if (ext0Pin >= 0 && digitalRead(ext0Pin) == ext0Level)
+      return ESP_SLEEP_WAKEUP_EXT0;
+    if (timerWakeupUs && SimHost::nowUs() - start >= timerWakeupUs)
+      return ESP_SLEEP_WAKEUP_TIMER;
+  }
+  return ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+esp_err_t esp_light_sleep_start(void)
+{
+  wakeCause = sleepUntilWakeup();
+  WiFi.lightSleep();
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+  // The GPIO wake is for light sleep only, ext0 (RTC GPIO) works in both
+  bool gpio = gpioWakeup;
+  gpioWakeup = false;
+  esp_sleep_wakeup_cause_t cause = sleepUntilWakeup();
+  gpioWakeup = gpio;
+  SimHost::deepSleepReset(cause);
+}
@@ -0,0 +1,39 @@
+// SimImu.h - QMI8658 emulated at register level, fed from a recorded or synthetic motion trace
+// The real QMI8658 driver runs unchanged on top of it through the Wire shim.
+#ifndef SIM_IMU_H
+#define SIM_IMU_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace SimImu
+{
+  // One trace row: milliseconds since the start of the replay, acceleration in mg, rotation in dps
+  struct Sample
+  {
+    uint32_t t_ms;
+    float acc[3];
+    float gyro[3];
+  };
+
+  // CSV rows "t_ms,ax,ay,az,gx,gy,gz", a non-numeric first line is taken as a header
+  bool loadCsv(const char *path);
+  void setTrace(const std::vector<Sample> &trace);
+  bool hasTrace();
+
+  // Replay the trace from the given simulator time; before and after it the device lies still.
+  // May be in the past (wrapped), to carry a replay on after a deep sleep reset.
+  void startReplay(uint32_t now_ms);
+
+  // Wake cause reported after a deep sleep reset
+  void setWakeCause(int cause);
+
+  // Trace value at a simulator time (sample and hold)
+  Sample sampleAt(uint32_t now_ms);
+
+  // Synthetic traces for the built-in scenarios
+  void appendStill(std::vector<Sample> &trace, uint32_t from_ms, uint32_t duration_ms, float wobble_dps);
+  void appendShake(std::vector<Sample> &trace, uint32_t from_ms, uint32_t duration_ms, float peak_mg);
+}
+
+#endif // SIM_IMU_H
@@ -0,0 +1,113 @@
+#include "SimPng.h"
+#include <stdio.h>
+#include <vector>
+
+static uint32_t crcTable[256];
+
+static void initCrcTable()
+{
+  if (crcTable[1])
+  {
+    return;
+  }
+  for (uint32_t n = 0; n < 256; n++)
+  {
+    uint32_t c = n;
+    for (int k = 0; k < 8; k++)
+    {
+      c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    }
+    crcTable[n] = c;
+  }
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t v)
+{
+  out.push_back((uint8_t)(v >> 24));
+  out.push_back((uint8_t)(v >> 16));
+  out.push_back((uint8_t)(v >> 8));
+  out.push_back((uint8_t)v);
+}
+
+static void writeChunk(FILE *f, const char *type, const std::vector<uint8_t> &data)
+{
+  std::vector<uint8_t> chunk;
+  put32(chunk, (uint32_t)data.size());
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 4; i < chunk.size(); i++)
+  {
+    crc = crcTable[(crc ^ chunk[i]) & 0xFF] ^ (crc >> 8);
+  }
+  put32(chunk, crc ^ 0xFFFFFFFFu);
+  fwrite(chunk.data(), 1, chunk.size(), f);
+}
+
+bool SimPng::writeRgb565(const char *path, const uint16_t *pixels, int width, int height)
+{
+  initCrcTable();
+
+  // Filter byte 0 + RGB888 per row
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)height * (1 + width * 3));
+  for (int y = 0; y < height; y++)
+  {
+    raw.push_back(0);
+    for (int x = 0; x < width; x++)
+    {
+      uint16_t c = pixels[y * width + x];
+      uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+      raw.push_back((uint8_t)((r << 3) | (r >> 2)));
+      raw.push_back((uint8_t)((g << 2) | (g >> 4)));
+      raw.push_back((uint8_t)((b << 3) | (b >> 2)));
+    }
+  }
+
+  // zlib stream of stored blocks
+  std::vector<uint8_t> idat;
+  idat.push_back(0x78);
+  idat.push_back(0x01);
+  size_t pos = 0;
+  do
+  {
+    size_t len = raw.size() - pos > 65535 ? 65535 : raw.size() - pos;
+    idat.push_back(pos + len == raw.size() ? 1 : 0);
+    idat.push_back((uint8_t)len);
+    idat.push_back((uint8_t)(len >> 8));
+    idat.push_back((uint8_t)~len);
+    idat.push_back((uint8_t)(~len >> 8));
+    idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+    pos += len;
+  } while (pos < raw.size());
+
+  uint32_t a = 1, b = 0;
+  for (size_t i = 0; i < raw.size(); i++)
+  {
+    a = (a + raw[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  put32(idat, (b << 16) | a);
+
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    return false;
+  }
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  fwrite(signature, 1, sizeof(signature), f);
+
+  std::vector<uint8_t> ihdr;
+  put32(ihdr, (uint32_t)width);
+  put32(ihdr, (uint32_t)height);
+  ihdr.push_back(8); // Bit depth
+  ihdr.push_back(2); // Truecolor
+  ihdr.push_back(0);
+  ihdr.push_back(0);
+  ihdr.push_back(0);
+  writeChunk(f, "IHDR", ihdr);
+  writeChunk(f, "IDAT", idat);
+  writeChunk(f, "IEND", std::vector<uint8_t>());
+  return fclose(f) == 0;
+}
@@ -0,0 +1,13 @@
+// SimPng.h - dependency-free PNG writer for framebuffer dumps
+#ifndef SIM_PNG_H
+#define SIM_PNG_H
+
+#include <stdint.h>
+
+namespace SimPng
+{
+  // Write an RGB565 frame as an 8-bit RGB PNG (stored deflate blocks, no compression)
+  bool writeRgb565(const char *path, const uint16_t *pixels, int width, int height);
+}
+
+#endif // SIM_PNG_H
@@ -0,0 +1,764 @@
+// SimRunner.cpp - host entry point: runs the app's setup()/loop() through scripted scenarios
+// and reports per-frame render time, invalidated area and heap operations.
+#include <Arduino.h>
+#include <lvgl.h>
+#include <TFT_eSPI.h>
+#include <HTTPClient.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "SimHost.h"
+#include "SimImu.h"
+#include "SimAudio.h"
+#include "SimAlloc.h"
+#include "SimPng.h"
+#include "ShakeBench.h"
+#include "TiltBench.h"
+#include "RingStress.h"
+#include "HapticBench.h"
+#include "SchedBench.h"
+#include "../src/TextStateManager.h"
+#include "../src/Recorder.h"
+
+// The app (src/main.cpp)
+void setup();
+void loop();
+const char *displayStateName(TextStateManager::DisplayState state);
+extern TextStateManager textManager;
+extern VoiceActivatedRecorder recorder;
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+enum class EndOn
+{
+  TIME,            // endDelay ms after the start
+  RECORDING_START, // endDelay ms after recording started
+  RECORDING_END,   // endDelay ms after the recorder stopped
+  BACK_TO_IDLE     // endDelay ms after the response cleared
+};
+
+struct Scenario
+{
+  const char *name;
+  uint32_t shakeAt; // Shake the device this many ms into the scenario, 0: never
+  float wobbleDps;  // Hand tremor outside of the shake, 0: lying on a table
+  bool speak;       // Play the microphone clip once recording starts
+  EndOn endOn;
+  uint32_t endDelay;
+  uint32_t timeout; // Fail if the end condition was not reached by then
+  bool upload;      // Fail unless the recording was uploaded
+};
+
+static const Scenario scenarios[] = {
+    {"idle", 0, 30.0f, false, EndOn::TIME, 10000, 10000, false},
+    {"shake", 2000, 30.0f, false, EndOn::RECORDING_START, 2000, 10000, false},
+    {"record", 2000, 30.0f, true, EndOn::RECORDING_END, 1000, 25000, false},
+    {"respond", 2000, 30.0f, true, EndOn::BACK_TO_IDLE, 1000, 60000, true},
+    {"standby", 40000, 0.0f, false, EndOn::RECORDING_START, 2000, 60000, false},
+    {"standbyupload", 40000, 0.0f, true, EndOn::BACK_TO_IDLE, 1000, 90000, true},
+    {"deepstandby", 330000, 0.0f, false, EndOn::RECORDING_START, 2000, 360000, false},
+};
+
+static const uint32_t SHAKE_DURATION = 800;
+static const float SHAKE_PEAK_MG = 7000.0f;
+static const uint32_t VOICE_DURATION = 1500;
+
+// ---------------------------------------------------------------------------
+// Options
+// ---------------------------------------------------------------------------
+
+struct Options
+{
+  std::string scenario;
+  std::string imuCsv;
+  std::string wavFile;
+  std::string outDir;
+  bool png;
+  uint32_t pngEvery;
+  uint32_t budgetP95Us;
+  bool shakeBench;
+  bool tiltBench;
+  bool ringStress;
+  bool hapticBench;
+  bool schedBench;
+  std::string resumeFile;
+
+  Options() : scenario("all"), png(false), pngEvery(1), budgetP95Us(0), shakeBench(false), tiltBench(false), ringStress(false), hapticBench(false), schedBench(false) {}
+};
+
+static Options options;
+
+static void usage(const char *argv0)
+{
+  printf("Usage: %s [options]\n"
+         "  --scenario NAME     idle, shake, record, respond, standby,\n"
+         "                      standbyupload, deepstandby or all\n"
+         "                      (default all)\n"
+         "  --imu FILE          replay an IMU trace (t_ms,ax,ay,az,gx,gy,gz in mg/dps)\n"
+         "  --wav FILE          microphone input, 16-bit PCM (default: synthetic voice)\n"
+         "  --server URL        stand-in upload server, e.g. http://127.0.0.1:5000/ask\n"
+         "  --no-wifi           report the station as disconnected\n"
+         "  --wifi-connect-ms N time to associate with the access point (default 1500)\n"
+         "  --wifi-reconnect-ms N  ... with its channel and BSSID known (default 400)\n"
+         "  --wifi-drop-at MS   take the access point away at MS ms ...\n"
+         "  --wifi-drop-ms N    ... for N ms (default 5000)\n"
+         "  --data DIR          directory mounted as LittleFS (default data)\n"
+         "  --out DIR           write DIR/<scenario>.csv with one row per frame\n"
+         "  --png               also dump frames to DIR/<scenario>/frame_NNNNN.png\n"
+         "  --png-every N       dump every Nth frame only\n"
+         "  --budget-p95-us N   exit with 1 when the p95 render time exceeds N us\n"
+         "  --realtime          run on the host clock instead of the virtual one\n"
+         "  --verbose           show the app's Serial output\n"
+         "  --shake-bench       run the shake detector over the built-in traces (or --imu\n"
+         "                      with an 8th column 0/1 marking the shakes) instead\n"
+         "  --tilt-bench        check the tilt estimator on the built-in traces, or print\n"
+         "                      its gravity estimate for the --imu trace, instead\n"
+         "  --ring-stress       stress the IMU sample ring with host threads instead\n"
+         "  --haptic-bench      check the timing of the haptic patterns instead\n"
+         "  --sched-bench       check when the loop's scheduler runs its jobs instead\n"
+         "  --resume FILE       continue a scenario after a deep sleep reset (the runner\n"
+         "                      restarts itself with it)\n",
+         argv0);
+}
+
+static bool parseOptions(int argc, char **argv)
+{
+  SimHost::Config &cfg = SimHost::config();
+  cfg.quiet = true;
+  cfg.wifi = true;
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--scenario" && hasValue)
+      options.scenario = argv[++i];
+    else if (arg == "--imu" && hasValue)
+      options.imuCsv = argv[++i];
+    else if (arg == "--wav" && hasValue)
+      options.wavFile = argv[++i];
+    else if (arg == "--server" && hasValue)
+      cfg.server = argv[++i];
+    else if (arg == "--no-wifi")
+      cfg.wifi = false;
+    else if (arg == "--wifi-connect-ms" && hasValue)
+      cfg.wifiConnectMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--wifi-reconnect-ms" && hasValue)
+      cfg.wifiReconnectMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--wifi-drop-at" && hasValue)
+    {
+      cfg.wifiDropAtMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+      if (!cfg.wifiDropMs)
+        cfg.wifiDropMs = 5000;
+    }
+    else if (arg == "--wifi-drop-ms" && hasValue)
+      cfg.wifiDropMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--resume" && hasValue)
+      options.resumeFile = argv[++i];
+    else if (arg == "--data" && hasValue)
+      cfg.dataDir = argv[++i];
+    else if (arg == "--out" && hasValue)
+      options.outDir = argv[++i];
+    else if (arg == "--png")
+      options.png = true;
+    else if (arg == "--png-every" && hasValue)
+      options.pngEvery = (uint32_t)std::max(1L, strtol(argv[++i], nullptr, 10));
+    else if (arg == "--budget-p95-us" && hasValue)
+      options.budgetP95Us = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--realtime")
+      cfg.realtime = true;
+    else if (arg == "--verbose")
+      cfg.quiet = false;
+    else if (arg == "--shake-bench")
+      options.shakeBench = true;
+    else if (arg == "--tilt-bench")
+      options.tiltBench = true;
+    else if (arg == "--ring-stress")
+      options.ringStress = true;
+    else if (arg == "--haptic-bench")
+      options.hapticBench = true;
+    else if (arg == "--sched-bench")
+      options.schedBench = true;
+    else
+    {
+      usage(argv[0]);
+      return false;
+    }
+  }
+  if (options.png && options.outDir.empty())
+  {
+    fprintf(stderr, "--png needs --out\n");
+    return false;
+  }
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Frame measurements
+// ---------------------------------------------------------------------------
+
+struct Frame
+{
+  uint32_t t_ms;       // Simulator time the frame was rendered
+  const char *state;   // Display state of the app
+  uint32_t renderUs;   // Host time spent in the refresh (layout, render, flush)
+  uint32_t areas;      // Invalidated areas before joining
+  uint32_t invPixels;  // Pixels of the joined invalidated areas
+  uint32_t flushedPixels;
+  uint32_t windows;    // Address windows sent to the panel
+  uint32_t allocs;     // Heap operations during the refresh
+  uint32_t frees;
+};
+
+static std::vector<Frame> frames;
+static lv_timer_t *refrTimer = nullptr;
+static bool frameRendered = false;
+static uint32_t framePixels = 0;
+static std::string pngDir;
+
+static void monitorCallback(lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px)
+{
+  (void)disp_drv;
+  (void)time;
+  frameRendered = true;
+  framePixels = px;
+}
+
+// Save what the glass shows: pixels outside the row spans are never rendered and may hold stale data
+static void dumpFrame(const char *path, const TFT_eSPI *panel, const lv_disp_row_span_t *spans)
+{
+  int w = panel->width(), h = panel->height();
+  std::vector<uint16_t> visible(panel->framebuffer(), panel->framebuffer() + w * h);
+  if (spans)
+  {
+    for (int y = 0; y < h; y++)
+    {
+      for (int x = 0; x < w; x++)
+      {
+        if (x < spans[y].x1 || x > spans[y].x2)
+          visible[y * w + x] = 0;
+      }
+    }
+  }
+  SimPng::writeRgb565(path, visible.data(), w, h);
+}
+
+static void refrTimerHook(lv_timer_t *timer)
+{
+  lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+  TFT_eSPI *panel = TFT_eSPI::instance();
+  uint32_t areas = disp->inv_p;
+
+  frameRendered = false;
+  panel->pixelsPushed = 0;
+  panel->windowsSet = 0;
+  SimAlloc::Counters before = SimAlloc::snapshot();
+  uint64_t start = SimHost::hostUs();
+
+  _lv_disp_refr_timer(timer);
+
+  uint64_t elapsed = SimHost::hostUs() - start;
+  SimAlloc::Counters after = SimAlloc::snapshot();
+  if (!frameRendered)
+  {
+    return;
+  }
+
+  Frame f;
+  f.t_ms = millis();
+  f.state = displayStateName(textManager.getState());
+  f.renderUs = (uint32_t)elapsed;
+  f.areas = areas;
+  f.invPixels = framePixels;
+  f.flushedPixels = panel->pixelsPushed;
+  f.windows = panel->windowsSet;
+  f.allocs = (uint32_t)(after.allocs - before.allocs + after.reallocs - before.reallocs);
+  f.frees = (uint32_t)(after.frees - before.frees);
+  frames.push_back(f);
+
+  if (!pngDir.empty() && (frames.size() - 1) % options.pngEvery == 0)
+  {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05u.png", pngDir.c_str(), (unsigned)(frames.size() - 1));
+    dumpFrame(path, panel, disp->driver->row_spans);
+  }
+}
+
+static bool installHooks()
+{
+  lv_disp_t *disp = lv_disp_get_default();
+  if (!disp || !TFT_eSPI::instance())
+  {
+    return false;
+  }
+  disp->driver->monitor_cb = monitorCallback;
+  refrTimer = _lv_disp_get_refr_timer(disp);
+  refrTimer->timer_cb = refrTimerHook;
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Reporting
+// ---------------------------------------------------------------------------
+
+struct Summary
+{
+  size_t count;
+  uint32_t meanUs, p50Us, p95Us, maxUs;
+  uint32_t meanInvPixels;
+  uint32_t meanFlushedPixels;
+  float allocsPerFrame;
+};
+
+static Summary summarize(const char *state)
+{
+  Summary s = {0, 0, 0, 0, 0, 0, 0, 0.0f};
+  std::vector<uint32_t> times;
+  uint64_t sumUs = 0, sumInv = 0, sumFlushed = 0, sumAllocs = 0;
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    const Frame &f = frames[i];
+    if (state && strcmp(state, f.state) != 0)
+      continue;
+    times.push_back(f.renderUs);
+    sumUs += f.renderUs;
+    sumInv += f.invPixels;
+    sumFlushed += f.flushedPixels;
+    sumAllocs += f.allocs;
+  }
+  s.count = times.size();
+  if (s.count == 0)
+  {
+    return s;
+  }
+  std::sort(times.begin(), times.end());
+  s.meanUs = (uint32_t)(sumUs / s.count);
+  s.p50Us = times[(s.count - 1) / 2];
+  s.p95Us = times[(s.count - 1) * 95 / 100];
+  s.maxUs = times.back();
+  s.meanInvPixels = (uint32_t)(sumInv / s.count);
+  s.meanFlushedPixels = (uint32_t)(sumFlushed / s.count);
+  s.allocsPerFrame = (float)sumAllocs / s.count;
+  return s;
+}
+
+static void printSummaryRow(const char *label, const Summary &s)
+{
+  printf("  %-10s %6zu %8u %8u %8u %8u %10u %10u %8.1f\n", label, s.count, s.meanUs, s.p50Us,
+         s.p95Us, s.maxUs, s.meanInvPixels, s.meanFlushedPixels, s.allocsPerFrame);
+}
+
+static void writeFramesCsv(const char *path)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+  {
+    fprintf(stderr, "Cannot write %s\n", path);
+    return;
+  }
+  fprintf(f, "frame,t_ms,state,render_us,areas,inv_px,flushed_px,windows,allocs,frees\n");
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    const Frame &fr = frames[i];
+    fprintf(f, "%zu,%u,%s,%u,%u,%u,%u,%u,%u,%u\n", i, fr.t_ms, fr.state, fr.renderUs, fr.areas,
+            fr.invPixels, fr.flushedPixels, fr.windows, fr.allocs, fr.frees);
+  }
+  fclose(f);
+}
+
+// ---------------------------------------------------------------------------
+// Deep sleep
+// ---------------------------------------------------------------------------
+
+// The RTC_DATA_ATTR variables, bounds from the linker (weak, there may be none)
+extern "C" char __start_rtc_data[] __attribute__((weak));
+extern "C" char __stop_rtc_data[] __attribute__((weak));
+
+// What goes over a deep sleep reset, followed by the RTC memory
+struct ResumeImage
+{
+  uint32_t magic;
+  int32_t wakeCause;
+  uint32_t elapsedMs; // Scenario time at the reset
+  uint32_t resets;    // Deep sleep resets in the scenario so far
+  uint32_t rtcSize;
+};
+
+static const uint32_t RESUME_MAGIC = 0x8BA11001;
+static std::vector<std::string> restartArgs; // The command line, minus --resume
+static const Scenario *current = nullptr;
+static uint32_t scenarioStart = 0;
+static uint32_t resets = 0;
+
+static size_t rtcSize()
+{
+  return __start_rtc_data && __stop_rtc_data ? (size_t)(__stop_rtc_data - __start_rtc_data) : 0;
+}
+
+void SimHost::deepSleepReset(int wakeCause)
+{
+  ResumeImage image;
+  image.magic = RESUME_MAGIC;
+  image.wakeCause = wakeCause;
+  image.elapsedMs = millis() - scenarioStart;
+  image.resets = resets + 1;
+  image.rtcSize = (uint32_t)rtcSize();
+
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/8ballsim-rtc-%d.bin", (int)getpid());
+  FILE *f = fopen(path, "wb");
+  if (!f || fwrite(&image, sizeof(image), 1, f) != 1 ||
+      (image.rtcSize && fwrite(__start_rtc_data, image.rtcSize, 1, f) != 1))
+  {
+    fprintf(stderr, "Cannot write %s\n", path);
+    _exit(2);
+  }
+  fclose(f);
+  printf("  deep sleep reset at %lu ms (wake cause %d), %u bytes of RTC memory kept\n",
+         (unsigned long)image.elapsedMs, wakeCause, (unsigned)image.rtcSize);
+  fflush(stdout);
+
+  // A fresh process is the closest to a reset: every global starts over
+  std::vector<char *> argv;
+  for (size_t i = 0; i < restartArgs.size(); i++)
+    argv.push_back((char *)restartArgs[i].c_str());
+  std::string resumePath = path;
+  const char *extra[] = {"--scenario", current->name, "--resume", resumePath.c_str()};
+  for (size_t i = 0; i < sizeof(extra) / sizeof(extra[0]); i++)
+    argv.push_back((char *)extra[i]);
+  argv.push_back(nullptr);
+  execv("/proc/self/exe", argv.data());
+  perror("execv");
+  _exit(2);
+}
+
+// Puts the RTC memory back, returns the scenario time of the reset
+static bool loadResume(const char *path, uint32_t *elapsedMs)
+{
+  FILE *f = fopen(path, "rb");
+  ResumeImage image;
+  bool ok = f && fread(&image, sizeof(image), 1, f) == 1 && image.magic == RESUME_MAGIC &&
+            image.rtcSize == rtcSize() && (!image.rtcSize || fread(__start_rtc_data, image.rtcSize, 1, f) == 1);
+  if (f)
+    fclose(f);
+  unlink(path);
+  if (!ok)
+  {
+    fprintf(stderr, "Cannot resume from %s\n", path);
+    return false;
+  }
+  SimImu::setWakeCause(image.wakeCause);
+  resets = image.resets;
+  *elapsedMs = image.elapsedMs;
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Run
+// ---------------------------------------------------------------------------
+
+static int runScenario(const Scenario &sc)
+{
+  if (!options.wavFile.empty() && !SimAudio::loadWav(options.wavFile.c_str()))
+  {
+    fprintf(stderr, "Cannot read %s (16-bit PCM WAV expected)\n", options.wavFile.c_str());
+    return 2;
+  }
+  if (options.wavFile.empty())
+  {
+    SimAudio::setSyntheticVoice(VOICE_DURATION);
+  }
+
+  if (!options.imuCsv.empty())
+  {
+    if (!SimImu::loadCsv(options.imuCsv.c_str()))
+    {
+      fprintf(stderr, "Cannot read IMU trace %s\n", options.imuCsv.c_str());
+      return 2;
+    }
+  }
+  else
+  {
+    std::vector<SimImu::Sample> trace;
+    uint32_t shakeAt = sc.shakeAt ? sc.shakeAt : sc.timeout;
+    SimImu::appendStill(trace, 0, shakeAt, sc.wobbleDps);
+    if (sc.shakeAt)
+    {
+      SimImu::appendShake(trace, sc.shakeAt, SHAKE_DURATION, SHAKE_PEAK_MG);
+      SimImu::appendStill(trace, sc.shakeAt + SHAKE_DURATION, sc.timeout, sc.wobbleDps);
+    }
+    SimImu::setTrace(trace);
+  }
+
+  if (!options.outDir.empty())
+  {
+    mkdir(options.outDir.c_str(), 0755);
+    if (options.png)
+    {
+      pngDir = options.outDir + "/" + sc.name;
+      mkdir(pngDir.c_str(), 0755);
+    }
+  }
+
+  // After a deep sleep reset the scenario and its motion go on from where they were
+  uint32_t resumedAt = 0;
+  if (!options.resumeFile.empty())
+  {
+    if (!loadResume(options.resumeFile.c_str(), &resumedAt))
+      return 2;
+    SimImu::startReplay(millis() - resumedAt);
+  }
+
+  uint64_t setupStart = SimHost::hostUs();
+  uint32_t setupStartMs = millis();
+  setup();
+  uint64_t setupUs = SimHost::hostUs() - setupStart;
+  uint32_t setupMs = millis() - setupStartMs;
+  if (!installHooks())
+  {
+    fprintf(stderr, "The app did not register a display\n");
+    return 2;
+  }
+
+  uint32_t start = setupStartMs - resumedAt; // Wraps, the scenario clock is uint32_t
+  if (options.resumeFile.empty())
+  {
+    start = millis();
+    SimImu::startReplay(start);
+  }
+  current = &sc;
+  scenarioStart = start;
+  SimAlloc::Counters allocStart = SimAlloc::snapshot();
+  lv_draw_sw_layer_pool_monitor_t layersStart;
+  lv_draw_sw_layer_pool_monitor(&layersStart);
+  lv_font_fmt_txt_cache_monitor_t glyphsStart;
+  lv_font_fmt_txt_cache_monitor(&glyphsStart);
+  uint32_t uploadsStart = HTTPClient::okCount();
+  uint64_t hostStart = SimHost::hostUs();
+
+  bool leftIdle = false;
+  bool recordingSeen = false;
+  uint32_t markAt = 0; // When the end condition's event happened
+  bool marked = false;
+  bool finished = false;
+
+  while ((uint32_t)millis() - start < sc.timeout)
+  {
+    uint64_t before = SimHost::nowUs();
+    loop();
+    if (SimHost::nowUs() == before)
+    {
+      SimHost::advanceUs(1000); // The loop never returns instantly on the device
+    }
+    SimHost::runDueTasks();
+
+    uint32_t now = millis();
+    bool recording = recorder.isRecording();
+    TextStateManager::DisplayState state = textManager.getState();
+
+    if (recording && !recordingSeen)
+    {
+      recordingSeen = true;
+      if (sc.speak)
+      {
+        SimAudio::arm();
+      }
+      if (sc.endOn == EndOn::RECORDING_START)
+      {
+        marked = true;
+        markAt = now;
+      }
+    }
+    if (recordingSeen && !recording && sc.endOn == EndOn::RECORDING_END && !marked)
+    {
+      marked = true;
+      markAt = now;
+    }
+    if (state != TextStateManager::DisplayState::IDLE)
+    {
+      leftIdle = leftIdle || recordingSeen;
+    }
+    else if (leftIdle && sc.endOn == EndOn::BACK_TO_IDLE && !marked)
+    {
+      marked = true;
+      markAt = now;
+    }
+    if (sc.endOn == EndOn::TIME)
+    {
+      marked = true;
+      markAt = start;
+    }
+    if (marked && now - markAt >= sc.endDelay)
+    {
+      finished = true;
+      break;
+    }
+  }
+
+  SimAlloc::Counters allocEnd = SimAlloc::snapshot();
+  uint64_t hostUs = SimHost::hostUs() - hostStart;
+
+  if (!options.outDir.empty())
+  {
+    writeFramesCsv((options.outDir + "/" + sc.name + ".csv").c_str());
+  }
+
+  printf("\n=== Scenario %s: %s, %lu ms simulated, %lu ms host, setup %lu ms (%lu ms host) ===\n", sc.name,
+         finished ? "completed" : "TIMED OUT", (unsigned long)((uint32_t)millis() - start),
+         (unsigned long)(hostUs / 1000), (unsigned long)setupMs, (unsigned long)(setupUs / 1000));
+  if (resets)
+  {
+    printf("  resumed from deep sleep at %lu ms (reset %lu), frames from before the reset are not counted\n",
+           (unsigned long)resumedAt, (unsigned long)resets);
+  }
+  printf("  %-10s %6s %8s %8s %8s %8s %10s %10s %8s\n", "state", "frames", "mean_us", "p50_us",
+         "p95_us", "max_us", "inv_px", "flushed_px", "allocs");
+  static const TextStateManager::DisplayState states[] = {
+      TextStateManager::DisplayState::IDLE, TextStateManager::DisplayState::RECORDING,
+      TextStateManager::DisplayState::THINKING, TextStateManager::DisplayState::RESPONSE,
+      TextStateManager::DisplayState::ERROR};
+  for (size_t i = 0; i < sizeof(states) / sizeof(states[0]); i++)
+  {
+    Summary s = summarize(displayStateName(states[i]));
+    if (s.count)
+    {
+      printSummaryRow(displayStateName(states[i]), s);
+    }
+  }
+  Summary total = summarize(nullptr);
+  printSummaryRow("all", total);
+  if (SimAlloc::available())
+  {
+    printf("  heap: %llu allocs, %llu frees, %llu bytes requested during the scenario\n",
+           (unsigned long long)(allocEnd.allocs - allocStart.allocs + allocEnd.reallocs - allocStart.reallocs),
+           (unsigned long long)(allocEnd.frees - allocStart.frees),
+           (unsigned long long)(allocEnd.bytes - allocStart.bytes));
+  }
+  lv_mem_monitor_t mem;
+  lv_mem_monitor(&mem);
+  lv_mem_monitor_t fast;
+  lv_mem_fast_monitor(&fast);
+  printf("  lv_mem: max %lu of %lu B, fast max %lu of %lu B, size classes (size used/max):",
+         (unsigned long)mem.max_used, (unsigned long)mem.total_size, (unsigned long)fast.max_used,
+         (unsigned long)fast.total_size);
+  for (uint32_t i = 0; i < lv_mem_class_count(); i++)
+  {
+    lv_mem_class_monitor_t c;
+    lv_mem_class_monitor(i, &c);
+    printf(" %u %lu/%lu", c.block_size, (unsigned long)c.used_cnt, (unsigned long)c.max_used_cnt);
+  }
+  printf("\n");
+  lv_draw_sw_layer_pool_monitor_t layersEnd;
+  lv_draw_sw_layer_pool_monitor(&layersEnd);
+  printf("  layers: pool %lu B in %lu buffers (max %lu B), %lu reused, %lu allocated during the scenario\n",
+         (unsigned long)layersEnd.size, (unsigned long)layersEnd.buf_cnt, (unsigned long)layersEnd.max_size,
+         (unsigned long)(layersEnd.reuse_cnt - layersStart.reuse_cnt),
+         (unsigned long)(layersEnd.alloc_cnt - layersStart.alloc_cnt));
+  lv_font_fmt_txt_cache_monitor_t glyphsEnd;
+  lv_font_fmt_txt_cache_monitor(&glyphsEnd);
+  unsigned long glyphHits = glyphsEnd.hit_cnt - glyphsStart.hit_cnt;
+  unsigned long glyphMisses = glyphsEnd.miss_cnt - glyphsStart.miss_cnt;
+  printf("  glyphs: cache %lu of %lu B, %lu hits, %lu misses during the scenario (%lu%% hits)\n",
+         (unsigned long)glyphsEnd.used_size, (unsigned long)glyphsEnd.total_size, glyphHits, glyphMisses,
+         glyphHits + glyphMisses ? glyphHits * 100 / (glyphHits + glyphMisses) : 0UL);
+
+  uint32_t uploads = HTTPClient::okCount() - uploadsStart;
+  printf("  uploads: %lu answered by the server\n", (unsigned long)uploads);
+  bool uploaded = !sc.upload || uploads;
+
+  // One greppable line per scenario for CI
+  printf("SUMMARY scenario=%s status=%s frames=%zu mean_us=%u p95_us=%u max_us=%u inv_px=%u allocs_per_frame=%.1f\n",
+         sc.name, !finished ? "timeout" : uploaded ? "ok" : "noupload", total.count, total.meanUs, total.p95Us,
+         total.maxUs, total.meanInvPixels, total.allocsPerFrame);
+
+  if (!finished || !uploaded)
+  {
+    return 2;
+  }
+  if (options.budgetP95Us && total.p95Us > options.budgetP95Us)
+  {
+    printf("  p95 render time %u us is over the budget of %u us\n", total.p95Us, options.budgetP95Us);
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 0; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--resume") == 0)
+      i++;
+    else
+      restartArgs.push_back(argv[i]);
+  }
+  if (!parseOptions(argc, argv))
+  {
+    return 2;
+  }
+  if (options.shakeBench)
+  {
+    return ShakeBench::run(options.imuCsv.empty() ? nullptr : options.imuCsv.c_str());
+  }
+  if (options.tiltBench)
+  {
+    return TiltBench::run(options.imuCsv.empty() ? nullptr : options.imuCsv.c_str());
+  }
+  if (options.ringStress)
+  {
+    return RingStress::run();
+  }
+  if (options.hapticBench)
+  {
+    return HapticBench::run();
+  }
+  if (options.schedBench)
+  {
+    return SchedBench::run();
+  }
+
+  std::vector<const Scenario *> selected;
+  for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+  {
+    if (options.scenario == "all" || options.scenario == scenarios[i].name)
+    {
+      selected.push_back(&scenarios[i]);
+    }
+  }
+  if (selected.empty())
+  {
+    usage(argv[0]);
+    return 2;
+  }
+  if (selected.size() == 1)
+  {
+    int rc = runScenario(*selected[0]);
+    fflush(stdout);
+    _exit(rc); // Task threads stay parked, skip static destructors
+  }
+
+  // The app keeps global state, so every scenario gets a fresh process
+  int worst = 0;
+  for (size_t i = 0; i < selected.size(); i++)
+  {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      int rc = runScenario(*selected[i]);
+      fflush(stdout);
+      _exit(rc);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status))
+    {
+      worst = 2;
+      continue;
+    }
+    worst = std::max(worst, WEXITSTATUS(status));
+  }
+  return worst;
+}
@@ -0,0 +1,358 @@
+#include "TiltBench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../src/Animations.h"
+#include "../src/MotionSampler.h"
+#include "../src/TiltEstimator.h"
+
+namespace
+{
+  const uint32_t ODR_HZ = MotionSampler::ODR_HZ;
+  const float SAMPLE_MS = 1000.0f / ODR_HZ;
+  const float DEG = (float)M_PI / 180.0f;
+
+  struct Trace
+  {
+    std::string name;
+    std::vector<float> acc;     // mg, 3 per sample at ODR_HZ
+    std::vector<float> gyro;    // dps
+    std::vector<float> truth;   // unit gravity, 3 per sample
+    std::vector<bool> scored;   // settled samples the error is taken over
+    float toleranceDeg;
+
+    size_t size() const { return scored.size(); }
+  };
+
+  // Deterministic sensor noise
+  uint32_t noiseState = 12345;
+  float noise(float amplitude)
+  {
+    noiseState = noiseState * 1103515245u + 12345u;
+    return amplitude * (((noiseState >> 16) & 0x7FFF) / 16384.0f - 1.0f);
+  }
+
+  // Builds a trace from the true direction of gravity over time. The gyro is what turns
+  // one sample's gravity into the next (g' = g + g x w dt), so the two sensors agree.
+  struct Builder
+  {
+    Trace &t;
+    float g[3];
+    float bias[3];
+    Builder(Trace &trace) : t(trace)
+    {
+      g[0] = 0;
+      g[1] = 0;
+      g[2] = 1;
+      bias[0] = bias[1] = bias[2] = 0;
+    }
+
+    void push(const float next[3], const float linear[3], bool scored)
+    {
+      float dt = SAMPLE_MS / 1000.0f;
+      float w[3] = {-(g[1] * next[2] - g[2] * next[1]) / dt, -(g[2] * next[0] - g[0] * next[2]) / dt,
+                    -(g[0] * next[1] - g[1] * next[0]) / dt};
+      for (int i = 0; i < 3; i++)
+      {
+        t.gyro.push_back(w[i] / DEG + bias[i] + noise(0.3f));
+        g[i] = next[i];
+      }
+      for (int i = 0; i < 3; i++)
+      {
+        t.acc.push_back(1000.0f * g[i] + linear[i] + noise(15));
+        t.truth.push_back(g[i]);
+      }
+      t.scored.push_back(scored);
+    }
+
+    // Tip over to `deg` around the axis in the screen plane at `dirDeg` from x, over `ms`
+    void tiltTo(float deg, float dirDeg, float ms)
+    {
+      const float zero[3] = {0, 0, 0};
+      float start = acosf(g[2] > 1 ? 1 : g[2]) / DEG;
+      for (float s = SAMPLE_MS; s <= ms; s += SAMPLE_MS)
+      {
+        float a = (start + (deg - start) * s / ms) * DEG;
+        float next[3] = {sinf(a) * cosf(dirDeg * DEG), sinf(a) * sinf(dirDeg * DEG), cosf(a)};
+        push(next, zero, false);
+      }
+    }
+
+    // Keep still; the first `settleMs` aren't scored
+    void hold(float ms, float settleMs)
+    {
+      const float zero[3] = {0, 0, 0};
+      float now[3] = {g[0], g[1], g[2]};
+      for (float s = 0; s < ms; s += SAMPLE_MS)
+        push(now, zero, s >= settleMs);
+    }
+
+    // Shake along x without turning, all scored
+    void shake(float ms, float peakMg, float hz)
+    {
+      float now[3] = {g[0], g[1], g[2]};
+      for (float s = 0; s < ms; s += SAMPLE_MS)
+      {
+        float linear[3] = {peakMg * sinf(2.0f * (float)M_PI * hz * s / 1000.0f), 0, 0};
+        push(now, linear, true);
+      }
+    }
+  };
+
+  std::vector<Trace> builtinTraces()
+  {
+    std::vector<Trace> traces(4);
+    traces[0].name = "tilt_x_30";
+    traces[0].toleranceDeg = 2;
+    Builder b0(traces[0]);
+    b0.hold(1000, 0);
+    b0.tiltTo(30, 0, 500);
+    b0.hold(3000, 0);
+    b0.tiltTo(0, 0, 500);
+    b0.hold(2000, 0);
+
+    traces[1].name = "tilt_y_45";
+    traces[1].toleranceDeg = 2;
+    Builder b1(traces[1]);
+    b1.hold(1000, 0);
+    b1.tiltTo(45, 90, 300);
+    b1.hold(3000, 0);
+    b1.tiltTo(-20, 90, 600);
+    b1.hold(3000, 0);
+
+    // Gyro bias, the accelerometer has to hold the estimate in place
+    traces[2].name = "gyro_bias";
+    traces[2].toleranceDeg = 2;
+    Builder b2(traces[2]);
+    b2.bias[0] = 3.0f;
+    b2.bias[1] = -2.0f;
+    b2.bias[2] = 1.0f;
+    b2.hold(20000, 2000);
+
+    // Shaken while tilted, the 3 g the accelerometer reads mustn't pass for gravity
+    traces[3].name = "shake_tilted";
+    traces[3].toleranceDeg = 2;
+    Builder b3(traces[3]);
+    b3.tiltTo(20, 45, 300);
+    b3.hold(1000, 0);
+    b3.shake(1500, 3000, 5);
+    b3.hold(2000, 0);
+    return traces;
+  }
+
+  // Sample-and-hold resampling of a recorded trace to ODR_HZ
+  bool loadTrace(const char *path, Trace &trace, std::vector<float> &times)
+  {
+    FILE *f = fopen(path, "r");
+    if (!f)
+      return false;
+    std::vector<float> t, rows;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+      float row[7] = {0};
+      if (sscanf(line, "%f,%f,%f,%f,%f,%f,%f", &row[0], &row[1], &row[2], &row[3], &row[4], &row[5], &row[6]) >= 4)
+      {
+        t.push_back(row[0]);
+        rows.insert(rows.end(), row + 1, row + 7);
+      }
+    }
+    fclose(f);
+    if (t.empty())
+      return false;
+
+    trace.name = path;
+    size_t row = 0;
+    for (float s = t.front(); s <= t.back(); s += SAMPLE_MS)
+    {
+      while (row + 1 < t.size() && t[row + 1] <= s)
+        row++;
+      trace.acc.insert(trace.acc.end(), &rows[6 * row], &rows[6 * row + 3]);
+      trace.gyro.insert(trace.gyro.end(), &rows[6 * row + 3], &rows[6 * row + 6]);
+      trace.scored.push_back(false);
+      times.push_back(s);
+    }
+    return true;
+  }
+
+  int16_t toRaw(float value, float lsbPerUnit)
+  {
+    long raw = lroundf(value * lsbPerUnit);
+    return (int16_t)(raw > INT16_MAX ? INT16_MAX : (raw < INT16_MIN ? INT16_MIN : raw));
+  }
+
+  void rawSample(const Trace &t, size_t i, int16_t acc[3], int16_t gyro[3])
+  {
+    for (int k = 0; k < 3; k++)
+    {
+      acc[k] = toRaw(t.acc[3 * i + k], MotionSampler::ACC_LSB_PER_G / 1000.0f);
+      gyro[k] = toRaw(t.gyro[3 * i + k], MotionSampler::GYRO_LSB_PER_DPS);
+    }
+  }
+
+  float angleDeg(const int32_t est[3], const float truth[3])
+  {
+    float n = sqrtf((float)est[0] * est[0] + (float)est[1] * est[1] + (float)est[2] * est[2]);
+    if (n == 0)
+      return 180;
+    float c = (est[0] * truth[0] + est[1] * truth[1] + est[2] * truth[2]) / n;
+    return acosf(c > 1 ? 1 : (c < -1 ? -1 : c)) / DEG;
+  }
+
+  // The per-tick model the triangle had before: integrate the gyro into a target and
+  // pull it back inside the circle with atan2/cos/sin
+  struct LegacyModel
+  {
+    float current[2], velocity[2], target[2], idleTime;
+    LegacyModel() : idleTime(0)
+    {
+      current[0] = current[1] = target[0] = target[1] = 60;
+      velocity[0] = velocity[1] = 0;
+    }
+
+    void update(float gx, float gy)
+    {
+      if (fabsf(gx) < 0.5f && fabsf(gy) < 0.5f)
+      {
+        idleTime += 0.001f;
+        target[0] += sinf(idleTime) * cosf(idleTime * 0.7f) * 15.0f * 0.01f;
+        target[1] += cosf(idleTime * 1.3f) * sinf(idleTime * 0.5f) * 15.0f * 0.01f;
+      }
+      else
+      {
+        target[0] -= gx * 0.08f;
+        target[1] -= gy * 0.08f;
+      }
+      float dx = target[0] + 60 - 120;
+      float dy = target[1] + 60 - 120;
+      if (sqrtf(dx * dx + dy * dy) > 48)
+      {
+        float angle = atan2f(dy, dx);
+        target[0] = 120 + cosf(angle) * 48 - 60;
+        target[1] = 120 + sinf(angle) * 48 - 60;
+      }
+      for (int i = 0; i < 2; i++)
+      {
+        velocity[i] = velocity[i] * 0.95f + (target[i] - current[i]) * 0.05f;
+        current[i] += velocity[i] * 0.1f;
+      }
+    }
+  };
+
+  double nsSince(std::chrono::steady_clock::time_point start, size_t count)
+  {
+    std::chrono::duration<double, std::nano> d = std::chrono::steady_clock::now() - start;
+    return count ? d.count() / count : 0;
+  }
+
+  // Host cost of one 16 ms UI tick with 2 new samples. The old model is math only,
+  // the full update includes moving the triangle in LVGL, which both paths pay.
+  void benchmarkUpdate(const Trace &trace)
+  {
+    size_t ticks = trace.size() / 2;
+    std::vector<int16_t> acc(3 * trace.size()), gyro(3 * trace.size());
+    for (size_t i = 0; i < trace.size(); i++)
+      rawSample(trace, i, &acc[3 * i], &gyro[3 * i]);
+
+    // Shares the display with the app's instance, and stays around like it
+    AnimationManager *anim = new AnimationManager(240, 240);
+    anim->begin();
+    anim->initializeTriangle();
+
+    const int rounds = 200;
+    LegacyModel legacy;
+    volatile float sink = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+      for (size_t i = 0; i < ticks; i++)
+        legacy.update(trace.gyro[6 * i], trace.gyro[6 * i + 1]);
+      sink += legacy.current[0];
+    }
+    double legacyNs = nsSince(start, rounds * ticks);
+
+    TiltEstimator tilt(MotionSampler::ACC_LSB_PER_G, MotionSampler::GYRO_LSB_PER_DPS, ODR_HZ);
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+      for (size_t i = 0; i < 2 * ticks; i++)
+        tilt.addSample(&acc[3 * i], &gyro[3 * i], (uint32_t)(r * trace.size() + i));
+      sink += tilt.getGravity()[0];
+    }
+    double filterNs = nsSince(start, rounds * ticks);
+
+    unsigned long now = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+      for (size_t i = 0; i < ticks; i++)
+      {
+        tilt.addSample(&acc[6 * i], &gyro[6 * i], (uint32_t)(r * trace.size() + 2 * i));
+        tilt.addSample(&acc[6 * i + 3], &gyro[6 * i + 3], (uint32_t)(r * trace.size() + 2 * i + 1));
+        anim->updateTrianglePosition(tilt.getGravity(), now += 16);
+      }
+    }
+    double fullNs = nsSince(start, rounds * ticks);
+    printf("  per tick (host): float gyro model %.0f ns, tilt filter %.0f ns, filter + spring + LVGL move %.0f ns\n",
+           legacyNs, filterNs, fullNs);
+  }
+}
+
+int TiltBench::run(const char *csvPath)
+{
+  if (csvPath)
+  {
+    Trace trace;
+    std::vector<float> times;
+    if (!loadTrace(csvPath, trace, times))
+    {
+      fprintf(stderr, "Cannot read IMU trace %s\n", csvPath);
+      return 2;
+    }
+    TiltEstimator tilt(MotionSampler::ACC_LSB_PER_G, MotionSampler::GYRO_LSB_PER_DPS, ODR_HZ);
+    printf("t_ms,gx,gy,gz\n");
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      int16_t acc[3], gyro[3];
+      rawSample(trace, i, acc, gyro);
+      tilt.addSample(acc, gyro, (uint32_t)i);
+      const int32_t *g = tilt.getGravity();
+      printf("%.0f,%ld,%ld,%ld\n", times[i], (long)g[0], (long)g[1], (long)g[2]);
+    }
+    return 0;
+  }
+
+  std::vector<Trace> traces = builtinTraces();
+  printf("  %-14s %8s %8s %8s %8s\n", "trace", "mean_deg", "max_deg", "all_max", "limit");
+  bool clean = true;
+  for (size_t t = 0; t < traces.size(); t++)
+  {
+    const Trace &trace = traces[t];
+    TiltEstimator tilt(MotionSampler::ACC_LSB_PER_G, MotionSampler::GYRO_LSB_PER_DPS, ODR_HZ);
+    float sum = 0, max = 0, allMax = 0;
+    int scored = 0;
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+      int16_t acc[3], gyro[3];
+      rawSample(trace, i, acc, gyro);
+      tilt.addSample(acc, gyro, (uint32_t)i);
+      float err = angleDeg(tilt.getGravity(), &trace.truth[3 * i]);
+      allMax = err > allMax ? err : allMax;
+      if (trace.scored[i])
+      {
+        sum += err;
+        max = err > max ? err : max;
+        scored++;
+      }
+    }
+    printf("  %-14s %8.2f %8.2f %8.2f %8.1f\n", trace.name.c_str(), scored ? sum / scored : 0.0f, max, allMax,
+           trace.toleranceDeg);
+    clean = clean && max <= trace.toleranceDeg;
+  }
+  benchmarkUpdate(traces[0]);
+  printf("TILTBENCH %s\n", clean ? "ok" : "off");
+  return clean ? 0 : 1;
+}
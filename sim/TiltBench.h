@@ -0,0 +1,15 @@
+// TiltBench.h - replays IMU traces through the tilt estimator and reports how well it
+// tracks gravity, and what a motion update of the triangle costs next to the old float model
+#ifndef TILT_BENCH_H
+#define TILT_BENCH_H
+
+namespace TiltBench
+{
+  // csvPath: trace with rows "t_ms,ax,ay,az,gx,gy,gz" (mg, dps); the estimate is printed
+  // as "t_ms,gx,gy,gz" (1 g = 16384) so recordings can be compared between builds.
+  // nullptr runs the built-in holds, gyro bias and shake-while-tilted traces.
+  // Returns 0, or 1 when a built-in trace is off by more than its tolerance.
+  int run(const char *csvPath);
+}
+
+#endif // TILT_BENCH_H
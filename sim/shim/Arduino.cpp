@@ -0,0 +1,704 @@
+// Arduino.cpp - host implementation of the Arduino core shim, the simulator clock and the task scheduler
+#include "Arduino.h"
+#include "SimHost.h"
+#include "esp_timer.h"
+#include "driver/rmt.h"
+#include <stdarg.h>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ---------------------------------------------------------------------------
+// Clock
+// ---------------------------------------------------------------------------
+
+static std::atomic<uint64_t> virtualUs(0);
+
+static uint64_t steadyUs()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+SimHost::Config &SimHost::config()
+{
+  static Config cfg;
+  return cfg;
+}
+
+uint64_t SimHost::hostUs()
+{
+  return steadyUs();
+}
+
+uint64_t SimHost::nowUs()
+{
+  return config().realtime ? steadyUs() : virtualUs.load();
+}
+
+void SimHost::advanceUs(uint64_t us)
+{
+  if (!config().realtime)
+  {
+    virtualUs += us;
+  }
+}
+
+unsigned long millis(void)
+{
+  return (unsigned long)(SimHost::nowUs() / 1000);
+}
+
+unsigned long micros(void)
+{
+  return (unsigned long)SimHost::nowUs();
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  if (SimHost::config().realtime)
+  {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+  }
+  else
+  {
+    SimHost::advanceUs(us);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Cooperative tasks
+// ---------------------------------------------------------------------------
+
+struct SimTask
+{
+  TaskFunction_t fn;
+  void *parameter;
+  std::string name;
+  uint64_t wakeUs;
+  bool alive;
+  uint32_t notifications;
+};
+
+// Never destroyed: detached task threads may still be blocked on them at exit
+static std::mutex &schedMutex()
+{
+  static std::mutex *m = new std::mutex;
+  return *m;
+}
+
+static std::condition_variable &schedCv()
+{
+  static std::condition_variable *cv = new std::condition_variable;
+  return *cv;
+}
+
+static std::vector<SimTask *> &taskList()
+{
+  static std::vector<SimTask *> *tasks = new std::vector<SimTask *>;
+  return *tasks;
+}
+
+static SimTask *runningTask = nullptr; // Guarded by schedMutex()
+static thread_local SimTask *currentTask = nullptr;
+
+// Hand the CPU back to the app thread and wait until the scheduler picks this task again
+static void yieldTask(std::unique_lock<std::mutex> &lock, SimTask *task)
+{
+  runningTask = nullptr;
+  schedCv().notify_all();
+  schedCv().wait(lock, [task]
+                 { return runningTask == task; });
+}
+
+static void taskEntry(SimTask *task)
+{
+  {
+    std::unique_lock<std::mutex> lock(schedMutex());
+    schedCv().wait(lock, [task]
+                   { return runningTask == task; });
+  }
+  currentTask = task;
+  task->fn(task->parameter);
+  vTaskDelete(nullptr);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stackDepth,
+                       void *parameter, UBaseType_t priority, TaskHandle_t *handle)
+{
+  (void)stackDepth;
+  (void)priority;
+  SimTask *t = new SimTask{task, parameter, name ? name : "", SimHost::nowUs(), true, 0};
+  {
+    std::lock_guard<std::mutex> lock(schedMutex());
+    taskList().push_back(t);
+  }
+  std::thread(taskEntry, t).detach();
+  if (handle)
+  {
+    *handle = t;
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackDepth,
+                                   void *parameter, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core)
+{
+  (void)core;
+  return xTaskCreate(task, name, stackDepth, parameter, priority, handle);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  SimTask *self = currentTask;
+  if (!self)
+  {
+    delay(ticks);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(schedMutex());
+  self->wakeUs = ticks == portMAX_DELAY ? UINT64_MAX : SimHost::nowUs() + (uint64_t)ticks * 1000;
+  yieldTask(lock, self);
+}
+
+void vTaskDelete(TaskHandle_t handle)
+{
+  SimTask *task = handle ? (SimTask *)handle : currentTask;
+  if (!task)
+  {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(schedMutex());
+  task->alive = false;
+  if (task == currentTask)
+  {
+    // A deleted task never runs again, park its thread for good
+    yieldTask(lock, task);
+  }
+}
+
+TickType_t xTaskGetTickCount()
+{
+  return (TickType_t)millis();
+}
+
+// Stands for the app thread (setup() and loop()), never in the task list
+static SimTask appThread{nullptr, nullptr, "loopTask", 0, true, 0};
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+  return currentTask ? currentTask : &appThread;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  ((SimTask *)task)->notifications++;
+  return pdPASS;
+}
+
+// Polls once per tick like the queues; the app thread's ticks run the tasks and timers
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+  SimTask *self = (SimTask *)xTaskGetCurrentTaskHandle();
+  for (TickType_t waited = 0; self->notifications == 0; waited++)
+  {
+    if (waited >= ticksToWait)
+      return 0;
+    vTaskDelay(1);
+  }
+  uint32_t value = self->notifications;
+  self->notifications = clearCountOnExit ? 0 : value - 1;
+  return value;
+}
+
+struct SimQueue
+{
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  return new SimQueue{length, itemSize, std::deque<std::vector<uint8_t>>()};
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticksToWait)
+{
+  SimQueue *q = (SimQueue *)queue;
+  for (TickType_t waited = 0; q->items.size() >= q->length; waited++)
+  {
+    if (waited >= ticksToWait)
+      return pdFAIL;
+    vTaskDelay(1);
+  }
+  const uint8_t *bytes = (const uint8_t *)item;
+  q->items.push_back(std::vector<uint8_t>(bytes, bytes + q->itemSize));
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticksToWait)
+{
+  SimQueue *q = (SimQueue *)queue;
+  for (TickType_t waited = 0; q->items.empty(); waited++)
+  {
+    if (waited >= ticksToWait)
+      return pdFALSE;
+    vTaskDelay(1);
+  }
+  memcpy(item, q->items.front().data(), q->itemSize);
+  q->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+  return (UBaseType_t)((SimQueue *)queue)->items.size();
+}
+
+// ---------------------------------------------------------------------------
+// esp_timer
+// ---------------------------------------------------------------------------
+
+struct SimTimer
+{
+  esp_timer_cb_t callback;
+  void *arg;
+  bool armed;
+  uint64_t dueUs;    // Deadline plus the configured latency
+  uint64_t periodUs; // 0: one-shot
+};
+
+static std::vector<SimTimer *> &timerList()
+{
+  static std::vector<SimTimer *> *timers = new std::vector<SimTimer *>;
+  return *timers;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+  SimTimer *t = new SimTimer{create_args->callback, create_args->arg, false, 0, 0};
+  timerList().push_back(t);
+  *out_handle = t;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+  if (timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = true;
+  timer->dueUs = SimHost::nowUs() + timeout_us + SimHost::config().timerLatencyUs;
+  timer->periodUs = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+  if (timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = true;
+  timer->dueUs = SimHost::nowUs() + period + SimHost::config().timerLatencyUs;
+  timer->periodUs = period;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+  if (!timer->armed)
+    return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+  return timer->armed;
+}
+
+int64_t esp_timer_get_time(void)
+{
+  return (int64_t)SimHost::nowUs();
+}
+
+// The armed timer with the earliest deadline, nullptr if there is none
+static SimTimer *nextTimer()
+{
+  SimTimer *next = nullptr;
+  for (size_t i = 0; i < timerList().size(); i++)
+  {
+    SimTimer *t = timerList()[i];
+    if (t->armed && (!next || t->dueUs < next->dueUs))
+      next = t;
+  }
+  return next;
+}
+
+static void runDueTimers()
+{
+  SimTimer *t;
+  while ((t = nextTimer()) && t->dueUs <= SimHost::nowUs())
+  {
+    // Periodic timers keep their phase, the periods missed in between are skipped
+    if (t->periodUs)
+      t->dueUs += ((SimHost::nowUs() - t->dueUs) / t->periodUs + 1) * t->periodUs;
+    else
+      t->armed = false;
+    t->callback(t->arg);
+  }
+}
+
+// Moves the virtual clock on by `us`, stopping at each timer deadline on the way
+static void advanceThroughTimers(uint64_t us)
+{
+  uint64_t end = SimHost::nowUs() + us;
+  SimTimer *t;
+  while ((t = nextTimer()) && t->dueUs <= end)
+  {
+    if (t->dueUs > SimHost::nowUs())
+      SimHost::advanceUs(t->dueUs - SimHost::nowUs());
+    runDueTimers();
+  }
+  SimHost::advanceUs(end - SimHost::nowUs());
+}
+
+void SimHost::runDueTasks()
+{
+  if (currentTask)
+  {
+    return;
+  }
+  runDueTimers();
+  std::unique_lock<std::mutex> lock(schedMutex());
+  uint64_t now = nowUs();
+  for (size_t i = 0; i < taskList().size(); i++)
+  {
+    SimTask *task = taskList()[i];
+    if (!task->alive || task->wakeUs > now)
+    {
+      continue;
+    }
+    runningTask = task;
+    schedCv().notify_all();
+    schedCv().wait(lock, []
+                   { return runningTask == nullptr; });
+  }
+}
+
+void delay(unsigned long ms)
+{
+  if (currentTask)
+  {
+    vTaskDelay(ms);
+    return;
+  }
+  if (SimHost::config().realtime)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  }
+  else
+  {
+    advanceThroughTimers((uint64_t)ms * 1000);
+  }
+  SimHost::runDueTasks();
+}
+
+// ---------------------------------------------------------------------------
+// GPIO / ADC / misc
+// ---------------------------------------------------------------------------
+
+static uint8_t pinLevels[64];
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+  if (pin < sizeof(pinLevels))
+  {
+    pinLevels[pin] = val;
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  (void)pin;
+  return 0;
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  digitalWrite(pin, value ? HIGH : LOW);
+}
+
+static uint32_t ledcDuty[8];
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits)
+{
+  (void)channel;
+  (void)resolutionBits;
+  return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel)
+{
+  (void)pin;
+  (void)channel;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty)
+{
+  if (channel < sizeof(ledcDuty) / sizeof(ledcDuty[0]))
+    ledcDuty[channel] = duty;
+}
+
+uint32_t ledcRead(uint8_t channel)
+{
+  return channel < sizeof(ledcDuty) / sizeof(ledcDuty[0]) ? ledcDuty[channel] : 0;
+}
+
+// ---------------------------------------------------------------------------
+// RMT
+// ---------------------------------------------------------------------------
+
+static uint32_t rmtColor[RMT_CHANNEL_MAX];
+static uint32_t rmtWrites[RMT_CHANNEL_MAX];
+
+esp_err_t rmt_config(const rmt_config_t *rmt_param)
+{
+  return rmt_param->channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags)
+{
+  (void)rx_buf_size;
+  (void)intr_alloc_flags;
+  return channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *rmt_item, int item_num, bool wait_tx_done)
+{
+  (void)wait_tx_done;
+  if (channel >= RMT_CHANNEL_MAX)
+    return ESP_ERR_INVALID_ARG;
+  uint32_t grb = 0;
+  for (int i = 0; i < item_num && i < 24; i++)
+  {
+    // A one is high for more of the bit, 48% at 400 kHz and 64% at 800 kHz against 20% and 32%
+    uint32_t period = rmt_item[i].duration0 + rmt_item[i].duration1;
+    grb = (grb << 1) | (rmt_item[i].duration0 * 5 > period * 2 ? 1 : 0);
+  }
+  rmtColor[channel] = ((grb & 0x00FF00) << 8) | ((grb & 0xFF0000) >> 8) | (grb & 0xFF);
+  rmtWrites[channel]++;
+  return ESP_OK;
+}
+
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time)
+{
+  (void)wait_time;
+  return channel < RMT_CHANNEL_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+uint32_t simRmtColor(rmt_channel_t channel)
+{
+  return channel < RMT_CHANNEL_MAX ? rmtColor[channel] : 0;
+}
+
+uint32_t simRmtWrites(rmt_channel_t channel)
+{
+  return channel < RMT_CHANNEL_MAX ? rmtWrites[channel] : 0;
+}
+
+void analogReadResolution(uint8_t bits)
+{
+  (void)bits;
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin)
+{
+  (void)pin;
+  return 0;
+}
+
+// xorshift32, so runs do not depend on the host libc's rand()
+static uint32_t randomState = 2463534242u;
+
+void randomSeed(unsigned long seed)
+{
+  randomState = seed ? (uint32_t)seed : 2463534242u;
+}
+
+long random(long howbig)
+{
+  if (howbig <= 0)
+  {
+    return 0;
+  }
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return (long)(randomState % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+  if (howsmall >= howbig)
+  {
+    return howsmall;
+  }
+  return random(howbig - howsmall) + howsmall;
+}
+
+bool psramInit()
+{
+  return true;
+}
+
+bool psramFound()
+{
+  return true;
+}
+
+void *ps_malloc(size_t size)
+{
+  return malloc(size);
+}
+
+// Nominal ESP32-S3 N16R8 figures, the host heap is not metered
+uint32_t EspClass::getHeapSize() { return 320 * 1024; }
+uint32_t EspClass::getFreeHeap() { return 256 * 1024; }
+uint32_t EspClass::getPsramSize() { return 8 * 1024 * 1024; }
+uint32_t EspClass::getFreePsram() { return 8 * 1024 * 1024; }
+
+void EspClass::restart()
+{
+  fflush(stdout);
+  exit(0);
+}
+
+// ---------------------------------------------------------------------------
+// String
+// ---------------------------------------------------------------------------
+
+void String::trim()
+{
+  const char *ws = " \t\r\n";
+  size_t first = find_first_not_of(ws);
+  if (first == npos)
+  {
+    clear();
+    return;
+  }
+  size_t last = find_last_not_of(ws);
+  assign(substr(first, last - first + 1));
+}
+
+bool String::startsWith(const String &prefix) const
+{
+  return compare(0, prefix.size(), prefix) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+  return size() >= suffix.size() && compare(size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+  size_t pos = find(c, from);
+  return pos == npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &s, unsigned int from) const
+{
+  size_t pos = find(s, from);
+  return pos == npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const
+{
+  return from >= size() ? String() : String(substr(from));
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+  if (from > to)
+  {
+    std::swap(from, to);
+  }
+  if (from >= size())
+  {
+    return String();
+  }
+  return String(substr(from, to - from));
+}
+
+// ---------------------------------------------------------------------------
+// Serial
+// ---------------------------------------------------------------------------
+
+int HardwareSerial::printf(const char *format, ...)
+{
+  if (SimHost::config().quiet)
+  {
+    return 0;
+  }
+  va_list args;
+  va_start(args, format);
+  int n = vprintf(format, args);
+  va_end(args);
+  return n;
+}
+
+size_t HardwareSerial::print(const char *s)
+{
+  if (SimHost::config().quiet || !s)
+  {
+    return 0;
+  }
+  return fputs(s, stdout) < 0 ? 0 : strlen(s);
+}
+
+size_t HardwareSerial::print(char c)
+{
+  char s[2] = {c, 0};
+  return print(s);
+}
+
+size_t HardwareSerial::print(long v, int base)
+{
+  char s[24];
+  snprintf(s, sizeof(s), base == HEX ? "%lx" : "%ld", v);
+  return print(s);
+}
+
+size_t HardwareSerial::print(unsigned long v, int base)
+{
+  char s[24];
+  snprintf(s, sizeof(s), base == HEX ? "%lx" : "%lu", v);
+  return print(s);
+}
+
+size_t HardwareSerial::print(double v, int digits)
+{
+  char s[40];
+  snprintf(s, sizeof(s), "%.*f", digits, v);
+  return print(s);
+}
@@ -0,0 +1,192 @@
+// Arduino.h - host shim of the Arduino-ESP32 core for the simulator build
+// Only what the app, LVGL's tick source and the QMI8658 driver use.
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+// RTC memory outlives a deep sleep, the runner carries this section over the restart
+#define RTC_DATA_ATTR __attribute__((section("rtc_data")))
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  // Time base of the simulator, virtual unless --realtime is given (see SimHost.h)
+  unsigned long millis(void);
+  unsigned long micros(void);
+  void delay(unsigned long ms);
+  void delayMicroseconds(unsigned int us);
+
+#ifdef __cplusplus
+}
+
+#include <string>
+#include <algorithm>
+#include "freertos_shim.h"
+
+using std::max;
+using std::min;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void analogReadResolution(uint8_t bits);
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+// LEDC PWM; the duty is only kept, for ledcRead()
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+long random(long howsmall, long howbig);
+long random(long howbig);
+void randomSeed(unsigned long seed);
+
+class String : public std::string
+{
+public:
+  String() {}
+  String(const char *s) : std::string(s ? s : "") {}
+  String(const std::string &s) : std::string(s) {}
+  String(char c) : std::string(1, c) {}
+  String(int value) : std::string(std::to_string(value)) {}
+  String(unsigned int value) : std::string(std::to_string(value)) {}
+  String(long value) : std::string(std::to_string(value)) {}
+  String(unsigned long value) : std::string(std::to_string(value)) {}
+
+  bool isEmpty() const { return empty(); }
+  void trim();
+  bool startsWith(const String &prefix) const;
+  bool endsWith(const String &suffix) const;
+  bool equals(const String &other) const { return *this == other; }
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const String &s, unsigned int from = 0) const;
+  String substring(unsigned int from) const;
+  String substring(unsigned int from, unsigned int to) const;
+  long toInt() const { return strtol(c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(c_str(), nullptr); }
+
+  String &operator+=(const String &s)
+  {
+    append(s);
+    return *this;
+  }
+  String &operator+=(const char *s)
+  {
+    append(s ? s : "");
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    push_back(c);
+    return *this;
+  }
+};
+
+inline String operator+(const String &a, const String &b)
+{
+  String r(a);
+  r += b;
+  return r;
+}
+inline String operator+(const String &a, const char *b)
+{
+  String r(a);
+  r += b;
+  return r;
+}
+inline String operator+(const char *a, const String &b)
+{
+  String r(a);
+  r += b;
+  return r;
+}
+
+// Serial output goes to stdout, silenced with --quiet
+class HardwareSerial
+{
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available() { return 0; }
+  int read() { return -1; }
+  void flush() { fflush(stdout); }
+
+  int printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const char *s);
+  size_t print(const String &s) { return print(s.c_str()); }
+  size_t print(char c);
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return print("\n"); }
+  template <typename T>
+  size_t println(const T &v)
+  {
+    size_t n = print(v);
+    return n + print("\n");
+  }
+  template <typename T>
+  size_t println(const T &v, int format)
+  {
+    size_t n = print(v, format);
+    return n + print("\n");
+  }
+};
+
+extern HardwareSerial Serial;
+
+// PSRAM is plain heap on the host
+bool psramInit();
+bool psramFound();
+void *ps_malloc(size_t size);
+
+class EspClass
+{
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getPsramSize();
+  uint32_t getFreePsram();
+  void restart();
+};
+
+extern EspClass ESP;
+
+#endif // __cplusplus
+
+#endif // SIM_ARDUINO_H
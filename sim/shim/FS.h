@@ -0,0 +1,29 @@
+// FS.h - files of the simulator's LittleFS, backed by a host directory
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+#include <Arduino.h>
+
+namespace fs
+{
+  class File
+  {
+  public:
+    File() : _f(nullptr) {}
+    explicit File(FILE *f) : _f(f) {}
+
+    operator bool() const { return _f != nullptr; }
+    int available();
+    int read();
+    size_t read(uint8_t *buf, size_t size);
+    size_t write(const uint8_t *buf, size_t size);
+    size_t size();
+    String readStringUntil(char terminator);
+    void close();
+
+  private:
+    FILE *_f;
+  };
+}
+
+#endif // SIM_FS_H
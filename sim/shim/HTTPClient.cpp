@@ -0,0 +1,198 @@
+#include "HTTPClient.h"
+#include "SimHost.h"
+#include <WiFi.h>
+#include <errno.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+uint32_t HTTPClient::_okCount = 0;
+
+// Split "http://host[:port]/path"
+static bool parseUrl(const String &url, String &host, uint16_t &port, String &path)
+{
+  String rest = url;
+  if (rest.startsWith("http://"))
+  {
+    rest = rest.substring(7);
+  }
+  else if (rest.indexOf("://") >= 0)
+  {
+    return false; // TLS is not emulated, use --server
+  }
+  int slash = rest.indexOf('/');
+  String hostPort = slash >= 0 ? rest.substring(0, slash) : rest;
+  path = slash >= 0 ? rest.substring(slash) : String("/");
+  int colon = hostPort.indexOf(':');
+  host = colon >= 0 ? hostPort.substring(0, colon) : hostPort;
+  port = colon >= 0 ? (uint16_t)hostPort.substring(colon + 1).toInt() : 80;
+  return !host.isEmpty();
+}
+
+bool HTTPClient::begin(const String &url)
+{
+  _headers.clear();
+  _body = String();
+  const String &server = SimHost::config().server;
+  return parseUrl(server.empty() ? url : String(server), _host, _port, _path);
+}
+
+void HTTPClient::end()
+{
+  _headers.clear();
+}
+
+void HTTPClient::addHeader(const String &name, const String &value)
+{
+  _headers.push_back(name + ": " + value + "\r\n");
+}
+
+int HTTPClient::GET()
+{
+  return sendRequest("GET", nullptr, 0);
+}
+
+int HTTPClient::POST(uint8_t *payload, size_t size)
+{
+  return sendRequest("POST", payload, size);
+}
+
+static bool sendAll(int fd, const char *data, size_t len)
+{
+  while (len > 0)
+  {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n <= 0)
+    {
+      if (n < 0 && errno == EINTR)
+        continue;
+      return false;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+int HTTPClient::sendRequest(const char *method, const uint8_t *payload, size_t size)
+{
+  uint64_t start = SimHost::hostUs();
+  _body = String();
+
+  // Nothing gets through a link the access point has dropped, the connect times out
+  if (!WiFi.linkUp())
+  {
+    SimHost::advanceUs((uint64_t)_timeoutMs * 1000);
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo *res = nullptr;
+  if (_host.isEmpty() || getaddrinfo(_host.c_str(), String((unsigned int)_port).c_str(), &hints, &res) != 0)
+  {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+
+  int fd = -1;
+  for (struct addrinfo *ai = res; ai; ai = ai->ai_next)
+  {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd < 0)
+      continue;
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+      break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(res);
+  if (fd < 0)
+  {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+
+  struct timeval tv;
+  tv.tv_sec = _timeoutMs / 1000;
+  tv.tv_usec = (_timeoutMs % 1000) * 1000;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  // HTTP/1.0 so the response is never chunked and ends when the server closes
+  String head = String(method) + " " + _path + " HTTP/1.0\r\n";
+  head += "Host: " + _host + "\r\n";
+  head += "Content-Length: " + String((unsigned long)size) + "\r\n";
+  head += "Connection: close\r\n";
+  for (size_t i = 0; i < _headers.size(); i++)
+  {
+    head += _headers[i];
+  }
+  head += "\r\n";
+
+  if (!sendAll(fd, head.c_str(), head.length()))
+  {
+    close(fd);
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
+  if (size && !sendAll(fd, (const char *)payload, size))
+  {
+    close(fd);
+    return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+  }
+
+  String response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+  {
+    response.append(buf, (size_t)n);
+  }
+  bool timedOut = n < 0;
+  close(fd);
+
+  // The request blocked the app for as long as the server took
+  SimHost::advanceUs(SimHost::hostUs() - start);
+
+  int code = 0;
+  if (!response.startsWith("HTTP/") || sscanf(response.c_str(), "HTTP/%*s %d", &code) != 1)
+  {
+    code = 0;
+  }
+  if (code <= 0)
+  {
+    return timedOut ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_NO_HTTP_SERVER;
+  }
+  if (code == 200)
+  {
+    _okCount++;
+  }
+  int bodyStart = response.indexOf("\r\n\r\n");
+  _body = bodyStart >= 0 ? response.substring(bodyStart + 4) : String();
+  return code;
+}
+
+String HTTPClient::errorToString(int error)
+{
+  switch (error)
+  {
+  case HTTPC_ERROR_CONNECTION_REFUSED:
+    return "connection refused";
+  case HTTPC_ERROR_SEND_HEADER_FAILED:
+    return "send header failed";
+  case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+    return "send payload failed";
+  case HTTPC_ERROR_NOT_CONNECTED:
+    return "not connected";
+  case HTTPC_ERROR_CONNECTION_LOST:
+    return "connection lost";
+  case HTTPC_ERROR_NO_STREAM:
+    return "no stream";
+  case HTTPC_ERROR_NO_HTTP_SERVER:
+    return "no HTTP server";
+  case HTTPC_ERROR_READ_TIMEOUT:
+    return "read Timeout";
+  default:
+    return String();
+  }
+}
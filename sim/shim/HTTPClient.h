@@ -0,0 +1,48 @@
+// HTTPClient.h - plain HTTP/1.0 client over POSIX sockets for the simulator build
+// With a stand-in server configured (--server) every request goes there instead of the
+// URL the app asked for, so the real val.town endpoint is never contacted.
+#ifndef SIM_HTTP_CLIENT_H
+#define SIM_HTTP_CLIENT_H
+
+#include <Arduino.h>
+#include <vector>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_NO_STREAM (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER (-7)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+class HTTPClient
+{
+public:
+  HTTPClient() : _port(80), _timeoutMs(5000) {}
+
+  bool begin(const String &url);
+  void end();
+  void addHeader(const String &name, const String &value);
+  void setTimeout(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+  int GET();
+  int POST(uint8_t *payload, size_t size);
+  int POST(const String &payload) { return POST((uint8_t *)payload.c_str(), payload.length()); }
+  String getString() { return _body; }
+  static String errorToString(int error);
+  // Simulator: requests answered with 200 so far, for the scenario checks
+  static uint32_t okCount() { return _okCount; }
+
+private:
+  String _host;
+  uint16_t _port;
+  String _path;
+  uint16_t _timeoutMs;
+  std::vector<String> _headers;
+  String _body;
+  static uint32_t _okCount;
+
+  int sendRequest(const char *method, const uint8_t *payload, size_t size);
+};
+
+#endif // SIM_HTTP_CLIENT_H
@@ -0,0 +1,113 @@
+#include "LittleFS.h"
+#include "SimHost.h"
+#include <sys/stat.h>
+
+LittleFSFS LittleFS;
+
+static String hostPath(const char *path)
+{
+  String p(path ? path : "");
+  if (p.startsWith("/littlefs"))
+  {
+    p = p.substring(9);
+  }
+  if (!p.startsWith("/"))
+  {
+    p = "/" + p;
+  }
+  return String(SimHost::config().dataDir) + p;
+}
+
+bool LittleFSFS::begin(bool formatOnFail)
+{
+  // Mounting scans the partition's metadata, tens of ms on the device
+  delay(30);
+  struct stat st;
+  if (stat(SimHost::config().dataDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+  {
+    return true;
+  }
+  return formatOnFail && mkdir(SimHost::config().dataDir.c_str(), 0755) == 0;
+}
+
+fs::File LittleFSFS::open(const char *path, const char *mode)
+{
+  String m(mode ? mode : "r");
+  if (m.indexOf('b') < 0)
+  {
+    m += "b";
+  }
+  return fs::File(fopen(hostPath(path).c_str(), m.c_str()));
+}
+
+bool LittleFSFS::exists(const char *path)
+{
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool LittleFSFS::remove(const char *path)
+{
+  return ::remove(hostPath(path).c_str()) == 0;
+}
+
+int fs::File::available()
+{
+  if (!_f)
+  {
+    return 0;
+  }
+  long pos = ftell(_f);
+  fseek(_f, 0, SEEK_END);
+  long end = ftell(_f);
+  fseek(_f, pos, SEEK_SET);
+  return (int)(end - pos);
+}
+
+int fs::File::read()
+{
+  return _f ? fgetc(_f) : -1;
+}
+
+size_t fs::File::read(uint8_t *buf, size_t size)
+{
+  return _f ? fread(buf, 1, size, _f) : 0;
+}
+
+size_t fs::File::write(const uint8_t *buf, size_t size)
+{
+  return _f ? fwrite(buf, 1, size, _f) : 0;
+}
+
+size_t fs::File::size()
+{
+  if (!_f)
+  {
+    return 0;
+  }
+  long pos = ftell(_f);
+  fseek(_f, 0, SEEK_END);
+  long end = ftell(_f);
+  fseek(_f, pos, SEEK_SET);
+  return (size_t)end;
+}
+
+String fs::File::readStringUntil(char terminator)
+{
+  String s;
+  int c;
+  while (_f && (c = fgetc(_f)) != EOF && c != terminator)
+  {
+    s += (char)c;
+  }
+  return s;
+}
+
+void fs::File::close()
+{
+  if (_f)
+  {
+    fclose(_f);
+    _f = nullptr;
+  }
+}
@@ -0,0 +1,20 @@
+// LittleFS.h - LittleFS mounted on a host directory (SimHost::Config::dataDir, "data" by default)
+// so the simulator reads the same data/.env that generate_env.py prepares for the firmware image.
+#ifndef SIM_LITTLEFS_H
+#define SIM_LITTLEFS_H
+
+#include <FS.h>
+
+class LittleFSFS
+{
+public:
+  bool begin(bool formatOnFail = false);
+  void end() {}
+  fs::File open(const char *path, const char *mode = "r");
+  bool exists(const char *path);
+  bool remove(const char *path);
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // SIM_LITTLEFS_H
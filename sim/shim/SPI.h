@@ -0,0 +1,34 @@
+// SPI.h - the display goes through the TFT_eSPI framebuffer shim, nothing else uses SPI
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+#include <Arduino.h>
+
+#define FSPI 0
+#define HSPI 1
+
+class SPIClass
+{
+public:
+  SPIClass(uint8_t bus = 0) { (void)bus; }
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1)
+  {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+  void end() {}
+  uint8_t transfer(uint8_t data)
+  {
+    (void)data;
+    return 0;
+  }
+  void transfer(void *data, uint32_t size)
+  {
+    (void)data;
+    (void)size;
+  }
+};
+
+#endif // SIM_SPI_H
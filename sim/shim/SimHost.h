@@ -0,0 +1,45 @@
+// SimHost.h - configuration and clock shared by the simulator shims and the scenario runner
+#ifndef SIM_HOST_H
+#define SIM_HOST_H
+
+#include <stdint.h>
+#include <string>
+
+namespace SimHost
+{
+  struct Config
+  {
+    bool realtime;      // Use the host clock instead of the virtual one
+    bool quiet;         // Drop Serial output
+    bool wifi;          // Report WL_CONNECTED to the app
+    std::string dataDir; // Host directory mounted as LittleFS
+    std::string server;  // Stand-in server, every HTTP request is sent here
+    uint32_t wifiConnectMs; // Association time after switching to station mode
+    uint32_t wifiReconnectMs; // ... when the channel and BSSID are given, no scan
+    uint32_t wifiDropAtMs;    // The access point goes away at this time ...
+    uint32_t wifiDropMs;      // ... for this long, 0: never
+    uint32_t timerLatencyUs;  // esp_timer callbacks run this late
+
+    Config() : realtime(false), quiet(false), wifi(false), dataDir("data"), wifiConnectMs(1500), wifiReconnectMs(400),
+               wifiDropAtMs(0), wifiDropMs(0), timerLatencyUs(0) {}
+  };
+
+  Config &config();
+
+  // Simulator clock in microseconds. The virtual clock only moves when the app
+  // sleeps, samples the microphone or waits on the network, so runs are repeatable.
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);
+
+  // Run the esp_timer callbacks and the tasks whose deadline has passed, called from the app thread
+  void runDueTasks();
+
+  // Host wall clock for measurements, independent of the simulator clock
+  uint64_t hostUs();
+
+  // The end of a deep sleep: the runner starts the app over in a new process with the
+  // RTC_DATA_ATTR variables, the wake cause and the scenario clock carried over
+  [[noreturn]] void deepSleepReset(int wakeCause);
+}
+
+#endif // SIM_HOST_H
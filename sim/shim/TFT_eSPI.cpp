@@ -0,0 +1,59 @@
+#include "TFT_eSPI.h"
+
+TFT_eSPI *TFT_eSPI::_instance = nullptr;
+
+TFT_eSPI::TFT_eSPI(int16_t w, int16_t h)
+    : pixelsPushed(0), windowsSet(0), _width(w), _height(h), _x1(0), _y1(0), _x2(w - 1), _y2(h - 1), _cx(0), _cy(0)
+{
+  _fb = new uint16_t[w * h]();
+  _instance = this;
+}
+
+TFT_eSPI::~TFT_eSPI()
+{
+  if (_instance == this)
+  {
+    _instance = nullptr;
+  }
+  delete[] _fb;
+}
+
+void TFT_eSPI::begin()
+{
+  // The GC9A01 init sequence: reset pulse, 120 ms after sleep out, 20 ms after display on
+  delay(150);
+  memset(_fb, 0, sizeof(uint16_t) * _width * _height);
+}
+
+void TFT_eSPI::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h)
+{
+  _x1 = x;
+  _y1 = y;
+  _x2 = x + w - 1;
+  _y2 = y + h - 1;
+  _cx = _x1;
+  _cy = _y1;
+  windowsSet++;
+}
+
+void TFT_eSPI::pushColors(uint16_t *data, uint32_t len, bool swap)
+{
+  pixelsPushed += len;
+  for (uint32_t i = 0; i < len; i++)
+  {
+    // swap only changes the byte order on the wire; data without it is already big-endian
+    uint16_t c = swap ? data[i] : (uint16_t)((data[i] << 8) | (data[i] >> 8));
+    if (_cx >= 0 && _cx < _width && _cy >= 0 && _cy < _height)
+    {
+      _fb[_cy * _width + _cx] = c;
+    }
+    if (++_cx > _x2)
+    {
+      _cx = _x1;
+      if (++_cy > _y2)
+      {
+        _cy = _y1;
+      }
+    }
+  }
+}
@@ -0,0 +1,47 @@
+// TFT_eSPI.h - memory framebuffer standing in for the GC9A01 panel in the simulator build
+// Keeps AnimationManager's flush path (including the round-viewport spans) running unchanged.
+#ifndef SIM_TFT_ESPI_H
+#define SIM_TFT_ESPI_H
+
+#include <Arduino.h>
+
+class TFT_eSPI
+{
+public:
+  TFT_eSPI(int16_t w = 240, int16_t h = 240);
+  ~TFT_eSPI();
+
+  void begin();
+  void setRotation(uint8_t r) { (void)r; }
+  void startWrite() {}
+  void endWrite() {}
+  void writecommand(uint8_t c) { (void)c; }
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+  void pushColors(uint16_t *data, uint32_t len, bool swap = true);
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+  // RGB565 frame as the panel would show it, row-major
+  const uint16_t *framebuffer() const { return _fb; }
+
+  // Bus traffic counters, cleared by the caller
+  uint32_t pixelsPushed;
+  uint32_t windowsSet;
+
+  // The panel the app created last, for the scenario runner
+  static TFT_eSPI *instance() { return _instance; }
+
+private:
+  int16_t _width;
+  int16_t _height;
+  uint16_t *_fb;
+
+  // Current address window and write cursor
+  int32_t _x1, _y1, _x2, _y2;
+  int32_t _cx, _cy;
+
+  static TFT_eSPI *_instance;
+};
+
+#endif // SIM_TFT_ESPI_H
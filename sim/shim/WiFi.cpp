@@ -0,0 +1,251 @@
+#include "WiFi.h"
+#include "SimHost.h"
+
+WiFiClass WiFi;
+
+// The stand-in access point
+static const uint8_t AP_BSSID[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t AP_CHANNEL = 6;
+const char SIM_AP_SSID[] = "simulator";
+const char SIM_AP_PSK[] = "simulator-psk";
+static const uint32_t EVENT_TASK_PERIOD = 5;
+static const uint32_t BEACON_TIMEOUT_MS = 6000; // ESP-IDF's default inactive time of the station
+
+String IPAddress::toString() const
+{
+  char s[16];
+  snprintf(s, sizeof(s), "%u.%u.%u.%u", (unsigned)(_addr & 0xFF), (unsigned)((_addr >> 8) & 0xFF),
+           (unsigned)((_addr >> 16) & 0xFF), (unsigned)(_addr >> 24));
+  return String(s);
+}
+
+// Reachable unless --no-wifi, or inside the --wifi-drop-at window
+static bool accessPointUp()
+{
+  const SimHost::Config &cfg = SimHost::config();
+  if (!cfg.wifi)
+    return false;
+  if (!cfg.wifiDropMs)
+    return true;
+  uint64_t now = SimHost::nowUs();
+  uint64_t from = (uint64_t)cfg.wifiDropAtMs * 1000;
+  return now < from || now >= from + (uint64_t)cfg.wifiDropMs * 1000;
+}
+
+WiFiClass::WiFiClass()
+    : _mode(WIFI_OFF),
+      _link(LINK_IDLE),
+      _attemptUs(0),
+      _connectMs(0),
+      _psk(SIM_AP_PSK),
+      _staleUntilUs(0),
+      _autoReconnect(true),
+      _powerSave(WIFI_PS_MIN_MODEM),
+      _eventTask(false)
+{
+}
+
+bool WiFiClass::mode(wifi_mode_t mode)
+{
+  if (mode != _mode)
+  {
+    _mode = mode;
+    // Station mode joins the saved network
+    if (mode == WIFI_STA)
+      startAttempt(false);
+    else
+      _link = LINK_IDLE;
+    _staleUntilUs = 0;
+  }
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel, const uint8_t *bssid,
+                             bool connect)
+{
+  (void)ssid;
+  _psk = passphrase ? passphrase : "";
+  if (_mode == WIFI_OFF)
+    _mode = WIFI_STA;
+  if (connect)
+    startAttempt(channel && bssid);
+  return status();
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap)
+{
+  (void)eraseap;
+  _staleUntilUs = 0;
+  if (_link != LINK_IDLE)
+  {
+    _link = LINK_IDLE;
+    post(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_ASSOC_LEAVE);
+  }
+  if (wifioff)
+    _mode = WIFI_OFF;
+  return true;
+}
+
+bool WiFiClass::reconnect()
+{
+  if (_mode == WIFI_OFF)
+    return false;
+  startAttempt(false);
+  return true;
+}
+
+bool WiFiClass::setAutoReconnect(bool autoReconnect)
+{
+  _autoReconnect = autoReconnect;
+  return true;
+}
+
+void WiFiClass::startAttempt(bool fast)
+{
+  const SimHost::Config &cfg = SimHost::config();
+  _link = LINK_CONNECTING;
+  _staleUntilUs = 0;
+  _attemptUs = SimHost::nowUs();
+  _connectMs = fast ? cfg.wifiReconnectMs : cfg.wifiConnectMs;
+}
+
+// Moves the link on with the clock
+void WiFiClass::update()
+{
+  if (_link == LINK_CONNECTING && SimHost::nowUs() - _attemptUs >= (uint64_t)_connectMs * 1000)
+  {
+    if (accessPointUp() && _psk == SIM_AP_PSK)
+    {
+      _link = LINK_CONNECTED;
+      post(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+      post(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+      return;
+    }
+    _link = LINK_IDLE;
+    post(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, accessPointUp() ? WIFI_REASON_AUTH_FAIL : WIFI_REASON_NO_AP_FOUND);
+    if (_autoReconnect)
+      startAttempt(false);
+  }
+  else if (_link == LINK_CONNECTED && (!accessPointUp() || (_staleUntilUs && SimHost::nowUs() >= _staleUntilUs)))
+  {
+    _staleUntilUs = 0;
+    _link = LINK_IDLE;
+    post(ARDUINO_EVENT_WIFI_STA_DISCONNECTED, WIFI_REASON_BEACON_TIMEOUT);
+    if (_autoReconnect)
+      startAttempt(false);
+  }
+}
+
+void WiFiClass::post(arduino_event_id_t id, uint8_t reason)
+{
+  if (!_eventTask)
+    return;
+  Pending p;
+  memset(&p, 0, sizeof(p));
+  p.id = id;
+  if (id == ARDUINO_EVENT_WIFI_STA_CONNECTED)
+  {
+    memcpy(p.info.wifi_sta_connected.ssid, SIM_AP_SSID, sizeof(SIM_AP_SSID) - 1);
+    p.info.wifi_sta_connected.ssid_len = sizeof(SIM_AP_SSID) - 1;
+    memcpy(p.info.wifi_sta_connected.bssid, AP_BSSID, sizeof(AP_BSSID));
+    p.info.wifi_sta_connected.channel = AP_CHANNEL;
+  }
+  else if (id == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+  {
+    memcpy(p.info.wifi_sta_disconnected.ssid, SIM_AP_SSID, sizeof(SIM_AP_SSID) - 1);
+    p.info.wifi_sta_disconnected.ssid_len = sizeof(SIM_AP_SSID) - 1;
+    memcpy(p.info.wifi_sta_disconnected.bssid, AP_BSSID, sizeof(AP_BSSID));
+    p.info.wifi_sta_disconnected.reason = reason;
+  }
+  _pending.push_back(p);
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb cb, arduino_event_id_t event)
+{
+  Handler h;
+  h.cb = cb;
+  h.event = event;
+  _handlers.push_back(h);
+  if (!_eventTask)
+  {
+    _eventTask = true;
+    xTaskCreate(eventTask, "arduino_events", 4096, this, 2, nullptr);
+  }
+  return _handlers.size();
+}
+
+void WiFiClass::eventTask(void *parameter)
+{
+  WiFiClass *self = (WiFiClass *)parameter;
+  for (;;)
+  {
+    self->update();
+    while (!self->_pending.empty())
+    {
+      Pending p = self->_pending.front();
+      self->_pending.pop_front();
+      for (size_t i = 0; i < self->_handlers.size(); i++)
+      {
+        if (self->_handlers[i].event == ARDUINO_EVENT_MAX || self->_handlers[i].event == p.id)
+          self->_handlers[i].cb(p.id, p.info);
+      }
+    }
+    vTaskDelay(pdMS_TO_TICKS(EVENT_TASK_PERIOD));
+  }
+}
+
+void WiFiClass::lightSleep()
+{
+  if (_link == LINK_CONNECTED && !_staleUntilUs)
+    _staleUntilUs = SimHost::nowUs() + (uint64_t)BEACON_TIMEOUT_MS * 1000;
+}
+
+bool WiFiClass::linkUp()
+{
+  return status() == WL_CONNECTED && !_staleUntilUs && accessPointUp();
+}
+
+wl_status_t WiFiClass::status()
+{
+  update();
+  return _link == LINK_CONNECTED ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress WiFiClass::localIP()
+{
+  return status() == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+String WiFiClass::SSID()
+{
+  return status() == WL_CONNECTED ? String(SIM_AP_SSID) : String();
+}
+
+// Like the core, nothing while the radio is off
+String WiFiClass::psk()
+{
+  return _mode == WIFI_OFF ? String() : _psk;
+}
+
+int32_t WiFiClass::RSSI()
+{
+  return status() == WL_CONNECTED ? -50 : 0;
+}
+
+uint8_t *WiFiClass::BSSID()
+{
+  static uint8_t bssid[6];
+  memcpy(bssid, AP_BSSID, sizeof(bssid));
+  return status() == WL_CONNECTED ? bssid : nullptr;
+}
+
+int32_t WiFiClass::channel()
+{
+  return status() == WL_CONNECTED ? AP_CHANNEL : 0;
+}
+
+bool WiFiClass::setSleep(wifi_ps_type_t sleepType)
+{
+  _powerSave = sleepType;
+  return true;
+}
@@ -0,0 +1,173 @@
+// WiFi.h - station interface of the simulator, "connected" when a stand-in server is configured.
+// The link is a small state machine that posts the driver's events to the callbacks from
+// an event task of its own, like the Arduino core does.
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include <deque>
+
+typedef enum
+{
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum
+{
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3,
+} wifi_mode_t;
+
+class IPAddress
+{
+public:
+  IPAddress() : _addr(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : _addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  String toString() const;
+
+private:
+  uint32_t _addr;
+};
+
+typedef enum
+{
+  WIFI_PS_NONE,
+  WIFI_PS_MIN_MODEM,
+  WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+typedef enum
+{
+  ARDUINO_EVENT_WIFI_READY = 0,
+  ARDUINO_EVENT_WIFI_STA_START = 2,
+  ARDUINO_EVENT_WIFI_STA_STOP = 3,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP = 9,
+  ARDUINO_EVENT_MAX = 40,
+} arduino_event_id_t;
+
+// Disconnect reasons the simulator reports
+#define WIFI_REASON_ASSOC_LEAVE 8
+#define WIFI_REASON_BEACON_TIMEOUT 200
+#define WIFI_REASON_NO_AP_FOUND 201
+#define WIFI_REASON_AUTH_FAIL 202
+
+// The stand-in access point's network, the one saved by the last portal session
+extern const char SIM_AP_SSID[];
+extern const char SIM_AP_PSK[];
+
+typedef struct
+{
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t channel;
+  int authmode;
+  uint16_t aid;
+} wifi_event_sta_connected_t;
+
+typedef struct
+{
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t bssid[6];
+  uint8_t reason;
+} wifi_event_sta_disconnected_t;
+
+typedef union
+{
+  wifi_event_sta_connected_t wifi_sta_connected;
+  wifi_event_sta_disconnected_t wifi_sta_disconnected;
+} arduino_event_info_t;
+
+typedef std::function<void(arduino_event_id_t event, arduino_event_info_t info)> WiFiEventFuncCb;
+typedef size_t wifi_event_id_t;
+
+class WiFiClass
+{
+public:
+  WiFiClass();
+
+  bool mode(wifi_mode_t mode);
+  // Joining with the channel and BSSID given skips the scan, so it's quicker. The
+  // passphrase is saved like the driver does, a wrong one fails the attempt.
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t *bssid = nullptr, bool connect = true);
+  bool disconnect(bool wifioff = false, bool eraseap = false);
+  bool reconnect();
+  bool setAutoReconnect(bool autoReconnect);
+  bool getAutoReconnect() const { return _autoReconnect; }
+  wifi_mode_t getMode() const { return _mode; }
+  wl_status_t status();
+  bool isConnected() { return status() == WL_CONNECTED; }
+  IPAddress localIP();
+  String SSID();
+  String psk();
+  int32_t RSSI();
+  uint8_t *BSSID();
+  int32_t channel();
+  bool setSleep(bool enable) { return setSleep(enable ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE); }
+  bool setSleep(wifi_ps_type_t sleepType);
+  wifi_ps_type_t getSleep() const { return _powerSave; }
+
+  // Callbacks run on the event task, for every event or the given one
+  wifi_event_id_t onEvent(WiFiEventFuncCb cb, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+
+  // Simulator: the chip light slept with the station started. The access point has
+  // dropped it meanwhile, but the driver only notices at the beacon timeout.
+  void lightSleep();
+  // Simulator: packets get through, not just associated as far as the driver knows
+  bool linkUp();
+
+private:
+  enum Link
+  {
+    LINK_IDLE,
+    LINK_CONNECTING,
+    LINK_CONNECTED
+  };
+  struct Pending
+  {
+    arduino_event_id_t id;
+    arduino_event_info_t info;
+  };
+  struct Handler
+  {
+    WiFiEventFuncCb cb;
+    arduino_event_id_t event;
+  };
+
+  wifi_mode_t _mode;
+  Link _link;
+  uint64_t _attemptUs; // When the current association attempt started
+  uint32_t _connectMs; // and how long it takes
+  String _psk;         // Saved passphrase
+  uint64_t _staleUntilUs; // Beacon timeout of a link lost in light sleep, 0: none
+  bool _autoReconnect;
+  wifi_ps_type_t _powerSave;
+  std::vector<Handler> _handlers;
+  std::deque<Pending> _pending;
+  bool _eventTask;
+
+  void startAttempt(bool fast);
+  void update();
+  void post(arduino_event_id_t id, uint8_t reason = 0);
+  static void eventTask(void *parameter);
+};
+
+extern WiFiClass WiFi;
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,45 @@
+// WiFiManager.h - no captive portal in the simulator, the station state comes from SimHost
+#ifndef SIM_WIFI_MANAGER_H
+#define SIM_WIFI_MANAGER_H
+
+#include <WiFi.h>
+#include "SimHost.h"
+
+class WiFiManager
+{
+public:
+  void setAPStaticIPConfig(IPAddress ip, IPAddress gw, IPAddress sn)
+  {
+    (void)ip;
+    (void)gw;
+    (void)sn;
+  }
+  void setConfigPortalTimeout(unsigned long seconds) { (void)seconds; }
+  void setConfigPortalBlocking(bool shouldBlock) { (void)shouldBlock; }
+  // Waits for the saved network like the real one, fails after the association time
+  bool autoConnect(const char *apName)
+  {
+    (void)apName;
+    unsigned long start = millis();
+    while (WiFi.status() != WL_CONNECTED && millis() - start < SimHost::config().wifiConnectMs)
+    {
+      delay(10);
+    }
+    return WiFi.status() == WL_CONNECTED;
+  }
+  bool process() { return false; }
+  // The network saved by the last portal session
+  String getWiFiSSID(bool persistent = true)
+  {
+    (void)persistent;
+    return SimHost::config().wifi ? String(SIM_AP_SSID) : String();
+  }
+  String getWiFiPass(bool persistent = true)
+  {
+    (void)persistent;
+    return SimHost::config().wifi ? String(SIM_AP_PSK) : String();
+  }
+  bool getConfigPortalActive() { return false; }
+};
+
+#endif // SIM_WIFI_MANAGER_H
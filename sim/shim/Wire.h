@@ -0,0 +1,50 @@
+// Wire.h - I2C bus of the simulator, the only device on it is the emulated QMI8658 (see SimImu.h)
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+  bool setPins(int sda, int scl)
+  {
+    (void)sda;
+    (void)scl;
+    return true;
+  }
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0)
+  {
+    (void)sda;
+    (void)scl;
+    (void)frequency;
+    return true;
+  }
+  bool end() { return true; }
+  bool setClock(uint32_t frequency)
+  {
+    (void)frequency;
+    return true;
+  }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t len);
+  uint8_t requestFrom(uint8_t address, size_t len);
+  int available();
+  int read();
+
+private:
+  uint8_t _address;
+  uint8_t _reg;
+  uint8_t _tx[32];
+  size_t _txLen;
+  uint8_t _rx[256];
+  size_t _rxLen;
+  size_t _rxPos;
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,36 @@
+// driver/gpio.h - GPIO numbering for the simulator build
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_NC -1
+
+typedef enum
+{
+  GPIO_INTR_DISABLE = 0,
+  GPIO_INTR_LOW_LEVEL = 4,
+  GPIO_INTR_HIGH_LEVEL = 5
+} gpio_int_type_t;
+
+// Light sleep wake sources, see esp_sleep.h
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type);
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num);
+
+// Pad state held through deep sleep, nothing to hold in the simulator
+inline esp_err_t gpio_hold_en(gpio_num_t gpio_num)
+{
+  (void)gpio_num;
+  return ESP_OK;
+}
+inline esp_err_t gpio_hold_dis(gpio_num_t gpio_num)
+{
+  (void)gpio_num;
+  return ESP_OK;
+}
+inline void gpio_deep_sleep_hold_en(void) {}
+inline void gpio_deep_sleep_hold_dis(void) {}
+
+#endif // SIM_DRIVER_GPIO_H
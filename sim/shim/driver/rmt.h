@@ -0,0 +1,66 @@
+// driver/rmt.h - RMT transmit channels for the simulator build
+// Nothing is clocked out; a write decodes the items of the status LED back to the color it shows.
+#ifndef SIM_DRIVER_RMT_H
+#define SIM_DRIVER_RMT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos_shim.h"
+
+typedef enum
+{
+  RMT_CHANNEL_0,
+  RMT_CHANNEL_1,
+  RMT_CHANNEL_2,
+  RMT_CHANNEL_3,
+  RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum
+{
+  RMT_MODE_TX,
+  RMT_MODE_RX
+} rmt_mode_t;
+
+typedef struct
+{
+  union
+  {
+    struct
+    {
+      uint32_t duration0 : 15;
+      uint32_t level0 : 1;
+      uint32_t duration1 : 15;
+      uint32_t level1 : 1;
+    };
+    uint32_t val;
+  };
+} rmt_item32_t;
+
+typedef struct
+{
+  rmt_mode_t rmt_mode;
+  rmt_channel_t channel;
+  gpio_num_t gpio_num;
+  uint8_t clk_div;
+  uint8_t mem_block_num;
+  uint32_t flags;
+} rmt_config_t;
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) \
+  {                                             \
+    RMT_MODE_TX, channel_id, gpio, 80, 1, 0     \
+  }
+
+esp_err_t rmt_config(const rmt_config_t *rmt_param);
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags);
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *rmt_item, int item_num, bool wait_tx_done);
+esp_err_t rmt_wait_tx_done(rmt_channel_t channel, TickType_t wait_time);
+
+// What the simulator keeps of the last write to a channel: its items read as 24 GRB bits
+// (a one when it is high for over 40% of the bit), returned as 0xRRGGBB, and the number of writes
+uint32_t simRmtColor(rmt_channel_t channel);
+uint32_t simRmtWrites(rmt_channel_t channel);
+
+#endif // SIM_DRIVER_RMT_H
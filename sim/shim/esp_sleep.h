@@ -0,0 +1,31 @@
+// esp_sleep.h - light and deep sleep for the simulator build, woken by the emulated IMU's interrupt line
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+typedef enum
+{
+  ESP_SLEEP_WAKEUP_UNDEFINED = 0,
+  ESP_SLEEP_WAKEUP_EXT0 = 2,
+  ESP_SLEEP_WAKEUP_TIMER = 4,
+  ESP_SLEEP_WAKEUP_GPIO = 7
+} esp_sleep_source_t;
+
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void);
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t gpio_num, int level);
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+
+// Advances the simulator clock until a wake source fires, tasks don't run meanwhile
+esp_err_t esp_light_sleep_start(void);
+
+// Waits the same way, then restarts the app like the chip's reset (see SimHost::deepSleepReset)
+[[noreturn]] void esp_deep_sleep_start(void);
+
+#endif // SIM_ESP_SLEEP_H
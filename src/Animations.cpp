@@ -1,18 +1,25 @@
 #include "Animations.h"
 #include <stdarg.h>
+#include <DEV_Config.h>
 
 TFT_eSPI *AnimationManager::tft = nullptr;
+FlushStats AnimationManager::_frameStats;
+FlushStats AnimationManager::_lastFrameStats;
 
 AnimationManager::AnimationManager(uint16_t screenW, uint16_t screenH)
-    : screenWidth(screenW), screenHeight(screenH), triangleSize(screenW / 2), _triangle(nullptr), _label(nullptr), _current_x(0), _current_y(0), _velocity_x(0), _velocity_y(0), _target_x(0), _target_y(0), _idle_time(0), _isShaking(false), _isTransitioningToCenter(false)
+    : screenWidth(screenW), screenHeight(screenH), triangleSize(screenW / 2), _triangle(nullptr), _label(nullptr), _anim_to_x(0), _anim_to_y(0), _pos_x(0), _pos_y(0), _vel_x(0), _vel_y(0), _lastMotionUpdate(0), _drawn_x(INT16_MIN), _drawn_y(INT16_MIN), _isShaking(false), _isTransitioningToCenter(false)
 {
   _buf = new lv_color_t[screenWidth * screenHeight / 10];
+  _spans = new lv_disp_row_span_t[screenHeight];
+  _roundViewport = false;
   tft = new TFT_eSPI(screenWidth, screenHeight);
 }
 
 AnimationManager::~AnimationManager()
 {
+  lv_anim_del(this, NULL); // The move animations point at us, not at the triangle
   delete[] _buf;
+  delete[] _spans;
   delete tft;
 }
 
@@ -33,8 +40,16 @@ bool AnimationManager::begin()
   disp_drv.ver_res = screenHeight;
   disp_drv.flush_cb = displayFlushCallback;
   disp_drv.draw_buf = &_draw_buf;
+  // Estimated costs in ns for joining the invalidated areas: a pixel is 200 ns on the 80 MHz SPI bus
+  // plus its drawing, an area is a transaction, its address window and a walk of the objects
+  disp_drv.area_cost = 25000;
+  disp_drv.px_cost = 250;
   lv_disp_drv_register(&disp_drv);
 
+  // The GC9A01 is round, the corners of the frame are never visible
+  lv_disp_row_spans_init_circle(_spans, screenWidth, screenHeight);
+  setRoundViewport(true);
+
   // Set black background
   lv_obj_set_style_bg_color(lv_scr_act(), lv_color_black(), LV_PART_MAIN);
 
@@ -62,8 +77,7 @@ void AnimationManager::initializeTriangle()
   lv_obj_set_style_text_line_space(_label, 5, LV_PART_MAIN); // Adjust line spacing
 
   lv_label_set_text(_label, "DISCONNECTED");
-  // lv_obj_align(_label, LV_ALIGN_CENTER, 0, 0);
-  // lv_obj_center(_label);
+  // Keep the label centered through the layout so moving the triangle never has to re-align it
   lv_obj_set_style_align(_label, LV_ALIGN_CENTER, LV_PART_MAIN);
   lv_label_set_long_mode(_label, LV_LABEL_LONG_WRAP);
   lv_obj_set_width(_label, (triangleSize - 30)); // Reduced width for better edge handling
@@ -73,9 +87,9 @@ void AnimationManager::initializeTriangle()
   lv_anim_init(&_anim_y);
 
   // Set initial position
-  _current_x = (screenWidth - triangleSize) / 2;
-  _current_y = (screenHeight - triangleSize) / 2;
-  updatePosition(_current_x, _current_y);
+  _pos_x = ((screenWidth - triangleSize) / 2) << 8;
+  _pos_y = ((screenHeight - triangleSize) / 2) << 8;
+  updatePosition(_pos_x >> 8, _pos_y >> 8);
 }
 
 void AnimationManager::displayFlushCallback(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p)
@@ -83,34 +97,125 @@ void AnimationManager::displayFlushCallback(lv_disp_drv_t *disp_drv, const lv_ar
   uint32_t w = (area->x2 - area->x1 + 1);
   uint32_t h = (area->y2 - area->y1 + 1);
 
+  _frameStats.areaPixels += w * h;
+  _frameStats.rectBytes += w * h * 2 + ADDR_WINDOW_BYTES;
+
+  LV_REFR_PROF_BEGIN(LV_REFR_PROF_TRANSFER);
   tft->startWrite();
-  tft->setAddrWindow(area->x1, area->y1, w, h);
-  tft->pushColors((uint16_t *)&color_p->full, w * h, true);
+  if (disp_drv->row_spans)
+  {
+    pushVisibleSpans(area, color_p, disp_drv->row_spans);
+  }
+  else
+  {
+    tft->setAddrWindow(area->x1, area->y1, w, h);
+    tft->pushColors((uint16_t *)&color_p->full, w * h, true);
+    _frameStats.renderedPixels += w * h;
+    _frameStats.bytesSent += w * h * 2 + ADDR_WINDOW_BYTES;
+    _frameStats.windows++;
+  }
   tft->endWrite();
+  LV_REFR_PROF_END(LV_REFR_PROF_TRANSFER);
+
+  if (lv_disp_flush_is_last(disp_drv))
+  {
+    _lastFrameStats = _frameStats;
+    _frameStats.reset();
+  }
 
   lv_disp_flush_ready(disp_drv);
 }
 
-void AnimationManager::animXCallback(void *var, int32_t v)
+void AnimationManager::pushVisibleSpans(const lv_area_t *area, lv_color_t *color_p, const lv_disp_row_span_t *spans)
 {
-  lv_obj_t *obj = (lv_obj_t *)var;
-  lv_obj_set_x(obj, v);
-  lv_obj_t *label = lv_obj_get_child(obj, 0);
-  if (label)
+  lv_coord_t w = lv_area_get_width(area);
+  lv_coord_t y = area->y1;
+
+  while (y <= area->y2)
   {
-    lv_obj_align_to(label, obj, LV_ALIGN_CENTER, 0, 0);
+    lv_coord_t x1 = max(spans[y].x1, area->x1);
+    lv_coord_t x2 = min(spans[y].x2, area->x2);
+    if (x1 > x2)
+    {
+      y++;
+      continue;
+    }
+
+    // Grow a band of rows while widening its window wastes fewer bytes than a new address window
+    lv_coord_t y2 = y;
+    uint32_t visible = x2 - x1 + 1;
+    while (y2 < area->y2)
+    {
+      lv_coord_t nx1 = max(spans[y2 + 1].x1, area->x1);
+      lv_coord_t nx2 = min(spans[y2 + 1].x2, area->x2);
+      if (nx1 > nx2)
+        break;
+
+      lv_coord_t rows = y2 - y + 1;
+      int32_t wasted = (x2 - x1 + 1) * rows - visible;
+      int32_t newWasted = (max(x2, nx2) - min(x1, nx1) + 1) * (rows + 1) - (visible + nx2 - nx1 + 1);
+      if ((newWasted - wasted) * 2 > (int32_t)ADDR_WINDOW_BYTES)
+        break;
+
+      x1 = min(x1, nx1);
+      x2 = max(x2, nx2);
+      visible += nx2 - nx1 + 1;
+      y2++;
+    }
+
+    lv_coord_t bw = x2 - x1 + 1;
+    lv_coord_t bh = y2 - y + 1;
+    tft->setAddrWindow(x1, y, bw, bh);
+    for (lv_coord_t row = y; row <= y2; row++)
+    {
+      tft->pushColors((uint16_t *)&color_p[(row - area->y1) * w + (x1 - area->x1)].full, bw, true);
+    }
+
+    _frameStats.renderedPixels += visible;
+    _frameStats.bytesSent += bw * bh * 2 + ADDR_WINDOW_BYTES;
+    _frameStats.windows++;
+    y = y2 + 1;
   }
 }
 
+void AnimationManager::setRoundViewport(bool enable)
+{
+  lv_disp_t *disp = lv_disp_get_default();
+  if (!disp)
+    return;
+
+  _roundViewport = enable;
+  disp->driver->row_spans = enable ? _spans : NULL;
+  lv_obj_invalidate(lv_scr_act());
+}
+
+void AnimationManager::printFlushStats()
+{
+  Serial.printf("Flush (%s): area=%lu px, rendered=%lu px, sent=%lu B (rect %lu B), windows=%u\n",
+                _roundViewport ? "round" : "rect",
+                (unsigned long)_lastFrameStats.areaPixels,
+                (unsigned long)_lastFrameStats.renderedPixels,
+                (unsigned long)_lastFrameStats.bytesSent,
+                (unsigned long)_lastFrameStats.rectBytes,
+                _lastFrameStats.windows);
+}
+
+// The x and y animations only stage their values, animMoveCallback moves the triangle once per
+// frame for both: one invalidation and layout instead of two
+void AnimationManager::animXCallback(void *var, int32_t v)
+{
+  ((AnimationManager *)var)->_anim_to_x = v;
+}
+
 void AnimationManager::animYCallback(void *var, int32_t v)
 {
-  lv_obj_t *obj = (lv_obj_t *)var;
-  lv_obj_set_y(obj, v);
-  lv_obj_t *label = lv_obj_get_child(obj, 0);
-  if (label)
-  {
-    lv_obj_align_to(label, obj, LV_ALIGN_CENTER, 0, 0);
-  }
+  ((AnimationManager *)var)->_anim_to_y = v;
+}
+
+void AnimationManager::animMoveCallback(void *var)
+{
+  AnimationManager *self = (AnimationManager *)var;
+  lv_obj_set_pos(self->_triangle, self->_anim_to_x, self->_anim_to_y);
 }
 
 void AnimationManager::animReadyCallback(lv_anim_t *a)
@@ -128,113 +233,190 @@ void AnimationManager::moveToCenter()
   {
     _isTransitioningToCenter = true;
 
-    _target_x = 120;
-    _target_y = 40;
-    // Reset velocities
-    _velocity_x = 0;
-    _velocity_y = 0;
+    int32_t start_x = _pos_x >> 8;
+    int32_t start_y = _pos_y >> 8;
+    int32_t end_x = 120;
+    int32_t end_y = 40;
+    // The spring picks up from where the animation ends
+    _pos_x = end_x << 8;
+    _pos_y = end_y << 8;
+    _vel_x = 0;
+    _vel_y = 0;
+    // The animation moves the object behind our back, force the next position update through
+    _drawn_x = INT16_MIN;
+    _drawn_y = INT16_MIN;
+
+    _anim_to_x = start_x;
+    _anim_to_y = start_y;
 
     // Set up X animation
     lv_anim_set_user_data(&_anim_x, this);
-    lv_anim_set_var(&_anim_x, _triangle);
-    lv_anim_set_values(&_anim_x, _current_x, _target_x);
+    lv_anim_set_var(&_anim_x, this);
+    lv_anim_set_values(&_anim_x, start_x, end_x);
     lv_anim_set_time(&_anim_x, 800);
     lv_anim_set_exec_cb(&_anim_x, animXCallback);
+    lv_anim_set_batch_cb(&_anim_x, animMoveCallback);
     lv_anim_set_path_cb(&_anim_x, lv_anim_path_ease_out);
     lv_anim_start(&_anim_x);
 
     // Set up Y animation
     lv_anim_set_user_data(&_anim_y, this);
-    lv_anim_set_var(&_anim_y, _triangle);
-    lv_anim_set_values(&_anim_y, _current_y, _target_y);
+    lv_anim_set_var(&_anim_y, this);
+    lv_anim_set_values(&_anim_y, start_y, end_y);
     lv_anim_set_time(&_anim_y, 800);
     lv_anim_set_exec_cb(&_anim_y, animYCallback);
+    lv_anim_set_batch_cb(&_anim_y, animMoveCallback);
     lv_anim_set_path_cb(&_anim_y, lv_anim_path_ease_out);
     lv_anim_set_ready_cb(&_anim_y, animReadyCallback);
     lv_anim_start(&_anim_y);
   }
 }
 
-void AnimationManager::updateIdleMotion()
+void AnimationManager::getTrianglePosition(int16_t *x, int16_t *y) const
 {
-  _idle_time += IDLE_SPEED;
+  *x = (_pos_x + 128) >> 8;
+  *y = (_pos_y + 128) >> 8;
+}
 
-  float offset_x = sin(_idle_time) * cos(_idle_time * 0.7f) * IDLE_AMPLITUDE;
-  float offset_y = cos(_idle_time * 1.3f) * sin(_idle_time * 0.5f) * IDLE_AMPLITUDE;
+void AnimationManager::setTrianglePosition(int16_t x, int16_t y)
+{
+  _pos_x = (int32_t)x << 8;
+  _pos_y = (int32_t)y << 8;
+  _vel_x = 0;
+  _vel_y = 0;
+  updatePosition(x, y);
+}
 
-  _target_x += offset_x * 0.01f;
-  _target_y += offset_y * 0.01f;
+void AnimationManager::sleepDisplay()
+{
+  DEV_SET_Backlight(0);
+  tft->writecommand(PANEL_DISPOFF);
+  tft->writecommand(PANEL_SLPIN);
 }
 
-void AnimationManager::updateTrianglePosition(float gyro_x, float gyro_y)
+void AnimationManager::getTarget(const int32_t gravity[3], unsigned long now, int32_t *x, int32_t *y)
 {
+  // The in-plane part of "up" points to the high side. IMU x is screen x, IMU y points up the screen.
+  int32_t off_x = gravity[0] * TILT_RANGE / (TiltEstimator::ONE >> 8);
+  int32_t off_y = -gravity[1] * TILT_RANGE / (TiltEstimator::ONE >> 8);
+
+  // Shakes can read more than 1 g, keep the offset on the disc
+  uint32_t dist2 = (uint32_t)((off_x >> 8) * (off_x >> 8) + (off_y >> 8) * (off_y >> 8));
+  if (dist2 > (uint32_t)(TILT_RANGE * TILT_RANGE))
+  {
+    lv_sqrt_res_t dist;
+    lv_sqrt(dist2, &dist, 0x8000);
+    off_x = off_x * TILT_RANGE / dist.i;
+    off_y = off_y * TILT_RANGE / dist.i;
+  }
+
+  // Slow drift, as if the liquid was never quite still
+  int16_t angle_x = (int16_t)((now % IDLE_PERIOD_X) * 360 / IDLE_PERIOD_X);
+  int16_t angle_y = (int16_t)((now % IDLE_PERIOD_Y) * 360 / IDLE_PERIOD_Y);
+  off_x += (lv_trigo_sin(angle_x) * IDLE_AMPLITUDE) >> (LV_TRIGO_SHIFT - 8);
+  off_y += (lv_trigo_sin(angle_y) * IDLE_AMPLITUDE) >> (LV_TRIGO_SHIFT - 8);
+
+  *x = (((int32_t)screenWidth - triangleSize) << 7) + off_x;
+  *y = (((int32_t)screenHeight - triangleSize) << 7) + off_y;
+}
+
+void AnimationManager::updateTrianglePosition(const int32_t gravity[3], unsigned long now)
+{
+  unsigned long elapsed = now - _lastMotionUpdate;
+  _lastMotionUpdate = now;
   if (!_triangle || _isShaking || _isTransitioningToCenter)
     return;
 
-  bool is_still = abs(gyro_x) < 0.5f && abs(gyro_y) < 0.5f;
+  int32_t target_x, target_y;
+  getTarget(gravity, now, &target_x, &target_y);
 
-  if (is_still)
+  // Damped spring integrated over the real elapsed time, so the motion doesn't depend on the frame rate
+  uint32_t remaining = elapsed < MAX_FRAME_MS ? elapsed : MAX_FRAME_MS;
+  while (remaining > 0)
   {
-    updateIdleMotion();
+    int32_t step = remaining < MAX_STEP_MS ? remaining : MAX_STEP_MS;
+    remaining -= step;
+    int32_t acc_x = SPRING_K * (target_x - _pos_x) - SPRING_C * _vel_x;
+    int32_t acc_y = SPRING_K * (target_y - _pos_y) - SPRING_C * _vel_y;
+    _vel_x += acc_x * step / 1000;
+    _vel_y += acc_y * step / 1000;
+    _pos_x += _vel_x * step / 1000;
+    _pos_y += _vel_y * step / 1000;
   }
-  else
+
+  // Track the fractional position internally, LVGL only sees whole pixels
+  updatePosition((_pos_x + 128) >> 8, (_pos_y + 128) >> 8);
+  updateMotionStats(now);
+}
+
+void AnimationManager::updatePosition(int16_t x, int16_t y)
+{
+  if (x == _drawn_x && y == _drawn_y)
   {
-    _target_x -= gyro_x * GYRO_SENSITIVITY;
-    _target_y -= gyro_y * GYRO_SENSITIVITY;
+    _motionStats.skippedUpdates++;
+    return;
   }
 
-  constrainPosition();
+  // Settle pending layout first (e.g. label text changes) so its invalidations go through normally
+  lv_obj_update_layout(_triangle);
 
-  float dx = _target_x - _current_x;
-  float dy = _target_y - _current_y;
+  lv_area_t oldArea;
+  getFootprint(&oldArea);
 
-  _velocity_x = _velocity_x * MOTION_SMOOTHING + dx * (1.0f - MOTION_SMOOTHING);
-  _velocity_y = _velocity_y * MOTION_SMOOTHING + dy * (1.0f - MOTION_SMOOTHING);
+  // Move without letting LVGL invalidate the old and new transformed areas separately
+  lv_disp_t *disp = lv_obj_get_disp(_triangle);
+  lv_disp_enable_invalidation(disp, false);
+  lv_obj_set_pos(_triangle, x, y);
+  lv_obj_update_layout(_triangle);
+  lv_disp_enable_invalidation(disp, true);
+
+  lv_area_t newArea;
+  getFootprint(&newArea);
+
+  // Invalidate only the tight union of both footprints, clipped to the screen
+  lv_area_t dirty;
+  lv_area_t screen;
+  _lv_area_join(&dirty, &oldArea, &newArea);
+  lv_area_set(&screen, 0, 0, screenWidth - 1, screenHeight - 1);
+  if (_lv_area_intersect(&dirty, &dirty, &screen))
+  {
+    lv_obj_invalidate_area(lv_scr_act(), &dirty);
+    _motionStats.invalidatedPixels += lv_area_get_size(&dirty);
+  }
 
-  _current_x += _velocity_x * 0.1f;
-  _current_y += _velocity_y * 0.1f;
+  _drawn_x = x;
+  _drawn_y = y;
+  _motionStats.issuedUpdates++;
+}
 
-  updatePosition(_current_x, _current_y);
+void AnimationManager::getFootprint(lv_area_t *area)
+{
+  // Same area lv_obj_invalidate() would use: coords + extra draw size, then rotated
+  lv_coord_t ext_size = _lv_obj_get_ext_draw_size(_triangle);
+  lv_obj_get_coords(_triangle, area);
+  lv_area_increase(area, ext_size, ext_size);
+  lv_obj_get_transformed_area(_triangle, area, true, false);
 }
 
-void AnimationManager::constrainPosition()
+void AnimationManager::updateMotionStats(unsigned long now)
 {
-  float center_x = screenWidth / 2.0f;
-  float center_y = screenHeight / 2.0f;
-  float radius = min(screenWidth, screenHeight) / 2.0f;
-  float max_distance = radius * SCREEN_MARGIN;
-
-  // Calculate distance from center
-  float dx = _target_x + (triangleSize / 2) - center_x;
-  float dy = _target_y + (triangleSize / 2) - center_y;
-  float distance = sqrt(dx * dx + dy * dy);
-
-  // If outside allowable radius, pull back inside
-  if (distance > max_distance)
-  {
-    float angle = atan2(dy, dx);
-    float new_x = center_x + cos(angle) * max_distance - (triangleSize / 2);
-    float new_y = center_y + sin(angle) * max_distance - (triangleSize / 2);
-
-    _target_x = constrain(new_x, -triangleSize * EDGE_BUFFER,
-                          screenWidth - triangleSize * (1.0f - EDGE_BUFFER));
-    _target_y = constrain(new_y, -triangleSize * EDGE_BUFFER,
-                          screenHeight - triangleSize * (1.0f - EDGE_BUFFER));
-  }
-  else
+  if (now - _motionStats.windowStart >= 1000)
   {
-    // Still apply rectangular constraints for extra safety
-    _target_x = constrain(_target_x, -triangleSize * EDGE_BUFFER,
-                          screenWidth - triangleSize * (1.0f - EDGE_BUFFER));
-    _target_y = constrain(_target_y, -triangleSize * EDGE_BUFFER,
-                          screenHeight - triangleSize * (1.0f - EDGE_BUFFER));
+    unsigned long elapsed = now - _motionStats.windowStart;
+    _motionStats.issuedPerSec = _motionStats.issuedUpdates * 1000UL / elapsed;
+    _motionStats.skippedPerSec = _motionStats.skippedUpdates * 1000UL / elapsed;
+    _motionStats.pixelsPerSec = (uint64_t)_motionStats.invalidatedPixels * 1000UL / elapsed;
+    _motionStats.reset();
+    _motionStats.windowStart = now;
   }
 }
 
-void AnimationManager::updatePosition(int16_t x, int16_t y)
+void AnimationManager::printMotionStats()
 {
-  lv_obj_set_pos(_triangle, x, y);
-  lv_obj_align_to(_label, _triangle, LV_ALIGN_CENTER, 0, 0);
+  Serial.printf("Motion: issued=%lu/s, skipped=%lu/s, invalidated=%lu px/s\n",
+                (unsigned long)_motionStats.issuedPerSec,
+                (unsigned long)_motionStats.skippedPerSec,
+                (unsigned long)_motionStats.pixelsPerSec);
 }
 
 void AnimationManager::setShaking(bool isShaking)
@@ -242,8 +424,8 @@ void AnimationManager::setShaking(bool isShaking)
   _isShaking = isShaking;
   if (!isShaking)
   {
-    _velocity_x = 0;
-    _velocity_y = 0;
+    _vel_x = 0;
+    _vel_y = 0;
   }
 }
 
@@ -254,6 +436,9 @@ void AnimationManager::setTriangleColor(uint8_t r, uint8_t g, uint8_t b)
 
 void AnimationManager::setLabelText(const char *text)
 {
+  // lv_label_set_text() always invalidates, don't keep the display busy with the same text
+  if (strcmp(lv_label_get_text(_label), text) == 0)
+    return;
   lv_label_set_text(_label, text);
 }
 
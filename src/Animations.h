@@ -4,6 +4,58 @@
 #include <Arduino.h>
 #include <lvgl.h>
 #include <TFT_eSPI.h>
+#include "TiltEstimator.h"
+
+// Position update / invalidation statistics for the tilt-driven triangle
+struct MotionStats
+{
+  uint32_t issuedUpdates;     // Integer position changes pushed to LVGL
+  uint32_t skippedUpdates;    // Ticks where the integer position did not change
+  uint32_t invalidatedPixels; // Pixels invalidated by position changes
+  uint32_t issuedPerSec;      // Rates latched over the last full second
+  uint32_t skippedPerSec;
+  uint32_t pixelsPerSec;
+  unsigned long windowStart;
+
+  MotionStats() : issuedUpdates(0),
+                  skippedUpdates(0),
+                  invalidatedPixels(0),
+                  issuedPerSec(0),
+                  skippedPerSec(0),
+                  pixelsPerSec(0),
+                  windowStart(0) {}
+
+  void reset()
+  {
+    issuedUpdates = 0;
+    skippedUpdates = 0;
+    invalidatedPixels = 0;
+  }
+};
+
+// Per-frame flush statistics, latched after the last area of every frame
+struct FlushStats
+{
+  uint32_t areaPixels;     // Pixels of the flushed rectangles
+  uint32_t renderedPixels; // Pixels LVGL actually rendered (visible ones in round mode)
+  uint32_t bytesSent;      // Pixel data + address window commands sent over SPI
+  uint32_t rectBytes;      // What a plain rectangular flush of the same areas would send
+  uint16_t windows;        // setAddrWindow calls
+  FlushStats() : areaPixels(0),
+                 renderedPixels(0),
+                 bytesSent(0),
+                 rectBytes(0),
+                 windows(0) {}
+
+  void reset()
+  {
+    areaPixels = 0;
+    renderedPixels = 0;
+    bytesSent = 0;
+    rectBytes = 0;
+    windows = 0;
+  }
+};
 
 class AnimationManager
 {
@@ -17,8 +69,15 @@ public:
 
   // Animation control
   void moveToCenter();
-  void updateIdleMotion();
-  void updateTrianglePosition(float gyro_x, float gyro_y);
+  // Float the triangle like the die in liquid: it drifts to the side that's up.
+  // gravity as from TiltEstimator (ONE = 1 g), now in ms for the spring's time step.
+  void updateTrianglePosition(const int32_t gravity[3], unsigned long now);
+  // Where the triangle is, in whole pixels, to put it back there after a deep sleep
+  void getTrianglePosition(int16_t *x, int16_t *y) const;
+  void setTrianglePosition(int16_t x, int16_t y);
+
+  // Backlight off and the panel in sleep mode, for a deep sleep; begin() wakes it
+  void sleepDisplay();
 
   // State management
   void setShaking(bool isShaking);
@@ -30,6 +89,12 @@ public:
   void setLabelText(const char *text);
   void setLabelTextFormatted(const char *format, ...);
 
+  // Round display: skip rendering and flushing the off-glass corners
+  void setRoundViewport(bool enable);
+  bool isRoundViewport() const { return _roundViewport; }
+  static const FlushStats &getFlushStats() { return _lastFrameStats; }
+  void printFlushStats();
+
   // LVGL display handler
   static void displayFlushCallback(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
 
@@ -37,6 +102,10 @@ public:
   lv_obj_t *getTriangle() { return _triangle; }
   lv_obj_t *getLabel() { return _label; }
 
+  // Motion statistics
+  const MotionStats &getMotionStats() const { return _motionStats; }
+  void printMotionStats();
+
 private:
   // Display configuration
   const uint16_t screenWidth;
@@ -49,41 +118,61 @@ private:
   lv_obj_t *_label;
   lv_disp_draw_buf_t _draw_buf;
   lv_color_t *_buf;
+  lv_disp_row_span_t *_spans;
+  bool _roundViewport;
+
+  // Flush statistics
+  static FlushStats _frameStats;
+  static FlushStats _lastFrameStats;
 
   // Animation objects
   lv_anim_t _anim_x;
   lv_anim_t _anim_y;
+  int32_t _anim_to_x; // Staged by the x and y animations, applied together
+  int32_t _anim_to_y;
+
+  // Position tracking, Q8 pixels and Q8 pixels per second
+  int32_t _pos_x;
+  int32_t _pos_y;
+  int32_t _vel_x;
+  int32_t _vel_y;
+  unsigned long _lastMotionUpdate;
 
-  // Position tracking
-  float _current_x;
-  float _current_y;
-  float _velocity_x;
-  float _velocity_y;
-  float _target_x;
-  float _target_y;
-  float _idle_time;
+  // Last integer position pushed to LVGL
+  int16_t _drawn_x;
+  int16_t _drawn_y;
+  MotionStats _motionStats;
 
   // State flags
   bool _isShaking;
   bool _isTransitioningToCenter;
 
   // Animation constants
-  static constexpr float MOTION_SMOOTHING = 0.95f;
-  static constexpr float GYRO_SENSITIVITY = 0.08f;
-  static constexpr float IDLE_AMPLITUDE = 15.0f;
-  static constexpr float IDLE_SPEED = 0.001f;
-  static constexpr float SCREEN_MARGIN = 0.4f;
-  static constexpr float EDGE_BUFFER = 0.15f;    // Maximum amount triangle can go over edge
+  static constexpr int32_t TILT_RANGE = 48;      // Offset from the center at 90 degrees of tilt, px
+  static constexpr int32_t SPRING_K = 60;        // Pull towards the target, 1/s^2 (~1.2 Hz)
+  static constexpr int32_t SPRING_C = 11;        // Drag of the liquid, 1/s (slightly underdamped)
+  static constexpr uint32_t MAX_STEP_MS = 32;    // Longer frames are integrated in steps
+  static constexpr uint32_t MAX_FRAME_MS = 250;  // ... up to this much, e.g. after a transition
+  static constexpr int32_t IDLE_AMPLITUDE = 6;   // Slow drift of the die at rest, px
+  static constexpr uint32_t IDLE_PERIOD_X = 7000; // ms
+  static constexpr uint32_t IDLE_PERIOD_Y = 9100;
   static constexpr uint16_t FONT_REDUCTION = 90; // Font size reduction to 90% of original
+  static constexpr uint32_t ADDR_WINDOW_BYTES = 11; // CASET + RASET + RAMWR with their parameters
+  static constexpr uint8_t PANEL_DISPOFF = 0x28;    // MIPI DCS commands, the same on the GC9A01 and ST7789
+  static constexpr uint8_t PANEL_SLPIN = 0x10;
 
   // Animation callbacks
   static void animXCallback(void *var, int32_t v);
   static void animYCallback(void *var, int32_t v);
+  static void animMoveCallback(void *var);
   static void animReadyCallback(lv_anim_t *a);
 
   // Helper methods
+  static void pushVisibleSpans(const lv_area_t *area, lv_color_t *color_p, const lv_disp_row_span_t *spans);
   void updatePosition(int16_t x, int16_t y);
-  void constrainPosition();
+  void getFootprint(lv_area_t *area);
+  void updateMotionStats(unsigned long now);
+  void getTarget(const int32_t gravity[3], unsigned long now, int32_t *x, int32_t *y);
 };
 
 #endif // ANIMATIONS_H
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "BootSequence.h"
+
+BootSequence::BootSequence()
+    : _count(0),
+      _nextDeferred(0),
+      _interactiveUs(0),
+      _reported(false)
+{
+}
+
+BootSequence::Stage *BootSequence::add(const char *name, StageFn fn, Kind kind)
+{
+  if (_count >= MAX_STAGES)
+  {
+    Serial.printf("Boot: no room for stage %s, running it now\n", name);
+    fn();
+    return nullptr;
+  }
+  Stage &stage = _stages[_count++];
+  stage.name = name;
+  stage.fn = fn;
+  stage.kind = kind;
+  stage.ok = false;
+  stage.startUs = 0;
+  stage.endUs = 0;
+  stage.done.store(false);
+  return &stage;
+}
+
+void BootSequence::execute(Stage &stage)
+{
+  stage.startUs = micros();
+  stage.ok = stage.fn();
+  stage.endUs = micros();
+  stage.done.store(true);
+}
+
+bool BootSequence::run(const char *name, StageFn fn)
+{
+  Stage *stage = add(name, fn, FOREGROUND);
+  if (!stage)
+    return true;
+  execute(*stage);
+  return stage->ok;
+}
+
+int BootSequence::start(const char *name, StageFn fn, uint32_t stackSize, BaseType_t core)
+{
+  Stage *stage = add(name, fn, BACKGROUND);
+  if (!stage)
+    return -1;
+  stage->startUs = micros();
+  if (xTaskCreatePinnedToCore(taskEntry, name, stackSize, stage, 1, NULL, core) != pdPASS)
+  {
+    Serial.printf("Boot: no task for %s, running it now\n", name);
+    execute(*stage);
+  }
+  return _count - 1;
+}
+
+void BootSequence::taskEntry(void *parameter)
+{
+  Stage *stage = (Stage *)parameter;
+  stage->ok = stage->fn();
+  stage->endUs = micros();
+  stage->done.store(true);
+  vTaskDelete(NULL);
+}
+
+void BootSequence::defer(const char *name, StageFn fn)
+{
+  add(name, fn, DEFERRED);
+}
+
+bool BootSequence::wait(int stage)
+{
+  if (stage < 0 || stage >= _count)
+    return true;
+  while (!_stages[stage].done.load())
+    vTaskDelay(pdMS_TO_TICKS(1));
+  return _stages[stage].ok;
+}
+
+bool BootSequence::isDone(int stage) const
+{
+  return stage < 0 || stage >= _count || _stages[stage].done.load();
+}
+
+void BootSequence::markInteractive()
+{
+  _interactiveUs = micros();
+  Serial.printf("Boot: interactive after %lu ms\n", getTimeToInteractive());
+}
+
+void BootSequence::update()
+{
+  if (_reported || !_interactiveUs)
+    return;
+
+  // One deferred stage per loop, so none of them holds up a frame for long
+  while (_nextDeferred < _count && _stages[_nextDeferred].kind != DEFERRED)
+    _nextDeferred++;
+  if (_nextDeferred < _count)
+  {
+    Stage &stage = _stages[_nextDeferred++];
+    if (!stage.done.load())
+      execute(stage);
+    return;
+  }
+
+  for (int i = 0; i < _count; i++)
+  {
+    if (!_stages[i].done.load())
+      return;
+  }
+  printTimeline();
+  _reported = true;
+}
+
+void BootSequence::finishDeferred()
+{
+  for (int i = 0; i < _count; i++)
+  {
+    if (_stages[i].kind == DEFERRED && !_stages[i].done.load())
+      execute(_stages[i]);
+  }
+}
+
+void BootSequence::printTimeline()
+{
+  static const char *const kindNames[] = {"setup", "task", "deferred"};
+  Serial.println("Boot timeline (ms since reset):");
+  for (int i = 0; i < _count; i++)
+  {
+    const Stage &stage = _stages[i];
+    if (!stage.done.load())
+    {
+      Serial.printf("  %-10s %-8s running since %lu.%lu\n", stage.name, kindNames[stage.kind],
+                    stage.startUs / 1000, (stage.startUs / 100) % 10);
+      continue;
+    }
+    unsigned long duration = stage.endUs - stage.startUs;
+    Serial.printf("  %-10s %-8s %6lu.%lu .. %6lu.%lu  %6lu.%lu ms%s\n", stage.name, kindNames[stage.kind],
+                  stage.startUs / 1000, (stage.startUs / 100) % 10, stage.endUs / 1000, (stage.endUs / 100) % 10,
+                  duration / 1000, (duration / 100) % 10, stage.ok ? "" : "  FAILED");
+  }
+  Serial.printf("Time to interactive: %lu ms\n", getTimeToInteractive());
+}
@@ -0,0 +1,72 @@
+#ifndef BOOT_SEQUENCE_H
+#define BOOT_SEQUENCE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Runs the boot stages and puts timestamps on them. Stages run in setup() (run),
+// in a task of their own while setup() goes on (start), or from the loop once
+// the ball is interactive (defer). The timeline is printed when all of them are done.
+class BootSequence
+{
+public:
+  typedef bool (*StageFn)();
+
+  BootSequence();
+
+  // Run a stage now, returns its result
+  bool run(const char *name, StageFn fn);
+  // Run a stage in its own task, returns the stage to wait() for
+  int start(const char *name, StageFn fn, uint32_t stackSize, BaseType_t core);
+  // Run a stage from update() after markInteractive()
+  void defer(const char *name, StageFn fn);
+
+  // Block until a started stage is done, returns its result
+  bool wait(int stage);
+  bool isDone(int stage) const;
+
+  // The idle screen is up and a shake is seen from here on
+  void markInteractive();
+  unsigned long getTimeToInteractive() const { return _interactiveUs / 1000; }
+
+  // Call every loop: runs the next deferred stage, reports the timeline when all are done
+  void update();
+  // Run the deferred stages that haven't yet, for what needs them early
+  void finishDeferred();
+  // Every stage is done and the timeline went out
+  bool isComplete() const { return _reported; }
+
+  void printTimeline();
+
+private:
+  enum Kind : uint8_t
+  {
+    FOREGROUND,
+    BACKGROUND,
+    DEFERRED
+  };
+
+  struct Stage
+  {
+    const char *name;
+    StageFn fn;
+    Kind kind;
+    bool ok;
+    unsigned long startUs;
+    unsigned long endUs;
+    std::atomic<bool> done; // Set last by the stage's task
+  };
+
+  static const int MAX_STAGES = 12;
+  Stage _stages[MAX_STAGES];
+  int _count;
+  int _nextDeferred;
+  unsigned long _interactiveUs;
+  bool _reported;
+
+  Stage *add(const char *name, StageFn fn, Kind kind);
+  void execute(Stage &stage);
+  static void taskEntry(void *parameter);
+};
+
+#endif // BOOT_SEQUENCE_H
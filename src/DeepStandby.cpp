@@ -0,0 +1,97 @@
+#include "DeepStandby.h"
+#include <WiFi.h>
+#include <DEV_Config.h>
+
+namespace
+{
+  // Kept in RTC slow memory through the sleep. Undefined after a power cycle,
+  // the magic is only trusted on a wake from deep sleep.
+  struct RtcState
+  {
+    uint32_t magic;
+    uint32_t sleeps;
+    uint8_t bssid[6];
+    uint8_t channel; // 0: no access point to rejoin
+    DeepStandby::UiState ui;
+  };
+
+  const uint32_t MAGIC = 0x8BA11DEE;
+}
+
+RTC_DATA_ATTR static RtcState rtcState;
+
+DeepStandby::DeepStandby()
+    : _resumed(false)
+{
+}
+
+bool DeepStandby::begin()
+{
+  gpio_hold_dis((gpio_num_t)LCD_BL_PIN);
+  gpio_deep_sleep_hold_dis();
+
+  _resumed = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_EXT0 && rtcState.magic == MAGIC;
+  if (!_resumed)
+  {
+    memset(&rtcState, 0, sizeof(rtcState));
+  }
+  return _resumed;
+}
+
+const DeepStandby::UiState &DeepStandby::getUiState() const
+{
+  return rtcState.ui;
+}
+
+uint32_t DeepStandby::getSleepCount() const
+{
+  return rtcState.sleeps;
+}
+
+bool DeepStandby::reconnect(const String &ssid, const String &pass, unsigned long timeoutMs)
+{
+  if (!_resumed || rtcState.channel == 0 || ssid.isEmpty())
+  {
+    return false;
+  }
+
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(ssid.c_str(), pass.c_str(), rtcState.channel, rtcState.bssid);
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED && millis() - start < timeoutMs)
+  {
+    delay(10);
+  }
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    Serial.printf("Reconnect on channel %u failed, scanning\n", rtcState.channel);
+    return false;
+  }
+  Serial.printf("Reconnected on channel %u in %lu ms\n", rtcState.channel, millis() - start);
+  return true;
+}
+
+void DeepStandby::enter(const UiState &ui, uint8_t channel, const uint8_t *bssid, gpio_num_t wakePin,
+                        int wakeLevel)
+{
+  rtcState.ui = ui;
+  rtcState.channel = channel;
+  if (channel)
+  {
+    memcpy(rtcState.bssid, bssid, sizeof(rtcState.bssid));
+  }
+  rtcState.sleeps++;
+  rtcState.magic = MAGIC;
+
+  // Keeps the saved credentials, only the radio goes off
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+
+  // The pads lose their drivers in deep sleep, the backlight would float on
+  gpio_hold_en((gpio_num_t)LCD_BL_PIN);
+  gpio_deep_sleep_hold_en();
+
+  esp_sleep_enable_ext0_wakeup(wakePin, wakeLevel);
+  Serial.flush();
+  esp_deep_sleep_start();
+}
@@ -0,0 +1,44 @@
+#ifndef DEEP_STANDBY_H
+#define DEEP_STANDBY_H
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+// Deep sleep for long idle stretches, woken by the IMU like the light standby.
+// Only the RTC domain stays powered, so a wake is a reset: what the next boot needs
+// to come back quickly (the access point to rejoin without a scan, where the triangle
+// was) is kept in RTC memory, which survives deep sleep but not a power cycle.
+class DeepStandby
+{
+public:
+  // What the last frame looked like, to draw the same one again on resume
+  struct UiState
+  {
+    int16_t triangleX;
+    int16_t triangleY;
+  };
+
+  DeepStandby();
+
+  // Call first thing in setup(): true when this boot is a wake from deep standby
+  // with valid saved state. Releases the pins held through the sleep.
+  bool begin();
+  bool isResume() const { return _resumed; }
+  const UiState &getUiState() const;
+  uint32_t getSleepCount() const;
+
+  // Rejoin the access point of the last session on its channel and BSSID, skipping
+  // the scan. Only on resume; returns false when there's nothing saved or it failed.
+  bool reconnect(const String &ssid, const String &pass, unsigned long timeoutMs);
+
+  // Save the state and the access point to rejoin (channel 0: none), power the radio
+  // down and deep sleep until wakePin reaches wakeLevel. The backlight pin is held low
+  // through the sleep. Doesn't return.
+  void enter(const UiState &ui, uint8_t channel, const uint8_t *bssid, gpio_num_t wakePin, int wakeLevel);
+
+private:
+  bool _resumed;
+};
+
+#endif // DEEP_STANDBY_H
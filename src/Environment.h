@@ -71,6 +71,10 @@ public:
       return _valtownUrl;
     if (key == "DEVICE_TOKEN")
       return _deviceToken;
+    if (key == "DEEP_STANDBY_SECONDS")
+      return _deepStandbySeconds;
+    if (key == "WIFI_POWER_SAVE")
+      return _wifiPowerSave;
     return "";
   }
 
@@ -81,14 +85,22 @@ private:
       _valtownUrl = value;
     if (key == "DEVICE_TOKEN")
       _deviceToken = value;
+    if (key == "DEEP_STANDBY_SECONDS")
+      _deepStandbySeconds = value;
+    if (key == "WIFI_POWER_SAVE")
+      _wifiPowerSave = value;
   }
 
   static String _valtownUrl;
   static String _deviceToken;
+  static String _deepStandbySeconds;
+  static String _wifiPowerSave;
 };
 
 // Initialize static members
 String Environment::_valtownUrl;
 String Environment::_deviceToken;
+String Environment::_deepStandbySeconds;
+String Environment::_wifiPowerSave;
 
 #endif // ENVIRONMENT_H
@@ -1,146 +1,216 @@
 #include "LEDLogger.h"
 
+// One breath, 0.5 - 0.5 cos over a period, gamma corrected (2.6) so it looks even
+static const uint8_t BREATH_TABLE[64] = {
+    0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 5, 8, 12, 17, 24, 32,
+    42, 54, 67, 82, 98, 115, 133, 151, 169, 186, 203, 218, 231, 241, 249, 253,
+    255, 253, 249, 241, 231, 218, 203, 186, 169, 151, 133, 115, 98, 82, 67, 54,
+    42, 32, 24, 17, 12, 8, 5, 3, 2, 1, 0, 0, 0, 0, 0, 0};
+
+// The hue wheel at full saturation, gamma corrected like the breath
+static const uint32_t RAINBOW_TABLE[64] = {
+    0xFF0000, 0xFF0100, 0xFF0300, 0xFF0900, 0xFF1400, 0xFF2400, 0xFF3900, 0xFF5500,
+    0xFF7900, 0xFFA400, 0xFFD800, 0xEBFF00, 0xB4FF00, 0x86FF00, 0x60FF00, 0x42FF00,
+    0x2AFF00, 0x19FF00, 0x0CFF00, 0x05FF00, 0x01FF00, 0x00FF00, 0x00FF00, 0x00FF02,
+    0x00FF07, 0x00FF10, 0x00FF1E, 0x00FF31, 0x00FF4B, 0x00FF6C, 0x00FF95, 0x00FFC5,
+    0x00FFFF, 0x00C5FF, 0x0095FF, 0x006CFF, 0x004BFF, 0x0031FF, 0x001EFF, 0x0010FF,
+    0x0007FF, 0x0002FF, 0x0000FF, 0x0000FF, 0x0100FF, 0x0500FF, 0x0C00FF, 0x1900FF,
+    0x2A00FF, 0x4200FF, 0x6000FF, 0x8600FF, 0xB400FF, 0xEB00FF, 0xFF00D8, 0xFF00A4,
+    0xFF0079, 0xFF0055, 0xFF0039, 0xFF0024, 0xFF0014, 0xFF0009, 0xFF0003, 0xFF0001};
+
+// Blinks as on/off slots, bit n set: on in slot n
+struct BlinkCurve
+{
+    uint16_t slotMs;
+    uint8_t slots;
+    uint8_t onMask;
+};
+
 LEDLogger::LEDLogger(uint8_t pin, uint8_t brightness)
-    : pixel(1, pin, NEO_GRB + NEO_KHZ400),
+    : pin(pin),
       currentState(SystemState::STARTUP),
       currentPattern(LEDPattern::PULSE),
-      lastUpdate(0),
-      pulseValue(0),
-      increasing(true),
       currentColor(COLOR_STARTUP),
-      brightness(brightness)
+      brightness(brightness),
+      lock(portMUX_INITIALIZER_UNLOCKED),
+      patternStart(0),
+      running(false),
+      rendering(false),
+      frameTimer(nullptr),
+      shownColor(0)
 {
 }
 
 void LEDLogger::begin()
 {
-    pixel.begin();
-    pixel.setBrightness(brightness);
-    pixel.show();
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, RMT_CHANNEL);
+    config.clk_div = RMT_CLOCK_DIV;
+    rmt_config(&config);
+    rmt_driver_install(RMT_CHANNEL, 0, 0);
+    transmit(0);
+
+    esp_timer_create_args_t args = {};
+    args.callback = onFrame;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "led";
+    args.skip_unhandled_events = true; // No catching up on the frames missed in light sleep
+    esp_timer_create(&args, &frameTimer);
+    restart();
 }
 
 void LEDLogger::setState(SystemState state, LEDPattern pattern)
 {
+    portENTER_CRITICAL(&lock);
     currentState = state;
     currentPattern = pattern;
     currentColor = getColorForState(state);
-    pulseValue = 0;
-    increasing = true;
-    lastUpdate = millis();
+    portEXIT_CRITICAL(&lock);
+    restart();
 }
 
 void LEDLogger::setCustomState(uint32_t color, LEDPattern pattern)
 {
+    portENTER_CRITICAL(&lock);
     currentState = SystemState::CUSTOM;
     currentPattern = pattern;
     currentColor = color;
-    pulseValue = 0;
-    increasing = true;
-    lastUpdate = millis();
+    portEXIT_CRITICAL(&lock);
+    restart();
 }
 
-void LEDLogger::update()
+// Start the pattern over, and the frame timer if clear() stopped it
+void LEDLogger::restart()
 {
-    updatePattern();
-    pixel.show();
+    portENTER_CRITICAL(&lock);
+    patternStart = esp_timer_get_time();
+    running = true;
+    portEXIT_CRITICAL(&lock);
+    if (frameTimer && !esp_timer_is_active(frameTimer))
+    {
+        esp_timer_start_periodic(frameTimer, FRAME_INTERVAL * 1000);
+    }
 }
 
-void LEDLogger::updatePattern()
+void LEDLogger::onFrame(void *arg)
 {
-    unsigned long now = millis();
-    switch (currentPattern)
+    LEDLogger *self = (LEDLogger *)arg;
+    portENTER_CRITICAL(&self->lock);
+    if (!self->running)
+    {
+        portEXIT_CRITICAL(&self->lock);
+        return;
+    }
+    LEDPattern pattern = self->currentPattern;
+    uint32_t color = self->currentColor;
+    uint8_t level = self->brightness;
+    uint32_t elapsedMs = (uint32_t)((esp_timer_get_time() - self->patternStart) / 1000);
+    self->rendering = true;
+    portEXIT_CRITICAL(&self->lock);
+
+    uint32_t frame = dimColor(self->renderFrame(pattern, color, elapsedMs), level);
+    if (frame != self->shownColor)
+    {
+        self->transmit(frame);
+    }
+
+    portENTER_CRITICAL(&self->lock);
+    self->rendering = false;
+    portEXIT_CRITICAL(&self->lock);
+}
+
+uint32_t LEDLogger::renderFrame(LEDPattern pattern, uint32_t color, uint32_t elapsedMs) const
+{
+    static const BlinkCurve BLINK_CURVE = {BLINK_INTERVAL, 2, 0x01};
+    static const BlinkCurve FAST_BLINK_CURVE = {FAST_BLINK_INTERVAL, 2, 0x01};
+    static const BlinkCurve DOUBLE_BLINK_CURVE = {BLINK_INTERVAL, 5, 0x05}; // On, off, on, off, off
+
+    const BlinkCurve *blink = nullptr;
+    switch (pattern)
     {
         case LEDPattern::SOLID:
-            setPixel(currentColor);
-            break;
+            return color;
 
         case LEDPattern::PULSE:
-            if (now - lastUpdate >= PULSE_INTERVAL)
+            return dimColor(color, BREATH_TABLE[(elapsedMs / PULSE_STEP) % 64]);
+
+        case LEDPattern::RAINBOW:
+        {
+            // Between two entries of the wheel
+            uint32_t step = elapsedMs / RAINBOW_STEP;
+            uint32_t from = RAINBOW_TABLE[step % 64];
+            uint32_t to = RAINBOW_TABLE[(step + 1) % 64];
+            uint32_t t = (elapsedMs % RAINBOW_STEP) * 256 / RAINBOW_STEP;
+            uint32_t mixed = 0;
+            for (int shift = 0; shift <= 16; shift += 8)
             {
-                if (increasing)
-                {
-                    pulseValue += 0.05;
-                    if (pulseValue >= 1.0)
-                    {
-                        pulseValue = 1.0;
-                        increasing = false;
-                    }
-                }
-                else
-                {
-                    pulseValue -= 0.05;
-                    if (pulseValue <= 0.0)
-                    {
-                        pulseValue = 0.0;
-                        increasing = true;
-                    }
-                }
-                setPixel(dimColor(currentColor, pulseValue));
-                lastUpdate = now;
+                uint32_t a = (from >> shift) & 0xFF;
+                uint32_t b = (to >> shift) & 0xFF;
+                mixed |= ((a * (256 - t) + b * t) >> 8) << shift;
             }
-            break;
+            return mixed;
+        }
 
         case LEDPattern::BLINK:
-            if (now - lastUpdate >= BLINK_INTERVAL)
-            {
-                static bool isOn = false;
-                isOn = !isOn;
-                setPixel(isOn ? currentColor : 0);
-                lastUpdate = now;
-            }
+            blink = &BLINK_CURVE;
             break;
-
         case LEDPattern::FAST_BLINK:
-            if (now - lastUpdate >= FAST_BLINK_INTERVAL)
-            {
-                static bool isOn = false;
-                isOn = !isOn;
-                setPixel(isOn ? currentColor : 0);
-                lastUpdate = now;
-            }
+            blink = &FAST_BLINK_CURVE;
             break;
-
         case LEDPattern::DOUBLE_BLINK:
-            if (now - lastUpdate >= BLINK_INTERVAL)
-            {
-                static uint8_t blinkState = 0;
-                switch (blinkState)
-                {
-                    case 0: setPixel(currentColor); break;
-                    case 1: setPixel(0); break;
-                    case 2: setPixel(currentColor); break;
-                    case 3: setPixel(0); break;
-                    default: blinkState = 0; break;
-                }
-                blinkState = (blinkState + 1) % 5;
-                lastUpdate = now;
-            }
-            break;
-
-        case LEDPattern::RAINBOW:
-            if (now - lastUpdate >= PULSE_INTERVAL)
-            {
-                static uint16_t hue = 0;
-                hue += 256;
-                if (hue >= 65536) hue = 0;
-                setPixel(pixel.gamma32(pixel.ColorHSV(hue)));
-                lastUpdate = now;
-            }
+            blink = &DOUBLE_BLINK_CURVE;
             break;
     }
+    uint32_t slot = (elapsedMs / blink->slotMs) % blink->slots;
+    return (blink->onMask >> slot) & 1 ? color : 0;
 }
 
 void LEDLogger::setBrightness(uint8_t newBrightness)
 {
+    portENTER_CRITICAL(&lock);
     brightness = newBrightness;
-    pixel.setBrightness(brightness);
-    pixel.show();
+    portEXIT_CRITICAL(&lock);
 }
 
 void LEDLogger::clear()
 {
-    pixel.clear();
-    pixel.show();
+    portENTER_CRITICAL(&lock);
+    running = false;
+    portEXIT_CRITICAL(&lock);
+    if (frameTimer)
+    {
+        esp_timer_stop(frameTimer);
+    }
+
+    // A frame already past its check could still go out after ours
+    for (;;)
+    {
+        portENTER_CRITICAL(&lock);
+        bool busy = rendering;
+        portEXIT_CRITICAL(&lock);
+        if (!busy)
+            break;
+        delay(1);
+    }
+    transmit(0);
+    rmt_wait_tx_done(RMT_CHANNEL, portMAX_DELAY);
+}
+
+// GRB, most significant bit first. Returns once the RMT has the items,
+// the previous frame (60 us on the wire) is long done by then.
+void LEDLogger::transmit(uint32_t color)
+{
+    uint32_t grb = ((color & 0x00FF00) << 8) | ((color & 0xFF0000) >> 8) | (color & 0xFF);
+    for (int i = 0; i < 24; i++)
+    {
+        bool one = grb & (1UL << (23 - i));
+        items[i].level0 = 1;
+        items[i].duration0 = one ? T1H : T0H;
+        items[i].level1 = 0;
+        items[i].duration1 = one ? T1L : T0L;
+    }
+    rmt_write_items(RMT_CHANNEL, items, 24, false);
+    shownColor = color;
 }
 
 uint32_t LEDLogger::getColorForState(SystemState state)
@@ -160,20 +230,16 @@ uint32_t LEDLogger::getColorForState(SystemState state)
     }
 }
 
-void LEDLogger::setPixel(uint32_t color)
+// Scales each channel by level/255 (255 keeps the color)
+uint32_t LEDLogger::dimColor(uint32_t color, uint8_t level)
 {
-    pixel.setPixelColor(0, color);
-}
+    uint32_t r = (color >> 16) & 0xFF;
+    uint32_t g = (color >> 8) & 0xFF;
+    uint32_t b = color & 0xFF;
 
-uint32_t LEDLogger::dimColor(uint32_t color, float factor)
-{
-    uint8_t r = (color >> 16) & 0xFF;
-    uint8_t g = (color >> 8) & 0xFF;
-    uint8_t b = color & 0xFF;
-    
-    r = r * factor;
-    g = g * factor;
-    b = b * factor;
-    
-    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
-}
\ No newline at end of file
+    r = r * (level + 1) >> 8;
+    g = g * (level + 1) >> 8;
+    b = b * (level + 1) >> 8;
+
+    return (r << 16) | (g << 8) | b;
+}
@@ -2,8 +2,13 @@
 #define LED_LOGGER_H
 
 #include <Arduino.h>
-#include <Adafruit_NeoPixel.h>
+#include <esp_timer.h>
+#include <driver/rmt.h>
 
+// Status LED (one WS2812-type pixel). The frames of the patterns come from integer
+// tables and are rendered by an esp_timer callback; a frame only goes out when the
+// color changed, through the RMT peripheral, which clocks the bits out on its own:
+// the CPU doesn't wait for the transfer or mask interrupts for its timing.
 class LEDLogger
 {
 public:
@@ -35,25 +40,33 @@ public:
 
   LEDLogger(uint8_t pin, uint8_t brightness = 30);
   void begin();
-  void update();
   void setState(SystemState state, LEDPattern pattern = LEDPattern::SOLID);
   void setCustomState(uint32_t color, LEDPattern pattern = LEDPattern::SOLID);
   void setBrightness(uint8_t brightness);
+
+  // Turn the LED off until the next setState(), waits until it is dark
   void clear();
 
   SystemState getCurrentState() const { return currentState; }
   LEDPattern getCurrentPattern() const { return currentPattern; }
 
 private:
-  Adafruit_NeoPixel pixel;
+  uint8_t pin;
   SystemState currentState;
   LEDPattern currentPattern;
-  unsigned long lastUpdate;
-  float pulseValue;
-  bool increasing;
   uint32_t currentColor;
   uint8_t brightness;
 
+  // Shared with the timer callback, which runs on the esp_timer task
+  portMUX_TYPE lock;
+  int64_t patternStart; // esp_timer time the pattern started
+  bool running;         // Cleared by clear(), the callback leaves the LED alone
+  bool rendering;       // The callback is between its snapshot and the transmission
+
+  esp_timer_handle_t frameTimer;
+  uint32_t shownColor; // Last color sent, only the callback and clear() touch it
+  rmt_item32_t items[24];
+
   // Color definitions
   static constexpr uint32_t COLOR_STARTUP = 0x0000FF;     // Blue
   static constexpr uint32_t COLOR_NORMAL = 0x00FF00;      // Green
@@ -66,14 +79,26 @@ private:
   static constexpr uint32_t COLOR_STANDBY = 0x101010;     // Dim white
 
   // Timing constants
-  static constexpr unsigned long PULSE_INTERVAL = 30;
-  static constexpr unsigned long BLINK_INTERVAL = 500;
-  static constexpr unsigned long FAST_BLINK_INTERVAL = 100;
+  static constexpr uint32_t FRAME_INTERVAL = 20;       // ms
+  static constexpr uint32_t PULSE_STEP = 20;           // ms per breathing table entry
+  static constexpr uint32_t RAINBOW_STEP = 120;        // ms per rainbow table entry
+  static constexpr uint16_t BLINK_INTERVAL = 500;      // ms per blink slot, on or off
+  static constexpr uint16_t FAST_BLINK_INTERVAL = 100; // ms
+
+  // RMT: 40 MHz ticks, the 400 kHz timing of the pixel
+  static constexpr rmt_channel_t RMT_CHANNEL = RMT_CHANNEL_0;
+  static constexpr uint8_t RMT_CLOCK_DIV = 2;
+  static constexpr uint16_t T0H = 20; // 0.5 us
+  static constexpr uint16_t T0L = 80; // 2.0 us
+  static constexpr uint16_t T1H = 48; // 1.2 us
+  static constexpr uint16_t T1L = 52; // 1.3 us
 
-  void updatePattern();
+  static void onFrame(void *arg);
+  uint32_t renderFrame(LEDPattern pattern, uint32_t color, uint32_t elapsedMs) const;
+  void restart();
+  void transmit(uint32_t color);
   uint32_t getColorForState(SystemState state);
-  void setPixel(uint32_t color);
-  uint32_t dimColor(uint32_t color, float factor);
+  static uint32_t dimColor(uint32_t color, uint8_t level);
 };
 
-#endif // LED_LOGGER_H
\ No newline at end of file
+#endif // LED_LOGGER_H
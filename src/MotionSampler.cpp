@@ -0,0 +1,196 @@
+#include "MotionSampler.h"
+#include <DEV_Config.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+MotionSampler::MotionSampler()
+    : _batched(false),
+      _acc{0.0f, 0.0f, 0.0f},
+      _gyro{0.0f, 0.0f, 0.0f},
+      _timestamp(0),
+      _batchSize(0),
+      _seenOverruns(0),
+      _task(nullptr),
+      _pauseRequested(false),
+      _paused(false),
+      _wokeAt(0),
+      _fifoOverflows(0)
+{
+}
+
+bool MotionSampler::begin()
+{
+  QMI8658Config config;
+  memset(&config, 0, sizeof(config));
+  config.inputSelection = QMI8658_CONFIG_ACCGYR_ENABLE;
+  config.accRange = QMI8658AccRange_8g;
+  config.accOdr = QMI8658AccOdr_125Hz;
+  config.gyrRange = QMI8658GyrRange_512dps;
+  config.gyrOdr = QMI8658GyrOdr_125Hz;
+  QMI8658_Config_apply(&config);
+
+  // Stream mode keeps the newest samples if the task is held up
+  _batched = QMI8658_config_fifo(WATERMARK, QMI8658FifoSize_64, QMI8658FifoMode_Stream);
+  if (!_batched)
+  {
+    Serial.println("QMI8658 FIFO setup failed, polling instead");
+  }
+  return _batched;
+}
+
+void MotionSampler::startTask()
+{
+  if (_task)
+    return;
+  xTaskCreatePinnedToCore(taskEntry, "IMU", TASK_STACK, this, TASK_PRIORITY, &_task, TASK_CORE);
+}
+
+void MotionSampler::taskEntry(void *parameter)
+{
+  MotionSampler *self = (MotionSampler *)parameter;
+  for (;;)
+  {
+    if (self->_pauseRequested.load())
+    {
+      self->_paused.store(true);
+      while (self->_pauseRequested.load())
+        vTaskDelay(pdMS_TO_TICKS(1));
+      self->_paused.store(false);
+    }
+
+    self->acquire();
+
+    unsigned long period = 1000 / ODR_HZ;
+    if (self->_batched)
+    {
+      unsigned long wokeAt = self->_wokeAt.load();
+      bool justWoke = wokeAt && millis() - wokeAt < WAKE_FAST_WINDOW;
+      period = justWoke ? WAKE_BATCH_PERIOD : BATCH_PERIOD;
+    }
+    vTaskDelay(pdMS_TO_TICKS(period));
+  }
+}
+
+// Runs in the task: read what the IMU collected and queue it for the loop
+void MotionSampler::acquire()
+{
+  if (!_batched)
+  {
+    QMI8658Sample &s = _taskSamples[0];
+    QMI8658_read_xyz(s.acc, s.gyro, &s.timestamp);
+    for (int axis = 0; axis < 3; axis++)
+    {
+      s.acc_raw[axis] = (short)lroundf(s.acc[axis] * ACC_LSB_PER_G / 1000.0f);
+      s.gyro_raw[axis] = (short)lroundf(s.gyro[axis] * GYRO_LSB_PER_DPS);
+    }
+    _ring.push(s);
+    return;
+  }
+
+  unsigned char status = 0;
+  int count = QMI8658_read_fifo(_taskSamples, MAX_BATCH, &status);
+  if (status & QMI8658_FIFO_STATUS_OVERFLOW)
+    _fifoOverflows.fetch_add(1, std::memory_order_relaxed);
+  for (int i = 0; i < count; i++)
+    _ring.push(_taskSamples[i]);
+}
+
+bool MotionSampler::update()
+{
+  // The loop fell behind by more than the ring holds (e.g. a blocking upload):
+  // what's left is stale, start over from the samples that come next
+  uint32_t overruns = _ring.getOverruns();
+  if (overruns != _seenOverruns)
+  {
+    _seenOverruns = overruns;
+    _ring.clear();
+    return false;
+  }
+
+  int count = (int)_ring.pop(_samples, MAX_BATCH);
+  if (count <= 0)
+    return false;
+
+  reduce(count);
+  return true;
+}
+
+void MotionSampler::pauseTask()
+{
+  if (!_task)
+    return;
+  _pauseRequested.store(true);
+  while (!_paused.load())
+    vTaskDelay(pdMS_TO_TICKS(1));
+}
+
+void MotionSampler::resumeTask()
+{
+  _pauseRequested.store(false);
+}
+
+unsigned long MotionSampler::sleepUntilMotion(unsigned long timeoutMs)
+{
+  gpio_num_t pin = (gpio_num_t)DEV_INT1_PIN;
+  gpio_wakeup_enable(pin, armWakeOnMotion() ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  if (timeoutMs)
+    esp_sleep_enable_timer_wakeup((uint64_t)timeoutMs * 1000);
+  Serial.flush();
+
+  unsigned long start = micros();
+  esp_light_sleep_start();
+  unsigned long slept = micros() - start;
+
+  gpio_wakeup_disable(pin);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  QMI8658_readStatus1(); // Clears the event
+  QMI8658_disableWakeOnMotion();
+
+  // Nothing queued before the sleep belongs to the wake
+  begin();
+  _ring.clear();
+  _wokeAt.store(millis());
+  resumeTask();
+  return slept;
+}
+
+int MotionSampler::armWakeOnMotion()
+{
+  // The task must be off the bus while the IMU is reconfigured
+  pauseTask();
+
+  // Picking the ball up is enough to wake, a shake is far above the threshold
+  QMI8658_enableWakeOnMotion(QMI8658WomThreshold_high, QMI8658_Int1);
+
+  // INT1 toggles on every event, wake on the opposite of its current level
+  pinMode(DEV_INT1_PIN, INPUT);
+  return digitalRead(DEV_INT1_PIN) ? LOW : HIGH;
+}
+
+void MotionSampler::printStats()
+{
+  Serial.printf("IMU: ring max fill %lu/%lu, ring overruns %lu, FIFO overflows %lu\n",
+                (unsigned long)_ring.getMaxFill(), (unsigned long)RING_SIZE,
+                (unsigned long)_ring.getOverruns(), (unsigned long)getFifoOverflows());
+}
+
+void MotionSampler::reduce(int count)
+{
+  float gyroSum[3] = {0.0f, 0.0f, 0.0f};
+  for (int i = 0; i < count; i++)
+  {
+    for (int axis = 0; axis < 3; axis++)
+      gyroSum[axis] += _samples[i].gyro[axis];
+  }
+
+  const QMI8658Sample &newest = _samples[count - 1];
+  for (int axis = 0; axis < 3; axis++)
+  {
+    _acc[axis] = newest.acc[axis];
+    _gyro[axis] = gyroSum[axis] / count;
+  }
+  _timestamp = newest.timestamp;
+  _batchSize = count;
+}
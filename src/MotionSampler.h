@@ -0,0 +1,101 @@
+#ifndef MOTION_SAMPLER_H
+#define MOTION_SAMPLER_H
+
+#include <Arduino.h>
+#include <QMI8658.h>
+#include <atomic>
+#include "SampleRing.h"
+
+// Reads the IMU in its own task at a fixed period and hands the timestamped samples
+// to the main loop through a lock-free ring, so a slow frame or a blocking upload
+// doesn't stall sampling. The QMI8658 FIFO collects them between reads, so the bus
+// is idle most of the time; when the FIFO can't be set up, the task polls every sample.
+class MotionSampler
+{
+public:
+  MotionSampler();
+
+  // Configure the output rate and the FIFO, call after QMI8658_init()
+  bool begin();
+
+  // Start the sampling task, call after begin()
+  void startTask();
+
+  // Take the samples the task collected since the last call (up to MAX_BATCH).
+  // Returns true when there are new ones.
+  bool update();
+
+  // Arm the IMU's wake on motion interrupt and light sleep the CPU until it fires,
+  // or for at most timeoutMs (0: no limit, the wake cause tells which it was).
+  // Sampling is restored before returning, with short batches for a moment.
+  // Returns the time slept in microseconds.
+  unsigned long sleepUntilMotion(unsigned long timeoutMs = 0);
+
+  // Stop sampling and arm the wake on motion interrupt for a sleep that ends in a reset.
+  // Returns the level of DEV_INT1_PIN that signals motion.
+  int armWakeOnMotion();
+
+  // Samples of the last update, oldest first
+  const QMI8658Sample *getSamples() const { return _samples; }
+  // Of the last update: the mean rate in dps, held until the next one
+  const float *getGyro() const { return _gyro; }
+  // Newest sample of the last update, acceleration in mg
+  const float *getAccel() const { return _acc; }
+  // IMU sample counter of the newest sample
+  unsigned int getTimestamp() const { return _timestamp; }
+  int getBatchSize() const { return _batchSize; }
+  bool isBatched() const { return _batched; }
+
+  // Samples lost because the main loop didn't keep up (the ring was full),
+  // and IMU FIFO overflows because the task didn't (the oldest samples were overwritten)
+  uint32_t getRingOverruns() const { return _ring.getOverruns(); }
+  uint32_t getFifoOverflows() const { return _fifoOverflows.load(std::memory_order_relaxed); }
+  void printStats();
+
+  // Output rate and scale of acc_raw/gyro_raw at the +-8g, +-512dps ranges set by begin()
+  static const uint32_t ODR_HZ = 125;
+  static const int32_t ACC_LSB_PER_G = 4096;
+  static const int32_t GYRO_LSB_PER_DPS = 64;
+
+private:
+  bool _batched;
+  float _acc[3];
+  float _gyro[3];
+  unsigned int _timestamp;
+  int _batchSize;
+
+  // 125 Hz sampling, the task reads a batch of 8 samples every 64 ms
+  static const int MAX_BATCH = 32;
+  static const unsigned char WATERMARK = 8;
+  static const unsigned long BATCH_PERIOD = 64;
+  // After a wake, small batches are read for a while so the shake is seen early
+  static const unsigned long WAKE_BATCH_PERIOD = 16;
+  static const unsigned long WAKE_FAST_WINDOW = 500;
+  // About a second of samples between the task and the loop
+  static const uint32_t RING_SIZE = 128;
+
+  // Sampling task. Above the loop's priority on the loop's core, so it preempts rendering
+  // and uploads but never reads the bus at the same time as another core.
+  static const uint32_t TASK_STACK = 3072;
+  static const UBaseType_t TASK_PRIORITY = 3;
+  static const BaseType_t TASK_CORE = 1;
+
+  SampleRing<QMI8658Sample, RING_SIZE> _ring;
+  QMI8658Sample _samples[MAX_BATCH];     // The loop's copy
+  QMI8658Sample _taskSamples[MAX_BATCH]; // The task's read buffer
+  uint32_t _seenOverruns;
+
+  TaskHandle_t _task;
+  std::atomic<bool> _pauseRequested;
+  std::atomic<bool> _paused;
+  std::atomic<unsigned long> _wokeAt;
+  std::atomic<uint32_t> _fifoOverflows;
+
+  static void taskEntry(void *parameter);
+  void acquire();
+  void pauseTask();
+  void resumeTask();
+  void reduce(int count);
+};
+
+#endif // MOTION_SAMPLER_H
@@ -0,0 +1,77 @@
+#include "RefreshController.h"
+
+RefreshController::RefreshController()
+    : _refrTimer(nullptr),
+      _rate(Rate::IDLE),
+      _period(LV_DISP_DEF_REFR_PERIOD),
+      _phaseName("BOOT"),
+      _phaseStart(0),
+      _phaseSleptUs(0)
+{
+}
+
+void RefreshController::begin()
+{
+  lv_disp_t *disp = lv_disp_get_default();
+  if (disp)
+  {
+    _refrTimer = _lv_disp_get_refr_timer(disp);
+  }
+  applyRate(Rate::IDLE);
+  _phaseStart = millis();
+}
+
+uint32_t RefreshController::update(bool transitioning)
+{
+  applyRate((transitioning || lv_anim_count_running() > 0) ? Rate::ACTIVE : Rate::IDLE);
+
+  // Straight from LVGL's timer queue, so a timer resumed or sped up since the last run counts
+  if (lv_timer_get_time_until_next() == 0)
+  {
+    lv_timer_handler();
+  }
+
+  // LVGL pauses the refresh timer by itself when nothing was invalidated
+  if (_rate == Rate::IDLE && _refrTimer && _refrTimer->paused)
+  {
+    _rate = Rate::STATIC;
+  }
+
+  return getSleepTime();
+}
+
+uint32_t RefreshController::getSleepTime() const
+{
+  uint32_t timeTillNext = lv_timer_get_time_until_next();
+  return timeTillNext < MAX_SLEEP ? timeTillNext : MAX_SLEEP;
+}
+
+void RefreshController::applyRate(Rate rate)
+{
+  _rate = rate;
+  uint32_t period = (rate == Rate::ACTIVE) ? ACTIVE_PERIOD : IDLE_PERIOD;
+  if (period == _period || !_refrTimer)
+    return;
+
+  _period = period;
+  lv_timer_set_period(_refrTimer, period);
+}
+
+void RefreshController::beginPhase(const char *name)
+{
+  printLoadStats();
+  _phaseName = name;
+  _phaseStart = millis();
+  _phaseSleptUs = 0;
+}
+
+void RefreshController::printLoadStats()
+{
+  unsigned long elapsed = millis() - _phaseStart;
+  if (elapsed == 0)
+    return;
+
+  float busy = 100.0f - (_phaseSleptUs / 10.0f) / elapsed;
+  Serial.printf("Load %s: %.1f%% busy over %lu ms (refresh %lu ms)\n",
+                _phaseName, busy, elapsed, (unsigned long)_period);
+}
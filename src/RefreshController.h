@@ -0,0 +1,53 @@
+#ifndef REFRESH_CONTROLLER_H
+#define REFRESH_CONTROLLER_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// Adapts the LVGL refresh rate to the on-screen activity and tells the main loop how long it may sleep
+class RefreshController
+{
+public:
+  enum class Rate
+  {
+    ACTIVE, // Animations or transitions running
+    IDLE,   // Only the slow idle wobble is moving
+    STATIC  // Nothing was invalidated, LVGL paused its refresh timer
+  };
+
+  RefreshController();
+
+  void begin();
+
+  // Run the LVGL timers if they are due and adapt the refresh period.
+  // Returns how long the caller may sleep before calling again.
+  uint32_t update(bool transitioning);
+  uint32_t getSleepTime() const;
+  Rate getRate() const { return _rate; }
+
+  // Account for time slept, in the scheduler or in light sleep
+  void addSleepTime(unsigned long us) { _phaseSleptUs += us; }
+
+  // Start a new load measurement phase, reports the previous one
+  void beginPhase(const char *name);
+  void printLoadStats();
+
+private:
+  lv_timer_t *_refrTimer;
+  Rate _rate;
+  uint32_t _period;
+
+  // CPU load of the current phase
+  const char *_phaseName;
+  unsigned long _phaseStart;
+  unsigned long _phaseSleptUs;
+
+  // Refresh periods
+  static constexpr uint32_t ACTIVE_PERIOD = 16; // ~60 Hz for the shake transition
+  static constexpr uint32_t IDLE_PERIOD = 50;   // 20 Hz is plenty for the idle wobble
+  static constexpr uint32_t MAX_SLEEP = 50;     // Pick up new invalidations at least this often
+
+  void applyRate(Rate rate);
+};
+
+#endif // REFRESH_CONTROLLER_H
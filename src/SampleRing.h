@@ -0,0 +1,69 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free ring for exactly one producer task and one consumer task.
+// Each index is written by one side only: the producer owns _head, the consumer _tail,
+// and the release store of an index publishes the slots before it to the other side.
+// When full, push() drops the new element and counts an overrun; the producer can't
+// make room without racing the consumer, so the consumer decides what to do about it.
+template <typename T, uint32_t SIZE>
+class SampleRing
+{
+  static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+public:
+  SampleRing() : _head(0), _tail(0), _overruns(0), _maxFill(0) {}
+
+  // Producer side
+  bool push(const T &item)
+  {
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    uint32_t fill = head - _tail.load(std::memory_order_acquire);
+    if (fill >= SIZE)
+    {
+      _overruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    _items[head & (SIZE - 1)] = item;
+    _head.store(head + 1, std::memory_order_release);
+    if (fill + 1 > _maxFill.load(std::memory_order_relaxed))
+      _maxFill.store(fill + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Consumer side: copies up to max elements, oldest first, returns the count
+  uint32_t pop(T *out, uint32_t max)
+  {
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    uint32_t count = _head.load(std::memory_order_acquire) - tail;
+    if (count > max)
+      count = max;
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = _items[(tail + i) & (SIZE - 1)];
+    _tail.store(tail + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer side: drops everything pushed so far
+  void clear() { _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release); }
+
+  // Either side, a snapshot
+  uint32_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+  static uint32_t capacity() { return SIZE; }
+
+  // Elements dropped because the ring was full, and the highest fill seen
+  uint32_t getOverruns() const { return _overruns.load(std::memory_order_relaxed); }
+  uint32_t getMaxFill() const { return _maxFill.load(std::memory_order_relaxed); }
+
+private:
+  T _items[SIZE];
+  std::atomic<uint32_t> _head; // Next slot to write, only the producer stores it
+  std::atomic<uint32_t> _tail; // Next slot to read, only the consumer stores it
+  std::atomic<uint32_t> _overruns;
+  std::atomic<uint32_t> _maxFill;
+};
+
+#endif // SAMPLE_RING_H
@@ -0,0 +1,248 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler()
+    : _count(0),
+      _running(NO_JOB),
+      _pass(0),
+      _heapSize(0),
+      _task(nullptr),
+      _triggered(0)
+{
+  for (int i = 0; i < MAX_JOBS; i++)
+    _heapPos[i] = -1;
+}
+
+void Scheduler::begin()
+{
+  _task = xTaskGetCurrentTaskHandle();
+}
+
+int Scheduler::every(const char *name, uint32_t periodMs, JobFn fn)
+{
+  return add(name, periodMs, true, 0, fn);
+}
+
+int Scheduler::after(const char *name, uint32_t delayMs, JobFn fn)
+{
+  return add(name, 0, false, delayMs, fn);
+}
+
+int Scheduler::add(const char *name, uint32_t periodMs, bool periodic, uint32_t delayMs, JobFn fn)
+{
+  if (_count >= MAX_JOBS)
+    return NO_JOB;
+
+  int id = _count++;
+  Job &job = _jobs[id];
+  job.name = name;
+  job.fn = fn;
+  job.periodUs = periodMs * 1000;
+  job.periodic = periodic;
+  job.scheduled = false;
+  job.handled = false;
+  job.pass = 0;
+  job.runs = 0;
+  job.totalRunUs = 0;
+  job.maxRunUs = 0;
+  job.totalLateUs = 0;
+  job.maxLateUs = 0;
+  schedule(id, micros() + delayMs * 1000);
+  return id;
+}
+
+void Scheduler::runAfter(int job, uint32_t delayMs)
+{
+  if (job < 0 || job >= _count)
+    return;
+  if (job == _running)
+    _jobs[job].handled = true;
+  schedule(job, micros() + delayMs * 1000);
+}
+
+void Scheduler::pause(int job)
+{
+  if (job < 0 || job >= _count)
+    return;
+  if (job == _running)
+    _jobs[job].handled = true;
+  unschedule(job);
+}
+
+bool Scheduler::isScheduled(int job) const
+{
+  return job >= 0 && job < _count && _jobs[job].scheduled;
+}
+
+void Scheduler::trigger(int job)
+{
+  if (job < 0 || job >= MAX_JOBS)
+    return;
+  _triggered.fetch_or(1UL << job);
+  if (_task)
+    xTaskNotifyGive(_task);
+}
+
+unsigned long Scheduler::run()
+{
+  unsigned long now = micros();
+  _pass++;
+
+  uint32_t triggered = _triggered.exchange(0);
+  for (int i = 0; triggered && i < _count; i++)
+  {
+    if (triggered & (1UL << i))
+      schedule(i, now);
+  }
+
+  // Only what was due when the pass started, each job once: one that is due again right away
+  // (a continuous one) ends the pass, the next one starts without sleeping
+  while (_heapSize > 0 && (long)(now - _jobs[_heap[0]].deadline) >= 0 && _jobs[_heap[0]].pass != _pass)
+  {
+    int id = _heap[0];
+    Job &job = _jobs[id];
+    unschedule(id);
+    job.handled = false;
+    job.pass = _pass;
+
+    unsigned long start = micros();
+    unsigned long late = start - job.deadline;
+    _running = id;
+    job.fn();
+    _running = NO_JOB;
+    unsigned long end = micros();
+
+    unsigned long runUs = end - start;
+    job.runs++;
+    job.totalRunUs += runUs;
+    job.totalLateUs += late;
+    if (runUs > job.maxRunUs)
+      job.maxRunUs = runUs;
+    if (late > job.maxLateUs)
+      job.maxLateUs = late;
+
+    // Fixed rate; the periods that went by while the job was late are skipped, not run in a burst
+    if (!job.handled && job.periodic)
+    {
+      unsigned long next = job.deadline + job.periodUs;
+      if (job.periodUs == 0)
+        next = end;
+      else if ((long)(end - next) >= 0)
+        next += ((end - next) / job.periodUs + 1) * job.periodUs;
+      schedule(id, next);
+    }
+  }
+
+  // Sleep until the next deadline, rounded up to a tick so the wake isn't early
+  uint32_t sleepMs = MAX_SLEEP_MS;
+  if (_heapSize > 0)
+  {
+    long remaining = (long)(_jobs[_heap[0]].deadline - micros());
+    if (remaining <= 0)
+      return 0;
+    uint32_t ms = (uint32_t)((remaining + 999) / 1000);
+    sleepMs = ms < MAX_SLEEP_MS ? ms : MAX_SLEEP_MS;
+  }
+  unsigned long start = micros();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs)); // Blocks, so the idle task (and light sleep) can run
+  return micros() - start;
+}
+
+void Scheduler::resume()
+{
+  unsigned long now = micros();
+  for (int i = 0; i < _count; i++)
+  {
+    if (_jobs[i].scheduled && (long)(now - _jobs[i].deadline) > 0)
+      schedule(i, now);
+  }
+}
+
+void Scheduler::printStats()
+{
+  Serial.printf("%-10s %8s %9s %9s %10s %10s\n", "job", "runs", "avg_us", "max_us", "late_avg", "late_max");
+  for (int i = 0; i < _count; i++)
+  {
+    const Job &job = _jobs[i];
+    unsigned long runs = job.runs ? job.runs : 1;
+    Serial.printf("%-10s %8lu %9lu %9lu %10lu %10lu\n", job.name, (unsigned long)job.runs, job.totalRunUs / runs,
+                  job.maxRunUs, job.totalLateUs / runs, job.maxLateUs);
+  }
+}
+
+// Heap
+
+void Scheduler::schedule(int job, unsigned long deadline)
+{
+  Job &j = _jobs[job];
+  j.deadline = deadline;
+  j.scheduled = true;
+  int index = _heapPos[job];
+  if (index < 0)
+  {
+    index = _heapSize++;
+    place(index, job);
+  }
+  siftUp(index);
+  siftDown(_heapPos[job]);
+}
+
+void Scheduler::unschedule(int job)
+{
+  int index = _heapPos[job];
+  _jobs[job].scheduled = false;
+  if (index < 0)
+    return;
+
+  _heapPos[job] = -1;
+  int last = _heap[--_heapSize];
+  if (index == _heapSize)
+    return;
+  place(index, last);
+  siftUp(index);
+  siftDown(_heapPos[last]);
+}
+
+bool Scheduler::earlier(int a, int b) const
+{
+  return (long)(_jobs[a].deadline - _jobs[b].deadline) < 0;
+}
+
+void Scheduler::place(int index, int job)
+{
+  _heap[index] = job;
+  _heapPos[job] = index;
+}
+
+void Scheduler::siftUp(int index)
+{
+  while (index > 0)
+  {
+    int parent = (index - 1) / 2;
+    if (!earlier(_heap[index], _heap[parent]))
+      break;
+    int job = _heap[index];
+    place(index, _heap[parent]);
+    place(parent, job);
+    index = parent;
+  }
+}
+
+void Scheduler::siftDown(int index)
+{
+  for (;;)
+  {
+    int smallest = index;
+    int left = 2 * index + 1;
+    int right = left + 1;
+    if (left < _heapSize && earlier(_heap[left], _heap[smallest]))
+      smallest = left;
+    if (right < _heapSize && earlier(_heap[right], _heap[smallest]))
+      smallest = right;
+    if (smallest == index)
+      return;
+    int job = _heap[index];
+    place(index, _heap[smallest]);
+    place(smallest, job);
+    index = smallest;
+  }
+}
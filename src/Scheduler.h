@@ -0,0 +1,94 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Runs the loop's jobs at their deadlines and sleeps in between. The jobs are kept in a
+// min-heap on their next deadline; run() calls the ones that are due and then blocks the
+// loop task until the earliest deadline, or until another task or a timer callback
+// trigger()s a job. Each job's run time and lateness (start after its deadline) is kept.
+class Scheduler
+{
+public:
+  typedef void (*JobFn)();
+
+  static const int NO_JOB = -1;
+
+  Scheduler();
+
+  // Call from the task that calls run(), it is the one trigger() wakes
+  void begin();
+
+  // A job that runs every periodMs, the first time right away; the deadlines stay on that
+  // grid, the ones missed while it ran late are skipped. 0: on every pass, the loop
+  // doesn't sleep while such a job is scheduled. Returns NO_JOB when full.
+  int every(const char *name, uint32_t periodMs, JobFn fn);
+  // A job that runs once, delayMs from now; runAfter() schedules it again
+  int after(const char *name, uint32_t delayMs, JobFn fn);
+
+  // Next run delayMs from now. From inside the job, this replaces its period once.
+  void runAfter(int job, uint32_t delayMs);
+  // No more runs until runAfter() or trigger()
+  void pause(int job);
+  bool isScheduled(int job) const;
+
+  // From any task or timer callback: run the job on the next pass and wake the loop
+  void trigger(int job);
+
+  // Run the jobs that are due, each once, then sleep until the next deadline or a trigger.
+  // Returns the time slept in microseconds.
+  unsigned long run();
+
+  // After a sleep the scheduler didn't do (light sleep): the deadlines that passed
+  // meanwhile move to now and don't count as late
+  void resume();
+
+  void printStats();
+
+private:
+  struct Job
+  {
+    const char *name;
+    JobFn fn;
+    uint32_t periodUs;
+    bool periodic;
+    bool scheduled;   // In the heap
+    bool handled;     // The job scheduled or paused itself while running
+    unsigned long deadline; // micros()
+    uint32_t pass;          // Of run() it last ran in
+
+    // Statistics
+    uint32_t runs;
+    unsigned long totalRunUs;
+    unsigned long maxRunUs;
+    unsigned long totalLateUs;
+    unsigned long maxLateUs;
+  };
+
+  static const int MAX_JOBS = 12;
+  static const uint32_t MAX_SLEEP_MS = 1000; // With nothing scheduled
+
+  Job _jobs[MAX_JOBS];
+  int _count;
+  int _running;
+  uint32_t _pass; // run() calls
+
+  // Min-heap of job ids on their deadline, _heapPos: where a job is, -1 if not in it
+  int8_t _heap[MAX_JOBS];
+  int8_t _heapPos[MAX_JOBS];
+  int _heapSize;
+
+  TaskHandle_t _task;
+  std::atomic<uint32_t> _triggered; // Bit n: job n was triggered
+
+  int add(const char *name, uint32_t periodMs, bool periodic, uint32_t delayMs, JobFn fn);
+  void schedule(int job, unsigned long deadline);
+  void unschedule(int job);
+  bool earlier(int a, int b) const;
+  void place(int index, int job);
+  void siftUp(int index);
+  void siftDown(int index);
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,128 @@
+#include "ShakeDetector.h"
+
+static uint32_t squaredThreshold(float g, int32_t lsbPerG)
+{
+  uint32_t lsb = (uint32_t)(g * lsbPerG);
+  return lsb * lsb;
+}
+
+static uint32_t msToSamples(uint32_t ms, uint32_t odrHz)
+{
+  return (ms * odrHz + 999) / 1000;
+}
+
+static int16_t clamp16(int32_t v)
+{
+  return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+ShakeDetector::ShakeDetector(int32_t lsbPerG, uint32_t odrHz)
+    : _peakThreshold2(squaredThreshold(PEAK_G, lsbPerG)),
+      _releaseThreshold2(squaredThreshold(RELEASE_G, lsbPerG)),
+      _minGap(msToSamples(MIN_PEAK_GAP_MS, odrHz)),
+      _window(msToSamples(WINDOW_MS, odrHz)),
+      _refractory(msToSamples(REFRACTORY_MS, odrHz))
+{
+  reset();
+}
+
+void ShakeDetector::reset()
+{
+  _primed = false;
+  _inPeak = false;
+  _hasLastPeak = false;
+  _lastPeakTime = 0;
+  _peakHead = 0;
+  _peakCount = 0;
+  _hasShake = false;
+  _lastShakeTime = 0;
+  _shakeCount = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    _gravity[i] = 0;
+    _lastDir[i] = 0;
+    _peakDir[i] = 0;
+  }
+}
+
+bool ShakeDetector::addSample(const int16_t acc[3], uint32_t timestamp)
+{
+  if (!_primed)
+  {
+    for (int i = 0; i < 3; i++)
+      _gravity[i] = (int32_t)acc[i] << GRAVITY_SHIFT;
+    _primed = true;
+  }
+
+  // Dynamic part: the sample minus the gravity estimate
+  int16_t dyn[3];
+  uint32_t mag2 = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    _gravity[i] += acc[i] - (_gravity[i] >> GRAVITY_SHIFT);
+    dyn[i] = clamp16(acc[i] - (_gravity[i] >> GRAVITY_SHIFT));
+    mag2 += (uint32_t)((int32_t)dyn[i] * dyn[i]);
+  }
+
+  // A peak ends when the acceleration drops or turns around; a hard, fast
+  // shake flips direction between two samples without passing through zero
+  if (_inPeak)
+  {
+    int64_t dot = 0;
+    for (int i = 0; i < 3; i++)
+      dot += (int32_t)dyn[i] * _peakDir[i];
+    if (mag2 >= _releaseThreshold2 && dot >= 0)
+      return false;
+    _inPeak = false;
+  }
+  if (mag2 <= _peakThreshold2)
+    return false;
+
+  _inPeak = true;
+  for (int i = 0; i < 3; i++)
+    _peakDir[i] = dyn[i];
+  return addPeak(dyn, timestamp);
+}
+
+bool ShakeDetector::addPeak(const int16_t dir[3], uint32_t timestamp)
+{
+  if (_hasShake && timestamp - _lastShakeTime < _refractory)
+    return false;
+  if (_hasLastPeak && timestamp - _lastPeakTime < _minGap)
+    return false;
+
+  int64_t dot = 0;
+  for (int i = 0; i < 3; i++)
+    dot += (int32_t)dir[i] * _lastDir[i];
+  bool reversal = _hasLastPeak && timestamp - _lastPeakTime <= _window && dot < 0;
+
+  _peaks[_peakHead].timestamp = timestamp;
+  _peaks[_peakHead].reversal = reversal;
+  _peakHead = (_peakHead + 1) % MAX_PEAKS;
+  if (_peakCount < MAX_PEAKS)
+    _peakCount++;
+  for (int i = 0; i < 3; i++)
+    _lastDir[i] = dir[i];
+  _lastPeakTime = timestamp;
+  _hasLastPeak = true;
+
+  // Reversals in the window ending with this peak
+  int reversals = 0;
+  for (int n = 0; n < _peakCount; n++)
+  {
+    const Peak &p = _peaks[(_peakHead - 1 - n + MAX_PEAKS) % MAX_PEAKS];
+    if (timestamp - p.timestamp > _window)
+      break;
+    if (p.reversal)
+      reversals++;
+  }
+  if (reversals < MIN_REVERSALS)
+    return false;
+
+  _hasShake = true;
+  _lastShakeTime = timestamp;
+  _shakeCount++;
+  _peakCount = 0;
+  _hasLastPeak = false;
+  return true;
+}
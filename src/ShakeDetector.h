@@ -0,0 +1,65 @@
+#ifndef SHAKE_DETECTOR_H
+#define SHAKE_DETECTOR_H
+
+#include <stdint.h>
+
+// Recognizes a shake in raw accelerometer samples with integer math only.
+// Gravity is tracked with a slow low-pass and removed; a peak is the dynamic
+// acceleration rising above PEAK_G, and a shake is MIN_REVERSALS peaks that flip
+// direction (negative dot product) within WINDOW_MS. A single bump, even a hard
+// one, has no reversal and is ignored. After a shake, REFRACTORY_MS pass before the next.
+class ShakeDetector
+{
+public:
+  // lsbPerG: accelerometer scale (4096 at +-8g), odrHz: rate of the sample counter
+  ShakeDetector(int32_t lsbPerG, uint32_t odrHz);
+
+  void reset();
+
+  // Feed one sample. timestamp is the IMU sample counter, it only has to
+  // increase by one per sample. Returns true on the sample that completes a shake.
+  bool addSample(const int16_t acc[3], uint32_t timestamp);
+
+  uint32_t getShakeCount() const { return _shakeCount; }
+
+  // Tuning, in g and ms
+  static constexpr float PEAK_G = 1.2f;      // Dynamic acceleration that starts a peak
+  static constexpr float RELEASE_G = 0.5f;   // ... and has to fall below (or turn around) before the next one
+  static constexpr uint32_t MIN_PEAK_GAP_MS = 40; // Rebounds of a bump come faster
+  static constexpr uint32_t WINDOW_MS = 600;
+  static constexpr uint32_t REFRACTORY_MS = 1500;
+  static constexpr int MIN_REVERSALS = 2;
+
+private:
+  struct Peak
+  {
+    uint32_t timestamp;
+    bool reversal; // Opposite direction to the peak before it
+  };
+  static constexpr int MAX_PEAKS = 8;
+  static constexpr int GRAVITY_SHIFT = 6; // Low-pass over ~64 samples
+
+  uint32_t _peakThreshold2;
+  uint32_t _releaseThreshold2;
+  uint32_t _minGap;
+  uint32_t _window;
+  uint32_t _refractory;
+
+  bool _primed;
+  int32_t _gravity[3]; // << GRAVITY_SHIFT
+  bool _inPeak;
+  int16_t _peakDir[3]; // Direction of the peak in progress
+  int16_t _lastDir[3];
+  uint32_t _lastPeakTime;
+  bool _hasLastPeak;
+  Peak _peaks[MAX_PEAKS];
+  int _peakHead;
+  int _peakCount;
+  uint32_t _lastShakeTime;
+  bool _hasShake;
+  uint32_t _shakeCount;
+
+  bool addPeak(const int16_t dir[3], uint32_t timestamp);
+};
+
+#endif // SHAKE_DETECTOR_H
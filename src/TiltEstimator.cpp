@@ -0,0 +1,68 @@
+#include "TiltEstimator.h"
+
+TiltEstimator::TiltEstimator(int32_t accLsbPerG, int32_t gyroLsbPerDps, uint32_t odrHz)
+    : _accLsbPerG(accLsbPerG),
+      _gyroScale((int64_t)(3.14159265358979 / 180.0 / gyroLsbPerDps / odrHz * 4294967296.0 + 0.5)),
+      _maxGap(MAX_GAP_MS * odrHz / 1000),
+      _settleSteps(ACC_SETTLE_MS * odrHz / 1000)
+{
+  int32_t min16 = (ONE >> 4) * ACC_MIN_PERCENT / 100;
+  int32_t max16 = (ONE >> 4) * ACC_MAX_PERCENT / 100;
+  _accMin2 = min16 * min16;
+  _accMax2 = max16 * max16;
+  reset();
+}
+
+void TiltEstimator::reset()
+{
+  _gravity[0] = 0;
+  _gravity[1] = 0;
+  _gravity[2] = ONE;
+  _primed = false;
+  _lastTimestamp = 0;
+  _inRangeSince = 0;
+}
+
+void TiltEstimator::addSample(const int16_t acc[3], const int16_t gyro[3], uint32_t timestamp)
+{
+  int32_t a[3];
+  int32_t mag2 = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    a[i] = (int32_t)acc[i] * ONE / _accLsbPerG;
+    int32_t a16 = a[i] >> 4;
+    mag2 += a16 * a16;
+  }
+
+  uint32_t steps = timestamp - _lastTimestamp;
+  _lastTimestamp = timestamp;
+  if (!_primed || steps == 0 || steps > _maxGap)
+  {
+    for (int i = 0; i < 3; i++)
+      _gravity[i] = a[i];
+    _primed = true;
+    _inRangeSince = timestamp;
+    return;
+  }
+
+  // The body turns by w*dt, gravity turns the other way in its frame: dg = g x w dt
+  const int32_t *g = _gravity;
+  int64_t scale = _gyroScale * steps;
+  int32_t dx = (int32_t)(((int64_t)g[1] * gyro[2] - (int64_t)g[2] * gyro[1]) * scale >> 32);
+  int32_t dy = (int32_t)(((int64_t)g[2] * gyro[0] - (int64_t)g[0] * gyro[2]) * scale >> 32);
+  int32_t dz = (int32_t)(((int64_t)g[0] * gyro[1] - (int64_t)g[1] * gyro[0]) * scale >> 32);
+  _gravity[0] += dx;
+  _gravity[1] += dy;
+  _gravity[2] += dz;
+
+  // Only a still-ish accelerometer measures gravity
+  if (mag2 < _accMin2 || mag2 > _accMax2)
+  {
+    _inRangeSince = timestamp;
+    return;
+  }
+  if (timestamp - _inRangeSince < _settleSteps)
+    return;
+  for (int i = 0; i < 3; i++)
+    _gravity[i] += (a[i] - _gravity[i]) >> ACC_SHIFT;
+}
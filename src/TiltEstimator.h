@@ -0,0 +1,47 @@
+#ifndef TILT_ESTIMATOR_H
+#define TILT_ESTIMATOR_H
+
+#include <stdint.h>
+
+// Fixed-point complementary filter: tracks the gravity vector in the IMU frame.
+// The gyro rotates the estimate every sample (dt from the IMU sample counter),
+// the accelerometer pulls it back whenever it reads close to 1 g, so the estimate
+// doesn't drift and isn't thrown off by shakes. Integer math only, so replays of
+// the same trace give the same output on the host and the device.
+class TiltEstimator
+{
+public:
+  static const int32_t ONE = 1 << 14; // 1 g
+
+  TiltEstimator(int32_t accLsbPerG, int32_t gyroLsbPerDps, uint32_t odrHz);
+
+  void reset();
+
+  // Feed one raw sample; timestamp is the IMU sample counter
+  void addSample(const int16_t acc[3], const int16_t gyro[3], uint32_t timestamp);
+
+  // Gravity in the IMU frame, ONE = 1 g. Lying flat: (0, 0, ONE)
+  const int32_t *getGravity() const { return _gravity; }
+
+  // Tuning
+  static const int ACC_SHIFT = 6;     // Accelerometer weight 1/64 per sample, ~0.5 s at 125 Hz
+  static const int32_t ACC_MIN_PERCENT = 70; // Accelerometer trusted between 0.7 g ...
+  static const int32_t ACC_MAX_PERCENT = 130; // ... and 1.3 g
+  static const uint32_t ACC_SETTLE_MS = 48;  // ... once it has stayed there this long (shakes cross 1 g briefly)
+  static const uint32_t MAX_GAP_MS = 250;  // Longer gaps restart from the accelerometer
+
+private:
+  int32_t _accLsbPerG;
+  int64_t _gyroScale; // Rotation per gyro LSB and sample, Q32 radians
+  uint32_t _maxGap;
+  uint32_t _settleSteps;
+  int32_t _accMin2;   // Squared bounds in (g >> 4) units
+  int32_t _accMax2;
+
+  int32_t _gravity[3];
+  bool _primed;
+  uint32_t _lastTimestamp;
+  uint32_t _inRangeSince;
+};
+
+#endif // TILT_ESTIMATOR_H
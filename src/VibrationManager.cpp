@@ -0,0 +1,141 @@
+#include "VibrationManager.h"
+
+static const HapticStep SHORT_BUZZ_STEPS[] = {{255, 100}};
+static const HapticStep MEDIUM_BUZZ_STEPS[] = {{255, 250}};
+static const HapticStep LONG_BUZZ_STEPS[] = {{255, 500}};
+static const HapticStep DOUBLE_BUZZ_STEPS[] = {{255, 100}, {0, 100}, {255, 100}};
+
+const HapticPattern VibrationManager::SHORT_BUZZ = {SHORT_BUZZ_STEPS, 1};
+const HapticPattern VibrationManager::MEDIUM_BUZZ = {MEDIUM_BUZZ_STEPS, 1};
+const HapticPattern VibrationManager::LONG_BUZZ = {LONG_BUZZ_STEPS, 1};
+const HapticPattern VibrationManager::DOUBLE_BUZZ = {DOUBLE_BUZZ_STEPS, 3};
+
+VibrationManager::VibrationManager(uint8_t motor1Pin, uint8_t motor2Pin)
+    : _motor1Pin(motor1Pin), _motor2Pin(motor2Pin), _timer(nullptr), _lock(portMUX_INITIALIZER_UNLOCKED),
+      _steps(nullptr), _count(0), _index(0), _stepEnd(0), _intensity(0), _generation(0) {
+    _single.intensity = 0;
+    _single.ms = 0;
+}
+
+void VibrationManager::begin() {
+    ledcSetup(MOTOR1_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION);
+    ledcSetup(MOTOR2_CHANNEL, PWM_FREQUENCY, PWM_RESOLUTION);
+    ledcAttachPin(_motor1Pin, MOTOR1_CHANNEL);
+    ledcAttachPin(_motor2Pin, MOTOR2_CHANNEL);
+
+    esp_timer_create_args_t args = {};
+    args.callback = onTimer;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "haptics";
+    esp_timer_create(&args, &_timer);
+
+    stop(); // Ensure motors are off initially
+}
+
+void VibrationManager::play(const HapticPattern &pattern) {
+    if (!_timer || pattern.count == 0) {
+        return;
+    }
+    portENTER_CRITICAL(&_lock);
+    _steps = pattern.steps;
+    _count = pattern.count;
+    _index = 0;
+    _stepEnd = esp_timer_get_time();
+    startStep();
+    portEXIT_CRITICAL(&_lock);
+    output();
+}
+
+void VibrationManager::startVibration(unsigned long duration, uint8_t intensity) {
+    if (!_timer) {
+        return;
+    }
+    portENTER_CRITICAL(&_lock);
+    _single.intensity = intensity;
+    _single.ms = duration < 0xFFFF ? duration : 0xFFFF;
+    portEXIT_CRITICAL(&_lock);
+    HapticPattern pattern = {&_single, 1};
+    play(pattern);
+}
+
+void VibrationManager::stop() {
+    portENTER_CRITICAL(&_lock);
+    _steps = nullptr;
+    _intensity = 0;
+    _generation++;
+    portEXIT_CRITICAL(&_lock);
+    output();
+}
+
+bool VibrationManager::isVibrating() const {
+    portENTER_CRITICAL(&_lock);
+    bool playing = _steps != nullptr;
+    portEXIT_CRITICAL(&_lock);
+    return playing;
+}
+
+void VibrationManager::onTimer(void *arg) {
+    VibrationManager *self = (VibrationManager *)arg;
+    portENTER_CRITICAL(&self->_lock);
+    // stop() or play() may have come in while this callback was waiting to run
+    bool due = self->_steps && esp_timer_get_time() >= self->_stepEnd;
+    if (due) {
+        self->_index++;
+        self->startStep();
+    }
+    portEXIT_CRITICAL(&self->_lock);
+    if (due) {
+        self->output();
+    }
+}
+
+// Under _lock: move on to the current step, or finish. Steps end at fixed times from
+// the start of the pattern, a late callback shortens the next step instead of pushing
+// all the ones after it back.
+void VibrationManager::startStep() {
+    _generation++;
+    if (_index >= _count) {
+        _steps = nullptr;
+        _intensity = 0;
+        return;
+    }
+    const HapticStep &step = _steps[_index];
+    _intensity = step.intensity;
+    _stepEnd += (int64_t)step.ms * 1000;
+}
+
+// Outside _lock: LEDC and esp_timer take locks of their own. Sets the motors and the
+// timer to the current state; when play(), stop() or a step came in meanwhile, their
+// output may have gone out before this one, so it's done again.
+void VibrationManager::output() {
+    for (;;) {
+        portENTER_CRITICAL(&_lock);
+        uint32_t generation = _generation;
+        uint8_t intensity = _intensity;
+        bool playing = _steps != nullptr;
+        int64_t stepEnd = _stepEnd;
+        portEXIT_CRITICAL(&_lock);
+
+        setIntensity(intensity);
+        if (_timer) {
+            esp_timer_stop(_timer);
+            if (playing) {
+                int64_t remaining = stepEnd - esp_timer_get_time();
+                esp_timer_start_once(_timer, remaining > 0 ? remaining : 0);
+            }
+        }
+
+        portENTER_CRITICAL(&_lock);
+        bool current = generation == _generation;
+        portEXIT_CRITICAL(&_lock);
+        if (current) {
+            return;
+        }
+    }
+}
+
+void VibrationManager::setIntensity(uint8_t intensity) {
+    ledcWrite(MOTOR1_CHANNEL, intensity);
+    ledcWrite(MOTOR2_CHANNEL, intensity);
+}
@@ -2,72 +2,78 @@
 #define VIBRATION_MANAGER_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 
+// One step of a haptic pattern: both motors at intensity (0 off, 255 full) for ms
+struct HapticStep {
+    uint8_t intensity;
+    uint16_t ms;
+};
+
+struct HapticPattern {
+    const HapticStep *steps;
+    uint8_t count;
+};
+
+// Plays haptic patterns on the two motors. The intensity is the LEDC PWM duty, and the
+// steps are advanced by an esp_timer callback, so a pattern keeps its timing while the
+// loop renders, waits on an upload or sleeps, and nothing has to be polled.
 class VibrationManager {
 public:
     // Constructor
-    VibrationManager(uint8_t motor1Pin = 5, uint8_t motor2Pin = 13) 
-        : _motor1Pin(motor1Pin), _motor2Pin(motor2Pin), _isVibrating(false), _startTime(0), _duration(0) {}
+    VibrationManager(uint8_t motor1Pin = 5, uint8_t motor2Pin = 13);
 
     // Initialize the vibration motors
-    void begin() {
-        pinMode(_motor1Pin, OUTPUT);
-        pinMode(_motor2Pin, OUTPUT);
-        stop(); // Ensure motors are off initially
-    }
+    void begin();
+
+    // Play a pattern from its first step, replacing whatever is playing.
+    // The steps must outlive the pattern.
+    void play(const HapticPattern &pattern);
 
     // Start vibration for a specific duration
-    void startVibration(unsigned long duration) {
-        _isVibrating = true;
-        _startTime = millis();
-        _duration = duration;
-        digitalWrite(_motor1Pin, HIGH);
-        digitalWrite(_motor2Pin, HIGH);
-    }
+    void startVibration(unsigned long duration, uint8_t intensity = 255);
 
     // Stop vibration immediately
-    void stop() {
-        _isVibrating = false;
-        digitalWrite(_motor1Pin, LOW);
-        digitalWrite(_motor2Pin, LOW);
-    }
-
-    // Update function to be called in the main loop
-    void update() {
-        if (_isVibrating && (millis() - _startTime >= _duration)) {
-            stop();
-        }
-    }
+    void stop();
 
     // Predefined vibration patterns
-    void shortBuzz() {
-        startVibration(100); // 100ms vibration
-    }
+    static const HapticPattern SHORT_BUZZ;
+    static const HapticPattern MEDIUM_BUZZ;
+    static const HapticPattern LONG_BUZZ;
+    static const HapticPattern DOUBLE_BUZZ;
 
-    void mediumBuzz() {
-        startVibration(250); // 250ms vibration
-    }
+    void shortBuzz() { play(SHORT_BUZZ); }
+    void mediumBuzz() { play(MEDIUM_BUZZ); }
+    void longBuzz() { play(LONG_BUZZ); }
+    void doubleBuzz() { play(DOUBLE_BUZZ); }
 
-    void longBuzz() {
-        startVibration(500); // 500ms vibration
-    }
-
-    void doubleBuzz() {
-        startVibration(100);
-        delay(100);
-        startVibration(100);
-    }
-
-    bool isVibrating() const {
-        return _isVibrating;
-    }
+    bool isVibrating() const;
 
 private:
+    // LEDC channels 0 and 1; analogWrite() (the backlight) takes channels from the top
+    static const uint8_t MOTOR1_CHANNEL = 0;
+    static const uint8_t MOTOR2_CHANNEL = 1;
+    static const uint32_t PWM_FREQUENCY = 20000; // Above hearing, the motors whine at lower ones
+    static const uint8_t PWM_RESOLUTION = 8;
+
     uint8_t _motor1Pin;
     uint8_t _motor2Pin;
-    bool _isVibrating;
-    unsigned long _startTime;
-    unsigned long _duration;
+    esp_timer_handle_t _timer;
+    mutable portMUX_TYPE _lock; // The timer callback runs on the esp_timer task
+
+    // Pattern being played, guarded by _lock
+    const HapticStep *_steps;
+    uint8_t _count;
+    uint8_t _index;
+    int64_t _stepEnd; // esp_timer time the current step ends
+    uint8_t _intensity; // of the current step, 0 when stopped
+    uint32_t _generation; // Counts the changes, output() checks it went out the latest
+    HapticStep _single; // Backs startVibration()
+
+    static void onTimer(void *arg);
+    void startStep();
+    void output();
+    void setIntensity(uint8_t intensity);
 };
 
-#endif // VIBRATION_MANAGER_H
\ No newline at end of file
+#endif // VIBRATION_MANAGER_H
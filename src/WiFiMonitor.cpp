@@ -0,0 +1,254 @@
+#include "WiFiMonitor.h"
+
+WiFiMonitor::WiFiMonitor()
+    : _events(nullptr),
+      _wake(nullptr),
+      _state(State::CONNECTING),
+      _managing(false),
+      _channel(0),
+      _attempts(0),
+      _attemptFast(false),
+      _retryDelay(RETRY_DELAY_MIN),
+      _retryPending(false),
+      _nextAttempt(0),
+      _lostUs(0),
+      _suspended(false),
+      _suspendedOnline(false),
+      _powerSave(WIFI_PS_MIN_MODEM),
+      _transfers(0),
+      _queueOverflows(0),
+      _drops(0),
+      _lastDetectUs(0),
+      _maxDetectUs(0),
+      _lastReconnectMs(0),
+      _maxReconnectMs(0),
+      _fastReconnects(0),
+      _scanReconnects(0)
+{
+  memset(_ssid, 0, sizeof(_ssid));
+  memset(_psk, 0, sizeof(_psk));
+  memset(_bssid, 0, sizeof(_bssid));
+}
+
+void WiFiMonitor::begin(void (*wake)())
+{
+  _wake = wake;
+  _events = xQueueCreate(EVENT_QUEUE_LENGTH, sizeof(Event));
+  WiFi.onEvent([this](arduino_event_id_t id, arduino_event_info_t info)
+               { onEvent(id, info); });
+}
+
+// Runs on the driver's event task: copy what the loop needs and queue it
+void WiFiMonitor::onEvent(arduino_event_id_t id, arduino_event_info_t info)
+{
+  if (id != ARDUINO_EVENT_WIFI_STA_CONNECTED && id != ARDUINO_EVENT_WIFI_STA_DISCONNECTED &&
+      id != ARDUINO_EVENT_WIFI_STA_GOT_IP && id != ARDUINO_EVENT_WIFI_STA_LOST_IP)
+  {
+    return;
+  }
+
+  Event e;
+  memset(&e, 0, sizeof(e));
+  e.id = id;
+  e.us = micros();
+  if (id == ARDUINO_EVENT_WIFI_STA_CONNECTED)
+  {
+    const wifi_event_sta_connected_t &c = info.wifi_sta_connected;
+    memcpy(e.ssid, c.ssid, c.ssid_len < sizeof(e.ssid) - 1 ? c.ssid_len : sizeof(e.ssid) - 1);
+    memcpy(e.bssid, c.bssid, sizeof(e.bssid));
+    e.channel = c.channel;
+  }
+  else if (id == ARDUINO_EVENT_WIFI_STA_DISCONNECTED)
+  {
+    e.reason = info.wifi_sta_disconnected.reason;
+  }
+
+  if (xQueueSend(_events, &e, 0) != pdPASS)
+  {
+    _queueOverflows.fetch_add(1, std::memory_order_relaxed);
+  }
+  else if (_wake)
+  {
+    _wake();
+  }
+}
+
+bool WiFiMonitor::update(bool settled)
+{
+  if (!_events)
+    return false;
+
+  bool changed = false;
+  Event e;
+  while (xQueueReceive(_events, &e, 0) == pdTRUE)
+  {
+    changed = handle(e) || changed;
+  }
+
+  // The first connect is over and it didn't work out, WiFiManager's portal takes it from here
+  if (settled && _state == State::CONNECTING && WiFi.status() != WL_CONNECTED)
+  {
+    _state = State::OFFLINE;
+    changed = true;
+  }
+
+  if (_retryPending && (long)(millis() - _nextAttempt) >= 0)
+  {
+    attempt();
+  }
+  return changed;
+}
+
+bool WiFiMonitor::handle(const Event &e)
+{
+  switch (e.id)
+  {
+  case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+    memcpy(_ssid, e.ssid, sizeof(_ssid));
+    memcpy(_bssid, e.bssid, sizeof(_bssid));
+    _channel = e.channel;
+    return false;
+
+  case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+    if (_state == State::ONLINE)
+      return false;
+    _state = State::ONLINE;
+    snprintf(_psk, sizeof(_psk), "%s", WiFi.psk().c_str());
+    if (!_managing)
+    {
+      WiFi.setAutoReconnect(false);
+      _managing = true;
+    }
+    if (_lostUs)
+    {
+      _lastReconnectMs = (e.us - _lostUs) / 1000;
+      if (_lastReconnectMs > _maxReconnectMs)
+        _maxReconnectMs = _lastReconnectMs;
+      if (_attemptFast)
+        _fastReconnects++;
+      else
+        _scanReconnects++;
+      Serial.printf("WiFi: back after %lu ms (%s, attempt %lu)\n", _lastReconnectMs,
+                    _attemptFast ? "fast" : "scan", (unsigned long)_attempts);
+    }
+    _attempts = 0;
+    _retryPending = false;
+    _retryDelay = RETRY_DELAY_MIN;
+    _lostUs = 0;
+    WiFi.setSleep(_transfers ? WIFI_PS_NONE : _powerSave);
+    return true;
+
+  case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+  case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+    if (_state == State::ONLINE)
+    {
+      _state = State::OFFLINE;
+      _lostUs = e.us;
+      _drops++;
+      _lastDetectUs = micros() - e.us;
+      if (_lastDetectUs > _maxDetectUs)
+        _maxDetectUs = _lastDetectUs;
+      Serial.printf("WiFi: lost (reason %u), seen by the loop %lu us after the event\n", e.reason, _lastDetectUs);
+      if (_managing)
+      {
+        _retryPending = true;
+        _nextAttempt = millis();
+      }
+      return true;
+    }
+    // One of our attempts failed, unless it's the station leaving on suspend()
+    if (_state == State::OFFLINE && _attempts && e.reason != WIFI_REASON_ASSOC_LEAVE)
+    {
+      scheduleRetry();
+    }
+    return false;
+
+  default:
+    return false;
+  }
+}
+
+void WiFiMonitor::scheduleRetry()
+{
+  _retryPending = true;
+  _nextAttempt = millis() + _retryDelay;
+  _retryDelay = _retryDelay * 2 < RETRY_DELAY_MAX ? _retryDelay * 2 : RETRY_DELAY_MAX;
+}
+
+void WiFiMonitor::attempt()
+{
+  _attempts++;
+  _attemptFast = _channel && _attempts % FULL_SCAN_EVERY != 0;
+
+  if (_attemptFast)
+    WiFi.begin(_ssid, _psk, _channel, _bssid);
+  else
+    WiFi.begin(_ssid, _psk);
+
+  // Try again if the driver doesn't report back
+  _retryPending = true;
+  _nextAttempt = millis() + ATTEMPT_TIMEOUT;
+}
+
+void WiFiMonitor::suspend()
+{
+  if (!_managing || _suspended)
+    return;
+  _suspended = true;
+  _suspendedOnline = _state == State::ONLINE;
+  // Not a drop: the UI keeps showing online through the standby
+  _state = State::OFFLINE;
+  _retryPending = false;
+  // Keeps the saved credentials, only the radio goes off
+  WiFi.disconnect(true);
+}
+
+void WiFiMonitor::resume()
+{
+  if (!_suspended)
+    return;
+  _suspended = false;
+  if (_suspendedOnline || !_lostUs)
+    _lostUs = micros();
+  _suspendedOnline = false;
+  _attempts = 0;
+  _retryDelay = RETRY_DELAY_MIN;
+  attempt();
+}
+
+uint8_t WiFiMonitor::getAccessPoint(uint8_t bssid[6]) const
+{
+  if (_state != State::ONLINE && !_suspendedOnline)
+    return 0;
+  memcpy(bssid, _bssid, sizeof(_bssid));
+  return _channel;
+}
+
+void WiFiMonitor::setPowerSave(wifi_ps_type_t mode)
+{
+  _powerSave = mode;
+  if (!_transfers)
+    WiFi.setSleep(mode);
+}
+
+void WiFiMonitor::beginTransfer()
+{
+  if (_transfers++ == 0 && _powerSave != WIFI_PS_NONE)
+    WiFi.setSleep(WIFI_PS_NONE);
+}
+
+void WiFiMonitor::endTransfer()
+{
+  if (_transfers > 0 && --_transfers == 0 && _powerSave != WIFI_PS_NONE)
+    WiFi.setSleep(_powerSave);
+}
+
+void WiFiMonitor::printStats()
+{
+  Serial.printf("WiFi: %s, %lu drops, event to loop %lu us (max %lu), reconnect %lu ms (max %lu), "
+                "%lu fast, %lu scan, %lu events lost\n",
+                _state == State::ONLINE ? "online" : (_state == State::OFFLINE ? "offline" : "connecting"),
+                (unsigned long)_drops, _lastDetectUs, _maxDetectUs, _lastReconnectMs, _maxReconnectMs,
+                (unsigned long)_fastReconnects, (unsigned long)_scanReconnects,
+                (unsigned long)_queueOverflows.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,118 @@
+#ifndef WIFI_MONITOR_H
+#define WIFI_MONITOR_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <atomic>
+
+// Follows the station's connection through the WiFi driver's events instead of polling.
+// The events arrive on the driver's event task and are queued; update() handles them
+// on the loop, the only place the state changes, so the UI is never touched from
+// another task. Once online, it takes over reconnecting from the Arduino core: straight
+// to the last access point's channel and BSSID, with a full scan now and then in case
+// the access point moved. The modem's power save is relaxed while a transfer is in flight.
+// The station is stopped for the light standby, which the access point would drop it in,
+// and rejoins the same way on wake.
+class WiFiMonitor
+{
+public:
+  enum class State : uint8_t
+  {
+    CONNECTING, // Not online yet since boot
+    ONLINE,     // Has an IP address
+    OFFLINE     // Lost it, or the first connect failed
+  };
+
+  WiFiMonitor();
+
+  // Register for the driver's events, call before the station is started.
+  // wake: called on the driver's event task after an event was queued, to have update() run soon
+  void begin(void (*wake)() = nullptr);
+
+  // Call from the loop: handles the queued events and runs the reconnects.
+  // settled: the first connect is over (WiFiManager's autoConnect returned).
+  // Returns true when the state changed.
+  bool update(bool settled);
+  State getState() const { return _state; }
+  bool isOnline() const { return _state == State::ONLINE; }
+
+  // Modem power save while idle (WIFI_PS_MIN_MODEM by default), none during transfers
+  void setPowerSave(wifi_ps_type_t mode);
+  void beginTransfer();
+  void endTransfer();
+
+  // Around the light standby: stop the station, and rejoin on the last channel and BSSID
+  // on wake. Only once online, before that the connect is WiFiManager's.
+  void suspend();
+  void resume();
+
+  // Channel of the access point to rejoin after a standby, 0 when there's none:
+  // online, or suspended while online. Its BSSID goes to bssid.
+  uint8_t getAccessPoint(uint8_t bssid[6]) const;
+
+  void printStats();
+
+private:
+  struct Event
+  {
+    arduino_event_id_t id;
+    unsigned long us; // micros() when the driver posted it
+    uint8_t reason;
+    uint8_t channel;
+    uint8_t bssid[6];
+    char ssid[33];
+  };
+
+  // Reconnect attempts: fast ones on the known channel and BSSID, every
+  // FULL_SCAN_EVERY-th a full scan; the delay between them doubles up to the max
+  static const uint32_t EVENT_QUEUE_LENGTH = 16;
+  static const uint32_t FULL_SCAN_EVERY = 3;
+  static const unsigned long RETRY_DELAY_MIN = 500;
+  static const unsigned long RETRY_DELAY_MAX = 30000;
+  static const unsigned long ATTEMPT_TIMEOUT = 8000; // No event by then counts as a failure
+
+  QueueHandle_t _events;
+  void (*_wake)();
+  State _state;
+  bool _managing; // Reconnects are ours, the core's auto reconnect is off
+
+  // Last connection. The passphrase isn't in the events, and the core only has it
+  // while the station is started, so it's saved once online.
+  char _ssid[33];
+  char _psk[65];
+  uint8_t _bssid[6];
+  uint8_t _channel;
+
+  // Reconnects
+  uint32_t _attempts;
+  bool _attemptFast;
+  unsigned long _retryDelay;
+  bool _retryPending;
+  unsigned long _nextAttempt; // millis() of the next attempt
+  unsigned long _lostUs;      // Driver time of the disconnect
+
+  // Standby
+  bool _suspended;
+  bool _suspendedOnline;
+
+  // Power save
+  wifi_ps_type_t _powerSave;
+  int _transfers;
+
+  // Statistics
+  std::atomic<uint32_t> _queueOverflows;
+  uint32_t _drops;
+  unsigned long _lastDetectUs; // Disconnect event to the loop handling it
+  unsigned long _maxDetectUs;
+  unsigned long _lastReconnectMs; // Disconnect to online again
+  unsigned long _maxReconnectMs;
+  uint32_t _fastReconnects;
+  uint32_t _scanReconnects;
+
+  void onEvent(arduino_event_id_t id, arduino_event_info_t info);
+  bool handle(const Event &e);
+  void scheduleRetry();
+  void attempt();
+};
+
+#endif // WIFI_MONITOR_H
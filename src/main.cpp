@@ -12,6 +12,14 @@
 #include "VibrationManager.h"
 #include "LEDLogger.h"
 #include "Environment.h"
+#include "RefreshController.h"
+#include "MotionSampler.h"
+#include "ShakeDetector.h"
+#include "TiltEstimator.h"
+#include "BootSequence.h"
+#include "DeepStandby.h"
+#include "WiFiMonitor.h"
+#include "Scheduler.h"
 
 // Display configuration
 static const uint16_t screenWidth = 240;
@@ -24,6 +32,14 @@ AnimationManager animations(screenWidth, screenHeight);
 TextStateManager textManager;
 VibrationManager vibration(45,46);
 LEDLogger ledLogger(3);
+RefreshController refresh;
+MotionSampler motion;
+ShakeDetector shakeDetector(MotionSampler::ACC_LSB_PER_G, MotionSampler::ODR_HZ);
+TiltEstimator tilt(MotionSampler::ACC_LSB_PER_G, MotionSampler::GYRO_LSB_PER_DPS, MotionSampler::ODR_HZ);
+BootSequence boot;
+DeepStandby deepStandby;
+WiFiMonitor wifiMonitor;
+Scheduler scheduler;
 
 // State variables
 bool isShaking = false;
@@ -32,11 +48,33 @@ bool isShowingResponse = false;             // Add this to track response state
 unsigned long responseStartTime = 0;        // Rename for clarity
 unsigned long lastShakeTime = 0;
 unsigned long responseDisplayStart = 0;
-float acc[3], gyro[3], totalAccel, totalGyro;
-unsigned int tim_count = 0;
-const float ACCEL_THRESHOLD = 5000.0f;
-unsigned long lastShakeCheck = 0;
+unsigned long lastRecordingUpdate = 0;
 const int RESPONSE_DISPLAY_DURATION = 7000;
+const unsigned long UPDATE_INTERVAL = 16;
+unsigned long lastActivityTime = 0;
+unsigned long lastInteractionTime = 0;        // Like lastActivityTime, but wakes that weren't a shake don't count
+bool standbyWoke = false;                     // Woke from a standby, until the next recording
+unsigned long standbyWakeUs = 0;              // micros() of that wake, 0 on a reset from deep standby
+const unsigned long STANDBY_AFTER = 20000;    // Idle time before the motion standby
+const unsigned long STANDBY_REARM = 3000;     // Back to standby this soon if a wake wasn't a shake
+unsigned long deepStandbyAfter = 300000;      // Untouched time before the deep standby, 0: never (DEEP_STANDBY_SECONDS)
+const unsigned long WIFI_RECONNECT_TIMEOUT = 2000; // Rejoining the last access point after a deep standby
+const float ACTIVITY_GYRO_THRESHOLD = 5.0f;   // Turning the ball by hand keeps it awake
+int wifiStage = -1;                           // Boot stage that connects, WiFiManager is ours once it's done
+const uint32_t WIFI_STAGE_STACK = 8192;
+const uint32_t IMU_STAGE_STACK = 3072;
+TextStateManager::DisplayState lastDisplayState = TextStateManager::DisplayState::ERROR;
+
+// Jobs of the loop
+int wifiJob = Scheduler::NO_JOB;
+int bootJob = Scheduler::NO_JOB;
+int serialJob = Scheduler::NO_JOB;
+int displayJob = Scheduler::NO_JOB;
+int uiJob = Scheduler::NO_JOB;
+int recorderJob = Scheduler::NO_JOB;
+const uint32_t WIFI_INTERVAL = 50;
+const uint32_t BOOT_INTERVAL = 10;
+const uint32_t SERIAL_INTERVAL = 50;
 
 // Magic 8 ball responses
 const char *responses[] = {
@@ -49,12 +87,180 @@ const char *responses[] = {
     "Very doubtful",
     "Concentrate and ask again"};
 
-bool checkForShake()
+const char *displayStateName(TextStateManager::DisplayState state)
 {
-  QMI8658_read_xyz(acc, gyro, &tim_count);
-  totalAccel = sqrt((acc[0] * acc[0]) + (acc[1] * acc[1]) + (acc[2] * acc[2]));
-  totalGyro = sqrt((gyro[0] * gyro[0]) + (gyro[1] * gyro[1]) + (gyro[2] * gyro[2]));
-  return (totalAccel > ACCEL_THRESHOLD);
+  switch (state)
+  {
+  case TextStateManager::DisplayState::IDLE:      return "IDLE";
+  case TextStateManager::DisplayState::RECORDING: return "RECORDING";
+  case TextStateManager::DisplayState::THINKING:  return "THINKING";
+  case TextStateManager::DisplayState::RESPONSE:  return "RESPONSE";
+  default:                                        return "ERROR";
+  }
+}
+
+void enterDeepStandby();
+
+// Serial console commands, one per line:
+//   prof        dump the frame profiler histograms as CSV
+//   prof reset  clear them
+//   sleep       deep standby right away, e.g. to measure its current
+//   wifi        connection state, drops and reconnect times
+//   jobs        run time and lateness of the loop's jobs
+//   mem         LVGL's pools, size classes and layer buffers
+void printMemStats()
+{
+  lv_mem_monitor_t mon;
+  lv_mem_monitor(&mon);
+  Serial.printf("main  %7lu B, used %3d%% (max %lu B), frag %3d%%\n", (unsigned long)mon.total_size, mon.used_pct,
+                (unsigned long)mon.max_used, mon.frag_pct);
+  lv_mem_fast_monitor(&mon);
+  Serial.printf("fast  %7lu B, used %3d%% (max %lu B), frag %3d%%\n", (unsigned long)mon.total_size, mon.used_pct,
+                (unsigned long)mon.max_used, mon.frag_pct);
+
+  Serial.printf("%6s %6s %8s %8s %10s %9s\n", "class", "pages", "used", "max", "allocs", "fallback");
+  for (uint32_t i = 0; i < lv_mem_class_count(); i++)
+  {
+    lv_mem_class_monitor_t c;
+    lv_mem_class_monitor(i, &c);
+    Serial.printf("%6u %6u %8lu %8lu %10lu %9lu\n", c.block_size, c.page_cnt, (unsigned long)c.used_cnt,
+                  (unsigned long)c.max_used_cnt, (unsigned long)c.alloc_cnt, (unsigned long)c.fallback_cnt);
+  }
+
+  lv_draw_sw_layer_pool_monitor_t layers;
+  lv_draw_sw_layer_pool_monitor(&layers);
+  Serial.printf("layers %lu B in %lu buffers (max %lu of %lu B), %lu reused, %lu allocated, %lu outside the pool\n",
+                (unsigned long)layers.size, (unsigned long)layers.buf_cnt, (unsigned long)layers.max_size,
+                (unsigned long)LV_LAYER_POOL_SIZE, (unsigned long)layers.reuse_cnt, (unsigned long)layers.alloc_cnt,
+                (unsigned long)layers.unpooled_cnt);
+
+  lv_font_fmt_txt_cache_monitor_t glyphs;
+  lv_font_fmt_txt_cache_monitor(&glyphs);
+  Serial.printf("glyphs %lu of %lu B, %lu hits, %lu misses (%u%% hits)\n", (unsigned long)glyphs.used_size,
+                (unsigned long)glyphs.total_size, (unsigned long)glyphs.hit_cnt, (unsigned long)glyphs.miss_cnt,
+                glyphs.hit_pct);
+}
+
+void handleSerialCommands()
+{
+  static char line[32];
+  static size_t len = 0;
+
+  while (Serial.available() > 0)
+  {
+    char c = (char)Serial.read();
+    if (c != '\n' && c != '\r')
+    {
+      if (len < sizeof(line) - 1)
+        line[len++] = c;
+      continue;
+    }
+    if (len == 0)
+      continue;
+    line[len] = '\0';
+    len = 0;
+
+    if (strcmp(line, "prof") == 0 || strcmp(line, "prof reset") == 0)
+    {
+#if LV_USE_REFR_PROFILER
+      if (strcmp(line, "prof") == 0)
+        lv_refr_prof_dump([](const char *csv) { Serial.println(csv); });
+      else
+        lv_refr_prof_reset();
+#else
+      Serial.println("Frame profiler disabled, set LV_USE_REFR_PROFILER in lv_conf.h");
+#endif
+    }
+    else if (strcmp(line, "sleep") == 0)
+    {
+      enterDeepStandby();
+    }
+    else if (strcmp(line, "wifi") == 0)
+    {
+      wifiMonitor.printStats();
+    }
+    else if (strcmp(line, "jobs") == 0)
+    {
+      scheduler.printStats();
+    }
+    else if (strcmp(line, "mem") == 0)
+    {
+      printMemStats();
+    }
+    else
+    {
+      Serial.printf("Unknown command: %s\n", line);
+    }
+  }
+}
+
+// Sleep until the IMU sees motion, with the last frame left on the panel
+void enterStandby()
+{
+  Serial.println("Entering motion standby");
+  refresh.beginPhase("STANDBY");
+  lv_refr_now(NULL);
+
+  // Wake up for the deep standby if nothing happens before
+  unsigned long timeout = 0;
+  if (deepStandbyAfter)
+  {
+    unsigned long untouched = millis() - lastInteractionTime;
+    timeout = untouched < deepStandbyAfter ? deepStandbyAfter - untouched : 1;
+  }
+
+  // The access point drops a station that sleeps through its beacons, rejoin on wake instead
+  wifiMonitor.suspend();
+  unsigned long slept = motion.sleepUntilMotion(timeout);
+  refresh.addSleepTime(slept);
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER)
+  {
+    enterDeepStandby();
+    return;
+  }
+  wifiMonitor.resume();
+  standbyWoke = true;
+  standbyWakeUs = micros();
+  Serial.printf("Woke from standby after %lu ms\n", slept / 1000);
+  scheduler.resume();
+  refresh.beginPhase(displayStateName(lastDisplayState));
+
+  // A bump that isn't followed by a shake goes back to standby soon
+  lastActivityTime = millis() - (STANDBY_AFTER - STANDBY_REARM);
+}
+
+// Long untouched: everything but the IMU and the RTC powers down, the next motion
+// resets the chip and setup() draws the same frame again
+void enterDeepStandby()
+{
+  Serial.println("Entering deep standby");
+  DeepStandby::UiState ui;
+  animations.getTrianglePosition(&ui.triangleX, &ui.triangleY);
+
+  vibration.stop();
+  ledLogger.clear(); // The LED latches its color while powered
+  animations.sleepDisplay();
+  int wakeLevel = motion.armWakeOnMotion();
+  uint8_t bssid[6];
+  uint8_t channel = wifiMonitor.getAccessPoint(bssid);
+  deepStandby.enter(ui, channel, bssid, (gpio_num_t)DEV_INT1_PIN, wakeLevel);
+}
+
+// Runs the new samples through the shake classifier and the tilt model, true on a shake
+bool processMotion()
+{
+  if (!motion.update())
+    return false;
+
+  // Every sample of the batch goes through, not just the last one
+  bool shake = false;
+  const QMI8658Sample *samples = motion.getSamples();
+  for (int i = 0; i < motion.getBatchSize(); i++)
+  {
+    shake = shakeDetector.addSample(samples[i].acc_raw, samples[i].timestamp) || shake;
+    tilt.addSample(samples[i].acc_raw, samples[i].gyro_raw, samples[i].timestamp);
+  }
+  return shake;
 }
 
 void uploadWAVFile(uint8_t *buffer, size_t bufferSize)
@@ -81,6 +287,7 @@ void uploadWAVFile(uint8_t *buffer, size_t bufferSize)
 
   HTTPClient http;
   Serial.printf("Uploading WAV file (%d bytes) to val.town\n", bufferSize);
+  wifiMonitor.beginTransfer(); // No modem sleep between the packets
   http.begin(valtownUrl);
 
   // Set headers for multipart form data and authentication
@@ -103,6 +310,7 @@ void uploadWAVFile(uint8_t *buffer, size_t bufferSize)
   {
     Serial.println("Failed to allocate memory for POST data");
     http.end();
+    wifiMonitor.endTransfer();
     return;
   }
 
@@ -231,6 +439,7 @@ void uploadWAVFile(uint8_t *buffer, size_t bufferSize)
   }
 
   http.end();
+  wifiMonitor.endTransfer();
 }
 
 void uploadWAVFileLocal(uint8_t *buffer, size_t bufferSize)
@@ -247,7 +456,7 @@ void uploadWAVFileLocal(uint8_t *buffer, size_t bufferSize)
   const char *uploadEndpoint = "http://192.168.1.108:5000/upload_wav";
 
   Serial.printf("Uploading WAV file (%d bytes) to %s\n", bufferSize, uploadEndpoint);
-
+  wifiMonitor.beginTransfer(); // No modem sleep between the packets
   http.begin(uploadEndpoint);
 
   // Set headers for multipart form data
@@ -270,6 +479,7 @@ void uploadWAVFileLocal(uint8_t *buffer, size_t bufferSize)
   {
     Serial.println("Failed to allocate memory for POST data");
     http.end();
+    wifiMonitor.endTransfer();
     return;
   }
 
@@ -305,106 +515,85 @@ void uploadWAVFileLocal(uint8_t *buffer, size_t bufferSize)
   }
 
   http.end();
+  wifiMonitor.endTransfer();
 }
 
-// WiFi status update task
-void updateWiFiStatus(void *parameter)
+// Offline shows on the idle screen, a recording or an answer in progress carries on
+void showWiFiState()
 {
-  TextStateManager *textManager = (TextStateManager *)parameter;
-  for (;;)
+  TextStateManager::DisplayState state = textManager.getState();
+  if (state != TextStateManager::DisplayState::IDLE && state != TextStateManager::DisplayState::ERROR)
   {
-    if (WiFi.status() != WL_CONNECTED)
-    {
-      textManager->setState(TextStateManager::DisplayState::ERROR);
-      ledLogger.setState(LEDLogger::SystemState::ERROR, LEDLogger::LEDPattern::BLINK);
-    }
-    else if (textManager->getState() == TextStateManager::DisplayState::ERROR)
-    {
-      textManager->setState(TextStateManager::DisplayState::IDLE);
-    }
-    vTaskDelay(pdMS_TO_TICKS(30000));
-  }
-}
-
-void setup()
-{
-  Serial.begin(115200);
-
-  ledLogger.begin();
-  ledLogger.setState(LEDLogger::SystemState::STARTUP, LEDLogger::LEDPattern::PULSE);
-
-  if (psramInit())
-  {
-    Serial.printf("PSRAM initialized. Size: %d MB\n", ESP.getPsramSize() / 1024 / 1024);
-    Serial.printf("Free PSRAM: %d KB\n", ESP.getFreePsram() / 1024);
-  }
-  else
-  {
-    Serial.println("PSRAM initialization failed!");
+    return;
   }
-  if (Environment::begin())
+  if (wifiMonitor.isOnline())
   {
-    Serial.println("Environment loaded successfully");
-    Serial.println("ValTown URL: " + Environment::getEnv("VALTOWN_URL"));
-    // Serial.println("Device Token: " + Environment::getEnv("DEVICE_TOKEN"));
+    textManager.setState(TextStateManager::DisplayState::IDLE);
+    ledLogger.setState(LEDLogger::SystemState::NORMAL);
   }
-  else
+  else if (wifiMonitor.getState() == WiFiMonitor::State::OFFLINE)
   {
-    Serial.println("Failed to load environment configuration");
+    textManager.setState(TextStateManager::DisplayState::ERROR);
+    ledLogger.setState(LEDLogger::SystemState::ERROR, LEDLogger::LEDPattern::BLINK);
   }
-  // Initialize hardware
+}
+
+// Boot stages, see setup() for what runs when
+bool bootWiFi()
+{
+  WiFi.mode(WIFI_STA);
+  IPAddress portalIP(8, 8, 4, 4);
+  IPAddress gateway(8, 8, 4, 4);
+  IPAddress subnet(255, 255, 255, 0);
+  wifiManager.setAPStaticIPConfig(portalIP, gateway, subnet);
+  wifiManager.setConfigPortalTimeout(180);
+  wifiManager.setConfigPortalBlocking(false);
+  // After a deep standby the access point is known, no need to scan for it
+  // The loop learns the outcome from wifiMonitor
+  return deepStandby.reconnect(wifiManager.getWiFiSSID(), wifiManager.getWiFiPass(), WIFI_RECONNECT_TIMEOUT) ||
+         wifiManager.autoConnect("MagicGPT8Ball");
+}
+
+bool bootHardware()
+{
   if (DEV_Module_Init() != 0)
   {
     Serial.println("DEV_Module_Init failed!");
+    return false;
   }
-  else
-  {
-    Serial.println("DEV_Module_Init success!");
-  }
+  Serial.println("DEV_Module_Init success!");
+  return true;
+}
 
-  // Initialize sensors
+bool bootImu()
+{
   Serial.println("Initializing QMI8658...");
-  if (QMI8658_init())
-  {
-    Serial.println("QMI8658 init success!");
-  }
-  else
+  if (!QMI8658_init())
   {
     Serial.println("QMI8658 init failed!");
+    return false;
   }
+  Serial.println("QMI8658 init success!");
+  motion.begin();
+  motion.startTask();
+  return true;
+}
 
-  // Initialize display and animations
+bool bootDisplay()
+{
   if (!animations.begin())
   {
-    Serial.println("Failed to initialize display!");
-    return;
+    return false;
   }
   animations.initializeTriangle();
+  refresh.begin();
+  return true;
+}
 
-  vibration.begin();
-  vibration.shortBuzz(); // Indicate startup
-
-  // Initialize WiFi
-  WiFi.mode(WIFI_STA);
-  IPAddress portalIP(8, 8, 4, 4);
-  IPAddress gateway(8, 8, 4, 4);
-  IPAddress subnet(255, 255, 255, 0);
-  wifiManager.setAPStaticIPConfig(portalIP, gateway, subnet);
-  wifiManager.setConfigPortalTimeout(180);
-  wifiManager.setConfigPortalBlocking(false);
-  wifiManager.autoConnect("MagicGPT8Ball");
-
-  // Start WiFi monitoring task
-  xTaskCreate(
-      updateWiFiStatus,
-      "WiFiStatus",
-      2048,
-      &textManager, // Pass textManager as parameter
-      1,
-      NULL);
-
-  // Initialize audio recorder
-  if (!recorder.begin())
+bool bootRecorder()
+{
+  bool ok = recorder.begin();
+  if (!ok)
   {
     Serial.println("Failed to initialize audio recorder!");
   }
@@ -415,132 +604,296 @@ void setup()
 
   // Random seed for responses
   randomSeed(analogRead(2));
+  return ok;
+}
 
-  if (WiFi.status() == WL_CONNECTED)
+bool bootEnvironment()
+{
+  if (!Environment::begin())
   {
-    ledLogger.setState(LEDLogger::SystemState::NORMAL);
+    Serial.println("Failed to load environment configuration");
+    return false;
   }
-  Serial.println("Initialization Complete!");
-  textManager.setState(TextStateManager::DisplayState::IDLE);
+  Serial.println("Environment loaded successfully");
+  Serial.println("ValTown URL: " + Environment::getEnv("VALTOWN_URL"));
+  String powerSave = Environment::getEnv("WIFI_POWER_SAVE");
+  if (powerSave == "none")
+    wifiMonitor.setPowerSave(WIFI_PS_NONE);
+  else if (powerSave == "max")
+    wifiMonitor.setPowerSave(WIFI_PS_MAX_MODEM);
+  String deepStandbySeconds = Environment::getEnv("DEEP_STANDBY_SECONDS");
+  if (!deepStandbySeconds.isEmpty())
+  {
+    deepStandbyAfter = (unsigned long)deepStandbySeconds.toInt() * 1000;
+  }
+  // Serial.println("Device Token: " + Environment::getEnv("DEVICE_TOKEN"));
+  return true;
 }
 
-void loop()
+// Jobs of the loop, run by the scheduler
+
+// WiFiManager's portal and the connection state, right away when the driver reports a change
+void serviceWiFi()
 {
-  unsigned long currentTime = millis();
-  
-  // Priority 1: Handle WiFi manager and essential LVGL tasks
-  wifiManager.process();
-  lv_timer_handler();
-  vibration.update();
-  ledLogger.update();
+  if (boot.isDone(wifiStage))
+  {
+    wifiManager.process();
+  }
+  if (wifiMonitor.update(boot.isDone(wifiStage)))
+  {
+    showWiFiState();
+  }
+}
 
-  // Priority 2: Handle active recording
-  if (recorder.isRecording())
+void runDeferredBoot()
+{
+  boot.update();
+  if (boot.isComplete())
   {
-    // When recording, focus on audio capture
-    recorder.update();
+    scheduler.pause(bootJob);
+  }
+}
 
-    // Minimal UI updates during recording (once per second)
-    if (currentTime - lastShakeCheck >= 1000)
-    {
-      lastShakeCheck = currentTime;
-      textManager.update(currentTime);
-      animations.setLabelText(textManager.getCurrentText().c_str());
-      ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::PULSE);
-    }
-    return; // Exit loop to prioritize next recording cycle
+// LVGL's timers, next when LVGL wants the CPU again
+void refreshDisplay()
+{
+  uint32_t wait = refresh.update(isShaking || animations.isTransitioning());
+  scheduler.runAfter(displayJob, wait);
+}
+
+// Audio capture on every pass while recording, the loop doesn't sleep meanwhile
+void captureAudio()
+{
+  if (!recorder.isRecording())
+  {
+    scheduler.pause(recorderJob);
+    scheduler.runAfter(uiJob, 0); // The answer
+    return;
   }
 
-  // Normal operation mode (not recording)
-  // Update at 60Hz (every ~16ms)
-  if (currentTime - lastShakeCheck >= 16)
+  recorder.update();
+  // Keep the tilt model current and the sample ring drained
+  processMotion();
+
+  // Minimal UI updates during recording (once per second)
+  unsigned long currentTime = millis();
+  if (currentTime - lastRecordingUpdate >= 1000)
   {
-    lastShakeCheck = currentTime;
+    lastRecordingUpdate = currentTime;
     textManager.update(currentTime);
+    animations.setLabelText(textManager.getCurrentText().c_str());
+    ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::PULSE);
+  }
+}
 
-    // Check for shake to start recording
-    if (checkForShake() && !recordingTriggered &&
-        textManager.getState() == TextStateManager::DisplayState::IDLE)
+// Shakes, the answer and the standby, at UPDATE_INTERVAL
+void updateUI()
+{
+  if (recorder.isRecording())
+  {
+    return; // captureAudio() has it
+  }
+  unsigned long currentTime = millis();
+
+  // Report the CPU load of each display state
+  if (textManager.getState() != lastDisplayState)
+  {
+    lastDisplayState = textManager.getState();
+    refresh.beginPhase(displayStateName(lastDisplayState));
+    motion.printStats();
+    lastActivityTime = currentTime;
+    lastInteractionTime = currentTime;
+  }
+
+  textManager.update(currentTime);
+
+  // Check for shake to start recording
+  if (processMotion() && !recordingTriggered &&
+      textManager.getState() == TextStateManager::DisplayState::IDLE)
+  {
+    // Start new recording session
+    recordingTriggered = true;
+    isShaking = true;
+    animations.setTriangleColor(255, 0, 0);
+    textManager.setState(TextStateManager::DisplayState::RECORDING);
+    animations.moveToCenter();
+    animations.setShaking(true);
+    scheduler.runAfter(displayJob, 0); // Up to the transition's frame rate
+    vibration.mediumBuzz();
+    ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::BLINK);
+    boot.finishDeferred(); // A shake right after boot
+    if (recorder.startRecording())
     {
-      // Start new recording session
-      recordingTriggered = true;
-      isShaking = true;
-      animations.setTriangleColor(255, 0, 0);
-      textManager.setState(TextStateManager::DisplayState::RECORDING);
-      animations.moveToCenter();
-      animations.setShaking(true);
-      vibration.mediumBuzz();
-      ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::BLINK);
-      if (recorder.startRecording())
-      {
-        Serial.println("Recording started");
-      }
-      else
+      Serial.println("Recording started");
+      lastRecordingUpdate = currentTime;
+      scheduler.runAfter(recorderJob, 0);
+      // Only when this shake is what woke us
+      if (standbyWoke && micros() - standbyWakeUs < STANDBY_REARM * 1000)
       {
-        Serial.println("Failed to start recording");
-        ledLogger.setState(LEDLogger::SystemState::ERROR, LEDLogger::LEDPattern::FAST_BLINK);
+        Serial.printf("Wake to recording: %lu us\n", micros() - standbyWakeUs);
       }
+      standbyWoke = false;
     }
-    // Check if recording just finished
-    else if (recordingTriggered && !recorder.isRecording())
+    else
     {
-      if (!isShowingResponse)
+      Serial.println("Failed to start recording");
+      ledLogger.setState(LEDLogger::SystemState::ERROR, LEDLogger::LEDPattern::FAST_BLINK);
+    }
+  }
+  // Check if recording just finished
+  else if (recordingTriggered)
+  {
+    if (!isShowingResponse)
+    {
+      vibration.shortBuzz(); // Plays out during the upload
+      isShowingResponse = true;
+      responseStartTime = currentTime;
+      if (WiFi.status() == WL_CONNECTED)
       {
-        vibration.shortBuzz();
-        vibration.update();
-        isShowingResponse = true;
-        responseStartTime = currentTime;
-        if (WiFi.status() == WL_CONNECTED)
-        {
-          // Upload the WAV file
-          uint8_t *wavData = recorder.getBuffer();
-          size_t wavSize = recorder.getBufferSize();
-          Serial.printf("Recording finished. Captured %d bytes\n", wavSize);
-          textManager.setState(TextStateManager::DisplayState::THINKING);
-          ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::PULSE);
-          animations.setLabelText(textManager.getCurrentText().c_str());
-          lv_timer_handler();
-          vibration.stop();
-          vibration.update();
-          uploadWAVFile(wavData, wavSize);
-        }
-        else
-        {
-          // Show random response
-          int responseIndex = random(0, sizeof(responses) / sizeof(responses[0]));
-          animations.setTriangleColor(0, 0, 255);
-          textManager.setState(TextStateManager::DisplayState::RESPONSE,
-                               responses[responseIndex]);
-          ledLogger.setState(LEDLogger::SystemState::WARNING, LEDLogger::LEDPattern::BLINK);
-          vibration.stop();
-          vibration.update();
-        }
+        // Upload the WAV file
+        uint8_t *wavData = recorder.getBuffer();
+        size_t wavSize = recorder.getBufferSize();
+        Serial.printf("Recording finished. Captured %d bytes\n", wavSize);
+        textManager.setState(TextStateManager::DisplayState::THINKING);
+        ledLogger.setState(LEDLogger::SystemState::BUSY, LEDLogger::LEDPattern::PULSE);
+        animations.setLabelText(textManager.getCurrentText().c_str());
+        lv_timer_handler();
+        uploadWAVFile(wavData, wavSize);
       }
-      // Check if we've shown the response long enough
-      else if (currentTime - responseStartTime >= RESPONSE_DISPLAY_DURATION)
+      else
       {
-        // Reset all states
-        vibration.stop();
-        recordingTriggered = false;
-        isShowingResponse = false;
-        isShaking = false;
-        animations.setShaking(false);
+        // Show random response
+        int responseIndex = random(0, sizeof(responses) / sizeof(responses[0]));
         animations.setTriangleColor(0, 0, 255);
-        textManager.setState(TextStateManager::DisplayState::IDLE);
-        ledLogger.setState(LEDLogger::SystemState::NORMAL);
-        QMI8658_read_xyz(acc, gyro, &tim_count);
-        animations.updateTrianglePosition(gyro[0], gyro[1]);
+        textManager.setState(TextStateManager::DisplayState::RESPONSE,
+                             responses[responseIndex]);
+        ledLogger.setState(LEDLogger::SystemState::WARNING, LEDLogger::LEDPattern::BLINK);
       }
     }
+    // Check if we've shown the response long enough
+    else if (currentTime - responseStartTime >= RESPONSE_DISPLAY_DURATION)
+    {
+      // Reset all states
+      vibration.stop();
+      recordingTriggered = false;
+      isShowingResponse = false;
+      isShaking = false;
+      animations.setShaking(false);
+      animations.setTriangleColor(0, 0, 255);
+      textManager.setState(TextStateManager::DisplayState::IDLE);
+      ledLogger.setState(LEDLogger::SystemState::NORMAL);
+      showWiFiState(); // Offline while the answer was up
+      animations.updateTrianglePosition(tilt.getGravity(), currentTime);
+    }
+  }
 
-    // Update animations when not recording or transitioning
-    if (!isShaking && !animations.isTransitioning())
+  // Update animations when not recording or transitioning
+  if (!isShaking && !animations.isTransitioning())
+  {
+    animations.updateTrianglePosition(tilt.getGravity(), currentTime);
+  }
+
+  // Update display text
+  animations.setLabelText(textManager.getCurrentText().c_str());
+
+  // Light sleep through long idle stretches, the IMU wakes us on motion. Not before the
+  // WiFi stage is done: it may be associating on the other core, and wifiManager isn't ours yet.
+  const float *rate = motion.getGyro();
+  float rateSq = rate[0] * rate[0] + rate[1] * rate[1] + rate[2] * rate[2];
+  if (rateSq > ACTIVITY_GYRO_THRESHOLD * ACTIVITY_GYRO_THRESHOLD || recordingTriggered ||
+      animations.isTransitioning())
+  {
+    lastActivityTime = currentTime;
+    lastInteractionTime = currentTime;
+  }
+  else if (currentTime - lastActivityTime >= STANDBY_AFTER &&
+           textManager.getState() == TextStateManager::DisplayState::IDLE && boot.isDone(wifiStage) &&
+           !wifiManager.getConfigPortalActive())
+  {
+    if (deepStandbyAfter && currentTime - lastInteractionTime >= deepStandbyAfter)
+    {
+      enterDeepStandby();
+    }
+    else
     {
-      QMI8658_read_xyz(acc, gyro, &tim_count);
-      animations.updateTrianglePosition(gyro[0], gyro[1]);
+      enterStandby();
     }
+    return;
+  }
+}
 
-    // Update display text
-    animations.setLabelText(textManager.getCurrentText().c_str());
+void setup()
+{
+  Serial.begin(115200);
+  if (deepStandby.begin())
+  {
+    Serial.printf("Resuming from deep standby (%lu)\n", (unsigned long)deepStandby.getSleepCount());
+    standbyWoke = true;
   }
-}
\ No newline at end of file
+
+  ledLogger.begin();
+  ledLogger.setState(LEDLogger::SystemState::STARTUP, LEDLogger::LEDPattern::PULSE);
+
+  if (psramInit())
+  {
+    Serial.printf("PSRAM initialized. Size: %d MB\n", ESP.getPsramSize() / 1024 / 1024);
+    Serial.printf("Free PSRAM: %d KB\n", ESP.getFreePsram() / 1024);
+  }
+  else
+  {
+    Serial.println("PSRAM initialization failed!");
+  }
+
+  // Associating takes the longest and the first shake doesn't need it, so it goes first,
+  // in the background next to the radio on core 0
+  wifiMonitor.begin([] { scheduler.trigger(wifiJob); });
+  wifiStage = boot.start("wifi", bootWiFi, WIFI_STAGE_STACK, 0);
+
+  boot.run("hardware", bootHardware);
+  // The IMU (I2C) comes up while the display (SPI) is initialized
+  int imuStage = boot.start("imu", bootImu, IMU_STAGE_STACK, 0);
+  if (!boot.run("display", bootDisplay))
+  {
+    Serial.println("Failed to initialize display!");
+    return;
+  }
+  if (deepStandby.isResume())
+  {
+    // The frame from before the sleep
+    const DeepStandby::UiState &ui = deepStandby.getUiState();
+    animations.setTrianglePosition(ui.triangleX, ui.triangleY);
+  }
+
+  vibration.begin();
+  if (!deepStandby.isResume())
+  {
+    vibration.shortBuzz(); // Indicate startup
+  }
+
+  // Show the idle screen as soon as a shake can be seen
+  boot.wait(imuStage);
+  textManager.setState(TextStateManager::DisplayState::IDLE);
+  animations.setLabelText(textManager.getCurrentText().c_str());
+  lv_refr_now(NULL);
+  boot.markInteractive();
+
+  // Not needed before the first recording, run from the loop
+  boot.defer("recorder", bootRecorder);
+  boot.defer("env", bootEnvironment);
+
+  // The loop sleeps until the earliest of these is due
+  scheduler.begin();
+  wifiJob = scheduler.every("wifi", WIFI_INTERVAL, serviceWiFi);
+  bootJob = scheduler.every("boot", BOOT_INTERVAL, runDeferredBoot);
+  serialJob = scheduler.every("serial", SERIAL_INTERVAL, handleSerialCommands);
+  displayJob = scheduler.after("display", 0, refreshDisplay);
+  uiJob = scheduler.every("ui", UPDATE_INTERVAL, updateUI);
+  recorderJob = scheduler.every("recorder", 0, captureAudio);
+  scheduler.pause(recorderJob);
+  Serial.println("Initialization Complete!");
+}
+
+void loop()
+{
+  refresh.addSleepTime(scheduler.run());
+}
@@ -1,5 +1,6 @@
-from flask import Flask, request
+from flask import Flask, request, jsonify
 import os
+import time
 from datetime import datetime
 
 app = Flask(__name__)
@@ -8,6 +9,24 @@ app = Flask(__name__)
 UPLOAD_DIR = 'wav_uploads'
 os.makedirs(UPLOAD_DIR, exist_ok=True)
 
+# Simulated Whisper / GPT latency of the /ask stand-in, in milliseconds
+WHISPER_DELAY_MS = int(os.environ.get('WHISPER_DELAY_MS', '0'))
+GPT_DELAY_MS = int(os.environ.get('GPT_DELAY_MS', '0'))
+CANNED_RESPONSE = os.environ.get('CANNED_RESPONSE', 'Signs point to yes')
+
+
+def save_upload(file):
+    # Create filename with timestamp
+    timestamp = datetime.now().strftime('%Y%m%d_%H%M%S')
+    filename = f'recording_{timestamp}.wav'
+
+    # Save the file
+    filepath = os.path.join(UPLOAD_DIR, filename)
+    file.save(filepath)
+    print(f"Saved file: {filepath}")
+    return filepath
+
+
 @app.route('/upload_wav', methods=['POST'])
 def upload_wav():
     if 'file' not in request.files:
@@ -17,16 +36,54 @@ def upload_wav():
     if file.filename == '':
         return 'No selected file', 400
     
-    # Create filename with timestamp
-    timestamp = datetime.now().strftime('%Y%m%d_%H%M%S')
-    filename = f'recording_{timestamp}.wav'
-    
-    # Save the file
-    filepath = os.path.join(UPLOAD_DIR, filename)
-    file.save(filepath)
-    print(f"Saved file: {filepath}")
+    save_upload(file)
     
     return 'File uploaded successfully', 200
 
+
+@app.route('/ask', methods=['POST'])
+def ask():
+    """Stand-in for the val.town endpoint, answers in the same JSON shape (see src/val.town.js)."""
+    start = time.time()
+    steps = ["Extracting form data"]
+
+    if 'file' not in request.files or request.files['file'].filename == '':
+        return jsonify({
+            'success': False,
+            'error': 'No audio file in request',
+            'debug': {'steps': steps, 'errors': [{
+                'message': 'No audio file in request',
+                'timestamp': datetime.now().isoformat(),
+            }]},
+        }), 400
+
+    filepath = save_upload(request.files['file'])
+    steps.append(f"Audio file extracted successfully: {os.path.getsize(filepath)} bytes")
+
+    steps.append("Sending to Whisper API")
+    time.sleep(WHISPER_DELAY_MS / 1000.0)
+    whisper_end = time.time()
+    steps.append("Whisper transcription successful")
+
+    steps.append("Sending to ChatGPT API")
+    time.sleep(GPT_DELAY_MS / 1000.0)
+    end = time.time()
+    steps.append("ChatGPT response received")
+
+    return jsonify({
+        'success': True,
+        'transcription': '(stand-in server, audio not transcribed)',
+        'response': CANNED_RESPONSE,
+        'debug': {
+            'steps': steps,
+            'timings': {
+                'whisperDuration': int((whisper_end - start) * 1000),
+                'gptDuration': int((end - whisper_end) * 1000),
+                'totalDuration': int((end - start) * 1000),
+            },
+        },
+    })
+
+
 if __name__ == '__main__':
-    app.run(host='0.0.0.0', port=5000)
\ No newline at end of file
+    app.run(host='0.0.0.0', port=5000)